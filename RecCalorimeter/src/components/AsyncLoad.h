@@ -0,0 +1,81 @@
+#ifndef RECCALORIMETER_ASYNCLOAD_H
+#define RECCALORIMETER_ASYNCLOAD_H
+
+// Gaudi
+#include "GaudiKernel/StatusCode.h"
+
+// ROOT
+#include "TVirtualMutex.h"
+
+#include "StageTimer.h"
+
+#include <functional>
+#include <future>
+
+/** @class AsyncLoad Reconstruction/RecCalorimeter/src/components/AsyncLoad.h
+ *
+ *  Heavy part of the initialisation of a tool or algorithm (reading a map from a file, enumerating all cells of a
+ *  detector), run as an asynchronous task so that the independent initialisations of a job overlap.
+ *
+ *  The task is started in initialize() and joined in start(), i.e. after all components are initialized and before the
+ *  first event, so that the accessors used in the event loop do not need to wait. Accessors that may be called from the
+ *  initialize() of another component (e.g. prepareEmptyCells) have to call wait() first. The task may be joined
+ *  from several threads. If the task fails or throws, wait() returns the failure or rethrows the exception.
+ *  When started with aAsync = false, the task runs immediately, as a serial initialize would. The asynchronous tasks
+ *  are opt-in ('\b asyncInitialize' of the components, false by default).
+ *
+ *  The wall-clock time of the task and the time spent waiting for it are added to counters of the owner (in
+ *  microseconds, see StageTimer): the difference is the startup time saved by the overlap.
+ *  The tasks reading ROOT files or the geometry run asynchronously only if the thread safety of ROOT is enabled for
+ *  the whole job, before any component is initialized (ROOT.EnableThreadSafety() in the job options); otherwise they
+ *  run immediately, and the owner reports it.
+ */
+
+class AsyncLoad {
+public:
+  AsyncLoad(StageTimer::Counter& aLoadTime, StageTimer::Counter& aWaitTime)
+      : m_loadTime(aLoadTime), m_waitTime(aWaitTime) {}
+  AsyncLoad(const AsyncLoad&) = delete;
+  AsyncLoad& operator=(const AsyncLoad&) = delete;
+
+  /** Start the task, asynchronously or immediately.
+   *   @param[in] aTask, task returning its status.
+   *   @param[in] aAsync, whether the task should run asynchronously.
+   *   @param[in] aUsesRoot, whether the task reads ROOT files or the geometry.
+   *   return whether the task runs asynchronously.
+   */
+  bool start(std::function<StatusCode()> aTask, bool aAsync, bool aUsesRoot = true) {
+    auto timedTask = [this, task = std::move(aTask)]() {
+      StageTimer timer(m_loadTime);
+      return task();
+    };
+    if (aAsync && (!aUsesRoot || rootThreadSafe())) {
+      m_result = std::async(std::launch::async, std::move(timedTask)).share();
+      return true;
+    }
+    std::promise<StatusCode> result;
+    result.set_value(timedTask());
+    m_result = result.get_future().share();
+    return false;
+  }
+
+  /// Whether the thread safety of ROOT is enabled (the global mutex is created by ROOT::EnableThreadSafety)
+  static bool rootThreadSafe() { return gGlobalMutex != nullptr; }
+
+  /// Wait for the end of the task and return its status (success if no task was started)
+  StatusCode wait() const {
+    if (!m_result.valid()) return StatusCode::SUCCESS;
+    StageTimer timer(m_waitTime);
+    return m_result.get();
+  }
+
+private:
+  /// Time of the task
+  StageTimer::Counter& m_loadTime;
+  /// Time spent waiting for the task
+  StageTimer::Counter& m_waitTime;
+  /// Result of the task
+  std::shared_future<StatusCode> m_result;
+};
+
+#endif /* RECCALORIMETER_ASYNCLOAD_H */
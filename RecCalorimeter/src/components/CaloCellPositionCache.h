@@ -0,0 +1,248 @@
+#ifndef RECCALORIMETER_CALOCELLPOSITIONCACHE_H
+#define RECCALORIMETER_CALOCELLPOSITIONCACHE_H
+
+// DD4hep
+#include "DD4hep/DD4hepUnits.h"
+#include "DD4hep/Objects.h"
+
+// datamodel
+#include "edm4hep/CalorimeterHitCollection.h"
+
+#include "LargeTableMemory.h"
+#include "MemoryUsage.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/** @class CaloCellPositionCache Reconstruction/RecCalorimeter/src/components/CaloCellPositionCache.h
+ *
+ *  Batched filling of the cell positions, used by the algorithms creating the positioned cells (CreateCellPositions,
+ *  CreateCaloCellPositions, CreateCaloCellPositionsFCCee) with "batchPositions" instead of cloning each cell.
+ *
+ *  The cellIDs of the input collection are copied to a contiguous buffer, the positions of the cells already seen in a
+ *  previous event are taken from the cache, the others are computed in one pass, split in chunks over "numThreads"
+ *  threads, and added to the cache. The threads are started once, at configure, and wait for the chunks of the next
+ *  event; with one thread the positions are computed by the calling thread only. The output cells are then created in
+ *  one pass, with all members of the input cell and the position, in the order of the input collection.
+ *  The positions are stored in mm, as in the cells. The cache grows up to the number of cells of the geometry; it is
+ *  filled by one algorithm and not shared between threads.
+ *  The memory of the cache can be interleaved over the NUMA nodes and put on huge pages (see LargeTableMemory.h); as it
+ *  is read by one algorithm, the placement "replicate" is not used for it.
+ */
+
+class CaloCellPositionCache {
+public:
+  /** Create the positioned cells.
+   *   @param[in] aCells, cells without position.
+   *   @param[out] aPositionedCells, collection to which the positioned cells are added.
+   *   @param[in] aPositionOf, position of a cellID (dd4hep::Position), called in parallel with several threads.
+   *   @return number of positions computed, i.e. not found in the cache.
+   */
+  template <typename F>
+  size_t fill(const edm4hep::CalorimeterHitCollection& aCells, edm4hep::CalorimeterHitCollection& aPositionedCells,
+              F&& aPositionOf) {
+    const size_t numCells = aCells.size();
+    m_cellIds.resize(numCells);
+    m_positions.resize(numCells);
+    m_missing.clear();
+    for (size_t i = 0; i < numCells; i++) {
+      m_cellIds[i] = aCells[i].getCellID();
+    }
+    for (size_t i = 0; i < numCells; i++) {
+      auto it = m_cache.find(m_cellIds[i]);
+      if (it == m_cache.end()) {
+        m_missing.push_back(i);
+      } else {
+        m_positions[i] = it->second;
+      }
+    }
+
+    // positions missing in the cache, computed in chunks
+    auto compute = [this, &aPositionOf](size_t aBegin, size_t aEnd) {
+      for (size_t j = aBegin; j < aEnd; j++) {
+        dd4hep::Position position = aPositionOf(m_cellIds[m_missing[j]]);
+        m_positions[m_missing[j]] = edm4hep::Vector3f(position.x() / dd4hep::mm, position.y() / dd4hep::mm,
+                                                      position.z() / dd4hep::mm);
+      }
+    };
+    size_t numChunks = std::max<size_t>(1, std::min(m_workers.size() + 1, m_missing.size() / kMinChunkSize));
+    if (numChunks == 1) {
+      compute(0, m_missing.size());
+    } else {
+      runChunks(compute, numChunks);
+    }
+    m_cache.reserve(m_cache.size() + m_missing.size());
+    for (size_t i : m_missing) {
+      m_cache.emplace(m_cellIds[i], m_positions[i]);
+    }
+
+    for (size_t i = 0; i < numCells; i++) {
+      const auto& cell = aCells[i];
+      aPositionedCells.create(cell.getCellID(), cell.getEnergy(), cell.getEnergyError(), cell.getTime(),
+                              m_positions[i], cell.getType());
+    }
+    return m_missing.size();
+  }
+
+  CaloCellPositionCache() = default;
+  CaloCellPositionCache(const CaloCellPositionCache&) = delete;
+  CaloCellPositionCache& operator=(const CaloCellPositionCache&) = delete;
+  ~CaloCellPositionCache() { stopWorkers(); }
+
+  /** Set the memory policy of the cache and start the threads, the cached positions are removed.
+   *   @param[in] aPolicy, placement and page size of the cache.
+   *   @param[in] aNumThreads, number of threads computing the positions missing in the cache, the calling one included.
+   */
+  void configure(const large_table::Policy& aPolicy, unsigned aNumThreads) {
+    m_policy = aPolicy;
+    if (m_policy.placement == large_table::Placement::kReplicate) m_policy.placement = large_table::Placement::kDefault;
+    clear();
+    stopWorkers();
+    for (unsigned iWorker = 1; iWorker < aNumThreads; iWorker++) {
+      m_workers.emplace_back([this, iWorker, generation = m_generation] { work(iWorker, generation); });
+    }
+  }
+
+  /// Number of cached positions
+  size_t size() const { return m_cache.size(); }
+  /// Heap memory of the cache and the buffers, in bytes (see MemoryUsage.h)
+  size_t heapBytes() const {
+    return MemoryUsage::heapBytes(m_cache) + MemoryUsage::heapBytes(m_cellIds) + MemoryUsage::heapBytes(m_positions) +
+           MemoryUsage::heapBytes(m_missing);
+  }
+  /// Memory mapped for the cache, in bytes (0 with the default policy)
+  size_t mappedBytes() const { return m_arena == nullptr ? 0 : m_arena->mappedBytes(); }
+  /// Remove all cached positions, and release their memory if the cache has its own arena
+  void clear() {
+    if (m_policy.isDefault()) {
+      m_cache.clear();
+      return;
+    }
+    m_cache = Cache();
+    m_arena = std::make_unique<large_table::Arena>(m_policy, -1);
+    m_cache = Cache(0, std::hash<uint64_t>(), std::equal_to<uint64_t>(), Allocator(m_arena.get()));
+  }
+
+private:
+  /** Compute the chunks of the missing positions, the first one in the calling thread and the others in the workers.
+   *   @param[in] aCompute, computation of the positions of a range of m_missing.
+   *   @param[in] aNumChunks, number of chunks, at most the number of workers + 1.
+   */
+  void runChunks(const std::function<void(size_t, size_t)>& aCompute, size_t aNumChunks) {
+    size_t chunkSize = (m_missing.size() + aNumChunks - 1) / aNumChunks;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_task = &aCompute;
+      m_numChunks = aNumChunks;
+      m_chunkSize = chunkSize;
+      m_pending = m_workers.size();
+      m_error = nullptr;
+      m_generation++;
+    }
+    m_start.notify_all();
+    std::exception_ptr error;
+    try {
+      aCompute(0, std::min(m_missing.size(), chunkSize));
+    } catch (...) {
+      error = std::current_exception();
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_pending == 0; });
+    m_task = nullptr;
+    if (error == nullptr) error = m_error;
+    if (error != nullptr) std::rethrow_exception(error);
+  }
+
+  /** Loop of a worker: wait for the next event and compute its chunk, if the event has one.
+   *   @param[in] aChunk, index of the chunk of the worker.
+   *   @param[in] aGeneration, number of the last event before the worker was started.
+   */
+  void work(size_t aChunk, unsigned long aGeneration) {
+    unsigned long generation = aGeneration;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+      m_start.wait(lock, [this, &generation] { return m_stop || m_generation != generation; });
+      if (m_stop) return;
+      generation = m_generation;
+      if (aChunk < m_numChunks) {
+        const std::function<void(size_t, size_t)>& compute = *m_task;
+        size_t begin = aChunk * m_chunkSize;
+        size_t end = std::min(m_missing.size(), begin + m_chunkSize);
+        lock.unlock();
+        std::exception_ptr error;
+        try {
+          compute(begin, end);
+        } catch (...) {
+          error = std::current_exception();
+        }
+        lock.lock();
+        if (error != nullptr && m_error == nullptr) m_error = error;
+      }
+      if (--m_pending == 0) m_done.notify_one();
+    }
+  }
+
+  /// Stop and join the workers
+  void stopWorkers() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_start.notify_all();
+    for (auto& worker : m_workers) {
+      worker.join();
+    }
+    m_workers.clear();
+    m_stop = false;
+  }
+
+  /// Minimal number of positions computed by a thread
+  static constexpr size_t kMinChunkSize = 1024;
+  typedef large_table::ArenaAllocator<std::pair<const uint64_t, edm4hep::Vector3f>> Allocator;
+  typedef std::unordered_map<uint64_t, edm4hep::Vector3f, std::hash<uint64_t>, std::equal_to<uint64_t>, Allocator>
+      Cache;
+  /// Memory policy of the cache
+  large_table::Policy m_policy;
+  /// Memory of the cache, declared before it so that it outlives it
+  std::unique_ptr<large_table::Arena> m_arena;
+  /// Positions of the cells seen so far, in mm
+  Cache m_cache;
+  /// CellIDs of the input cells, reused between events
+  std::vector<uint64_t> m_cellIds;
+  /// Positions of the input cells, reused between events
+  std::vector<edm4hep::Vector3f> m_positions;
+  /// Indices of the input cells not found in the cache
+  std::vector<size_t> m_missing;
+  /// Threads computing the chunks after the first one, waiting between the events
+  std::vector<std::thread> m_workers;
+  /// Protects the state of the chunks shared with the workers
+  std::mutex m_mutex;
+  /// Start of the chunks of an event, or stop of the workers
+  std::condition_variable m_start;
+  /// End of the chunks of all workers
+  std::condition_variable m_done;
+  /// Computation of the chunks of the current event
+  const std::function<void(size_t, size_t)>* m_task = nullptr;
+  /// Number of chunks of the current event
+  size_t m_numChunks = 0;
+  /// Number of positions per chunk of the current event
+  size_t m_chunkSize = 0;
+  /// Number of workers not done with the current event
+  size_t m_pending = 0;
+  /// Number of the current event, for the workers to start once per event
+  unsigned long m_generation = 0;
+  /// First exception of the workers in the current event
+  std::exception_ptr m_error;
+  /// Whether the workers stop
+  bool m_stop = false;
+};
+
+#endif /* RECCALORIMETER_CALOCELLPOSITIONCACHE_H */
@@ -0,0 +1,176 @@
+#include "CaloCellReplayFormat.h"
+
+#include <cmath>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace calo_replay {
+
+void encodeColumn(const std::vector<std::pair<uint64_t, float>>& aCells, IdEncoding aEncoding,
+                  float aEnergyPrecision, std::vector<char>& aBuffer) {
+  size_t start = aBuffer.size();
+  const bool quantised = aEnergyPrecision > 0;
+  // worst case size: 10 bytes per varint
+  size_t maxIdBytes = aEncoding == kRawIds ? aCells.size() * sizeof(uint64_t) : aCells.size() * 10;
+  size_t maxEnergyBytes = quantised ? aCells.size() * 10 : aCells.size() * sizeof(float);
+  aBuffer.resize(start + sizeof(ColumnHeader) + padded(maxIdBytes) + padded(maxEnergyBytes), 0);
+  char* ids = aBuffer.data() + start + sizeof(ColumnHeader);
+  size_t idBytes = 0;
+  if (aEncoding == kRawIds) {
+    for (size_t i = 0; i < aCells.size(); i++) {
+      std::memcpy(ids + i * sizeof(uint64_t), &aCells[i].first, sizeof(uint64_t));
+    }
+    idBytes = aCells.size() * sizeof(uint64_t);
+  } else {
+    unsigned char* pos = reinterpret_cast<unsigned char*>(ids);
+    uint64_t previous = 0;
+    for (const auto& cell : aCells) {
+      pos = writeVarint(cell.first - previous, pos);
+      previous = cell.first;
+    }
+    idBytes = pos - reinterpret_cast<unsigned char*>(ids);
+  }
+  char* energies = ids + padded(idBytes);
+  size_t energyBytes = 0;
+  if (quantised) {
+    unsigned char* pos = reinterpret_cast<unsigned char*>(energies);
+    for (const auto& cell : aCells) {
+      int64_t steps = std::llround(cell.second / aEnergyPrecision);
+      pos = writeVarint((static_cast<uint64_t>(steps) << 1) ^ static_cast<uint64_t>(steps >> 63), pos);
+    }
+    energyBytes = pos - reinterpret_cast<unsigned char*>(energies);
+  } else {
+    for (size_t i = 0; i < aCells.size(); i++) {
+      std::memcpy(energies + i * sizeof(float), &aCells[i].second, sizeof(float));
+    }
+    energyBytes = aCells.size() * sizeof(float);
+  }
+  ColumnHeader header{static_cast<uint32_t>(aCells.size()),
+                      aEncoding,
+                      idBytes,
+                      quantised ? kQuantisedEnergies : kFloatEnergies,
+                      quantised ? aEnergyPrecision : 0.f,
+                      energyBytes};
+  std::memcpy(aBuffer.data() + start, &header, sizeof(header));
+  aBuffer.resize(start + sizeof(ColumnHeader) + padded(idBytes) + padded(energyBytes));
+}
+
+namespace {
+/// Size of a block of aNumCells values with the given encoding: exact for fixed-size values, at least one and at most
+/// ten bytes per varint
+bool validBlockSize(uint64_t aBytes, uint32_t aNumCells, bool aVarints, size_t aValueSize) {
+  if (aVarints) return aBytes >= aNumCells && aBytes <= uint64_t(aNumCells) * 10;
+  return aBytes == uint64_t(aNumCells) * aValueSize;
+}
+}  // namespace
+
+bool validColumn(const ColumnHeader& aHeader, size_t aAvailable) {
+  if (aHeader.idEncoding > kDeltaVarintIds || aHeader.energyEncoding > kQuantisedEnergies) return false;
+  if (!validBlockSize(aHeader.idBytes, aHeader.numCells, aHeader.idEncoding == kDeltaVarintIds, sizeof(uint64_t)) ||
+      !validBlockSize(aHeader.energyBytes, aHeader.numCells, aHeader.energyEncoding == kQuantisedEnergies,
+                      sizeof(float))) {
+    return false;
+  }
+  // both sizes are at most 10 bytes per cell, the sum does not overflow
+  return padded(aHeader.idBytes) + padded(aHeader.energyBytes) <= aAvailable;
+}
+
+File::~File() { close(); }
+
+void File::close() {
+  if (m_data != nullptr) {
+    munmap(const_cast<char*>(m_data), m_size);
+  }
+  m_data = nullptr;
+  m_size = 0;
+  m_collectionNames.clear();
+  m_events.clear();
+  m_eventSizes.clear();
+}
+
+std::string File::open(const std::string& aFileName) {
+  close();
+  int fd = ::open(aFileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return "cannot open file " + aFileName;
+  }
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+    ::close(fd);
+    return "file " + aFileName + " is too short";
+  }
+  void* data = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    return "cannot map file " + aFileName;
+  }
+  m_data = static_cast<const char*>(data);
+  m_size = fileStat.st_size;
+  // events are read in order
+  madvise(data, m_size, MADV_SEQUENTIAL);
+
+  FileHeader header;
+  std::memcpy(&header, m_data, sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+    close();
+    return "file " + aFileName + " is not a cell replay file of version " + std::to_string(kVersion);
+  }
+  size_t offset = sizeof(FileHeader);
+  for (uint32_t i = 0; i < header.numCollections; i++) {
+    uint32_t length = 0;
+    if (offset + sizeof(length) > m_size) {
+      close();
+      return "file " + aFileName + " is truncated";
+    }
+    std::memcpy(&length, m_data + offset, sizeof(length));
+    offset += sizeof(length);
+    if (offset + length > m_size) {
+      close();
+      return "file " + aFileName + " is truncated";
+    }
+    m_collectionNames.emplace_back(m_data + offset, length);
+    offset += length;
+  }
+  offset = padded(offset);
+
+  // index the event blocks
+  while (offset + sizeof(EventHeader) <= m_size) {
+    EventHeader eventHeader;
+    std::memcpy(&eventHeader, m_data + offset, sizeof(eventHeader));
+    if (eventHeader.magic != kEventMagic || eventHeader.numCollections != header.numCollections ||
+        eventHeader.payloadSize > m_size - offset - sizeof(EventHeader)) {
+      // incomplete last event, e.g. if the writing job was stopped
+      break;
+    }
+    const char* column = m_data + offset + sizeof(EventHeader);
+    const char* eventEnd = column + eventHeader.payloadSize;
+    std::vector<Column> columns;
+    columns.reserve(eventHeader.numCollections);
+    for (uint32_t i = 0; i < eventHeader.numCollections; i++) {
+      Column entry;
+      if (size_t(eventEnd - column) < sizeof(ColumnHeader)) {
+        close();
+        return "file " + aFileName + " has a column outside of its event at byte " + std::to_string(offset);
+      }
+      std::memcpy(&entry.header, column, sizeof(ColumnHeader));
+      // the blocks of the column, and the energies of the quantised encoding, have to be inside the event
+      if (!validColumn(entry.header, eventEnd - column - sizeof(ColumnHeader))) {
+        close();
+        return "file " + aFileName + " has a corrupt column in the event at byte " + std::to_string(offset);
+      }
+      entry.ids = column + sizeof(ColumnHeader);
+      entry.energies = entry.ids + padded(entry.header.idBytes);
+      columns.push_back(entry);
+      column = entry.energies + padded(entry.header.energyBytes);
+    }
+    m_events.push_back(std::move(columns));
+    m_eventSizes.push_back(sizeof(EventHeader) + eventHeader.payloadSize);
+    offset += sizeof(EventHeader) + eventHeader.payloadSize;
+  }
+  return "";
+}
+
+}  // namespace calo_replay
@@ -0,0 +1,215 @@
+#ifndef RECCALORIMETER_CALOCELLREPLAYFORMAT_H
+#define RECCALORIMETER_CALOCELLREPLAYFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** @file CaloCellReplayFormat.h Reconstruction/RecCalorimeter/src/components/CaloCellReplayFormat.h
+ *
+ *  Binary format of the cell replay files, used to store the calorimeter cells after digitisation (calibration,
+ *  noise, filtering) and to feed them back to the reconstruction without running the upstream algorithms.
+ *
+ *  Layout (host byte order, all blocks padded to 8 bytes so that the columns can be read in place from a mapped file):
+ *   - FileHeader, followed by the names of the stored collections (uint32 length + characters each);
+ *   - one block per event: EventHeader, followed by one column block per collection:
+ *     ColumnHeader, the cellIDs sorted in increasing order (raw uint64 or delta-coded varints),
+ *     the cell energies in the same order (float32, or quantised in steps of energyPrecision and stored as
+ *     zigzag-coded varints).
+ *  Only files of the current version are read, the files of the earlier version 1 (shorter column header, float32
+ *  energies only) are rejected.
+ *  Positions and the other members of the cells are not stored, the positions can be recomputed from the geometry
+ *  (e.g. CreateCaloCellPositions).
+ *
+ *  Written by WriteCaloCellReplay, read by ReadCaloCellReplay and CaloCellReplayInputTool.
+ */
+
+namespace calo_replay {
+
+/// File identifier
+constexpr char kMagic[8] = {'C', 'C', 'R', 'E', 'P', 'L', 'A', 'Y'};
+/// Current format version
+constexpr uint32_t kVersion = 2;
+/// Event block identifier ("CEVT")
+constexpr uint32_t kEventMagic = 0x54564543;
+
+/// Encoding of the cellID column
+enum IdEncoding : uint32_t { kRawIds = 0, kDeltaVarintIds = 1 };
+/// Encoding of the energy column
+enum EnergyEncoding : uint32_t { kFloatEnergies = 0, kQuantisedEnergies = 1 };
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t numCollections;
+};
+
+struct EventHeader {
+  uint32_t magic;
+  uint32_t numCollections;
+  /// size in bytes of the column blocks following the header
+  uint64_t payloadSize;
+};
+
+struct ColumnHeader {
+  uint32_t numCells;
+  uint32_t idEncoding;
+  /// size in bytes of the cellID column, without padding
+  uint64_t idBytes;
+  uint32_t energyEncoding;
+  /// step of the quantised energies, in GeV
+  float energyPrecision;
+  /// size in bytes of the energy column, without padding
+  uint64_t energyBytes;
+};
+
+/// Column of a mapped file
+struct Column {
+  ColumnHeader header;
+  const char* ids;
+  const char* energies;
+};
+
+/// Size rounded up to the block alignment
+inline size_t padded(size_t aSize) { return (aSize + 7) & ~size_t(7); }
+
+/// Append a variable-length unsigned integer (7 bits per byte)
+inline unsigned char* writeVarint(uint64_t aValue, unsigned char* aPos) {
+  while (aValue >= 0x80) {
+    *aPos++ = static_cast<unsigned char>(aValue | 0x80);
+    aValue >>= 7;
+  }
+  *aPos++ = static_cast<unsigned char>(aValue);
+  return aPos;
+}
+
+/// Read a variable-length unsigned integer and advance the position
+inline uint64_t readVarint(const unsigned char*& aPos) {
+  uint64_t value = 0;
+  int shift = 0;
+  while (*aPos & 0x80) {
+    value |= uint64_t(*aPos++ & 0x7f) << shift;
+    shift += 7;
+  }
+  value |= uint64_t(*aPos++) << shift;
+  return value;
+}
+
+/// Read a variable-length unsigned integer ending before aEnd and advance the position, truncated at aEnd
+inline uint64_t readVarint(const unsigned char*& aPos, const unsigned char* aEnd) {
+  uint64_t value = 0;
+  for (int shift = 0; aPos < aEnd && shift < 64; shift += 7) {
+    unsigned char byte = *aPos++;
+    value |= uint64_t(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) break;
+  }
+  return value;
+}
+
+/** Append one column (cells of one collection) to the buffer.
+ *   @param[in] aCells, pairs of cellID and energy, sorted by cellID.
+ *   @param[in] aEncoding, encoding of the cellIDs.
+ *   @param[in] aEnergyPrecision, step of the quantised energies in GeV, float energies if 0.
+ *   @param[out] aBuffer, buffer to which the column is appended.
+ */
+void encodeColumn(const std::vector<std::pair<uint64_t, float>>& aCells, IdEncoding aEncoding,
+                  float aEnergyPrecision, std::vector<char>& aBuffer);
+
+/** Decode one column, calling aFunc(cellID, energy) for each cell.
+ *  The varints are read within the sizes of their blocks, checked against the event block by File::open, so that a
+ *  corrupt column gives wrong cells but is never read outside of the mapping.
+ *   @param[in] aColumn, column of a mapped file.
+ */
+template <typename F>
+void decodeColumn(const Column& aColumn, F&& aFunc) {
+  const ColumnHeader& header = aColumn.header;
+  const unsigned char* idPos = reinterpret_cast<const unsigned char*>(aColumn.ids);
+  const unsigned char* idEnd = idPos + header.idBytes;
+  const uint64_t* rawIds = reinterpret_cast<const uint64_t*>(aColumn.ids);
+  const float* floatEnergies = reinterpret_cast<const float*>(aColumn.energies);
+  const unsigned char* energyPos = reinterpret_cast<const unsigned char*>(aColumn.energies);
+  const unsigned char* energyEnd = energyPos + header.energyBytes;
+  const bool deltaIds = header.idEncoding != kRawIds;
+  const bool quantised = header.energyEncoding == kQuantisedEnergies;
+  uint64_t cellId = 0;
+  for (uint32_t i = 0; i < header.numCells; i++) {
+    cellId = deltaIds ? cellId + readVarint(idPos, idEnd) : rawIds[i];
+    float energy;
+    if (quantised) {
+      uint64_t zigzag = readVarint(energyPos, energyEnd);
+      int64_t steps = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+      energy = steps * header.energyPrecision;
+    } else {
+      energy = floatEnergies[i];
+    }
+    aFunc(cellId, energy);
+  }
+}
+
+/** Whether the sizes of the blocks of a column are consistent with its encodings and number of cells, and fit in
+ *  aAvailable bytes (the rest of the event block after the column header).
+ */
+bool validColumn(const ColumnHeader& aHeader, size_t aAvailable);
+
+/** @class calo_replay::File
+ *
+ *  Read-only access to a replay file through a memory mapping.
+ *  The positions of the event blocks are indexed when the file is opened, the cells are decoded on demand.
+ *  The columns are checked to lie within their event block, with cellID and energy blocks of a size consistent with
+ *  their encoding and number of cells; a file with a corrupt column is rejected.
+ */
+class File {
+public:
+  File() = default;
+  ~File();
+  File(const File&) = delete;
+  File& operator=(const File&) = delete;
+
+  /** Map the file and index its events.
+   *   return empty string on success, the error message otherwise.
+   */
+  std::string open(const std::string& aFileName);
+  /// Unmap the file
+  void close();
+
+  /// Number of events in the file
+  size_t numEvents() const { return m_events.size(); }
+  /// Names of the stored collections
+  const std::vector<std::string>& collectionNames() const { return m_collectionNames; }
+  /// Size of the mapped file in bytes
+  size_t size() const { return m_size; }
+
+  /// Size of the block of an event in bytes
+  size_t eventSize(size_t aEvent) const { return m_eventSizes[aEvent]; }
+
+  /** Number of cells of a collection in an event
+   *   @param[in] aEvent, index of the event.
+   *   @param[in] aCollection, index of the collection.
+   */
+  uint32_t numCells(size_t aEvent, size_t aCollection) const { return m_events[aEvent][aCollection].header.numCells; }
+
+  /** Call aFunc(cellID, energy) for all cells of a collection in an event, sorted by cellID.
+   *   @param[in] aEvent, index of the event.
+   *   @param[in] aCollection, index of the collection.
+   */
+  template <typename F>
+  void forEachCell(size_t aEvent, size_t aCollection, F&& aFunc) const {
+    decodeColumn(m_events[aEvent][aCollection], aFunc);
+  }
+
+private:
+  const char* m_data = nullptr;
+  size_t m_size = 0;
+  std::vector<std::string> m_collectionNames;
+  /// Per event, the column of each collection
+  std::vector<std::vector<Column>> m_events;
+  /// Per event, the size of its block
+  std::vector<size_t> m_eventSizes;
+};
+
+}  // namespace calo_replay
+
+#endif /* RECCALORIMETER_CALOCELLREPLAYFORMAT_H */
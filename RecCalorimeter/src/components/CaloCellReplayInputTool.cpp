@@ -0,0 +1,70 @@
+#include "CaloCellReplayInputTool.h"
+
+// Gaudi
+#include "GaudiKernel/ThreadLocalContext.h"
+
+#include <algorithm>
+
+DECLARE_COMPONENT(CaloCellReplayInputTool)
+
+CaloCellReplayInputTool::CaloCellReplayInputTool(const std::string& type, const std::string& name,
+                                                 const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareInterface<ITopoClusterInputTool>(this);
+}
+
+StatusCode CaloCellReplayInputTool::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  std::string err = m_file.open(m_fileName);
+  if (!err.empty()) {
+    error() << "Unable to read cell replay file: " << err << endmsg;
+    return StatusCode::FAILURE;
+  }
+  const auto& storedNames = m_file.collectionNames();
+  if (m_collectionNames.empty()) {
+    for (size_t i = 0; i < storedNames.size(); i++) {
+      m_collections.push_back(i);
+    }
+  } else {
+    for (const auto& name : m_collectionNames) {
+      auto it = std::find(storedNames.begin(), storedNames.end(), name);
+      if (it == storedNames.end()) {
+        error() << "Collection " << name << " not found in " << m_fileName << endmsg;
+        return StatusCode::FAILURE;
+      }
+      m_collections.push_back(it - storedNames.begin());
+    }
+  }
+  info() << "Cell replay file " << m_fileName << " with " << m_file.numEvents() << " events, using "
+         << m_collections.size() << " of " << storedNames.size() << " collections" << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CaloCellReplayInputTool::finalize() {
+  m_file.close();
+  return GaudiTool::finalize();
+}
+
+StatusCode CaloCellReplayInputTool::cellIDMap(std::map<uint64_t, double>& aCells) {
+  aCells.clear();
+  size_t event = m_firstEvent + Gaudi::Hive::currentContext().evt();
+  if (event >= m_file.numEvents()) {
+    error() << "Event " << event << " not found in " << m_fileName << " (" << m_file.numEvents() << " events)"
+            << endmsg;
+    return StatusCode::FAILURE;
+  }
+  for (auto collection : m_collections) {
+    // cells are sorted by cellID, the insertion position of the next cell is right after the previous one
+    auto hint = aCells.end();
+    m_file.forEachCell(event, collection, [&aCells, &hint](uint64_t aCellId, float aEnergy) {
+      hint = aCells.emplace_hint(hint, aCellId, aEnergy);
+      ++hint;
+    });
+    debug() << "Input " << m_file.collectionNames()[collection] << " cell collection size: "
+            << m_file.numCells(event, collection) << endmsg;
+  }
+  debug() << "Number of cells in map: " << aCells.size() << endmsg;
+  return StatusCode::SUCCESS;
+}
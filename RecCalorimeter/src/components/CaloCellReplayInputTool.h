@@ -0,0 +1,57 @@
+#ifndef RECCALORIMETER_CALOCELLREPLAYINPUTTOOL_H
+#define RECCALORIMETER_CALOCELLREPLAYINPUTTOOL_H
+
+// from Gaudi
+#include "GaudiAlg/GaudiTool.h"
+
+// FCCSW
+#include "k4Interface/ITopoClusterInputTool.h"
+
+#include "CaloCellReplayFormat.h"
+
+/** @class CaloCellReplayInputTool Reconstruction/RecCalorimeter/src/components/CaloCellReplayInputTool.h
+ *
+ *  Tool filling the map of all Calo cells as input for the TopoCluster algorithm directly from a cell replay file
+ *  written by WriteCaloCellReplay (see CaloCellReplayFormat.h), without creating cell collections in the event store.
+ *  Replaces CaloTopoClusterInputTool for fast scans of the clustering parameters.
+ *
+ *  The file is memory-mapped, event N of the job reads event (firstEvent + N) of the file.
+ *  All collections stored in the file are used, unless a subset is given in "collections".
+ *
+ */
+
+class CaloCellReplayInputTool : public GaudiTool, virtual public ITopoClusterInputTool {
+public:
+  CaloCellReplayInputTool(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~CaloCellReplayInputTool() = default;
+
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+
+  /**  Finalize.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+
+  /** cellIDMap
+   * Fills the given map with all cellIDs pointing to the cells energy.
+   *  @return status code
+   */
+  virtual StatusCode cellIDMap(std::map<uint64_t, double>& aCells) final;
+
+private:
+  /// Name of the input file
+  Gaudi::Property<std::string> m_fileName{this, "filename", "caloCellReplay.bin", "Name of the input file"};
+  /// Names of the stored collections to use, all if empty
+  Gaudi::Property<std::vector<std::string>> m_collectionNames{this, "collections", {}, "Stored collections to use, all if empty"};
+  /// First event of the file to read
+  Gaudi::Property<unsigned int> m_firstEvent{this, "firstEvent", 0, "First event of the file to read"};
+  /// Mapped input file
+  calo_replay::File m_file;
+  /// Indices of the stored collections to use
+  std::vector<size_t> m_collections;
+};
+
+#endif /* RECCALORIMETER_CALOCELLREPLAYINPUTTOOL_H */
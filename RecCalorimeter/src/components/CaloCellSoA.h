@@ -0,0 +1,162 @@
+#ifndef RECCALORIMETER_CALOCELLSOA_H
+#define RECCALORIMETER_CALOCELLSOA_H
+
+// datamodel
+#include "edm4hep/CalorimeterHitCollection.h"
+
+#include "MemoryUsage.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+/** @class CaloCellSoA Reconstruction/RecCalorimeter/src/components/CaloCellSoA.h
+ *
+ *  Calorimeter cells of an event as a structure of arrays: cellID and energy (as float) of each cell, and optionally
+ *  its time and position, in separate contiguous columns.
+ *  It is a transient object of the event store, written once per event by CreateCaloCellSoA from the cell collections
+ *  and read by the following algorithms and tools (e.g. CaloCellSoAInputTool) through a DataHandle<CaloCellSoA>,
+ *  without copies of the cells and without the per-cell allocations of the maps. It is not written to the output
+ *  files, CreateCaloCellsFromSoA converts it back to a CalorimeterHitCollection.
+ *
+ *  The optional columns are chosen at construction and are either empty or of the same size as the cellIDs.
+ *  After sortByCellId() the cells can be looked up by cellID with a binary search.
+ */
+
+class CaloCellSoA {
+public:
+  /// Optional columns
+  enum Column : unsigned { kTime = 1, kPosition = 2 };
+  /// Returned by find() for a missing cell
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  explicit CaloCellSoA(unsigned aColumns = 0) : m_columns(aColumns) {}
+
+  /// Whether the time column is filled
+  bool hasTime() const { return m_columns & kTime; }
+  /// Whether the position columns are filled
+  bool hasPosition() const { return m_columns & kPosition; }
+  /// Number of cells
+  size_t size() const { return m_cellIds.size(); }
+  bool empty() const { return m_cellIds.empty(); }
+  /// Whether the cells are sorted by cellID
+  bool sorted() const { return m_sorted; }
+
+  /// Reserve the columns for aSize cells
+  void reserve(size_t aSize) {
+    m_cellIds.reserve(aSize);
+    m_energies.reserve(aSize);
+    if (hasTime()) m_times.reserve(aSize);
+    if (hasPosition()) {
+      m_x.reserve(aSize);
+      m_y.reserve(aSize);
+      m_z.reserve(aSize);
+    }
+  }
+
+  /// Remove all cells, the columns keep their capacity
+  void clear() {
+    m_cellIds.clear();
+    m_energies.clear();
+    m_times.clear();
+    m_x.clear();
+    m_y.clear();
+    m_z.clear();
+    m_sorted = true;
+  }
+
+  /// Append a cell, the time and the position are ignored if the columns are not filled
+  void add(uint64_t aCellId, float aEnergy, float aTime = 0, const edm4hep::Vector3f& aPosition = {}) {
+    if (!m_cellIds.empty() && aCellId < m_cellIds.back()) m_sorted = false;
+    m_cellIds.push_back(aCellId);
+    m_energies.push_back(aEnergy);
+    if (hasTime()) m_times.push_back(aTime);
+    if (hasPosition()) {
+      m_x.push_back(aPosition.x);
+      m_y.push_back(aPosition.y);
+      m_z.push_back(aPosition.z);
+    }
+  }
+
+  /// Append the cells of a collection
+  void append(const edm4hep::CalorimeterHitCollection& aCells) {
+    reserve(size() + aCells.size());
+    for (const auto& cell : aCells) {
+      add(cell.getCellID(), cell.getEnergy(), cell.getTime(), cell.getPosition());
+    }
+  }
+
+  /// Fill a collection with the cells, in the order of the columns
+  void toCollection(edm4hep::CalorimeterHitCollection& aCells) const {
+    for (size_t i = 0; i < size(); i++) {
+      auto cell = aCells.create();
+      cell.setCellID(m_cellIds[i]);
+      cell.setEnergy(m_energies[i]);
+      if (hasTime()) cell.setTime(m_times[i]);
+      if (hasPosition()) cell.setPosition(edm4hep::Vector3f(m_x[i], m_y[i], m_z[i]));
+    }
+  }
+
+  /// Sort all columns by cellID
+  void sortByCellId() {
+    if (m_sorted) return;
+    std::vector<uint32_t> order(size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [this](uint32_t lhs, uint32_t rhs) { return m_cellIds[lhs] < m_cellIds[rhs]; });
+    permute(m_cellIds, order);
+    permute(m_energies, order);
+    permute(m_times, order);
+    permute(m_x, order);
+    permute(m_y, order);
+    permute(m_z, order);
+    m_sorted = true;
+  }
+
+  /// Index of a cell in the columns, which have to be sorted, npos if not found
+  size_t find(uint64_t aCellId) const {
+    auto it = std::lower_bound(m_cellIds.begin(), m_cellIds.end(), aCellId);
+    return (it == m_cellIds.end() || *it != aCellId) ? npos : it - m_cellIds.begin();
+  }
+
+  /// Columns, indexed by cell
+  const std::vector<uint64_t>& cellIds() const { return m_cellIds; }
+  const std::vector<float>& energies() const { return m_energies; }
+  const std::vector<float>& times() const { return m_times; }
+  const std::vector<float>& x() const { return m_x; }
+  const std::vector<float>& y() const { return m_y; }
+  const std::vector<float>& z() const { return m_z; }
+
+  /// Heap memory of the columns in bytes (see MemoryUsage.h)
+  size_t heapBytes() const {
+    return MemoryUsage::heapBytes(m_cellIds) + MemoryUsage::heapBytes(m_energies) + MemoryUsage::heapBytes(m_times) +
+           MemoryUsage::heapBytes(m_x) + MemoryUsage::heapBytes(m_y) + MemoryUsage::heapBytes(m_z);
+  }
+
+private:
+  template <typename T>
+  static void permute(std::vector<T>& aColumn, const std::vector<uint32_t>& aOrder) {
+    if (aColumn.empty()) return;
+    std::vector<T> permuted;
+    permuted.reserve(aColumn.size());
+    for (uint32_t index : aOrder) {
+      permuted.push_back(aColumn[index]);
+    }
+    aColumn.swap(permuted);
+  }
+
+  /// Filled optional columns
+  unsigned m_columns;
+  /// Whether the cellIDs are in increasing order
+  bool m_sorted = true;
+  std::vector<uint64_t> m_cellIds;
+  std::vector<float> m_energies;
+  std::vector<float> m_times;
+  std::vector<float> m_x;
+  std::vector<float> m_y;
+  std::vector<float> m_z;
+};
+
+#endif /* RECCALORIMETER_CALOCELLSOA_H */
@@ -0,0 +1,44 @@
+#include "CaloCellSoAInputTool.h"
+
+DECLARE_COMPONENT(CaloCellSoAInputTool)
+
+CaloCellSoAInputTool::CaloCellSoAInputTool(const std::string& type, const std::string& name,
+                                           const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareProperty("cellSoA", m_cellSoA, "The cells as structure of arrays (input)");
+  declareInterface<ITopoClusterInputTool>(this);
+}
+
+StatusCode CaloCellSoAInputTool::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CaloCellSoAInputTool::finalize() { return GaudiTool::finalize(); }
+
+StatusCode CaloCellSoAInputTool::cellIDMap(std::map<uint64_t, double>& aCells) {
+  aCells.clear();
+  const CaloCellSoA* cells = m_cellSoA.get();
+  const auto& cellIds = cells->cellIds();
+  const auto& energies = cells->energies();
+  if (cells->sorted()) {
+    // the insertion position of the next cell is right after the previous one
+    auto hint = aCells.end();
+    for (size_t i = 0; i < cells->size(); i++) {
+      hint = aCells.emplace_hint(hint, cellIds[i], energies[i]);
+      ++hint;
+    }
+  } else {
+    for (size_t i = 0; i < cells->size(); i++) {
+      aCells.emplace(cellIds[i], energies[i]);
+    }
+  }
+  debug() << "Input cell SoA size: " << cells->size() << endmsg;
+  if (cells->size() != aCells.size()) {
+    error() << "Map size != total number of cells! " << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
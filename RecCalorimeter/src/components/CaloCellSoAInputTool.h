@@ -0,0 +1,48 @@
+#ifndef RECCALORIMETER_CALOCELLSOAINPUTTOOL_H
+#define RECCALORIMETER_CALOCELLSOAINPUTTOOL_H
+
+// from Gaudi
+#include "GaudiAlg/GaudiTool.h"
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+#include "k4Interface/ITopoClusterInputTool.h"
+
+#include "CaloCellSoA.h"
+
+/** @class CaloCellSoAInputTool Reconstruction/RecCalorimeter/src/components/CaloCellSoAInputTool.h
+ *
+ *  Tool filling the map of all Calo cells as input for the TopoCluster algorithm from the CaloCellSoA object written
+ *  by CreateCaloCellSoA (see CaloCellSoA.h), which holds the cells of all systems.
+ *  Replaces CaloTopoClusterInputTool and its seven cell collections; the cells sorted by cellID are inserted at the
+ *  end of the map, without searching the position of each cell.
+ *
+ */
+
+class CaloCellSoAInputTool : public GaudiTool, virtual public ITopoClusterInputTool {
+public:
+  CaloCellSoAInputTool(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~CaloCellSoAInputTool() = default;
+
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+
+  /**  Finalize.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+
+  /** cellIDMap
+   * Fills the given map with all cellIDs pointing to the cells energy.
+   *  @return status code
+   */
+  virtual StatusCode cellIDMap(std::map<uint64_t, double>& aCells) final;
+
+private:
+  /// Handle for the cells as structure of arrays (input)
+  DataHandle<CaloCellSoA> m_cellSoA{"cellSoA", Gaudi::DataHandle::Reader, this};
+};
+
+#endif /* RECCALORIMETER_CALOCELLSOAINPUTTOOL_H */
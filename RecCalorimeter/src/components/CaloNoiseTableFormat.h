@@ -0,0 +1,123 @@
+#ifndef RECCALORIMETER_CALONOISETABLEFORMAT_H
+#define RECCALORIMETER_CALONOISETABLEFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/** @file CaloNoiseTableFormat.h Reconstruction/RecCalorimeter/src/components/CaloNoiseTableFormat.h
+ *
+ *  Binary format of the noise tables, a compact alternative to the ROOT file with the trees "noisyCells_system<ID>"
+ *  for the noise level and offset of all cells.
+ *
+ *  Layout (host byte order, all blocks padded to 8 bytes):
+ *   - FileHeader, followed by one SystemEntry per system (system ID, number of cells, position of its block);
+ *   - one block per system: the cellIDs sorted in increasing order (uint64), the noise levels and the noise offsets
+ *     in the same order (float32).
+ *  A system is read without reading the blocks of the other systems.
+ *
+ *  Written by CreateFCChhCaloNoiseLevelMap, read by TopoCaloNoisyCells (files with the extension ".bin").
+ */
+
+namespace calo_noise {
+
+/// File identifier
+constexpr char kMagic[8] = {'C', 'N', 'O', 'I', 'S', 'E', '\0', '\0'};
+/// Current format version
+constexpr uint32_t kVersion = 1;
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t numSystems;
+};
+
+struct SystemEntry {
+  uint32_t system;
+  uint32_t numCells;
+  /// position of the block of the system, in bytes from the beginning of the file
+  uint64_t offset;
+};
+
+/// Size of a block padded to 8 bytes
+inline size_t padded(size_t aSize) { return (aSize + 7) & ~size_t(7); }
+
+/// Size of the block of a system with aNumCells cells
+inline size_t blockSize(size_t aNumCells) {
+  return aNumCells * sizeof(uint64_t) + 2 * padded(aNumCells * sizeof(float));
+}
+
+/// Size of the header and the system table
+inline size_t headerSize(size_t aNumSystems) { return sizeof(FileHeader) + aNumSystems * sizeof(SystemEntry); }
+
+/// Write the header and the system table, at the beginning of the stream
+inline void writeHeader(std::ostream& aStream, const std::vector<SystemEntry>& aSystems) {
+  FileHeader header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.numSystems = aSystems.size();
+  aStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  aStream.write(reinterpret_cast<const char*>(aSystems.data()), aSystems.size() * sizeof(SystemEntry));
+}
+
+/** Write the block of a system at the current position of the stream.
+ *   @param[in] aCellIds, cellIDs sorted in increasing order.
+ *   @param[in] aNoiseLevels, aNoiseOffsets, noise of the cells in the same order.
+ */
+inline void writeSystem(std::ostream& aStream, const std::vector<uint64_t>& aCellIds,
+                        const std::vector<float>& aNoiseLevels, const std::vector<float>& aNoiseOffsets) {
+  const char padding[8] = {0};
+  size_t floatBytes = aCellIds.size() * sizeof(float);
+  aStream.write(reinterpret_cast<const char*>(aCellIds.data()), aCellIds.size() * sizeof(uint64_t));
+  aStream.write(reinterpret_cast<const char*>(aNoiseLevels.data()), floatBytes);
+  aStream.write(padding, padded(floatBytes) - floatBytes);
+  aStream.write(reinterpret_cast<const char*>(aNoiseOffsets.data()), floatBytes);
+  aStream.write(padding, padded(floatBytes) - floatBytes);
+}
+
+/** Read the header and the system table.
+ *   return empty string on success, the error message otherwise.
+ */
+inline std::string readHeader(std::istream& aStream, std::vector<SystemEntry>& aSystems) {
+  FileHeader header;
+  if (!aStream.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    return "the file is too short";
+  }
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+    return "the file is not a noise table of version " + std::to_string(kVersion);
+  }
+  aSystems.resize(header.numSystems);
+  if (!aStream.read(reinterpret_cast<char*>(aSystems.data()), aSystems.size() * sizeof(SystemEntry))) {
+    return "the system table is incomplete";
+  }
+  return "";
+}
+
+/** Read the block of a system and call aInsert(cellID, noise level, noise offset) for its cells.
+ *   return false if the block is incomplete.
+ */
+template <typename F>
+bool readSystem(std::istream& aStream, const SystemEntry& aSystem, F&& aInsert) {
+  std::vector<uint64_t> cellIds(aSystem.numCells);
+  std::vector<float> noiseLevels(aSystem.numCells);
+  std::vector<float> noiseOffsets(aSystem.numCells);
+  size_t floatBytes = aSystem.numCells * sizeof(float);
+  aStream.seekg(aSystem.offset);
+  aStream.read(reinterpret_cast<char*>(cellIds.data()), aSystem.numCells * sizeof(uint64_t));
+  aStream.read(reinterpret_cast<char*>(noiseLevels.data()), floatBytes);
+  aStream.seekg(padded(floatBytes) - floatBytes, std::ios::cur);
+  aStream.read(reinterpret_cast<char*>(noiseOffsets.data()), floatBytes);
+  if (!aStream) return false;
+  for (uint32_t i = 0; i < aSystem.numCells; i++) {
+    aInsert(cellIds[i], noiseLevels[i], noiseOffsets[i]);
+  }
+  return true;
+}
+
+}  // namespace calo_noise
+
+#endif /* RECCALORIMETER_CALONOISETABLEFORMAT_H */
@@ -0,0 +1,155 @@
+#include "CaloPileupBankFormat.h"
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace calo_pileup {
+
+namespace {
+/// Whether the index block of a sparse entry holds numCells varints inside its size, all below aNumCells
+bool validIndices(const EntryHeader& aHeader, const char* aPayload, uint32_t aNumCells) {
+  const unsigned char* pos = reinterpret_cast<const unsigned char*>(aPayload);
+  const unsigned char* end = pos + aHeader.indexBytes;
+  uint64_t index = 0;
+  for (uint32_t i = 0; i < aHeader.numCells; i++) {
+    uint64_t delta = 0;
+    unsigned char byte = 0x80;
+    for (int shift = 0; byte & 0x80; shift += 7) {
+      if (pos == end || shift > 63) return false;
+      byte = *pos++;
+      delta |= uint64_t(byte & 0x7f) << shift;
+    }
+    if (delta >= aNumCells - index) return false;
+    index += delta;
+  }
+  return true;
+}
+}  // namespace
+
+void CellIndex::build(const std::unordered_map<uint64_t, double>& aCells) {
+  m_cellIds.clear();
+  m_cellIds.reserve(aCells.size());
+  for (const auto& cell : aCells) {
+    m_cellIds.push_back(cell.first);
+  }
+  std::sort(m_cellIds.begin(), m_cellIds.end());
+  m_indices.clear();
+  m_indices.reserve(m_cellIds.size());
+  m_checksum = 0xcbf29ce484222325ULL;
+  for (uint32_t i = 0; i < m_cellIds.size(); i++) {
+    m_indices.emplace(m_cellIds[i], i);
+    for (int byte = 0; byte < 8; byte++) {
+      m_checksum ^= (m_cellIds[i] >> (8 * byte)) & 0xff;
+      m_checksum *= 0x100000001b3ULL;
+    }
+  }
+}
+
+uint32_t encodeEntry(const std::vector<float>& aEnergies, double aDenseFraction, std::vector<char>& aBuffer) {
+  size_t start = aBuffer.size();
+  uint32_t numCells = std::count_if(aEnergies.begin(), aEnergies.end(), [](float aEnergy) { return aEnergy != 0; });
+  EntryHeader header{kEntryMagic, kSparse, numCells, 0, 0, 0};
+  if (numCells > aDenseFraction * aEnergies.size()) {
+    header.encoding = kDense;
+    size_t energyBytes = aEnergies.size() * sizeof(float);
+    header.payloadSize = calo_replay::padded(energyBytes);
+    aBuffer.resize(start + sizeof(EntryHeader) + header.payloadSize, 0);
+    std::memcpy(aBuffer.data() + start + sizeof(EntryHeader), aEnergies.data(), energyBytes);
+  } else {
+    // worst case size: 5 bytes per varint of 32 bits
+    size_t energyBytes = numCells * sizeof(float);
+    aBuffer.resize(start + sizeof(EntryHeader) + calo_replay::padded(numCells * 5) + calo_replay::padded(energyBytes),
+                   0);
+    unsigned char* indices = reinterpret_cast<unsigned char*>(aBuffer.data() + start + sizeof(EntryHeader));
+    unsigned char* pos = indices;
+    std::vector<float> energies;
+    energies.reserve(numCells);
+    uint32_t previous = 0;
+    for (uint32_t i = 0; i < aEnergies.size(); i++) {
+      if (aEnergies[i] == 0) continue;
+      pos = calo_replay::writeVarint(i - previous, pos);
+      previous = i;
+      energies.push_back(aEnergies[i]);
+    }
+    header.indexBytes = pos - indices;
+    std::memcpy(reinterpret_cast<char*>(indices) + calo_replay::padded(header.indexBytes), energies.data(),
+                energyBytes);
+    header.payloadSize = calo_replay::padded(header.indexBytes) + calo_replay::padded(energyBytes);
+    aBuffer.resize(start + sizeof(EntryHeader) + header.payloadSize);
+  }
+  std::memcpy(aBuffer.data() + start, &header, sizeof(header));
+  return numCells;
+}
+
+File::~File() { close(); }
+
+void File::close() {
+  if (m_data != nullptr) {
+    munmap(const_cast<char*>(m_data), m_size);
+  }
+  m_data = nullptr;
+  m_size = 0;
+  m_entries.clear();
+}
+
+std::string File::open(const std::string& aFileName) {
+  close();
+  int fd = ::open(aFileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return "cannot open file " + aFileName;
+  }
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+    ::close(fd);
+    return "file " + aFileName + " is too short";
+  }
+  void* data = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    return "cannot map file " + aFileName;
+  }
+  m_data = static_cast<const char*>(data);
+  m_size = fileStat.st_size;
+  // entries are picked at random
+  madvise(data, m_size, MADV_RANDOM);
+
+  std::memcpy(&m_header, m_data, sizeof(m_header));
+  if (std::memcmp(m_header.magic, kMagic, sizeof(kMagic)) != 0 || m_header.version != kVersion) {
+    close();
+    return "file " + aFileName + " is not a pileup bank file of version " + std::to_string(kVersion);
+  }
+
+  // index the entry blocks
+  size_t offset = sizeof(FileHeader);
+  while (offset + sizeof(EntryHeader) <= m_size) {
+    EntryHeader entryHeader;
+    std::memcpy(&entryHeader, m_data + offset, sizeof(entryHeader));
+    if (entryHeader.magic != kEntryMagic || entryHeader.payloadSize > m_size - offset - sizeof(EntryHeader)) {
+      // incomplete last entry, e.g. if the writing job was stopped
+      break;
+    }
+    if (entryHeader.encoding == kDense && entryHeader.payloadSize < m_header.numCells * sizeof(float)) {
+      close();
+      return "file " + aFileName + " has a dense entry with less than " + std::to_string(m_header.numCells) +
+             " cells";
+    }
+    // the cells of the sparse entries are checked once here, so that addTo does not check each index
+    if (entryHeader.encoding != kDense &&
+        (entryHeader.numCells > m_header.numCells || entryHeader.indexBytes > entryHeader.payloadSize ||
+         calo_replay::padded(entryHeader.indexBytes) + uint64_t(entryHeader.numCells) * sizeof(float) >
+             entryHeader.payloadSize ||
+         !validIndices(entryHeader, m_data + offset + sizeof(EntryHeader), m_header.numCells))) {
+      close();
+      return "file " + aFileName + " has a corrupt sparse entry at byte " + std::to_string(offset);
+    }
+    m_entries.push_back(m_data + offset);
+    offset += sizeof(EntryHeader) + entryHeader.payloadSize;
+  }
+  return "";
+}
+
+}  // namespace calo_pileup
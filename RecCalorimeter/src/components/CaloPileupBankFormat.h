@@ -0,0 +1,176 @@
+#ifndef RECCALORIMETER_CALOPILEUPBANKFORMAT_H
+#define RECCALORIMETER_CALOPILEUPBANKFORMAT_H
+
+#include "CaloCellReplayFormat.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/** @file CaloPileupBankFormat.h Reconstruction/RecCalorimeter/src/components/CaloPileupBankFormat.h
+ *
+ *  Binary format of the pileup bank files, used to store the energies of pileup interactions already merged into
+ *  cells, so that the pileup is overlaid on the signal by adding one stored entry to the cells instead of merging the
+ *  hits of all pileup interactions in every event.
+ *
+ *  The cells are addressed by their dense index: the position of the cellID in the sorted list of all cells of the
+ *  geometry tool (see CellIndex). The number of cells and a checksum of the sorted cellIDs are stored in the header,
+ *  so that a bank is only overlaid with the geometry it was written with.
+ *
+ *  Layout (host byte order, all blocks padded to 8 bytes, as the cell replay files, see CaloCellReplayFormat.h):
+ *   - FileHeader: number of cells, checksum of the cellIDs, number of pileup interactions merged in an entry;
+ *   - one block per entry: EntryHeader, followed either (sparse entries) by the indices of the cells with energy,
+ *     delta-coded as varints, and their energies as float32, or (dense entries, if most cells have energy) by the
+ *     energies of all cells as float32, which are added to the signal in one contiguous loop.
+ *  Energies are the deposited (uncalibrated) energies, as the hits.
+ *
+ *  Written by WriteCaloPileupBank, read by OverlayCaloPileupCells.
+ */
+
+namespace calo_pileup {
+
+/// File identifier
+constexpr char kMagic[8] = {'C', 'P', 'I', 'L', 'E', 'U', 'P', '\0'};
+/// Current format version
+constexpr uint32_t kVersion = 1;
+/// Entry block identifier ("PENT")
+constexpr uint32_t kEntryMagic = 0x544e4550;
+
+/// Encoding of an entry
+enum Encoding : uint32_t { kSparse = 0, kDense = 1 };
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t numCells;
+  /// checksum of the sorted cellIDs of the geometry
+  uint64_t cellsChecksum;
+  /// number of pileup interactions merged in an entry
+  uint32_t pileup;
+  uint32_t reserved;
+};
+
+struct EntryHeader {
+  uint32_t magic;
+  uint32_t encoding;
+  /// number of cells with energy
+  uint32_t numCells;
+  uint32_t reserved;
+  /// size in bytes of the blocks following the header
+  uint64_t payloadSize;
+  /// size in bytes of the index block, without padding (sparse entries)
+  uint64_t indexBytes;
+};
+
+/** @class calo_pileup::CellIndex
+ *
+ *  Dense index of the cells of a geometry: the cellIDs sorted in increasing order, and the position of each cellID.
+ */
+class CellIndex {
+public:
+  /// Index returned for cells outside the geometry
+  static constexpr uint32_t npos = static_cast<uint32_t>(-1);
+
+  /// Build the index from the map of all cells of a geometry tool (see ICalorimeterTool::prepareEmptyCells)
+  void build(const std::unordered_map<uint64_t, double>& aCells);
+  /// Number of cells
+  size_t size() const { return m_cellIds.size(); }
+  /// CellID of an index
+  uint64_t cellId(uint32_t aIndex) const { return m_cellIds[aIndex]; }
+  /// Index of a cellID, npos if the cell is not in the geometry
+  uint32_t index(uint64_t aCellId) const {
+    auto it = m_indices.find(aCellId);
+    return it == m_indices.end() ? npos : it->second;
+  }
+  /// Checksum (FNV-1a) of the sorted cellIDs
+  uint64_t checksum() const { return m_checksum; }
+
+private:
+  std::vector<uint64_t> m_cellIds;
+  std::unordered_map<uint64_t, uint32_t> m_indices;
+  uint64_t m_checksum = 0;
+};
+
+/** Append one entry to the buffer.
+ *   @param[in] aEnergies, energies of all cells, indexed by the dense index.
+ *   @param[in] aDenseFraction, the entry is stored dense if more than this fraction of the cells have energy.
+ *   @param[out] aBuffer, buffer to which the entry is appended.
+ *   @return number of cells with energy.
+ */
+uint32_t encodeEntry(const std::vector<float>& aEnergies, double aDenseFraction, std::vector<char>& aBuffer);
+
+/** @class calo_pileup::File
+ *
+ *  Read-only access to a pileup bank file through a memory mapping.
+ *  The positions of the entries are indexed when the file is opened, and their sizes checked; the indices of the cells
+ *  of the sparse entries are decoded once to check that they are inside the bank, so that addTo only writes to
+ *  the header().numCells energies.
+ */
+class File {
+public:
+  File() = default;
+  ~File();
+  File(const File&) = delete;
+  File& operator=(const File&) = delete;
+
+  /** Map the file and index its entries.
+   *   return empty string on success, the error message otherwise.
+   */
+  std::string open(const std::string& aFileName);
+  /// Unmap the file
+  void close();
+
+  /// Number of cells, checksum and pileup of the bank
+  const FileHeader& header() const { return m_header; }
+  /// Number of entries in the file
+  size_t numEntries() const { return m_entries.size(); }
+  /// Size of the mapped file in bytes
+  size_t size() const { return m_size; }
+  /// Size of an entry in bytes, including its header
+  size_t entrySize(size_t aEntry) const {
+    EntryHeader header;
+    std::memcpy(&header, m_entries[aEntry], sizeof(header));
+    return sizeof(EntryHeader) + header.payloadSize;
+  }
+
+  /** Add the energies of an entry to the energies of all cells.
+   *   @param[in] aEntry, index of the entry.
+   *   @param[in,out] aEnergies, energies of all cells (header().numCells), indexed by the dense index.
+   *   @return number of cells with energy in the entry.
+   */
+  uint32_t addTo(size_t aEntry, float* aEnergies) const {
+    EntryHeader header;
+    std::memcpy(&header, m_entries[aEntry], sizeof(header));
+    const char* payload = m_entries[aEntry] + sizeof(EntryHeader);
+    if (header.encoding == kDense) {
+      const float* energies = reinterpret_cast<const float*>(payload);
+      const uint32_t numCells = m_header.numCells;
+      for (uint32_t i = 0; i < numCells; i++) {
+        aEnergies[i] += energies[i];
+      }
+    } else {
+      const float* energies = reinterpret_cast<const float*>(payload + calo_replay::padded(header.indexBytes));
+      const unsigned char* pos = reinterpret_cast<const unsigned char*>(payload);
+      uint64_t index = 0;
+      for (uint32_t i = 0; i < header.numCells; i++) {
+        index += calo_replay::readVarint(pos);
+        aEnergies[index] += energies[i];
+      }
+    }
+    return header.numCells;
+  }
+
+private:
+  const char* m_data = nullptr;
+  size_t m_size = 0;
+  FileHeader m_header;
+  /// Pointers to the entry headers
+  std::vector<const char*> m_entries;
+};
+
+}  // namespace calo_pileup
+
+#endif /* RECCALORIMETER_CALOPILEUPBANKFORMAT_H */
@@ -1,9 +1,9 @@
 #include "CaloTopoCluster.h"
 #include "NoiseCaloCellsFromFileTool.h"
+#include "TopoClusterBuilder.h"
 
 // FCCSW
 #include "DetCommon/DetUtils.h"
-#include "k4Interface/IGeoSvc.h"
 
 // datamodel
 #include "edm4hep/Cluster.h"
@@ -41,15 +41,11 @@ CaloTopoCluster::CaloTopoCluster(const std::string& name, ISvcLocator* svcLoc) :
   declareProperty("positionsHFwdTool", m_cellPositionsHFwdTool, "Handle for tool to retrieve cell positions Had Fwd");
   declareProperty("clusters", m_clusterCollection, "Handle for calo clusters (output collection)");
   declareProperty("clusterCells", m_clusterCellsCollection, "Handle for clusters (output collection)");
+  declareProperty("clusterSummaries", m_clusterSummaries,
+                  "Handle for summaries of clusters below the full evaluation thresholds (output collection)");
 }
 StatusCode CaloTopoCluster::initialize() {
   if (GaudiAlgorithm::initialize().isFailure()) return StatusCode::FAILURE;
-  m_geoSvc = service("GeoSvc");
-  if (!m_geoSvc) {
-    error() << "Unable to locate Geometry Service. "
-            << "Make sure you have GeoSvc and SimSvc in the right order in the configuration." << endmsg;
-    return StatusCode::FAILURE;
-  }
   if (!m_inputTool.retrieve()) {
     error() << "Unable to retrieve the topo cluster input tool!!!" << endmsg;
     return StatusCode::FAILURE;
@@ -79,309 +75,108 @@ StatusCode CaloTopoCluster::initialize() {
 }
 
 StatusCode CaloTopoCluster::execute() {
+  // limits of the work in this event, including the input
+  EventBudget budget(m_maxNeighbourLookups, m_maxClusterCells, m_maxEventTime);
   
   std::map<uint64_t, double> allCells;
-  std::vector<std::pair<uint64_t, double>> firstSeeds;
   
   // get input cell map from input tool
+  StageTimer inputTimer(m_timeInput);
   StatusCode sc_prepareCellMap = m_inputTool->cellIDMap(allCells);
+  inputTimer.stop();
   if (sc_prepareCellMap.isFailure()) {
     error() << "Unable to create cell map!" << endmsg;
     return StatusCode::FAILURE;
   }
   debug() << "Active Cells          :    " << allCells.size() << endmsg;
+  m_numCells += allCells.size();
+  m_memoryCells += MemoryUsage::kiloBytes(MemoryUsage::heapBytes(allCells));
  
   // Create output collections
   auto edmClusters = m_clusterCollection.createAndPut();
   edm4hep::CalorimeterHitCollection* edmClusterCells = new edm4hep::CalorimeterHitCollection();
-
-  // Finds seeds
-  CaloTopoCluster::findingSeeds(allCells, m_seedSigma, firstSeeds);
-  debug() << "Number of seeds found :    " << firstSeeds.size() << endmsg;
-
-  // decending order of seeds
-  std::sort(firstSeeds.begin(), firstSeeds.end(),
-            [](const std::pair<uint64_t, double>& lhs, const std::pair<uint64_t, double>& rhs) {
-              return lhs.second < rhs.second;
-            });
-
-  std::map<uint, std::vector<std::pair<uint64_t, int>>> preClusterCollection;
-  CaloTopoCluster::buildingProtoCluster(m_neighbourSigma, m_lastNeighbourSigma, firstSeeds, allCells,
-                                        preClusterCollection);
+  auto edmClusterSummaries = m_clusterSummaries.createAndPut();
+
+  // once the event is over budget, the clusters grow only with cells above this threshold
+  int budgetNumSigma = m_budgetNeighbourSigma >= 0 ? int(m_budgetNeighbourSigma) : int(m_seedSigma);
+  TopoClusterBuilder builder(allCells, &(*m_neighboursTool), &(*m_noiseTool),
+                             {{int(m_seedSigma), int(m_neighbourSigma), int(m_lastNeighbourSigma), budgetNumSigma}});
+
+  // Finds seeds, sorted by energy
+  StageTimer seedsTimer(m_timeSeeds);
+  builder.findingSeeds();
+  seedsTimer.stop();
+  debug() << "Number of seeds found :    " << builder.stats(0).seeds << endmsg;
+  m_numSeeds += builder.stats(0).seeds;
+
+  std::vector<TopoClusterBuilder::PreClusterCollection> preClusterCollections;
+  StageTimer protoClustersTimer(m_timeProtoClusters);
+  bool protoClustersComplete = builder.buildingProtoClusters(preClusterCollections, {&budget});
+  protoClustersTimer.stop();
+  if (!protoClustersComplete) {
+    error() << "Building of cluster is stopped due to missing id in neighbours map." << endmsg;
+    error() << "No neighbours for cellID found: " << builder.missingNeighboursCell() << ", in system "
+            << m_decoder->get(builder.missingNeighboursCell(), "system") << endmsg;
+  }
+  const auto& preClusterCollection = preClusterCollections[0];
+  m_numNeighbourLookups += builder.stats(0).lookups;
+  m_numMerges += builder.stats(0).merges;
+  m_memoryProtoClusters += MemoryUsage::kiloBytes(builder.stats(0).memoryBytes);
+  m_budgetCounters += budget;
+  if (budget.exceeded() != EventBudget::kNone) {
+    warning() << "Event over budget (" << budget.exceededNames() << " ) after " << budget.lookups()
+              << " neighbour lookups, clusters built with reduced growth" << endmsg;
+  }
+  StageTimer outputTimer(m_timeOutput);
   // Build Clusters in edm
   debug() << "Building " << preClusterCollection.size() << " cluster." << endmsg;
-  double checkTotEnergy = 0.;
-  int clusterWithMixedCells = 0;
-  for (auto i : preClusterCollection) {
-    edm4hep::MutableCluster cluster;
-    //auto& clusterCore = cluster.core();
-    double posX = 0.;
-    double posY = 0.;
-    double posZ = 0.;
-    double energy = 0.;
-    double deltaR = 0.;
-    std::vector<double> posPhi (i.second.size());
-    std::vector<double> posEta (i.second.size());
-    std::vector<double> vecEnergy (i.second.size());
-    double sumPhi = 0.;
-    double sumEta = 0.;
-    std::map<int,int> system;
-
-    for (auto pair : i.second) {
-      dd4hep::DDSegmentation::CellID cID = pair.first;
-	//      auto cellID = pair.first;
-      // get CalorimeterHit by cellID
-      auto newCell = edmClusterCells->create();
-      newCell.setEnergy(allCells[cID]);
-      newCell.setCellID(cID);
-      newCell.setType(pair.second);
-      energy += newCell.getEnergy();
-
-      // get cell position by cellID
-      // identify calo system
-      auto systemId = m_decoder->get(cID, "system");
-      system[int(systemId)]++;
-      dd4hep::Position posCell;
-      if (systemId == 5)  // ECAL BARREL system id
-        posCell = m_cellPositionsECalBarrelTool->xyzPosition(cID);
-      else if (systemId == 8){  // HCAL BARREL system id
-	if (m_noSegmentationHCalUsed)
-	  posCell = m_cellPositionsHCalBarrelNoSegTool->xyzPosition(cID);
-	else{
-	  posCell = m_cellPositionsHCalBarrelTool->xyzPosition(cID);
-	}}
-      else if (systemId == 9)  // HCAL EXT BARREL system id
-        posCell = m_cellPositionsHCalExtBarrelTool->xyzPosition(cID);
-      else if (systemId == 6)  // EMEC system id
-        posCell = m_cellPositionsEMECTool->xyzPosition(cID);
-      else if (systemId == 7)  // HEC system id
-        posCell = m_cellPositionsHECTool->xyzPosition(cID);
-      else if (systemId == 10)  // EMFWD system id
-        posCell = m_cellPositionsEMFwdTool->xyzPosition(cID);
-      else if (systemId == 11)  // HFWD system id
-        posCell = m_cellPositionsHFwdTool->xyzPosition(cID);
-      else
-        warning() << "No cell positions tool found for system id " << systemId << ". " << endmsg;
-
-      posX += posCell.X() * newCell.getEnergy();
-      posY += posCell.Y() * newCell.getEnergy();
-      posZ += posCell.Z() * newCell.getEnergy();
-      posPhi.push_back(posCell.Phi());
-      posEta.push_back(posCell.Eta());
-      vecEnergy.push_back(newCell.getEnergy());
-      sumPhi += posCell.Phi() * newCell.getEnergy();
-      sumEta += posCell.Eta() * newCell.getEnergy();
-      
-      cluster.addToHits(newCell);
-      auto er = allCells.erase(cID);
-      
-      if (er!=1)
-	info() << "Problem in erasing cell ID from map." << endmsg;
-    }
-    cluster.setEnergy(energy);
-    cluster.setPosition(edm4hep::Vector3f(posX / energy, posY / energy, posZ / energy));
-    // store deltaR of cluster in time for the moment..
-    sumPhi = sumPhi / energy;
-    sumEta = sumEta / energy;
-    int counter = 0;
-    for (auto entryEta : posEta){
-      deltaR += sqrt(pow(entryEta-sumEta,2) + pow(posEta[counter]-sumPhi,2)) * vecEnergy[counter];
-      counter++;
-    }
-    cluster.addToShapeParameters(deltaR / energy);
-    verbose() << "Cluster energy:     " << cluster.getEnergy() << endmsg;
-    checkTotEnergy += cluster.getEnergy();
-
-    edmClusters->push_back(cluster);
-    if (system.size() > 1)
-      clusterWithMixedCells++;
-
-    posPhi.clear();
-    posEta.clear();
-    vecEnergy.clear();
-
+  double checkTotEnergy =
+      builder.writeClusters(preClusterCollection, [this](uint64_t aCellId) { return cellPosition(aCellId); },
+                            m_minEnergyFullCluster, m_minCellsFullCluster, *edmClusters, *edmClusterCells,
+                            *edmClusterSummaries);
+  size_t clusteredCells = 0;
+  for (const auto& i : preClusterCollection) {
+    clusteredCells += i.second.size();
   }
 
   m_clusterCellsCollection.put(edmClusterCells);
-  debug() << "Number of clusters with cells in E and HCal:        " << clusterWithMixedCells << endmsg;
+  outputTimer.stop();
+  m_numClusters += edmClusters->size() + edmClusterSummaries->size();
+  debug() << "Number of clusters stored as summaries:             " << edmClusterSummaries->size() << endmsg;
   debug() << "Total energy of clusters:                           " << checkTotEnergy << endmsg;
-  debug() << "Leftover cells :                                    " << allCells.size() << endmsg;
+  debug() << "Leftover cells :                                    " << allCells.size() - clusteredCells << endmsg;
   return StatusCode::SUCCESS;
 }
 
-void CaloTopoCluster::findingSeeds(const std::map<uint64_t, double>& aCells,
-                                   int aNumSigma,
-                                   std::vector<std::pair<uint64_t, double>>& aSeeds) {
-  for (const auto& cell : aCells) {
-    // retrieve the noise const and offset assigned to cell
-    double threshold = m_noiseTool->noiseOffset(cell.first) + ( m_noiseTool->noiseRMS(cell.first) * aNumSigma);
-    if (msgLevel() <= MSG::VERBOSE){
-      verbose() << "noise offset    = " << m_noiseTool->noiseOffset(cell.first) << "GeV " << endmsg;
-      verbose() << "noise rms       = " << m_noiseTool->noiseRMS(cell.first) << "GeV " << endmsg;
-      verbose() << "seed threshold  = " << threshold << "GeV " << endmsg;
-    }
-    if (abs(cell.second) > threshold) {
-      aSeeds.emplace_back(cell.first, cell.second);
-    }
-  }
+dd4hep::Position CaloTopoCluster::cellPosition(uint64_t aCellId) {
+  dd4hep::DDSegmentation::CellID cID = aCellId;
+  auto systemId = m_decoder->get(cID, "system");
+  dd4hep::Position posCell;
+  if (systemId == 5)  // ECAL BARREL system id
+    posCell = m_cellPositionsECalBarrelTool->xyzPosition(cID);
+  else if (systemId == 8){  // HCAL BARREL system id
+    if (m_noSegmentationHCalUsed)
+      posCell = m_cellPositionsHCalBarrelNoSegTool->xyzPosition(cID);
+    else{
+      posCell = m_cellPositionsHCalBarrelTool->xyzPosition(cID);
+    }}
+  else if (systemId == 9)  // HCAL EXT BARREL system id
+    posCell = m_cellPositionsHCalExtBarrelTool->xyzPosition(cID);
+  else if (systemId == 6)  // EMEC system id
+    posCell = m_cellPositionsEMECTool->xyzPosition(cID);
+  else if (systemId == 7)  // HEC system id
+    posCell = m_cellPositionsHECTool->xyzPosition(cID);
+  else if (systemId == 10)  // EMFWD system id
+    posCell = m_cellPositionsEMFwdTool->xyzPosition(cID);
+  else if (systemId == 11)  // HFWD system id
+    posCell = m_cellPositionsHFwdTool->xyzPosition(cID);
+  else
+    warning() << "No cell positions tool found for system id " << systemId << ". " << endmsg;
+  return posCell;
 }
 
-StatusCode CaloTopoCluster::buildingProtoCluster(
-    int aNumSigma,
-    int aLastNumSigma,
-    std::vector<std::pair<uint64_t, double>>& aSeeds,
-    const std::map<uint64_t, double>& aCells,
-    std::map<uint, std::vector< std::pair<uint64_t, int>>>& aPreClusterCollection) {
-  // Map of cellIDs to clusterIds
-  std::map<uint64_t, uint> clusterOfCell;
-
-  // Loop over every seed in Calo to create first cluster
-  uint iSeeds = 0;
-  verbose() << "seeds to loop over : " << aSeeds.size() << endmsg;
-  for (auto& itSeed : aSeeds) {
-    iSeeds++;
-    verbose() << "Seed num: " << iSeeds << endmsg;
-    auto seedId = itSeed.first;
-    auto cellInCluster = clusterOfCell.find(seedId);
-    if (cellInCluster != clusterOfCell.end()) {
-      verbose() << "Seed is already assigned to another cluster!" << endmsg;
-      continue;
-    } else {
-      // new cluster starts with seed
-      // set cell Bits to 1 for seed cell
-      aPreClusterCollection[iSeeds].push_back(std::make_pair(seedId, 1));
-      uint clusterId = iSeeds;
-      clusterOfCell[seedId] = clusterId;
-
-      std::vector<std::vector<std::pair<uint64_t, uint>>> vecNextNeighbours(100000);
-      vecNextNeighbours[0] = CaloTopoCluster::searchForNeighbours(seedId, clusterId, aNumSigma, aCells, clusterOfCell,
-                                                     aPreClusterCollection, true);
-      // first loop over seeds neighbours
-      verbose() << "Found " << vecNextNeighbours[0].size() << " neighbours.." << endmsg;
-      int it = 0;
-      while (vecNextNeighbours[it].size() > 0) {
-        it++;
-        for (auto& id : vecNextNeighbours[it - 1]) {
-	  if (id.first == 0){
-	    error() << "Building of cluster is stopped due to missing id in neighbours map." << endmsg;
-	    return StatusCode::FAILURE;
-	  }
-          verbose() << "Next neighbours assigned to clusterId : " << clusterId << endmsg;
-          auto vec = CaloTopoCluster::searchForNeighbours(id.first, clusterId, aNumSigma, aCells, clusterOfCell,
-								       aPreClusterCollection, true);
-	  vecNextNeighbours[it].insert(vecNextNeighbours[it].end(), vec.begin(), vec.end());
-	}
-        verbose() << "Found " << vecNextNeighbours[it].size() << " more neighbours.." << endmsg;
-      }
-      // last try with different condition on neighbours
-      if (vecNextNeighbours[it].size() == 0) {
-	auto clusteredCells = aPreClusterCollection[clusterId];
-	// loop over all clustered cells
-	for (auto& id : clusteredCells) {
-	  if (id.second <= 2){
-	    verbose() << "Add neighbours of " << id.first << " in last round with thr = " << aLastNumSigma << " x sigma." << endmsg;
-	    auto lastNeighours = CaloTopoCluster::searchForNeighbours(id.first, clusterId, aLastNumSigma, aCells, clusterOfCell,
-								      aPreClusterCollection, false);
-	  }
-	}
-      }
-    }
-  }
-  return StatusCode::SUCCESS;
+StatusCode CaloTopoCluster::finalize() {
+  info() << "Peak memory of the cells map: " << m_memoryCells.max() << " kB, of the proto-clusters: "
+         << m_memoryProtoClusters.max() << " kB" << endmsg;
+  return GaudiAlgorithm::finalize();
 }
-
-std::vector<std::pair<uint64_t, uint> >
-CaloTopoCluster::searchForNeighbours(const uint64_t aCellId,
-                                     uint& aClusterID,
-                                     int aNumSigma,
-                                     const std::map<uint64_t, double>& aCells,
-                                     std::map<uint64_t, uint>& aClusterOfCell,
-                                     std::map<uint, std::vector<std::pair<uint64_t, int>>>& aPreClusterCollection,
-				     bool aAllowClusterMerge) {
-  // Fill vector to be returned, next cell ids and cluster id for which neighbours are found
-  std::vector<std::pair<uint64_t, uint>> addedNeighbourIds;
-  // Retrieve cellIDs of neighbours
-  auto neighboursVec = m_neighboursTool->neighbours(aCellId);
-  if (neighboursVec.size() == 0) {
-    error() << "No neighbours for cellID found! " << endmsg;
-    error() << "to cellID :  " << aCellId << endmsg;
-    error() << "in system:   " << m_decoder->get(aCellId, "system") << endmsg;
-    addedNeighbourIds.resize(0);
-    addedNeighbourIds.push_back(std::make_pair(0, 0));
-  } else {
-
-    verbose() << "For cluster: " << aClusterID << endmsg;
-    // loop over neighbours
-    for (auto& itr : neighboursVec) {
-      auto neighbourID = itr;
-      // Find the neighbour in the Calo cells list
-      auto itAllCells = aCells.find(neighbourID);
-      auto itAllUsedCells = aClusterOfCell.find(neighbourID);
-
-      // If cell is hit.. and is not assigned to a cluster
-      if (itAllCells != aCells.end() && itAllUsedCells == aClusterOfCell.end()) {
-        verbose() << "Found neighbour with CellID: " << neighbourID << endmsg;
-        auto neighbouringCellEnergy = itAllCells->second;
-        bool addNeighbour = false;
-	int cellType = 2;
-	// retrieve the cell noise level [GeV]
-        double thr = m_noiseTool->noiseOffset(neighbourID) + (aNumSigma * m_noiseTool->noiseRMS(neighbourID));
-	if (abs(neighbouringCellEnergy) > thr)
-	  addNeighbour = true;
-	else
-	  addNeighbour = false;
-	// give cell type according to threshold
-	if (aNumSigma == m_lastNeighbourSigma){
-	  cellType = 3;
-	}
-	// if threshold is 0, collect the cell independent on its energy
-	if (aNumSigma == 0){
-	  addNeighbour = true;
-	}
-        // if neighbour is validated
-        if (addNeighbour) {
-          // retrieve the cell
-          // add neighbour to cells for cluster
-          aPreClusterCollection[aClusterID].push_back(std::make_pair(neighbourID, cellType));
-          aClusterOfCell[neighbourID] = aClusterID;
-          addedNeighbourIds.push_back(std::make_pair(neighbourID, aClusterID));
-        }
-      }
-      // If cell is hit.. but is assigned to another cluster
-      else if (itAllUsedCells != aClusterOfCell.end() && itAllUsedCells->second != aClusterID && aAllowClusterMerge) {
-        uint clusterIDToMerge = itAllUsedCells->second;
-	if (msgLevel() <= MSG::VERBOSE){
-	  verbose() << "This neighbour was found in cluster " << clusterIDToMerge << ", cluster " << aClusterID
-		    << " will be merged!" << endmsg;
-	  verbose() << "Assigning all cells ( " << aPreClusterCollection.find(aClusterID)->second.size() << " ) to Cluster "
-		    << clusterIDToMerge << " with ( " << aPreClusterCollection.find(clusterIDToMerge)->second.size()
-		    << " ). " << endmsg;
-	}
-        // Fill all cells into cluster, and assigned cells to new cluster
-        aClusterOfCell[neighbourID] = clusterIDToMerge;
-        for (auto& i : aPreClusterCollection.find(aClusterID)->second) {
-          aClusterOfCell[i.first] = clusterIDToMerge;
-          bool found = false;
-          // make sure that already assigned cells are not added
-          for (auto& j : aPreClusterCollection[clusterIDToMerge]) {
-            if (j.first == i.first) found = true;
-          }
-          if (!found) {
-            aPreClusterCollection[clusterIDToMerge].push_back(std::make_pair(i.first, i.second));
-          }
-        }
-        aPreClusterCollection.erase(aClusterID);
-        // changed clusterId -> if more neighbours are found, correct assignment
-        verbose() << "Cluster Id changed to " << clusterIDToMerge << endmsg;
-        aClusterID = clusterIDToMerge;
-        // found neighbour for next search
-        addedNeighbourIds.push_back(std::make_pair(neighbourID, aClusterID));
-        // end loop to ensure correct cluster assignment
-        break;
-      }
-    }
-  }
-  return std::move(addedNeighbourIds);
-}
-
-StatusCode CaloTopoCluster::finalize() { return GaudiAlgorithm::finalize(); }
@@ -13,7 +13,9 @@
 #include "k4Interface/ICellPositionsTool.h"
 #include "k4Interface/ITopoClusterInputTool.h"
 
-class IGeoSvc;
+#include "EventBudget.h"
+#include "MemoryUsage.h"
+#include "StageTimer.h"
 
 // datamodel
 namespace edm4hep {
@@ -39,6 +41,17 @@ class Segmentation;
  *  4. The found and added neighbours function as next seeds and their neighbours are added until no more cells exceed the threshold.
  *  5. In the last step the neighbours that did not exceed the threshold the first time are tested on "lastNeighbourSigma".
  *  In case that a neighbour is found that has already been assigned to another cluster, both clusters are merged and assigned to the "older" clusterID, this is the one originating from a higher seed energy. The iteration over neighburing cellIDs is continued.
+ *  6. The energy and number of cells of each proto-cluster are summed first. Only clusters passing "minEnergyFullCluster" or
+ *  "minCellsFullCluster" get their position, shape and cells computed, the others are written as summaries
+ *  (energy, seed position, number of cells) to "clusterSummaries". Both thresholds are disabled by default.
+ *  The time of each stage (input, seed finding, proto-cluster building with merging, output) and the number of cells,
+ *  seeds, neighbour lookups, cluster merges and clusters per event are recorded in counters printed at finalize.
+ *  7. Optional per-event budget (see EventBudget.h), disabled by default: "maxNeighbourLookups", "maxClusterCells" and
+ *  "maxEventTime". Once the lookups or the time of an event exceed their limit, the neighbour threshold is raised to
+ *  "budgetNeighbourSigma" and the last round with "lastNeighbourSigma" is skipped for the rest of the event; a cluster
+ *  reaching "maxClusterCells" stops growing. The events over budget are counted in "Events over budget".
+ *  The seeds and proto-clusters are built by TopoClusterBuilder, shared with CaloTopoClusterMultiThreshold and
+ *  CreateCaloTopoClustersFromHits.
  *  @author Coralie Neubueser
  */
 
@@ -48,57 +61,23 @@ public:
 
   StatusCode initialize();
 
-  /**  Find cells with a signal to noise ratio > nSigma.
-   *   @param[in] aCells, parse the map of all cells.
-   *   @param[in] aNumSigma, the signal to noise ratio that the cell has to exceed to become seed.
-   *   @param[in] aSeeds, the vector of seed cell ids anf their energy to build proto-clusters.
-   */
-  virtual void findingSeeds(const std::map<uint64_t, double>& aCells, int aNumSigma,
-                            std::vector<std::pair<uint64_t, double>>& aSeeds);
-
-  /** Building proto-clusters from the found seeds.
-   * First the function initialises a cluster in the preClusterCollection for the seed cells,
-   * then it calls the CaloTopoCluster::searchForNeighbours function to retrieve the vector of next cellIDs to add and loop over to find neighbours.
-   * The iteration of search for neighbours is continued until no more neihgbours are found. Then a last round of adding neighbouring cells to the cluster is run where the parameter lastNeighbourSigma is applied.
-   *   @param[in] aNumSigma, signal to noise ratio the neighbouring cell has to pass to be added to cluster.
-   *   @param[in] aSeeds, vector of seeding cells.
-   *   @param[in] aCells, map of all cells.
-   *   @param[in] aPreClusterCollection, map that is filled with clusterID pointing to the associated cells, in a pair of cellID and cellType.
-   */
-  StatusCode buildingProtoCluster(int aNumSigma,
-                                    int aLastNumSigma,
-                                    std::vector<std::pair<uint64_t, double>>& aSeeds,
-                                    const std::map<uint64_t, double>& aCells,
-                                    std::map<uint, std::vector<std::pair<uint64_t, int>>>& aPreClusterCollection);
-
-  /** Search for neighbours and add them to preClusterCollection
-   * The 
-   *   @param[in] aCellId, the cell ID for which to find the neighbours.
-   *   @param[in] aClusterID, the current cluster ID.
-   *   @param[in] aNumSigma, the signal/noise ratio to be exceeded by the neighbouring cell to be added to cluster.
-   *   @param[in] aCells, map of all cells.
-   *   @param[in] aClusterOfCell, map of cellID to clusterID.
-   *   @param[in] aPreClusterCollection, map that is filled with clusterID pointing to the associated cells, in a pair of cellID and cellType.
-   *   @param[in] aAllowClusterMerge, bool to allow for clusters to be merged, set to false in case of last iteration in CaloTopoCluster::buildingProtoCluster.
-   *   return vector of pairs with cellID and energy of found neighbours.
-   */
-  std::vector<std::pair<uint64_t, uint>>
-  searchForNeighbours(const uint64_t aCellId, uint& aClusterID, int aNumSigma, const std::map<uint64_t, double>& aCells,
-                      std::map<uint64_t, uint>& aClusterOfCell,
-                      std::map<uint, std::vector<std::pair<uint64_t, int>>>& aPreClusterCollection,
-		      bool aAllowClusterMerge);
-
   StatusCode execute();
 
   StatusCode finalize();
 
 private:
+  /** Position of a cell, retrieved from the positions tool of its calorimeter system.
+   *   @param[in] aCellId, the cell ID.
+   *   return position of the cell, (0,0,0) if no tool is defined for the system.
+   */
+  dd4hep::Position cellPosition(uint64_t aCellId);
+
   // Cluster collection
   DataHandle<edm4hep::ClusterCollection> m_clusterCollection{"calo/clusters", Gaudi::DataHandle::Writer, this};
   // Cluster cells in collection
   DataHandle<edm4hep::CalorimeterHitCollection> m_clusterCellsCollection{"calo/clusterCells", Gaudi::DataHandle::Writer, this};
-  /// Pointer to the geometry service
-  SmartIF<IGeoSvc> m_geoSvc;
+  // Summaries of the clusters below the thresholds for full evaluation
+  DataHandle<edm4hep::ClusterCollection> m_clusterSummaries{"calo/clusterSummaries", Gaudi::DataHandle::Writer, this};
   /// Handle for the input tool
   ToolHandle<ITopoClusterInputTool> m_inputTool{"TopoClusterInput", this};
   /// Handle for the cells noise tool
@@ -130,6 +109,47 @@ private:
   Gaudi::Property<int> m_neighbourSigma{this, "neighbourSigma", 2, "number of sigma in noise threshold"};
   /// Last neighbour threshold in sigma
   Gaudi::Property<int> m_lastNeighbourSigma{this, "lastNeighbourSigma", 0, "number of sigma in noise threshold"};
+  /// Energy threshold above which the cluster position, shape and cells are evaluated (disabled if <= 0)
+  Gaudi::Property<double> m_minEnergyFullCluster{this, "minEnergyFullCluster", 0.,
+                                                  "cluster energy [GeV] for full evaluation, <= 0 to disable"};
+  /// Cell-count threshold above which the cluster position, shape and cells are evaluated (disabled if <= 0)
+  Gaudi::Property<int> m_minCellsFullCluster{this, "minCellsFullCluster", 0,
+                                             "number of cells for full evaluation, <= 0 to disable"};
+  /// Maximal number of neighbour lookups per event (disabled if <= 0)
+  Gaudi::Property<long> m_maxNeighbourLookups{this, "maxNeighbourLookups", 0,
+                                              "maximal number of neighbour lookups per event, <= 0 to disable"};
+  /// Maximal number of cells of a cluster (disabled if <= 0)
+  Gaudi::Property<long> m_maxClusterCells{this, "maxClusterCells", 0,
+                                          "maximal number of cells of a cluster, <= 0 to disable"};
+  /// Maximal time per event (disabled if <= 0)
+  Gaudi::Property<double> m_maxEventTime{this, "maxEventTime", 0., "maximal time [ms] per event, <= 0 to disable"};
+  /// Neighbour threshold in sigma for the rest of an event over budget
+  Gaudi::Property<int> m_budgetNeighbourSigma{this, "budgetNeighbourSigma", -1,
+                                              "neighbour threshold of an event over budget, seedSigma if < 0"};
+  /// Events over budget
+  EventBudget::Counters m_budgetCounters{this};
+  /// Time to retrieve the input cells
+  StageTimer::Counter m_timeInput{this, "Time input [us]"};
+  /// Time to find and sort the seeds
+  StageTimer::Counter m_timeSeeds{this, "Time seeds [us]"};
+  /// Time to build the proto-clusters, including cluster merging
+  StageTimer::Counter m_timeProtoClusters{this, "Time proto-clusters [us]"};
+  /// Time to create the output clusters
+  StageTimer::Counter m_timeOutput{this, "Time output [us]"};
+  /// Number of input cells per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numCells{this, "Cells"};
+  /// Number of seeds per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numSeeds{this, "Seeds"};
+  /// Number of neighbour lookups per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numNeighbourLookups{this, "Neighbour lookups"};
+  /// Number of cluster merges per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numMerges{this, "Cluster merges"};
+  /// Number of clusters per event (full clusters and summaries)
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numClusters{this, "Clusters"};
+  /// Estimated memory of the map of input cells per event
+  MemoryUsage::Counter m_memoryCells{this, "Memory cells map [kB]"};
+  /// Estimated memory of the proto-clusters per event: cluster of each cell, proto-clusters and next neighbours
+  MemoryUsage::Counter m_memoryProtoClusters{this, "Memory proto-clusters [kB]"};
   /// General decoder to encode the calorimeter sub-system to determine which positions tool to use
   dd4hep::DDSegmentation::BitFieldCoder* m_decoder = new dd4hep::DDSegmentation::BitFieldCoder("system:4");
 
@@ -1,8 +1,5 @@
 #include "CaloTopoClusterInputTool.h"
 
-// FCCSW
-#include "k4Interface/IGeoSvc.h"
-
 // datamodel
 #include "edm4hep/CalorimeterHit.h"
 #include "edm4hep/CalorimeterHitCollection.h"
@@ -11,6 +8,10 @@
 #include "DD4hep/Detector.h"
 #include "DD4hep/Readout.h"
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
 DECLARE_COMPONENT(CaloTopoClusterInputTool)
 
 CaloTopoClusterInputTool::CaloTopoClusterInputTool(const std::string& type, const std::string& name, const IInterface* parent)
@@ -29,13 +30,6 @@ StatusCode CaloTopoClusterInputTool::initialize() {
   if (GaudiTool::initialize().isFailure()) {
     return StatusCode::FAILURE;
   }
-  m_geoSvc = service("GeoSvc");
-  if (!m_geoSvc) {
-    error() << "Unable to locate Geometry Service. "
-            << "Make sure you have GeoSvc and SimSvc in the right order in the configuration." << endmsg;
-    return StatusCode::FAILURE;
-  }
-  
   return StatusCode::SUCCESS;
 }
 
@@ -43,72 +37,57 @@ StatusCode CaloTopoClusterInputTool::finalize() { return GaudiTool::finalize();
 
 StatusCode CaloTopoClusterInputTool::cellIDMap(std::map<uint64_t, double>& aCells) {
   aCells.clear();
-  uint totalNumberOfCells = 0;
 
-  // 1. ECAL barrel
-  // Get the input collection with calorimeter cells
-  const edm4hep::CalorimeterHitCollection* ecalBarrelCells = m_ecalBarrelCells.get();
-  debug() << "Input Ecal barrel cell collection size: " << ecalBarrelCells->size() << endmsg;
-  // Loop over a collection of calorimeter cells and build calo towers
-  for (const auto& iCell : *ecalBarrelCells) {
-    aCells.emplace(iCell.getCellID(), iCell.getEnergy());
-  }
-  totalNumberOfCells += ecalBarrelCells->size();
-  
-  // 2. ECAL endcap calorimeter
-  const edm4hep::CalorimeterHitCollection* ecalEndcapCells = m_ecalEndcapCells.get();
-  debug() << "Input Ecal endcap cell collection size: " << ecalEndcapCells->size() << endmsg;
-  // Loop over a collection of calorimeter cells and build calo towers
-  for (const auto& iCell : *ecalEndcapCells) {
-    aCells.emplace(iCell.getCellID(), iCell.getEnergy());
-  }
-  totalNumberOfCells += ecalEndcapCells->size();
-    
-  // 3. ECAL forward calorimeter
-  const edm4hep::CalorimeterHitCollection* ecalFwdCells = m_ecalFwdCells.get();
-  debug() << "Input Ecal forward cell collection size: " << ecalFwdCells->size() << endmsg;
-  // Loop over a collection of calorimeter cells and build calo towers
-  for (const auto& iCell : *ecalFwdCells) {
-    aCells.emplace(iCell.getCellID(), iCell.getEnergy());
-  }
-  totalNumberOfCells += ecalFwdCells->size();
-  
-  // 4. HCAL barrel
-  const edm4hep::CalorimeterHitCollection* hcalBarrelCells = m_hcalBarrelCells.get();
-  debug() << "Input hadronic barrel cell collection size: " << hcalBarrelCells->size() << endmsg;
-  // Loop over a collection of calorimeter cells and build calo towers
-  for (const auto& iCell : *hcalBarrelCells) {
-    aCells.emplace(iCell.getCellID(), iCell.getEnergy());
-  }
-  totalNumberOfCells += hcalBarrelCells->size();
-  
-  // 5. HCAL extended barrel
-  const edm4hep::CalorimeterHitCollection* hcalExtBarrelCells = m_hcalExtBarrelCells.get();
-  debug() << "Input hadronic extended barrel cell collection size: " << hcalExtBarrelCells->size() << endmsg;
-  // Loop over a collection of calorimeter cells and build calo towers
-  for (const auto& iCell : *hcalExtBarrelCells) {
-    aCells.emplace(iCell.getCellID(), iCell.getEnergy());
-  }
-  totalNumberOfCells += hcalExtBarrelCells->size();
-  
-  // 6. HCAL endcap calorimeter                                                                                                              
-  const edm4hep::CalorimeterHitCollection* hcalEndcapCells = m_hcalEndcapCells.get();
-  debug() << "Input Hcal endcap cell collection size: " << hcalEndcapCells->size() << endmsg;
-  // Loop over a collection of calorimeter cells and build calo towers
-  for (const auto& iCell : *hcalEndcapCells) {
-    aCells.emplace(iCell.getCellID(), iCell.getEnergy());
+  // ECAL barrel, endcap and forward, HCAL barrel, extended barrel, endcap and forward
+  const std::array<DataHandle<edm4hep::CalorimeterHitCollection>*, 7> handles = {
+      &m_ecalBarrelCells, &m_ecalEndcapCells, &m_ecalFwdCells, &m_hcalBarrelCells,
+      &m_hcalExtBarrelCells, &m_hcalEndcapCells, &m_hcalFwdCells};
+  std::array<const edm4hep::CalorimeterHitCollection*, 7> collections;
+  uint totalNumberOfCells = 0;
+  // whether the cells of all collections, one after the other, are ordered by cellID
+  bool ordered = true;
+  bool firstCell = true;
+  uint64_t previousCellId = 0;
+  for (size_t i = 0; i < handles.size(); i++) {
+    collections[i] = handles[i]->get();
+    debug() << "Input " << handles[i]->objKey() << " cell collection size: " << collections[i]->size() << endmsg;
+    totalNumberOfCells += collections[i]->size();
+    for (auto iCell = collections[i]->begin(); ordered && iCell != collections[i]->end(); ++iCell) {
+      ordered = firstCell || (*iCell).getCellID() > previousCellId;
+      previousCellId = (*iCell).getCellID();
+      firstCell = false;
+    }
   }
-  totalNumberOfCells += hcalEndcapCells->size();
-  
-  // 7. HCAL forward calorimeter
-  const edm4hep::CalorimeterHitCollection* hcalFwdCells = m_hcalFwdCells.get();
-  debug() << "Input Hcal forward cell collection size: " << hcalFwdCells->size() << endmsg;
-  // Loop over a collection of calorimeter cells and build calo towers
-  for (const auto& iCell : *hcalFwdCells) {
-    aCells.emplace(iCell.getCellID(), iCell.getEnergy());
+
+  // the cells are inserted at the end of the map, the insertion position is the one after the previous cell
+  auto insertOrdered = [&aCells](uint64_t aCellId, double aEnergy, std::map<uint64_t, double>::iterator& aHint) {
+    aHint = aCells.emplace_hint(aHint, aCellId, aEnergy);
+    ++aHint;
+  };
+  auto hint = aCells.end();
+  if (ordered) {
+    // no copy of the cells
+    for (auto cells : collections) {
+      for (const auto& iCell : *cells) {
+        insertOrdered(iCell.getCellID(), iCell.getEnergy(), hint);
+      }
+    }
+  } else {
+    // the cells are copied into one buffer and sorted first, which is faster than inserting them in random order
+    typedef std::pair<uint64_t, double> Cell;
+    std::vector<Cell> cells;
+    cells.reserve(totalNumberOfCells);
+    for (auto collection : collections) {
+      for (const auto& iCell : *collection) {
+        cells.emplace_back(iCell.getCellID(), iCell.getEnergy());
+      }
+    }
+    std::sort(cells.begin(), cells.end(), [](const Cell& lhs, const Cell& rhs) { return lhs.first < rhs.first; });
+    for (const auto& cell : cells) {
+      insertOrdered(cell.first, cell.second, hint);
+    }
   }
-  totalNumberOfCells += hcalFwdCells->size();
-  
+
   if (totalNumberOfCells != aCells.size()){
     error() << "Map size != total number of cells! " << endmsg;
     return StatusCode::FAILURE;
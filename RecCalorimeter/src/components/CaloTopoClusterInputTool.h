@@ -7,8 +7,6 @@
 #include "k4FWCore/DataHandle.h"
 #include "k4Interface/ITopoClusterInputTool.h"
 
-class IGeoSvc;
-
 // datamodel
 namespace edm4hep {
   class CalorimeterHit;
@@ -29,6 +27,11 @@ class Segmentation;
  * forward calorimeters). If not all systems are available or not wanted to be used, create an empty collection using
  * CreateDummyCellsCollection algorithm.
  *
+ *  The map is built by inserting the cells at its end, so that no search in the map is needed. If the cells of the
+ *  collections are ordered by cellID, they are inserted directly; otherwise (e.g. cells created from a hash map) they
+ *  are first copied into one buffer of (cellID, energy) and sorted, which is faster than inserting them in random
+ *  order. The time of the map building is recorded by the "Time input" counter of CaloTopoCluster.
+ *
  *  @author Coralie Neubueser
  */
 
@@ -68,8 +71,6 @@ private:
   DataHandle<edm4hep::CalorimeterHitCollection> m_hcalEndcapCells{"hcalEndcapCells", Gaudi::DataHandle::Reader, this};
   /// Handle for hcal forward calorimeter cells (input collection)
   DataHandle<edm4hep::CalorimeterHitCollection> m_hcalFwdCells{"hcalFwdCells", Gaudi::DataHandle::Reader, this};
-  /// Pointer to the geometry service
-  SmartIF<IGeoSvc> m_geoSvc;
   /// Name of the electromagnetic barrel readout
   Gaudi::Property<std::string> m_ecalBarrelReadoutName{this, "ecalBarrelReadoutName", "",
                                                        "name of the ecal barrel readout"};
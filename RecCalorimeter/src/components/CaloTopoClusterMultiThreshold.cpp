@@ -0,0 +1,177 @@
+#include "CaloTopoClusterMultiThreshold.h"
+
+// datamodel
+#include "edm4hep/CalorimeterHit.h"
+#include "edm4hep/CalorimeterHitCollection.h"
+#include "edm4hep/Cluster.h"
+#include "edm4hep/ClusterCollection.h"
+
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+DECLARE_COMPONENT(CaloTopoClusterMultiThreshold)
+
+CaloTopoClusterMultiThreshold::CaloTopoClusterMultiThreshold(const std::string& name, ISvcLocator* svcLoc)
+    : GaudiAlgorithm(name, svcLoc) {
+  declareProperty("TopoClusterInput", m_inputTool, "Handle for input map of cells");
+  declareProperty("noiseTool", m_noiseTool, "Handle for the cells noise tool");
+  declareProperty("neigboursTool", m_neighboursTool, "Handle for tool to retrieve cell neighbours");
+  declareProperty("positionsECalBarrelTool", m_cellPositionsECalBarrelTool,
+                  "Handle for tool to retrieve cell positions in ECal Barrel");
+  declareProperty("positionsHCalBarrelTool", m_cellPositionsHCalBarrelTool,
+                  "Handle for tool to retrieve cell positions in HCal Barrel");
+  declareProperty("positionsHCalBarrelNoSegTool", m_cellPositionsHCalBarrelNoSegTool,
+                  "Handle for tool to retrieve cell positions in HCal Barrel without DD4hep segmentation");
+  declareProperty("positionsHCalExtBarrelTool", m_cellPositionsHCalExtBarrelTool,
+                  "Handle for tool to retrieve cell positions in HCal ext Barrel");
+  declareProperty("positionsEMECTool", m_cellPositionsEMECTool, "Handle for tool to retrieve cell positions in EMEC");
+  declareProperty("positionsHECTool", m_cellPositionsHECTool, "Handle for tool to retrieve cell positions in HEC");
+  declareProperty("positionsEMFwdTool", m_cellPositionsEMFwdTool, "Handle for tool to retrieve cell positions EM Fwd");
+  declareProperty("positionsHFwdTool", m_cellPositionsHFwdTool, "Handle for tool to retrieve cell positions Had Fwd");
+}
+
+StatusCode CaloTopoClusterMultiThreshold::initialize() {
+  if (GaudiAlgorithm::initialize().isFailure()) return StatusCode::FAILURE;
+  size_t numConfigs = m_seedSigma.size();
+  if (numConfigs == 0 || m_neighbourSigma.size() != numConfigs || m_lastNeighbourSigma.size() != numConfigs ||
+      m_clusterNames.size() != numConfigs || m_clusterCellsNames.size() != numConfigs) {
+    error() << "Properties seedSigma, neighbourSigma, lastNeighbourSigma, clusters and clusterCells need to have the "
+            << "same, non-zero size!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  std::set<int> thresholds;
+  for (size_t iConfig = 0; iConfig < numConfigs; iConfig++) {
+    // without budget, the budget threshold is not used
+    m_configs.push_back({m_seedSigma[iConfig], m_neighbourSigma[iConfig], m_lastNeighbourSigma[iConfig],
+                         m_seedSigma[iConfig]});
+    thresholds.insert({m_seedSigma[iConfig], m_neighbourSigma[iConfig], m_lastNeighbourSigma[iConfig]});
+    m_clusterCollections.push_back(
+        new DataHandle<edm4hep::ClusterCollection>(m_clusterNames[iConfig], Gaudi::DataHandle::Writer, this));
+    m_clusterCellsCollections.push_back(new DataHandle<edm4hep::CalorimeterHitCollection>(
+        m_clusterCellsNames[iConfig], Gaudi::DataHandle::Writer, this));
+    info() << "Configuration " << iConfig << ": seed " << m_seedSigma[iConfig] << " sigma, neighbours "
+           << m_neighbourSigma[iConfig] << " sigma, last neighbours " << m_lastNeighbourSigma[iConfig]
+           << " sigma -> " << m_clusterNames[iConfig] << endmsg;
+  }
+  if (thresholds.size() > TopoClusterBuilder::kMaxThresholds) {
+    error() << "At most " << TopoClusterBuilder::kMaxThresholds << " distinct thresholds are supported, "
+            << thresholds.size() << " given!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!m_inputTool.retrieve()) {
+    error() << "Unable to retrieve the topo cluster input tool!!!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!m_neighboursTool.retrieve()) {
+    error() << "Unable to retrieve the cells neighbours tool!!!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!m_noiseTool.retrieve()) {
+    error() << "Unable to retrieve the cells noise tool!!!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  // Check if cell position ECal Barrel tool available
+  if (!m_cellPositionsECalBarrelTool.retrieve()) {
+    error() << "Unable to retrieve ECal Barrel cell positions tool!!!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  // Check if cell position HCal Barrel tool available
+  if (!m_cellPositionsHCalBarrelTool.retrieve()) {
+    error() << "Unable to retrieve HCal Barrel cell positions tool!!!" << endmsg;
+    if (!m_cellPositionsHCalBarrelNoSegTool.retrieve()) {
+      error() << "Also unable to retrieve HCal Barrel no segmentation cell positions tool!!!" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CaloTopoClusterMultiThreshold::execute() {
+  std::map<uint64_t, double> allCells;
+
+  // get input cell map from input tool, once for all configurations
+  StatusCode sc_prepareCellMap = m_inputTool->cellIDMap(allCells);
+  if (sc_prepareCellMap.isFailure()) {
+    error() << "Unable to create cell map!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  debug() << "Active Cells          :    " << allCells.size() << endmsg;
+
+  // noise and neighbours are cached by the builder and shared by all configurations
+  TopoClusterBuilder builder(allCells, &(*m_neighboursTool), &(*m_noiseTool), m_configs);
+  debug() << "Number of seeds found :    " << builder.findingSeeds().size() << endmsg;
+  // proto-clusters of all configurations, built in one traversal of the seeds
+  std::vector<TopoClusterBuilder::PreClusterCollection> preClusterCollections;
+  if (!builder.buildingProtoClusters(preClusterCollections)) {
+    error() << "No neighbours for cellID found! " << endmsg;
+    error() << "to cellID :  " << builder.missingNeighboursCell() << endmsg;
+    error() << "in system:   " << m_decoder->get(builder.missingNeighboursCell(), "system") << endmsg;
+    error() << "Building of cluster is stopped due to missing id in neighbours map." << endmsg;
+  }
+  // cell positions, computed once per event
+  std::unordered_map<uint64_t, dd4hep::Position> positions;
+  auto position = [this, &positions](uint64_t aCellId) -> const dd4hep::Position& {
+    auto itPosition = positions.find(aCellId);
+    if (itPosition == positions.end()) {
+      itPosition = positions.emplace(aCellId, cellPosition(aCellId)).first;
+    }
+    return itPosition->second;
+  };
+  // all clusters are fully evaluated, no summaries are written
+  edm4hep::ClusterCollection noSummaries;
+
+  for (size_t iConfig = 0; iConfig < m_configs.size(); iConfig++) {
+    auto edmClusters = m_clusterCollections[iConfig]->createAndPut();
+    edm4hep::CalorimeterHitCollection* edmClusterCells = new edm4hep::CalorimeterHitCollection();
+    debug() << "Configuration " << iConfig << ", number of seeds found :    " << builder.stats(iConfig).seeds
+            << endmsg;
+
+    // Build Clusters in edm
+    debug() << "Building " << preClusterCollections[iConfig].size() << " cluster." << endmsg;
+    double checkTotEnergy =
+        builder.writeClusters(preClusterCollections[iConfig], position, 0., 0, *edmClusters, *edmClusterCells,
+                              noSummaries);
+    m_clusterCellsCollections[iConfig]->put(edmClusterCells);
+    debug() << "Configuration " << iConfig << ", total energy of clusters:     " << checkTotEnergy << endmsg;
+  }
+  debug() << "Neighbour lookups :    " << builder.numNeighbourLookups() << endmsg;
+  debug() << "Noise lookups     :    " << builder.numNoiseLookups() << endmsg;
+  debug() << "Cell positions    :    " << positions.size() << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+dd4hep::Position CaloTopoClusterMultiThreshold::cellPosition(uint64_t aCellId) {
+  dd4hep::DDSegmentation::CellID cID = aCellId;
+  auto systemId = m_decoder->get(cID, "system");
+  dd4hep::Position posCell;
+  if (systemId == 5)  // ECAL BARREL system id
+    posCell = m_cellPositionsECalBarrelTool->xyzPosition(cID);
+  else if (systemId == 8) {  // HCAL BARREL system id
+    if (m_noSegmentationHCalUsed)
+      posCell = m_cellPositionsHCalBarrelNoSegTool->xyzPosition(cID);
+    else
+      posCell = m_cellPositionsHCalBarrelTool->xyzPosition(cID);
+  } else if (systemId == 9)  // HCAL EXT BARREL system id
+    posCell = m_cellPositionsHCalExtBarrelTool->xyzPosition(cID);
+  else if (systemId == 6)  // EMEC system id
+    posCell = m_cellPositionsEMECTool->xyzPosition(cID);
+  else if (systemId == 7)  // HEC system id
+    posCell = m_cellPositionsHECTool->xyzPosition(cID);
+  else if (systemId == 10)  // EMFWD system id
+    posCell = m_cellPositionsEMFwdTool->xyzPosition(cID);
+  else if (systemId == 11)  // HFWD system id
+    posCell = m_cellPositionsHFwdTool->xyzPosition(cID);
+  else
+    warning() << "No cell positions tool found for system id " << systemId << ". " << endmsg;
+  return posCell;
+}
+
+StatusCode CaloTopoClusterMultiThreshold::finalize() {
+  for (auto handle : m_clusterCollections) delete handle;
+  for (auto handle : m_clusterCellsCollections) delete handle;
+  m_clusterCollections.clear();
+  m_clusterCellsCollections.clear();
+  return GaudiAlgorithm::finalize();
+}
@@ -0,0 +1,103 @@
+#ifndef RECCALORIMETER_CALOTOPOCLUSTERMULTITHRESHOLD_H
+#define RECCALORIMETER_CALOTOPOCLUSTERMULTITHRESHOLD_H
+
+// Gaudi
+#include "GaudiAlg/GaudiAlgorithm.h"
+#include "GaudiKernel/ToolHandle.h"
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+#include "k4Interface/ICaloReadCellNoiseMap.h"
+#include "k4Interface/ICaloReadNeighboursMap.h"
+#include "k4Interface/ICellPositionsTool.h"
+#include "k4Interface/ITopoClusterInputTool.h"
+
+#include "TopoClusterBuilder.h"
+
+// datamodel
+namespace edm4hep {
+class CalorimeterHitCollection;
+class ClusterCollection;
+}
+
+/** @class CaloTopoClusterMultiThreshold Reconstruction/RecCalorimeter/src/components/CaloTopoClusterMultiThreshold.h
+ *
+ *  Algorithm building the topological clusters for several threshold configurations in one go, e.g. for the tuning
+ *  of the thresholds. The clustering of each configuration follows exactly the one of CaloTopoCluster (same seeds,
+ *  same cluster merging, same cell types), so the clusters of configuration i are identical to the ones of a
+ *  CaloTopoCluster run with seedSigma[i], neighbourSigma[i] and lastNeighbourSigma[i].
+ *
+ *  Per event, the work that does not depend on the thresholds is done only once and shared by all configurations:
+ *  the cell map is retrieved once from the input tool, the noise level and the neighbours of a cell are read once
+ *  from the tools, and the position of a cell is computed once. The proto-clusters of all configurations are built
+ *  in one traversal of the seeds by the builder of CaloTopoCluster (see TopoClusterBuilder): each cell is compared
+ *  once to all thresholds, and each seed grows the cluster of every configuration it is a seed of.
+ *
+ *  For each configuration i, the clusters are written to "clusters[i]" and their cells to "clusterCells[i]".
+ *  All vector properties need to have the same size.
+ *  The cluster moments are computed as in CaloTopoCluster (see ClusterMomentsAccumulator).
+ *
+ */
+
+class CaloTopoClusterMultiThreshold : public GaudiAlgorithm {
+public:
+  CaloTopoClusterMultiThreshold(const std::string& name, ISvcLocator* svcLoc);
+
+  StatusCode initialize();
+
+  StatusCode execute();
+
+  StatusCode finalize();
+
+private:
+  /** Position of a cell, retrieved from the positions tool of its calorimeter system.
+   *   @param[in] aCellId, the cell ID.
+   *   return position of the cell, (0,0,0) if no tool is defined for the system.
+   */
+  dd4hep::Position cellPosition(uint64_t aCellId);
+
+  /// Thresholds of the configurations
+  std::vector<TopoClusterBuilder::Thresholds> m_configs;
+  /// Handles of the output cluster collections, one per configuration
+  std::vector<DataHandle<edm4hep::ClusterCollection>*> m_clusterCollections;
+  /// Handles of the output cluster cells collections, one per configuration
+  std::vector<DataHandle<edm4hep::CalorimeterHitCollection>*> m_clusterCellsCollections;
+  /// Handle for the input tool
+  ToolHandle<ITopoClusterInputTool> m_inputTool{"TopoClusterInput", this};
+  /// Handle for the cells noise tool
+  ToolHandle<ICaloReadCellNoiseMap> m_noiseTool{"TopoCaloNoisyCells", this};
+  /// Handle for neighbours tool
+  ToolHandle<ICaloReadNeighboursMap> m_neighboursTool{"TopoCaloNeighbours", this};
+  /// Handle for tool to get positions in ECal Barrel
+  ToolHandle<ICellPositionsTool> m_cellPositionsECalBarrelTool{"CellPositionsECalBarrelTool", this};
+  /// Handle for tool to get positions in HCal Barrel
+  ToolHandle<ICellPositionsTool> m_cellPositionsHCalBarrelNoSegTool{"CellPositionsHCalBarrelNoSegTool", this};
+  /// Handle for tool to get positions in HCal Barrel
+  ToolHandle<ICellPositionsTool> m_cellPositionsHCalBarrelTool{"CellPositionsHCalBarrelTool", this};
+  /// Handle for tool to get positions in HCal Barrel and Ext Barrel, no Segmentation
+  ToolHandle<ICellPositionsTool> m_cellPositionsHCalExtBarrelTool{"CellPositionsHCalBarrelNoSegTool", this};
+  /// Handle for tool to get positions in Calo Discs
+  ToolHandle<ICellPositionsTool> m_cellPositionsEMECTool{"CellPositionsCaloDiscsTool", this};
+  /// Handle for tool to get positions in Calo Discs
+  ToolHandle<ICellPositionsTool> m_cellPositionsHECTool{"CellPositionsCaloDiscsTool", this};
+  /// Handle for tool to get positions in Calo Discs
+  ToolHandle<ICellPositionsTool> m_cellPositionsEMFwdTool{"CellPositionsCaloDiscsTool", this};
+  /// Handle for tool to get positions in Calo Discs
+  ToolHandle<ICellPositionsTool> m_cellPositionsHFwdTool{"CellPositionsCaloDiscsTool", this};
+
+  /// no segmentation used in HCal
+  Gaudi::Property<bool> m_noSegmentationHCalUsed{this, "noSegmentationHCal", true, "HCal Barrel readout without DD4hep eta-phi segmentation used."};
+  /// Seed thresholds in sigma, one per configuration
+  Gaudi::Property<std::vector<int>> m_seedSigma{this, "seedSigma", {4}, "number of sigma in noise threshold, per configuration"};
+  /// Neighbour thresholds in sigma, one per configuration
+  Gaudi::Property<std::vector<int>> m_neighbourSigma{this, "neighbourSigma", {2}, "number of sigma in noise threshold, per configuration"};
+  /// Last neighbour thresholds in sigma, one per configuration
+  Gaudi::Property<std::vector<int>> m_lastNeighbourSigma{this, "lastNeighbourSigma", {0}, "number of sigma in noise threshold, per configuration"};
+  /// Names of the output cluster collections, one per configuration
+  Gaudi::Property<std::vector<std::string>> m_clusterNames{this, "clusters", {"calo/clusters"}, "Names of the output cluster collections, per configuration"};
+  /// Names of the output cluster cells collections, one per configuration
+  Gaudi::Property<std::vector<std::string>> m_clusterCellsNames{this, "clusterCells", {"calo/clusterCells"}, "Names of the output cluster cells collections, per configuration"};
+  /// General decoder to encode the calorimeter sub-system to determine which positions tool to use
+  dd4hep::DDSegmentation::BitFieldCoder* m_decoder = new dd4hep::DDSegmentation::BitFieldCoder("system:4");
+};
+#endif /* RECCALORIMETER_CALOTOPOCLUSTERMULTITHRESHOLD_H */
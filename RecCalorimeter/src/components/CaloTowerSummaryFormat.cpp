@@ -0,0 +1,90 @@
+#include "CaloTowerSummaryFormat.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace calo_towers {
+
+void encodeEvent(const std::vector<uint32_t>& aIndices, const std::vector<float>& aEnergies,
+                 std::vector<char>& aBuffer) {
+  size_t start = aBuffer.size();
+  // worst case size: 5 bytes per varint of 32 bits
+  size_t maxIndexBytes = aIndices.size() * 5;
+  size_t energyBytes = aEnergies.size() * sizeof(float);
+  aBuffer.resize(start + sizeof(EventHeader) + calo_replay::padded(maxIndexBytes) + calo_replay::padded(energyBytes),
+                 0);
+  unsigned char* indices = reinterpret_cast<unsigned char*>(aBuffer.data() + start + sizeof(EventHeader));
+  unsigned char* pos = indices;
+  uint32_t previous = 0;
+  for (uint32_t index : aIndices) {
+    pos = calo_replay::writeVarint(index - previous, pos);
+    previous = index;
+  }
+  size_t indexBytes = pos - indices;
+  std::memcpy(reinterpret_cast<char*>(indices) + calo_replay::padded(indexBytes), aEnergies.data(), energyBytes);
+  size_t payloadSize = calo_replay::padded(indexBytes) + calo_replay::padded(energyBytes);
+  EventHeader header{kEventMagic, static_cast<uint32_t>(aIndices.size()), payloadSize, indexBytes};
+  std::memcpy(aBuffer.data() + start, &header, sizeof(header));
+  aBuffer.resize(start + sizeof(EventHeader) + payloadSize);
+}
+
+File::~File() { close(); }
+
+void File::close() {
+  if (m_data != nullptr) {
+    munmap(const_cast<char*>(m_data), m_size);
+  }
+  m_data = nullptr;
+  m_size = 0;
+  m_events.clear();
+}
+
+std::string File::open(const std::string& aFileName) {
+  close();
+  int fd = ::open(aFileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return "cannot open file " + aFileName;
+  }
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+    ::close(fd);
+    return "file " + aFileName + " is too short";
+  }
+  void* data = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    return "cannot map file " + aFileName;
+  }
+  m_data = static_cast<const char*>(data);
+  m_size = fileStat.st_size;
+  // events are read in order
+  madvise(data, m_size, MADV_SEQUENTIAL);
+
+  std::memcpy(&m_header, m_data, sizeof(m_header));
+  if (std::memcmp(m_header.magic, kMagic, sizeof(kMagic)) != 0 || m_header.version != kVersion) {
+    close();
+    return "file " + aFileName + " is not a tower summary file of version " + std::to_string(kVersion);
+  }
+  if (m_header.numEta == 0 || m_header.numPhi == 0) {
+    close();
+    return "file " + aFileName + " has an empty tower grid";
+  }
+
+  // index the event blocks
+  size_t offset = sizeof(FileHeader);
+  while (offset + sizeof(EventHeader) <= m_size) {
+    EventHeader eventHeader;
+    std::memcpy(&eventHeader, m_data + offset, sizeof(eventHeader));
+    if (eventHeader.magic != kEventMagic || offset + sizeof(EventHeader) + eventHeader.payloadSize > m_size) {
+      // incomplete last event, e.g. if the writing job was stopped
+      break;
+    }
+    m_events.push_back(m_data + offset);
+    offset += sizeof(EventHeader) + eventHeader.payloadSize;
+  }
+  return "";
+}
+
+}  // namespace calo_towers
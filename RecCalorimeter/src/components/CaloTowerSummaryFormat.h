@@ -0,0 +1,133 @@
+#ifndef RECCALORIMETER_CALOTOWERSUMMARYFORMAT_H
+#define RECCALORIMETER_CALOTOWERSUMMARYFORMAT_H
+
+#include "CaloCellReplayFormat.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/** @file CaloTowerSummaryFormat.h Reconstruction/RecCalorimeter/src/components/CaloTowerSummaryFormat.h
+ *
+ *  Binary format of the tower summary files, used to store the eta-phi grid of calorimeter towers built by a tower
+ *  tool (e.g. CaloTowerTool), so that the analyses and the sliding window clustering can run on the towers without
+ *  the cells.
+ *
+ *  Layout (host byte order, all blocks padded to 8 bytes, as the cell replay files, see CaloCellReplayFormat.h):
+ *   - FileHeader, with the tower grid: number of towers, centre of the first tower and size of the towers in eta and
+ *     phi, radius for the cluster positions, and the number of layer groups;
+ *   - one block per event: EventHeader, followed by the indices (eta index * number of phi towers + phi index) of the
+ *     towers above threshold, sorted and delta-coded as varints, the transverse energies of these towers as float32,
+ *     and for each layer group the transverse energies of the same towers in the layers of the group as float32.
+ *
+ *  Written by WriteCaloTowerSummary, read by CaloTowerSummaryTool.
+ */
+
+namespace calo_towers {
+
+/// File identifier
+constexpr char kMagic[8] = {'C', 'T', 'O', 'W', 'E', 'R', 'S', '\0'};
+/// Current format version
+constexpr uint32_t kVersion = 1;
+/// Event block identifier ("TEVT")
+constexpr uint32_t kEventMagic = 0x54564554;
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t numLayerGroups;
+  uint32_t numEta;
+  uint32_t numPhi;
+  /// centre of the first tower in eta and size of the towers in eta
+  float etaFirst;
+  float deltaEta;
+  /// centre of the first tower in phi and size of the towers in phi
+  float phiFirst;
+  float deltaPhi;
+  /// radius for the cluster positions
+  float radius;
+  uint32_t reserved;
+};
+
+struct EventHeader {
+  uint32_t magic;
+  uint32_t numTowers;
+  /// size in bytes of the index and energy blocks following the header
+  uint64_t payloadSize;
+  /// size in bytes of the index block, without padding
+  uint64_t indexBytes;
+};
+
+/** Append one event to the buffer.
+ *   @param[in] aIndices, indices of the stored towers, sorted.
+ *   @param[in] aEnergies, transverse energies: all layers, then each layer group, aIndices.size() values each.
+ *   @param[out] aBuffer, buffer to which the event is appended.
+ */
+void encodeEvent(const std::vector<uint32_t>& aIndices, const std::vector<float>& aEnergies,
+                 std::vector<char>& aBuffer);
+
+/** @class calo_towers::File
+ *
+ *  Read-only access to a tower summary file through a memory mapping.
+ *  The positions of the event blocks are indexed when the file is opened, the towers are decoded on demand.
+ */
+class File {
+public:
+  File() = default;
+  ~File();
+  File(const File&) = delete;
+  File& operator=(const File&) = delete;
+
+  /** Map the file and index its events.
+   *   return empty string on success, the error message otherwise.
+   */
+  std::string open(const std::string& aFileName);
+  /// Unmap the file
+  void close();
+
+  /// Tower grid and number of layer groups
+  const FileHeader& header() const { return m_header; }
+  /// Number of events in the file
+  size_t numEvents() const { return m_events.size(); }
+  /// Size of the mapped file in bytes
+  size_t size() const { return m_size; }
+
+  /// Number of towers stored in an event
+  uint32_t numTowers(size_t aEvent) const {
+    EventHeader header;
+    std::memcpy(&header, m_events[aEvent], sizeof(header));
+    return header.numTowers;
+  }
+
+  /** Call aFunc(eta index, phi index, transverse energy) for the stored towers of an event.
+   *   @param[in] aEvent, index of the event.
+   *   @param[in] aLayerGroup, layer group of the energies, -1 for all layers.
+   */
+  template <typename F>
+  void forEachTower(size_t aEvent, int aLayerGroup, F&& aFunc) const {
+    EventHeader header;
+    std::memcpy(&header, m_events[aEvent], sizeof(header));
+    const char* indices = m_events[aEvent] + sizeof(EventHeader);
+    const float* energies = reinterpret_cast<const float*>(indices + calo_replay::padded(header.indexBytes)) +
+                            size_t(aLayerGroup + 1) * header.numTowers;
+    const unsigned char* pos = reinterpret_cast<const unsigned char*>(indices);
+    uint64_t index = 0;
+    for (uint32_t i = 0; i < header.numTowers; i++) {
+      index += calo_replay::readVarint(pos);
+      aFunc(uint(index / m_header.numPhi), uint(index % m_header.numPhi), energies[i]);
+    }
+  }
+
+private:
+  const char* m_data = nullptr;
+  size_t m_size = 0;
+  FileHeader m_header;
+  /// Pointers to the event headers
+  std::vector<const char*> m_events;
+};
+
+}  // namespace calo_towers
+
+#endif /* RECCALORIMETER_CALOTOWERSUMMARYFORMAT_H */
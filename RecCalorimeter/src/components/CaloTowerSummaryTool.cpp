@@ -0,0 +1,90 @@
+#include "CaloTowerSummaryTool.h"
+
+// Gaudi
+#include "GaudiKernel/GaudiException.h"
+#include "GaudiKernel/ThreadLocalContext.h"
+
+#include <cmath>
+#include <sstream>
+
+DECLARE_COMPONENT(CaloTowerSummaryTool)
+
+CaloTowerSummaryTool::CaloTowerSummaryTool(const std::string& type, const std::string& name,
+                                           const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareInterface<ITowerTool>(this);
+}
+
+StatusCode CaloTowerSummaryTool::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  std::string err = m_file.open(m_fileName);
+  if (!err.empty()) {
+    error() << "Unable to read tower summary file: " << err << endmsg;
+    return StatusCode::FAILURE;
+  }
+  const auto& header = m_file.header();
+  if (m_layerGroup >= int(header.numLayerGroups)) {
+    error() << "Layer group " << m_layerGroup << " requested, but " << m_fileName << " contains "
+            << header.numLayerGroups << " layer groups!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  info() << "Tower summary file " << m_fileName << " with " << m_file.numEvents() << " events, towers ("
+         << header.numEta << " x " << header.numPhi << "), " << header.numLayerGroups << " layer groups" << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CaloTowerSummaryTool::finalize() {
+  m_file.close();
+  return GaudiTool::finalize();
+}
+
+tower CaloTowerSummaryTool::towersNumber() {
+  tower total;
+  total.eta = m_file.header().numEta;
+  total.phi = m_file.header().numPhi;
+  return total;
+}
+
+uint CaloTowerSummaryTool::buildTowers(std::vector<std::vector<float>>& aTowers) {
+  StageTimer timer(m_timeTowers);
+  size_t event = m_firstEvent + Gaudi::Hive::currentContext().evt();
+  if (event >= m_file.numEvents()) {
+    // an empty tower grid would be taken for an event without energy, the job has to stop
+    std::ostringstream message;
+    message << "Event " << event << " not found in " << m_fileName.value() << " (" << m_file.numEvents() << " events)";
+    throw GaudiException(message.str(), name(), StatusCode::FAILURE);
+  }
+  m_file.forEachTower(event, m_layerGroup, [&aTowers](uint aIdEta, uint aIdPhi, float aEnergy) {
+    aTowers[aIdEta][aIdPhi] += aEnergy;
+  });
+  uint numTowers = m_file.numTowers(event);
+  m_numTowers += numTowers;
+  return numTowers;
+}
+
+float CaloTowerSummaryTool::radiusForPosition() const { return m_file.header().radius; }
+
+uint CaloTowerSummaryTool::idEta(float aEta) const {
+  const auto& header = m_file.header();
+  return floor((aEta - header.etaFirst) / header.deltaEta + 0.5);
+}
+
+uint CaloTowerSummaryTool::idPhi(float aPhi) const {
+  const auto& header = m_file.header();
+  return floor((aPhi - header.phiFirst) / header.deltaPhi + 0.5);
+}
+
+float CaloTowerSummaryTool::eta(int aIdEta) const {
+  const auto& header = m_file.header();
+  return header.etaFirst + aIdEta * header.deltaEta;
+}
+
+float CaloTowerSummaryTool::phi(int aIdPhi) const {
+  const auto& header = m_file.header();
+  return header.phiFirst + aIdPhi * header.deltaPhi;
+}
+
+void CaloTowerSummaryTool::attachCells(float, float, uint, uint, edm4hep::MutableCluster&,
+                                       edm4hep::CalorimeterHitCollection*, bool) {}
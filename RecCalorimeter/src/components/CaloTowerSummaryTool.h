@@ -0,0 +1,92 @@
+#ifndef RECCALORIMETER_CALOTOWERSUMMARYTOOL_H
+#define RECCALORIMETER_CALOTOWERSUMMARYTOOL_H
+
+// from Gaudi
+#include "GaudiAlg/GaudiTool.h"
+
+// FCCSW
+#include "k4Interface/ITowerTool.h"
+
+#include "CaloTowerSummaryFormat.h"
+#include "StageTimer.h"
+
+// datamodel
+namespace edm4hep {
+class CalorimeterHitCollection;
+}
+
+/** @class CaloTowerSummaryTool Reconstruction/RecCalorimeter/src/components/CaloTowerSummaryTool.h
+ *
+ *  Tool rebuilding the calorimeter towers from a tower summary file written by WriteCaloTowerSummary (see
+ *  CaloTowerSummaryFormat.h), replacing CaloTowerTool in CreateCaloClustersSlidingWindow when the cells are not
+ *  available or not needed. The tower grid is the one stored in the file.
+ *
+ *  The file is memory-mapped, event N of the job reads event (firstEvent + N) of the file; buildTowers throws a
+ *  GaudiException past the last event of the file. The towers have the
+ *  transverse energy of all layers, or of the layer group '\b layerGroup' if it is not negative.
+ *  No cells are attached to the clusters. buildTowers returns the number of stored towers, so the sliding window
+ *  skips the events without towers above the threshold of the writer.
+ */
+
+class CaloTowerSummaryTool : public GaudiTool, virtual public ITowerTool {
+public:
+  CaloTowerSummaryTool(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~CaloTowerSummaryTool() = default;
+  virtual StatusCode initialize() final;
+  virtual StatusCode finalize() final;
+  /**  Number of calorimeter towers, as stored in the file.
+   *   @return Struct containing number of towers in eta and phi.
+   */
+  virtual tower towersNumber() final;
+  /**  Fill the stored towers of the event.
+   *   @param[out] aTowers Calorimeter towers.
+   *   @return Number of stored towers.
+   *   @throw GaudiException if the event is past the end of the file.
+   */
+  virtual uint buildTowers(std::vector<std::vector<float>>& aTowers) final;
+  /**  Get the radius for the position calculation.
+   *   @return Radius
+   */
+  virtual float radiusForPosition() const final;
+  /**  Get the tower IDs in eta.
+   *   @param[in] aEta Position of the calorimeter cell in eta
+   *   @return ID (eta) of a tower
+   */
+  virtual uint idEta(float aEta) const final;
+  /**  Get the tower IDs in phi.
+   *   @param[in] aPhi Position of the calorimeter cell in phi
+   *   @return ID (phi) of a tower
+   */
+  virtual uint idPhi(float aPhi) const final;
+  /**  Get the eta position of the centre of the tower.
+   *   @param[in] aIdEta ID (eta) of a tower
+   *   @return Position of the centre of the tower
+   */
+  virtual float eta(int aIdEta) const final;
+  /**  Get the phi position of the centre of the tower.
+   *   @param[in] aIdPhi ID (phi) of a tower
+   *   @return Position of the centre of the tower
+   */
+  virtual float phi(int aIdPhi) const final;
+  /**  No cells are stored, nothing is attached.
+   */
+  virtual void attachCells(float aEta, float aPhi, uint aHalfEtaFinal, uint aHalfPhiFinal,
+                           edm4hep::MutableCluster& aEdmCluster, edm4hep::CalorimeterHitCollection* aEdmClusterCells,
+                           bool aEllipse = false) final;
+
+private:
+  /// Name of the input file
+  Gaudi::Property<std::string> m_fileName{this, "filename", "caloTowerSummary.bin", "Name of the input file"};
+  /// First event of the file to read
+  Gaudi::Property<unsigned int> m_firstEvent{this, "firstEvent", 0, "First event of the file to read"};
+  /// Layer group of the tower energies
+  Gaudi::Property<int> m_layerGroup{this, "layerGroup", -1, "Layer group of the tower energies, all layers if -1"};
+  /// Mapped input file
+  calo_towers::File m_file;
+  /// Time to fill the towers
+  StageTimer::Counter m_timeTowers{this, "Time towers [us]"};
+  /// Number of towers read per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numTowers{this, "Towers"};
+};
+
+#endif /* RECCALORIMETER_CALOTOWERSUMMARYTOOL_H */
@@ -5,6 +5,7 @@
 
 // datamodel
 #include "edm4hep/CalorimeterHitCollection.h"
+#include "edm4hep/CalorimeterHitData.h"
 #include "edm4hep/Cluster.h"
 #include "edm4hep/MutableCluster.h"
 
@@ -102,6 +103,7 @@ StatusCode CaloTowerTool::initialize() {
 }
 
 StatusCode CaloTowerTool::finalize() { 
+  info() << "Peak memory of the cells in towers: " << m_memoryCellsInTowers.max() << " kB" << endmsg;
   for (auto& towerInMap : m_cellsInTowers) {
     towerInMap.second.clear();
     }
@@ -190,6 +192,9 @@ tower CaloTowerTool::towersNumber() {
           << endmsg;
   debug() << "Towers: phiMax " << m_phiMax << ", deltaPhiTower " << m_deltaPhiTower << ", nPhiTower " << m_nPhiTower
           << endmsg;
+  // the tower IDs and centres are given by the descriptor of the grid, the tables are reused if the grid is the same
+  m_geometry = TowerGeometry(m_nEtaTower, m_nPhiTower, -m_etaMax, m_deltaEtaTower, -m_phiMax, m_deltaPhiTower, m_radius,
+                             false, m_geometryTables);
 
   tower total;
   total.eta = m_nEtaTower;
@@ -208,6 +213,7 @@ uint CaloTowerTool::buildTowers(std::vector<std::vector<float>>& aTowers) {
   debug() << "Input Ecal barrel cell collection size: " << ecalBarrelCells->size() << endmsg;
   // Loop over a collection of calorimeter cells and build calo towers
   if (m_ecalBarrelSegmentation != nullptr) {
+    StageTimer timer(m_timeEcalBarrel);
     CellsIntoTowers(aTowers, ecalBarrelCells, m_ecalBarrelSegmentation, m_ecalBarrelSegmentationType);
     totalNumberOfCells += ecalBarrelCells->size();
   }
@@ -217,6 +223,7 @@ uint CaloTowerTool::buildTowers(std::vector<std::vector<float>>& aTowers) {
   debug() << "Input Ecal endcap cell collection size: " << ecalEndcapCells->size() << endmsg;
   // Loop over a collection of calorimeter cells and build calo towers
   if (m_ecalEndcapSegmentation != nullptr) {
+    StageTimer timer(m_timeEcalEndcap);
     CellsIntoTowers(aTowers, ecalEndcapCells, m_ecalEndcapSegmentation, m_ecalEndcapSegmentationType);
     totalNumberOfCells += ecalEndcapCells->size();
   }
@@ -226,6 +233,7 @@ uint CaloTowerTool::buildTowers(std::vector<std::vector<float>>& aTowers) {
   debug() << "Input Ecal forward cell collection size: " << ecalFwdCells->size() << endmsg;
   // Loop over a collection of calorimeter cells and build calo towers
   if (m_ecalFwdSegmentation != nullptr) {
+    StageTimer timer(m_timeEcalFwd);
     CellsIntoTowers(aTowers, ecalFwdCells, m_ecalFwdSegmentation, m_ecalFwdSegmentationType);
     totalNumberOfCells += ecalFwdCells->size();
   }
@@ -235,6 +243,7 @@ uint CaloTowerTool::buildTowers(std::vector<std::vector<float>>& aTowers) {
   debug() << "Input hadronic barrel cell collection size: " << hcalBarrelCells->size() << endmsg;
   // Loop over a collection of calorimeter cells and build calo towers
   if (m_hcalBarrelSegmentation != nullptr) {
+    StageTimer timer(m_timeHcalBarrel);
     CellsIntoTowers(aTowers, hcalBarrelCells, m_hcalBarrelSegmentation, m_hcalBarrelSegmentationType);
     totalNumberOfCells += hcalBarrelCells->size();
   }
@@ -244,6 +253,7 @@ uint CaloTowerTool::buildTowers(std::vector<std::vector<float>>& aTowers) {
   debug() << "Input hadronic extended barrel cell collection size: " << hcalExtBarrelCells->size() << endmsg;
   // Loop over a collection of calorimeter cells and build calo towers
   if (m_hcalExtBarrelSegmentation != nullptr) {
+    StageTimer timer(m_timeHcalExtBarrel);
     CellsIntoTowers(aTowers, hcalExtBarrelCells, m_hcalExtBarrelSegmentation, m_hcalExtBarrelSegmentationType);
     totalNumberOfCells += hcalExtBarrelCells->size();
   }
@@ -253,6 +263,7 @@ uint CaloTowerTool::buildTowers(std::vector<std::vector<float>>& aTowers) {
   debug() << "Input Hcal endcap cell collection size: " << hcalEndcapCells->size() << endmsg;
   // Loop over a collection of calorimeter cells and build calo towers
   if (m_hcalEndcapSegmentation != nullptr) {
+    StageTimer timer(m_timeHcalEndcap);
     CellsIntoTowers(aTowers, hcalEndcapCells, m_hcalEndcapSegmentation, m_hcalEndcapSegmentationType);
     totalNumberOfCells += hcalEndcapCells->size();
   }
@@ -262,41 +273,39 @@ uint CaloTowerTool::buildTowers(std::vector<std::vector<float>>& aTowers) {
   debug() << "Input Hcal forward cell collection size: " << hcalFwdCells->size() << endmsg;
   // Loop over a collection of calorimeter cells and build calo towers
   if (m_hcalFwdSegmentation != nullptr) {
+    StageTimer timer(m_timeHcalFwd);
     CellsIntoTowers(aTowers, hcalFwdCells, m_hcalFwdSegmentation, m_hcalFwdSegmentationType);
     totalNumberOfCells += hcalFwdCells->size();
   }
+  m_numCells += totalNumberOfCells;
+  // the vectors of the towers keep their capacity from the previous events, the cloned cells are owned by the map
+  size_t numClonedCells = 0;
+  for (const auto& towerInMap : m_cellsInTowers) {
+    numClonedCells += towerInMap.second.size();
+  }
+  m_memoryCellsInTowers += MemoryUsage::kiloBytes(MemoryUsage::heapBytes(m_cellsInTowers) +
+                                                  numClonedCells * sizeof(edm4hep::CalorimeterHitData));
 
   return totalNumberOfCells;
 }
 
-uint CaloTowerTool::idEta(float aEta) const {
-  uint id = floor((aEta + m_etaMax) / m_deltaEtaTower);
-  return id;
-}
+uint CaloTowerTool::idEta(float aEta) const { return m_geometry.idEta(aEta); }
 
-uint CaloTowerTool::idPhi(float aPhi) const {
-  uint id = floor((aPhi + m_phiMax) / m_deltaPhiTower);
-  return id;
-}
+uint CaloTowerTool::idPhi(float aPhi) const { return m_geometry.idPhi(aPhi); }
 
 float CaloTowerTool::eta(int aIdEta) const {
   // middle of the tower
-  return ((aIdEta + 0.5) * m_deltaEtaTower - m_etaMax);
+  return m_geometry.eta(aIdEta);
 }
 
 float CaloTowerTool::phi(int aIdPhi) const {
   // middle of the tower
-  return ((aIdPhi + 0.5) * m_deltaPhiTower - m_phiMax);
+  return m_geometry.phi(aIdPhi);
 }
 
-uint CaloTowerTool::phiNeighbour(int aIPhi) const {
-  if (aIPhi < 0) {
-    return m_nPhiTower + aIPhi;
-  } else if (aIPhi >= m_nPhiTower) {
-    return aIPhi % m_nPhiTower;
-  }
-  return aIPhi;
-}
+const TowerGeometry& CaloTowerTool::towerGeometry() const { return m_geometry; }
+
+uint CaloTowerTool::phiNeighbour(int aIPhi) const { return m_geometry.phiNeighbour(aIPhi); }
 
 float CaloTowerTool::radiusForPosition() const { return m_radius; }
 
@@ -9,6 +9,10 @@
 #include "k4FWCore/DataHandle.h"
 #include "k4Interface/ITowerTool.h"
 
+#include "MemoryUsage.h"
+#include "StageTimer.h"
+#include "TowerGeometry.h"
+
 class IGeoSvc;
 #include "DDSegmentation/MultiSegmentation.h"
 
@@ -37,6 +41,9 @@ class BitFieldCoder;
  *  A tower contains all cells within certain eta and phi (tower size: '\b deltaEtaTower', '\b deltaPhiTower').
  *  Distance in r plays no role, however `\b radiusForPosition` needs to be defined
  *  (e.g. to inner radius of the detector) for the cluster position calculation. By default the radius is equal to 1.
+ *  The time to fill the cells of each system into towers and the number of cells per event are recorded in counters.
+ *  The grid of the towers is described by a TowerGeometry, computed by towersNumber(), used by the algorithms in their
+ *  loops over towers instead of the virtual queries of the tool.
  *
  *  For more explanation please [see reconstruction documentation](@ref md_reconstruction_doc_reccalorimeter).
  *
@@ -44,7 +51,7 @@ class BitFieldCoder;
  *  @author Jana Faltova
  */
 
-class CaloTowerTool : public GaudiTool, virtual public ITowerTool {
+class CaloTowerTool : public GaudiTool, virtual public ITowerTool, public TowerGeometry::Provider {
 public:
   CaloTowerTool(const std::string& type, const std::string& name, const IInterface* parent);
   virtual ~CaloTowerTool() = default;
@@ -95,6 +102,10 @@ public:
    *   @return Position of the centre of the tower
    */
   virtual float phi(int aIdPhi) const final;
+  /**  Get the descriptor of the tower grid, with the queries above as inline functions (see TowerGeometry.h).
+   *   @return Descriptor of the grid computed by towersNumber()
+   */
+  virtual const TowerGeometry& towerGeometry() const final;
   /**  Find cells belonging to a cluster.
    *   @param[in] aEta Position of the middle tower of a cluster in eta
    *   @param[in] aPhi Position of the middle tower of a cluster in phi
@@ -211,11 +222,33 @@ private:
   int m_nEtaTower;
   /// Number of towers in phi (calculated from m_deltaPhiTower)
   int m_nPhiTower;
+  /// Descriptor of the tower grid, computed by towersNumber()
+  TowerGeometry m_geometry;
+  /// Tables of the tower centres of the descriptor
+  TowerGeometry::Tables m_geometryTables;
   /// map to cells contained within a tower so they can be attached to a reconstructed cluster (note that fraction of
   /// their energy assigned to a cluster is not acknowledged)
   std::map<std::pair<uint, uint>, std::vector<edm4hep::CalorimeterHit>> m_cellsInTowers;
   /// Use only half of calorimeter
   Gaudi::Property<bool> m_useHalfTower{this, "halfTower", false, "Use half tower"};
+  /// Time to fill the ecal barrel cells into towers
+  StageTimer::Counter m_timeEcalBarrel{this, "Time ecal barrel towers [us]"};
+  /// Time to fill the ecal endcap cells into towers
+  StageTimer::Counter m_timeEcalEndcap{this, "Time ecal endcap towers [us]"};
+  /// Time to fill the ecal forward cells into towers
+  StageTimer::Counter m_timeEcalFwd{this, "Time ecal forward towers [us]"};
+  /// Time to fill the hcal barrel cells into towers
+  StageTimer::Counter m_timeHcalBarrel{this, "Time hcal barrel towers [us]"};
+  /// Time to fill the hcal extended barrel cells into towers
+  StageTimer::Counter m_timeHcalExtBarrel{this, "Time hcal extended barrel towers [us]"};
+  /// Time to fill the hcal endcap cells into towers
+  StageTimer::Counter m_timeHcalEndcap{this, "Time hcal endcap towers [us]"};
+  /// Time to fill the hcal forward cells into towers
+  StageTimer::Counter m_timeHcalFwd{this, "Time hcal forward towers [us]"};
+  /// Number of cells filled into towers per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numCells{this, "Cells"};
+  /// Estimated memory of the cells in towers per event, map and cloned cells
+  MemoryUsage::Counter m_memoryCellsInTowers{this, "Memory cells in towers [kB]"};
 };
 
 #endif /* RECCALORIMETER_CALOTOWERTOOL_H */
@@ -0,0 +1,64 @@
+#ifndef RECCALORIMETER_CELLSMAPSCRATCH_H
+#define RECCALORIMETER_CELLSMAPSCRATCH_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/** @class CellsMapScratch Reconstruction/RecCalorimeter/src/components/CellsMapScratch.h
+ *
+ *  Map of the cells of an event, reused from event to event by an algorithm creating cells from hits
+ *  (CreateCaloCells, CreateCaloTopoClustersFromHits). Each event starts from all cells of the calorimeter with zero
+ *  energy (emptyCells(), prepared at initialize when noise is added, never modified afterwards), or from an empty map.
+ *
+ *  reset() restores the map in place instead of copying the map of all cells, which allocates every cell in every
+ *  event: the cells of hits outside of the map of all cells are erased, the cells erased by the filtering of the
+ *  noise are inserted back, and all energies are set to zero. Only the first event and the events after a filtering
+ *  allocate, for the missing cells (the assignment of the map of all cells reuses the nodes of the other cells).
+ *  The hits have to be added with add(), which records the cells it inserts.
+ *
+ *  The algorithms are not reentrant: each instance, i.e. each event slot, has its own map.
+ */
+
+class CellsMapScratch {
+public:
+  typedef std::unordered_map<uint64_t, double> Map;
+
+  /// Map of all cells with zero energy, filled at initialize
+  Map& emptyCells() { return m_emptyCells; }
+  const Map& emptyCells() const { return m_emptyCells; }
+
+  /// Map of the event, with all cells with zero energy, to be called at the start of each event
+  Map& reset() {
+    for (uint64_t cellId : m_addedCells) {
+      m_cells.erase(cellId);
+    }
+    m_addedCells.clear();
+    if (m_cells.size() < m_emptyCells.size()) {
+      // the assignment reuses the nodes of the map, only the missing cells are allocated
+      m_cells = m_emptyCells;
+      return m_cells;
+    }
+    for (auto& cell : m_cells) {
+      cell.second = 0;
+    }
+    return m_cells;
+  }
+
+  /// Add the energy of a hit to its cell, inserted if it is not in the map of all cells
+  void add(uint64_t aCellId, double aEnergy) {
+    auto inserted = m_cells.emplace(aCellId, 0.);
+    if (inserted.second) m_addedCells.push_back(aCellId);
+    inserted.first->second += aEnergy;
+  }
+
+private:
+  /// Map of all cells with zero energy
+  Map m_emptyCells;
+  /// Cells of the event
+  Map m_cells;
+  /// Cells inserted by add() in the event, erased at the next reset
+  std::vector<uint64_t> m_addedCells;
+};
+
+#endif /* RECCALORIMETER_CELLSMAPSCRATCH_H */
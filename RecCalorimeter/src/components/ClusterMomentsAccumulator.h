@@ -0,0 +1,238 @@
+#ifndef RECCALORIMETER_CLUSTERMOMENTSACCUMULATOR_H
+#define RECCALORIMETER_CLUSTERMOMENTSACCUMULATOR_H
+
+// EDM4HEP
+#include "edm4hep/MutableCluster.h"
+#include "edm4hep/Vector3f.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/** @class ClusterMomentsAccumulator Reconstruction/RecCalorimeter/src/components/ClusterMomentsAccumulator.h
+ *
+ *  Helper collecting the energy and position of the cells of one cluster in contiguous arrays (structure of arrays),
+ *  and computing the cluster moments from them:
+ *  energy, energy-weighted barycentre (x, y, z, eta, phi, r), second central moments in eta, phi and r,
+ *  energy-weighted distance of the cells to the barycentre in eta-phi (deltaR), maximum cell energy and the
+ *  log-weighted position (weight per cell: max(0, W0 + ln(E_cell / E_cluster))).
+ *
+ *  The linear sums are accumulated in one pass over the arrays, the second moments and the log-weighted position in a
+ *  second one, deltaR in a third one. The loops are branch-free over plain arrays.
+ *  Sums are done in the order in which cells were added, so the energy and barycentre are identical to a direct
+ *  summation over the same cells.
+ *
+ *  Phi of each cell is taken relative to the phi of the energy-weighted position, atan2(sum(E*y), sum(E*x)), and
+ *  wrapped into [-pi, pi], so that clusters crossing phi = +-pi get the right barycentre, variance and deltaR. The
+ *  variances are accumulated around the barycentre (eta, r) or this reference (phi) instead of as E[x^2] - E[x]^2.
+ *  Cells on the beam axis have no eta and phi, they are left out of the eta and phi moments and of deltaR.
+ *
+ *  Shape parameters written by addShapeParameters, in this order:
+ *  [0] deltaR, [1] eta variance, [2] phi variance, [3] r variance, [4] maximum cell energy,
+ *  [5] log-weighted x, [6] log-weighted y, [7] log-weighted z.
+ *
+ *  Used by CaloTopoCluster, CaloTopoClusterFCCee and SplitClusters.
+ */
+
+class ClusterMomentsAccumulator {
+public:
+  /// Moments of one cluster
+  struct Moments {
+    double energy = 0.;
+    double x = 0.;
+    double y = 0.;
+    double z = 0.;
+    double eta = 0.;
+    double phi = 0.;
+    double r = 0.;
+    double eta2 = 0.;
+    double phi2 = 0.;
+    double r2 = 0.;
+    double deltaR = 0.;
+    double maxCellEnergy = 0.;
+    double logX = 0.;
+    double logY = 0.;
+    double logZ = 0.;
+  };
+
+  /// Number of shape parameters written by addShapeParameters
+  static constexpr unsigned int kNumShapeParameters = 8;
+
+  ClusterMomentsAccumulator() = default;
+
+  /// Reserve space for the given number of cells
+  void reserve(size_t aNumCells) {
+    m_energy.reserve(aNumCells);
+    m_x.reserve(aNumCells);
+    m_y.reserve(aNumCells);
+    m_z.reserve(aNumCells);
+    m_eta.reserve(aNumCells);
+    m_phi.reserve(aNumCells);
+    m_r.reserve(aNumCells);
+    m_energyOffAxis.reserve(aNumCells);
+  }
+
+  /// Remove all cells, keeping the allocated memory
+  void clear() {
+    m_energy.clear();
+    m_x.clear();
+    m_y.clear();
+    m_z.clear();
+    m_eta.clear();
+    m_phi.clear();
+    m_r.clear();
+    m_energyOffAxis.clear();
+  }
+
+  /// Number of cells added
+  size_t size() const { return m_energy.size(); }
+
+  /** Add a cell.
+   *   @param[in] aEnergy, energy of the cell.
+   *   @param[in] aX, aY, aZ, position of the cell.
+   */
+  void add(double aEnergy, double aX, double aY, double aZ) {
+    double rho = std::sqrt(aX * aX + aY * aY);
+    bool offAxis = rho > 0;
+    m_energy.push_back(aEnergy);
+    m_x.push_back(aX);
+    m_y.push_back(aY);
+    m_z.push_back(aZ);
+    m_eta.push_back(offAxis ? std::asinh(aZ / rho) : 0.);
+    m_phi.push_back(offAxis ? std::atan2(aY, aX) : 0.);
+    m_r.push_back(std::sqrt(rho * rho + aZ * aZ));
+    // weight of the cell in the eta and phi moments, cells on the beam axis have no eta and phi
+    m_energyOffAxis.push_back(offAxis ? aEnergy : 0.);
+  }
+
+  /** Compute the moments of the added cells.
+   *   @param[in] aLogWeightW0, W0 parameter of the log-weighted position.
+   *   return moments of the cluster, all zero if no cell was added or the energy sum is zero.
+   */
+  Moments compute(double aLogWeightW0 = 4.2) const {
+    Moments m;
+    const size_t n = m_energy.size();
+    if (n == 0) return m;
+    const double* e = m_energy.data();
+    const double* eAngle = m_energyOffAxis.data();
+    double sumE = 0., sumX = 0., sumY = 0., sumZ = 0., sumR = 0.;
+    double sumEAngle = 0., sumEta = 0.;
+    double maxE = e[0];
+    // first pass: linear sums
+    for (size_t i = 0; i < n; i++) {
+      sumE += e[i];
+      sumX += m_x[i] * e[i];
+      sumY += m_y[i] * e[i];
+      sumZ += m_z[i] * e[i];
+      sumR += m_r[i] * e[i];
+      sumEAngle += eAngle[i];
+      sumEta += m_eta[i] * eAngle[i];
+      maxE = std::max(maxE, e[i]);
+    }
+    m.energy = sumE;
+    m.maxCellEnergy = maxE;
+    if (sumE == 0) return m;
+    m.x = sumX / sumE;
+    m.y = sumY / sumE;
+    m.z = sumZ / sumE;
+    m.r = sumR / sumE;
+    const bool hasAngles = sumEAngle != 0;
+    m.eta = hasAngles ? sumEta / sumEAngle : 0.;
+    const double phiRef = (sumX == 0 && sumY == 0) ? firstPhi() : std::atan2(sumY, sumX);
+    // second pass: second moments around the barycentre (eta, r) and the reference phi, log-weighted position
+    double sumDEta = 0., sumDPhi = 0., sumDR = 0.;
+    double sumDEta2 = 0., sumDPhi2 = 0., sumDR2 = 0.;
+    double sumW = 0., sumWX = 0., sumWY = 0., sumWZ = 0.;
+    const double logSumE = std::log(std::fabs(sumE));
+    for (size_t i = 0; i < n; i++) {
+      double dEta = m_eta[i] - m.eta;
+      double dPhi = wrapPhi(m_phi[i] - phiRef);
+      double dR = m_r[i] - m.r;
+      sumDEta += dEta * eAngle[i];
+      sumDPhi += dPhi * eAngle[i];
+      sumDR += dR * e[i];
+      sumDEta2 += dEta * dEta * eAngle[i];
+      sumDPhi2 += dPhi * dPhi * eAngle[i];
+      sumDR2 += dR * dR * e[i];
+      double w = e[i] > 0 ? std::max(0., aLogWeightW0 + std::log(e[i]) - logSumE) : 0.;
+      sumW += w;
+      sumWX += m_x[i] * w;
+      sumWY += m_y[i] * w;
+      sumWZ += m_z[i] * w;
+    }
+    // the mean offset is subtracted, so that rounding in the mean does not bias the variances
+    m.r2 = (sumDR2 - sumDR * sumDR / sumE) / sumE;
+    double meanDPhi = 0.;
+    if (hasAngles) {
+      meanDPhi = sumDPhi / sumEAngle;
+      m.phi = wrapPhi(phiRef + meanDPhi);
+      m.eta2 = (sumDEta2 - sumDEta * sumDEta / sumEAngle) / sumEAngle;
+      m.phi2 = (sumDPhi2 - sumDPhi * sumDPhi / sumEAngle) / sumEAngle;
+    }
+    if (sumW > 0) {
+      m.logX = sumWX / sumW;
+      m.logY = sumWY / sumW;
+      m.logZ = sumWZ / sumW;
+    } else {
+      m.logX = m.x;
+      m.logY = m.y;
+      m.logZ = m.z;
+    }
+    if (!hasAngles) return m;
+    // third pass: distance to the barycentre in eta-phi
+    double sumDeltaR = 0.;
+    for (size_t i = 0; i < n; i++) {
+      double dEta = m_eta[i] - m.eta;
+      double dPhi = wrapPhi(m_phi[i] - phiRef) - meanDPhi;
+      sumDeltaR += std::sqrt(dEta * dEta + dPhi * dPhi) * eAngle[i];
+    }
+    m.deltaR = sumDeltaR / sumEAngle;
+    return m;
+  }
+
+  /** Set energy and barycentre position of the cluster.
+   *   @param[in] aMoments, moments computed by compute().
+   *   @param[out] aCluster, cluster to be filled.
+   */
+  static void setEnergyAndPosition(const Moments& aMoments, edm4hep::MutableCluster& aCluster) {
+    aCluster.setEnergy(aMoments.energy);
+    aCluster.setPosition(edm4hep::Vector3f(aMoments.x, aMoments.y, aMoments.z));
+  }
+
+  /** Append the shape parameters (see class description for the order).
+   *   @param[in] aMoments, moments computed by compute().
+   *   @param[out] aCluster, cluster to be filled.
+   */
+  static void addShapeParameters(const Moments& aMoments, edm4hep::MutableCluster& aCluster) {
+    aCluster.addToShapeParameters(aMoments.deltaR);
+    aCluster.addToShapeParameters(aMoments.eta2);
+    aCluster.addToShapeParameters(aMoments.phi2);
+    aCluster.addToShapeParameters(aMoments.r2);
+    aCluster.addToShapeParameters(aMoments.maxCellEnergy);
+    aCluster.addToShapeParameters(aMoments.logX);
+    aCluster.addToShapeParameters(aMoments.logY);
+    aCluster.addToShapeParameters(aMoments.logZ);
+  }
+
+private:
+  /// Angle wrapped into [-pi, pi]
+  static double wrapPhi(double aPhi) { return std::remainder(aPhi, 2. * M_PI); }
+  /// Phi of the first cell off the beam axis, reference if the energy-weighted position is on the axis
+  double firstPhi() const {
+    for (size_t i = 0; i < m_energy.size(); i++) {
+      if (m_energyOffAxis[i] != 0) return m_phi[i];
+    }
+    return 0.;
+  }
+
+  std::vector<double> m_energy;
+  std::vector<double> m_x;
+  std::vector<double> m_y;
+  std::vector<double> m_z;
+  std::vector<double> m_eta;
+  std::vector<double> m_phi;
+  std::vector<double> m_r;
+  std::vector<double> m_energyOffAxis;
+};
+
+#endif /* RECCALORIMETER_CLUSTERMOMENTSACCUMULATOR_H */
@@ -0,0 +1,106 @@
+#include "CompareCaloCells.h"
+
+// datamodel
+#include "edm4hep/CalorimeterHitCollection.h"
+
+#include <cmath>
+#include <sstream>
+#include <unordered_map>
+
+DECLARE_COMPONENT(CompareCaloCells)
+
+CompareCaloCells::CompareCaloCells(const std::string& name, ISvcLocator* svcLoc) : GaudiAlgorithm(name, svcLoc) {
+  declareProperty("reference", m_reference, "Cells of the reference configuration (input)");
+  declareProperty("candidate", m_candidate, "Cells of the candidate configuration (input)");
+}
+
+StatusCode CompareCaloCells::initialize() {
+  StatusCode sc = GaudiAlgorithm::initialize();
+  if (sc.isFailure()) return sc;
+  std::ostringstream title;
+  title << "cells " << m_candidate.objKey() << " compared to " << m_reference.objKey() << ", energy tolerance "
+        << m_energyTolerance << " (relative) " << m_absoluteEnergyTolerance << " GeV, position tolerance "
+        << m_positionTolerance << " mm";
+  if (!m_diff.open(m_diffFile, title.str(), m_maxDiffsPerEvent)) {
+    error() << "Unable to write the differences to " << m_diffFile.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_event = 0;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CompareCaloCells::execute() {
+  const edm4hep::CalorimeterHitCollection* reference = m_reference.get();
+  const edm4hep::CalorimeterHitCollection* candidate = m_candidate.get();
+  m_numReference += reference->size();
+  m_numCandidate += candidate->size();
+  m_diff.startEvent(m_event++);
+
+  std::unordered_map<uint64_t, size_t> candidateIndex;
+  candidateIndex.reserve(candidate->size());
+  for (size_t i = 0; i < candidate->size(); i++) {
+    candidateIndex.emplace((*candidate)[i].getCellID(), i);
+  }
+  std::vector<bool> matched(candidate->size(), false);
+  double maxEnergyDiff = 0;
+  for (const auto& cell : *reference) {
+    auto it = candidateIndex.find(cell.getCellID());
+    if (it == candidateIndex.end()) {
+      ++m_numMissing;
+      std::ostringstream message;
+      message << "cell " << cell.getCellID() << " (E = " << cell.getEnergy() << " GeV) missing in the candidate";
+      m_diff.add(message.str());
+      continue;
+    }
+    matched[it->second] = true;
+    const auto& other = (*candidate)[it->second];
+    maxEnergyDiff = std::max<double>(maxEnergyDiff, std::abs(cell.getEnergy() - other.getEnergy()));
+    if (!OutputDiff::agree(cell.getEnergy(), other.getEnergy(), m_energyTolerance, m_absoluteEnergyTolerance)) {
+      ++m_numEnergyDiffs;
+      std::ostringstream message;
+      message.precision(8);
+      message << "cell " << cell.getCellID() << " energy " << cell.getEnergy() << " vs " << other.getEnergy() << " GeV";
+      m_diff.add(message.str());
+    }
+    const auto& position = cell.getPosition();
+    const auto& otherPosition = other.getPosition();
+    double distance = std::sqrt(std::pow(position.x - otherPosition.x, 2) + std::pow(position.y - otherPosition.y, 2) +
+                                std::pow(position.z - otherPosition.z, 2));
+    if (distance > m_positionTolerance) {
+      ++m_numPositionDiffs;
+      std::ostringstream message;
+      message << "cell " << cell.getCellID() << " position (" << position.x << ", " << position.y << ", " << position.z
+              << ") vs (" << otherPosition.x << ", " << otherPosition.y << ", " << otherPosition.z << ") mm";
+      m_diff.add(message.str());
+    }
+  }
+  for (size_t i = 0; i < candidate->size(); i++) {
+    if (matched[i]) continue;
+    ++m_numExtra;
+    std::ostringstream message;
+    message << "cell " << (*candidate)[i].getCellID() << " (E = " << (*candidate)[i].getEnergy()
+            << " GeV) not in the reference";
+    m_diff.add(message.str());
+  }
+  m_maxEnergyDiff += maxEnergyDiff;
+  unsigned numDiffs = m_diff.endEvent();
+  m_eventsWithDiffs += numDiffs > 0;
+  if (numDiffs > 0) {
+    debug() << "Event " << m_event - 1 << ": " << numDiffs << " differences between " << m_candidate.objKey()
+            << " and " << m_reference.objKey() << endmsg;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CompareCaloCells::finalize() {
+  m_diff.close();
+  if (m_eventsWithDiffs.nTrueEntries() > 0) {
+    warning() << m_candidate.objKey() << " differs from " << m_reference.objKey() << " in "
+              << m_eventsWithDiffs.nTrueEntries() << " of " << m_event << " events"
+              << (m_diffFile.value().empty() ? "" : ", see " + m_diffFile.value()) << endmsg;
+  } else {
+    info() << m_candidate.objKey() << " agrees with " << m_reference.objKey() << " in " << m_event << " events"
+           << endmsg;
+  }
+  return GaudiAlgorithm::finalize();
+}
@@ -0,0 +1,77 @@
+#ifndef RECCALORIMETER_COMPARECALOCELLS_H
+#define RECCALORIMETER_COMPARECALOCELLS_H
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+
+// Gaudi
+#include "Gaudi/Accumulators.h"
+#include "GaudiAlg/GaudiAlgorithm.h"
+
+#include "OutputDiff.h"
+
+// datamodel
+namespace edm4hep {
+class CalorimeterHitCollection;
+}
+
+/** @class CompareCaloCells
+ *
+ *  Algorithm comparing the cells of a candidate configuration (e.g. an optimised algorithm) with the cells of a
+ *  reference configuration run on the same events. The cells are matched by cellID; the energies have to agree within
+ *  '\b energyTolerance' (relative) or '\b absoluteEnergyTolerance' (GeV), the positions within '\b positionTolerance'
+ *  (mm). Missing, extra and differing cells are counted in the counters of the algorithm and listed in
+ *  '\b diffFile' (see OutputDiff), so that the differences of a candidate can be inspected.
+ *  Used with CompareCaloClusters in runSyntheticGrid_GoldenOutput.py.
+ */
+
+class CompareCaloCells : public GaudiAlgorithm {
+public:
+  CompareCaloCells(const std::string& name, ISvcLocator* svcLoc);
+
+  StatusCode initialize();
+
+  StatusCode execute();
+
+  StatusCode finalize();
+
+private:
+  /// Handle for the cells of the reference configuration (input)
+  DataHandle<edm4hep::CalorimeterHitCollection> m_reference{"reference", Gaudi::DataHandle::Reader, this};
+  /// Handle for the cells of the candidate configuration (input)
+  DataHandle<edm4hep::CalorimeterHitCollection> m_candidate{"candidate", Gaudi::DataHandle::Reader, this};
+  /// Relative tolerance of the energies
+  Gaudi::Property<double> m_energyTolerance{this, "energyTolerance", 1e-6, "Relative tolerance of the energies"};
+  /// Absolute tolerance of the energies
+  Gaudi::Property<double> m_absoluteEnergyTolerance{this, "absoluteEnergyTolerance", 1e-9,
+                                                    "Absolute tolerance of the energies [GeV]"};
+  /// Tolerance of the positions
+  Gaudi::Property<double> m_positionTolerance{this, "positionTolerance", 1e-3, "Tolerance of the positions [mm]"};
+  /// File with the list of the differences
+  Gaudi::Property<std::string> m_diffFile{this, "diffFile", "", "File with the list of the differences, none if empty"};
+  /// Maximal number of differences listed per event
+  Gaudi::Property<unsigned> m_maxDiffsPerEvent{this, "maxDiffsPerEvent", 20,
+                                               "Maximal number of differences listed per event"};
+  /// List of the differences
+  OutputDiff m_diff;
+  /// Number of the event
+  unsigned long m_event = 0;
+  /// Number of reference cells per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numReference{this, "Reference cells"};
+  /// Number of candidate cells per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numCandidate{this, "Candidate cells"};
+  /// Reference cells missing in the candidate
+  Gaudi::Accumulators::Counter<> m_numMissing{this, "Missing cells"};
+  /// Candidate cells not in the reference
+  Gaudi::Accumulators::Counter<> m_numExtra{this, "Extra cells"};
+  /// Cells with different energies
+  Gaudi::Accumulators::Counter<> m_numEnergyDiffs{this, "Energy differences"};
+  /// Cells with different positions
+  Gaudi::Accumulators::Counter<> m_numPositionDiffs{this, "Position differences"};
+  /// Largest energy difference per event
+  Gaudi::Accumulators::StatCounter<double> m_maxEnergyDiff{this, "Largest energy difference [GeV]"};
+  /// Fraction of events with differences
+  Gaudi::Accumulators::BinomialCounter<> m_eventsWithDiffs{this, "Events with differences"};
+};
+
+#endif /* RECCALORIMETER_COMPARECALOCELLS_H */
@@ -0,0 +1,173 @@
+#include "CompareCaloClusters.h"
+
+// datamodel
+#include "edm4hep/CalorimeterHit.h"
+#include "edm4hep/ClusterCollection.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+#include <unordered_map>
+
+DECLARE_COMPONENT(CompareCaloClusters)
+
+namespace {
+/// Sorted cellIDs of a cluster
+std::vector<uint64_t> cellIds(const edm4hep::Cluster& aCluster) {
+  std::vector<uint64_t> ids;
+  ids.reserve(aCluster.hits_size());
+  for (auto cell = aCluster.hits_begin(); cell != aCluster.hits_end(); ++cell) {
+    ids.push_back(cell->getCellID());
+  }
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+double distance(const edm4hep::Cluster& aCluster, const edm4hep::Cluster& aOther) {
+  const auto& position = aCluster.getPosition();
+  const auto& otherPosition = aOther.getPosition();
+  return std::sqrt(std::pow(position.x - otherPosition.x, 2) + std::pow(position.y - otherPosition.y, 2) +
+                   std::pow(position.z - otherPosition.z, 2));
+}
+}
+
+CompareCaloClusters::CompareCaloClusters(const std::string& name, ISvcLocator* svcLoc)
+    : GaudiAlgorithm(name, svcLoc) {
+  declareProperty("reference", m_reference, "Clusters of the reference configuration (input)");
+  declareProperty("candidate", m_candidate, "Clusters of the candidate configuration (input)");
+}
+
+StatusCode CompareCaloClusters::initialize() {
+  StatusCode sc = GaudiAlgorithm::initialize();
+  if (sc.isFailure()) return sc;
+  std::ostringstream title;
+  title << "clusters " << m_candidate.objKey() << " compared to " << m_reference.objKey() << ", energy tolerance "
+        << m_energyTolerance << " (relative) " << m_absoluteEnergyTolerance << " GeV, position tolerance "
+        << m_positionTolerance << " mm" << (m_compareCells ? ", same cells" : "");
+  if (!m_diff.open(m_diffFile, title.str(), m_maxDiffsPerEvent)) {
+    error() << "Unable to write the differences to " << m_diffFile.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_event = 0;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CompareCaloClusters::execute() {
+  const edm4hep::ClusterCollection* reference = m_reference.get();
+  const edm4hep::ClusterCollection* candidate = m_candidate.get();
+  m_numReference += reference->size();
+  m_numCandidate += candidate->size();
+  m_diff.startEvent(m_event++);
+
+  // candidate clusters of each cell
+  std::vector<std::vector<uint64_t>> candidateCells(candidate->size());
+  std::unordered_map<uint64_t, std::vector<size_t>> clustersOfCell;
+  for (size_t i = 0; i < candidate->size(); i++) {
+    candidateCells[i] = cellIds((*candidate)[i]);
+    for (uint64_t cellId : candidateCells[i]) {
+      clustersOfCell[cellId].push_back(i);
+    }
+  }
+  // reference clusters in decreasing energy, so that the most energetic clusters get their best match
+  std::vector<size_t> order(reference->size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [reference](size_t a, size_t b) {
+    return (*reference)[a].getEnergy() > (*reference)[b].getEnergy();
+  });
+
+  std::vector<bool> matched(candidate->size(), false);
+  for (size_t iReference : order) {
+    const auto& cluster = (*reference)[iReference];
+    std::vector<uint64_t> referenceCells = cellIds(cluster);
+    // unmatched candidate with the most common cells, ties resolved by the lowest index
+    std::unordered_map<size_t, unsigned> commonCells;
+    for (uint64_t cellId : referenceCells) {
+      auto it = clustersOfCell.find(cellId);
+      if (it == clustersOfCell.end()) continue;
+      for (size_t iCandidate : it->second) {
+        if (!matched[iCandidate]) commonCells[iCandidate]++;
+      }
+    }
+    long best = -1;
+    unsigned bestCommon = 0;
+    for (const auto& common : commonCells) {
+      if (common.second > bestCommon || (common.second == bestCommon && long(common.first) < best)) {
+        best = common.first;
+        bestCommon = common.second;
+      }
+    }
+    // closest unmatched candidate, for the clusters without common cells
+    if (best < 0) {
+      double bestDistance = m_matchDistance;
+      for (size_t iCandidate = 0; iCandidate < candidate->size(); iCandidate++) {
+        if (matched[iCandidate]) continue;
+        double dist = distance(cluster, (*candidate)[iCandidate]);
+        if (dist <= bestDistance) {
+          best = iCandidate;
+          bestDistance = dist;
+        }
+      }
+    }
+    if (best < 0) {
+      ++m_numMissing;
+      std::ostringstream message;
+      message << "cluster " << iReference << " (E = " << cluster.getEnergy() << " GeV, " << referenceCells.size()
+              << " cells) missing in the candidate";
+      m_diff.add(message.str());
+      continue;
+    }
+    matched[best] = true;
+    const auto& other = (*candidate)[best];
+    if (!OutputDiff::agree(cluster.getEnergy(), other.getEnergy(), m_energyTolerance, m_absoluteEnergyTolerance)) {
+      ++m_numEnergyDiffs;
+      std::ostringstream message;
+      message.precision(8);
+      message << "cluster " << iReference << " energy " << cluster.getEnergy() << " vs " << other.getEnergy()
+              << " GeV (candidate " << best << ")";
+      m_diff.add(message.str());
+    }
+    double dist = distance(cluster, other);
+    if (dist > m_positionTolerance) {
+      ++m_numPositionDiffs;
+      std::ostringstream message;
+      message << "cluster " << iReference << " position differs by " << dist << " mm (candidate " << best << ")";
+      m_diff.add(message.str());
+    }
+    if (m_compareCells && referenceCells != candidateCells[best]) {
+      ++m_numMembershipDiffs;
+      std::ostringstream message;
+      message << "cluster " << iReference << " has " << referenceCells.size() << " cells, candidate " << best
+              << " has " << candidateCells[best].size() << " cells, " << bestCommon << " in common";
+      m_diff.add(message.str());
+    }
+  }
+  for (size_t i = 0; i < candidate->size(); i++) {
+    if (matched[i]) continue;
+    ++m_numExtra;
+    std::ostringstream message;
+    message << "cluster " << i << " (E = " << (*candidate)[i].getEnergy() << " GeV, " << candidateCells[i].size()
+            << " cells) not in the reference";
+    m_diff.add(message.str());
+  }
+  unsigned numDiffs = m_diff.endEvent();
+  m_eventsWithDiffs += numDiffs > 0;
+  if (numDiffs > 0) {
+    debug() << "Event " << m_event - 1 << ": " << numDiffs << " differences between " << m_candidate.objKey()
+            << " and " << m_reference.objKey() << endmsg;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CompareCaloClusters::finalize() {
+  m_diff.close();
+  if (m_eventsWithDiffs.nTrueEntries() > 0) {
+    warning() << m_candidate.objKey() << " differs from " << m_reference.objKey() << " in "
+              << m_eventsWithDiffs.nTrueEntries() << " of " << m_event << " events"
+              << (m_diffFile.value().empty() ? "" : ", see " + m_diffFile.value()) << endmsg;
+  } else {
+    info() << m_candidate.objKey() << " agrees with " << m_reference.objKey() << " in " << m_event << " events"
+           << endmsg;
+  }
+  return GaudiAlgorithm::finalize();
+}
@@ -0,0 +1,86 @@
+#ifndef RECCALORIMETER_COMPARECALOCLUSTERS_H
+#define RECCALORIMETER_COMPARECALOCLUSTERS_H
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+
+// Gaudi
+#include "Gaudi/Accumulators.h"
+#include "GaudiAlg/GaudiAlgorithm.h"
+
+#include "OutputDiff.h"
+
+// datamodel
+namespace edm4hep {
+class ClusterCollection;
+}
+
+/** @class CompareCaloClusters
+ *
+ *  Algorithm comparing the clusters of a candidate configuration (e.g. an optimised clustering) with the clusters of a
+ *  reference configuration run on the same events.
+ *
+ *  The reference clusters are matched in decreasing energy to the unmatched candidate cluster sharing the most cells.
+ *  Clusters without cells (e.g. sliding window clusters without '\b attachCells') are matched to the closest unmatched
+ *  candidate within '\b matchDistance' (mm). For the matched clusters, the energies have to agree within
+ *  '\b energyTolerance' (relative) or '\b absoluteEnergyTolerance' (GeV), the positions within '\b positionTolerance'
+ *  (mm) and, if '\b compareCells' is set, the cellIDs of the clusters have to be the same. Missing, extra and
+ *  differing clusters are counted in the counters of the algorithm and listed in '\b diffFile' (see OutputDiff).
+ *  Used with CompareCaloCells in runSyntheticGrid_GoldenOutput.py.
+ */
+
+class CompareCaloClusters : public GaudiAlgorithm {
+public:
+  CompareCaloClusters(const std::string& name, ISvcLocator* svcLoc);
+
+  StatusCode initialize();
+
+  StatusCode execute();
+
+  StatusCode finalize();
+
+private:
+  /// Handle for the clusters of the reference configuration (input)
+  DataHandle<edm4hep::ClusterCollection> m_reference{"reference", Gaudi::DataHandle::Reader, this};
+  /// Handle for the clusters of the candidate configuration (input)
+  DataHandle<edm4hep::ClusterCollection> m_candidate{"candidate", Gaudi::DataHandle::Reader, this};
+  /// Relative tolerance of the energies
+  Gaudi::Property<double> m_energyTolerance{this, "energyTolerance", 1e-6, "Relative tolerance of the energies"};
+  /// Absolute tolerance of the energies
+  Gaudi::Property<double> m_absoluteEnergyTolerance{this, "absoluteEnergyTolerance", 1e-9,
+                                                    "Absolute tolerance of the energies [GeV]"};
+  /// Tolerance of the positions
+  Gaudi::Property<double> m_positionTolerance{this, "positionTolerance", 1e-3, "Tolerance of the positions [mm]"};
+  /// Maximal distance of the clusters matched by position
+  Gaudi::Property<double> m_matchDistance{this, "matchDistance", 100,
+                                          "Maximal distance of the clusters without common cells to be matched [mm]"};
+  /// Compare the cells of the matched clusters
+  Gaudi::Property<bool> m_compareCells{this, "compareCells", true, "Compare the cellIDs of the matched clusters"};
+  /// File with the list of the differences
+  Gaudi::Property<std::string> m_diffFile{this, "diffFile", "", "File with the list of the differences, none if empty"};
+  /// Maximal number of differences listed per event
+  Gaudi::Property<unsigned> m_maxDiffsPerEvent{this, "maxDiffsPerEvent", 20,
+                                               "Maximal number of differences listed per event"};
+  /// List of the differences
+  OutputDiff m_diff;
+  /// Number of the event
+  unsigned long m_event = 0;
+  /// Number of reference clusters per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numReference{this, "Reference clusters"};
+  /// Number of candidate clusters per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numCandidate{this, "Candidate clusters"};
+  /// Reference clusters without candidate
+  Gaudi::Accumulators::Counter<> m_numMissing{this, "Missing clusters"};
+  /// Candidate clusters without reference
+  Gaudi::Accumulators::Counter<> m_numExtra{this, "Extra clusters"};
+  /// Matched clusters with different energies
+  Gaudi::Accumulators::Counter<> m_numEnergyDiffs{this, "Energy differences"};
+  /// Matched clusters with different positions
+  Gaudi::Accumulators::Counter<> m_numPositionDiffs{this, "Position differences"};
+  /// Matched clusters with different cells
+  Gaudi::Accumulators::Counter<> m_numMembershipDiffs{this, "Membership differences"};
+  /// Fraction of events with differences
+  Gaudi::Accumulators::BinomialCounter<> m_eventsWithDiffs{this, "Events with differences"};
+};
+
+#endif /* RECCALORIMETER_COMPARECALOCLUSTERS_H */
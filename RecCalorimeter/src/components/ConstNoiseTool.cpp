@@ -65,8 +65,9 @@ double ConstNoiseTool::getNoiseConstantPerCell(uint64_t aCellId) {
   dd4hep::DDSegmentation::CellID cID = aCellId;
   unsigned cellSystem = m_decoder->get(cID, "system");
   // cell noise in system
-  if (m_systemNoiseConstMap[cellSystem])
-    Noise = m_systemNoiseConstMap[cellSystem];
+  auto it = m_systemNoiseConstMap.find(cellSystem);
+  if (it != m_systemNoiseConstMap.end() && it->second)
+    Noise = it->second;
   else
     warning() << "No noise constants set for this subsystem! Noise of cell set to 0. " << endmsg;
   return Noise;
@@ -79,8 +80,9 @@ double ConstNoiseTool::getNoiseOffsetPerCell(uint64_t aCellId) {
   dd4hep::DDSegmentation::CellID cID = aCellId;
   unsigned cellSystem = m_decoder->get(cID, "system");
   // cell noise in system
-  if (m_systemNoiseOffsetMap[cellSystem])
-    Noise = m_systemNoiseOffsetMap[cellSystem];
+  auto it = m_systemNoiseOffsetMap.find(cellSystem);
+  if (it != m_systemNoiseOffsetMap.end() && it->second)
+    Noise = it->second;
   else
     warning() << "No noise constants set for this subsystem! Noise of cell set to 0. " << endmsg;
   return Noise;
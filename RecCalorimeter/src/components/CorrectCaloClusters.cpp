@@ -12,6 +12,7 @@
 
 // DD4hep
 #include "DD4hep/Detector.h"
+#include "DDSegmentation/BitFieldCoder.h"
 #include "DDSegmentation/MultiSegmentation.h"
 
 // our EDM
@@ -42,13 +43,24 @@ StatusCode CorrectCaloClusters::initialize() {
     return sc;
   }
 
-  // Check if readouts exist
-  {
+  // Decoders of the readouts, from the given encodings or from the geometry
+  if (!m_readoutEncodings.empty()) {
+    if (m_readoutEncodings.size() != m_readoutNames.size()) {
+      error() << "Sizes of the readoutEncodings vector and readoutNames vector does not match, exiting!" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    for (const auto& encoding : m_readoutEncodings) {
+      m_ownedDecoders.emplace_back(std::make_unique<dd4hep::DDSegmentation::BitFieldCoder>(encoding));
+      m_decoders.push_back(m_ownedDecoders.back().get());
+    }
+  } else {
     bool readoutMissing = false;
     for (size_t i = 0; i < m_readoutNames.size(); ++i) {
       auto readouts = m_geoSvc->lcdd()->readouts();
       if (readouts.find(m_readoutNames.value().at(i)) == readouts.end()) {
         readoutMissing = true;
+      } else {
+        m_decoders.push_back(m_geoSvc->lcdd()->readout(m_readoutNames.value().at(i)).idSpec().decoder());
       }
     }
     if (readoutMissing) {
@@ -238,7 +250,7 @@ StatusCode CorrectCaloClusters::applyUpstreamCorr(const edm4hep::ClusterCollecti
   for (size_t i = 0; i < m_readoutNames.size(); ++i) {
     for (size_t j = 0; j < inClusters->size(); ++j) {
       double energyInFirstLayer = getEnergyInLayer(inClusters->at(j),
-                                                   m_readoutNames[i],
+                                                   m_decoders[i],
                                                    m_systemIDs[i],
                                                    m_firstLayerIDs[i]);
       if (energyInFirstLayer < 0) {
@@ -275,7 +287,7 @@ StatusCode CorrectCaloClusters::applyDownstreamCorr(const edm4hep::ClusterCollec
   for (size_t i = 0; i < m_readoutNames.size(); ++i) {
     for (size_t j = 0; j < inClusters->size(); ++j) {
       double energyInLastLayer = getEnergyInLayer(inClusters->at(j),
-                                                  m_readoutNames[i],
+                                                  m_decoders[i],
                                                   m_systemIDs[i],
                                                   m_lastLayerIDs[i]);
       if (energyInLastLayer < 0) {
@@ -308,11 +320,9 @@ StatusCode CorrectCaloClusters::applyDownstreamCorr(const edm4hep::ClusterCollec
 
 
 double CorrectCaloClusters::getEnergyInLayer(edm4hep::Cluster cluster,
-                                             const std::string& readoutName,
+                                             const dd4hep::DDSegmentation::BitFieldCoder* decoder,
                                              size_t systemID,
                                              size_t layerID) {
-  dd4hep::DDSegmentation::BitFieldCoder* decoder = m_geoSvc->lcdd()->readout(readoutName).idSpec().decoder();
-
   double energy = 0;
   for (auto cell = cluster.hits_begin(); cell != cluster.hits_end(); ++cell) {
     dd4hep::DDSegmentation::CellID cellID = cell->getCellID();
@@ -27,14 +27,16 @@ namespace edm4hep {
 }
 
 // DD4HEP
+#include "DDSegmentation/BitFieldCoder.h"
 namespace dd4hep {
   namespace DDSegmentation {
     class FCCSWGridPhiEta;
     class MultiSegmentation;
-    class BitFieldCoder;
   }
 }
 
+#include <memory>
+
 /** @class CorrectCaloClusters
  *
  *  Apply corrections to the clusters reconstructed in ECAL.
@@ -45,6 +47,9 @@ namespace dd4hep {
  *    instrumentation behind the active volume of the calorimeter. It is parametrized in one (cluster energy) or two
  *    variables (cluster energy, cluster angle)
  *
+ *  The energies in the layers are found by decoding the cell IDs with the readouts of the geometry service, or with
+ *  the encodings given in '\b readoutEncodings' (e.g. for synthetic events, without detector description).
+ *
  *  Based on similar corrections by Jana Faltova and Anna Zaborowska.
  *
  *  @author Juraj Smiesko
@@ -108,13 +113,14 @@ private:
    * This energy is not calibrated.
    *
    * @param[in]  cluster       Pointer to cluster of interest.
-   * @param[in]  readoutName   Name of the readout.
+   * @param[in]  decoder       Decoder of the readout.
+   * @param[in]  systemID      ID of the system of the readout.
    * @param[in]  layerID       ID of the layer of the readout.
    *
    * @return                   Energy in layer.
    */
   double getEnergyInLayer(edm4hep::Cluster cluster,
-                          const std::string& readoutName,
+                          const dd4hep::DDSegmentation::BitFieldCoder* decoder,
                           size_t systemID,
                           size_t layerID);
 
@@ -152,6 +158,15 @@ private:
       this, "readoutNames", {"ECalBarrelPhiEta"},
       "Names of the detector readout, corresponding to systemID"
   };
+  /// Cell ID encodings of the readouts (optional), corresponding to system IDs, used instead of the geometry
+  Gaudi::Property<std::vector<std::string>> m_readoutEncodings {
+      this, "readoutEncodings", {},
+      "Cell ID encodings of the readouts, corresponding to systemID; if set, the geometry service is not used"
+  };
+  /// Decoders of the readouts, corresponding to system IDs
+  std::vector<const dd4hep::DDSegmentation::BitFieldCoder*> m_decoders;
+  /// Decoders created from the readout encodings
+  std::vector<std::unique_ptr<dd4hep::DDSegmentation::BitFieldCoder>> m_ownedDecoders;
   /// Numbers of layers of the detectors
   Gaudi::Property<std::vector<size_t>> m_numLayers {
       this, "numLayers", {12}, "Numbers of layers of the systems"};
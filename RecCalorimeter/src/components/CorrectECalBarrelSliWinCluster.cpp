@@ -361,7 +361,7 @@ StatusCode CorrectECalBarrelSliWinCluster::execute() {
       noise = m_constPileupNoise * m_gauss.shoot() * std::sqrt(static_cast<int>(m_mu));
     }
     newCluster.setEnergy(newCluster.getEnergy() + noise);
-    m_hPileupEnergy->Fill(noise);
+    m_histogramFills.fill(m_hPileupEnergy, noise);
 
     // 3. Correct for energy upstream
     // correct for presampler based on energy in the first layer layer:
@@ -384,38 +384,41 @@ StatusCode CorrectECalBarrelSliWinCluster::execute() {
     double presamplerShift = P00 + P01 * cluster.getEnergy();
     double presamplerScale = P10 + P11 * sqrt(cluster.getEnergy());
     double energyFront = presamplerShift + presamplerScale * sumEnFirstLayer * m_samplingFraction[0];
-    m_hUpstreamEnergy->Fill(energyFront);
+    m_histogramFills.fill(m_hUpstreamEnergy, energyFront);
     newCluster.setEnergy(newCluster.getEnergy() + energyFront);
 
     // Fill histograms
-    m_hEnergyPreAnyCorrections->Fill(oldEnergy);
-    m_hEnergyPostAllCorrections->Fill(newCluster.getEnergy());
-    m_hEnergyPostAllCorrectionsAndScaling->Fill(newCluster.getEnergy() / m_response);
+    m_histogramFills.fill(m_hEnergyPreAnyCorrections, oldEnergy);
+    m_histogramFills.fill(m_hEnergyPostAllCorrections, newCluster.getEnergy());
+    m_histogramFills.fill(m_hEnergyPostAllCorrectionsAndScaling, newCluster.getEnergy() / m_response);
 
     // Position resolution
-    m_hEta->Fill(newEta);
-    m_hPhi->Fill(phi);
+    m_histogramFills.fill(m_hEta, newEta);
+    m_histogramFills.fill(m_hPhi, phi);
     verbose() << " energy " << energy << "   numCells = " << numCells << " old energy = " << oldEnergy <<
       " newEta " << newEta << "   phi = " << phi << " theta = " << 2 * atan( exp( - newEta ) ) << endmsg;
-    m_hNumCells->Fill(numCells);
+    m_histogramFills.fill(m_hNumCells, numCells);
     // Fill histograms for single particle events
     if (particle->size() == 1) {
-      m_hDiffEta->Fill(newEta - etaVertex);
-      m_hDiffEtaResWeight->Fill(newEtaErrorRes - etaVertex);
-      m_hDiffEtaResWeight2point->Fill(newEtaErrorRes2point - etaVertex);
+      m_histogramFills.fill(m_hDiffEta, newEta - etaVertex);
+      m_histogramFills.fill(m_hDiffEtaResWeight, newEtaErrorRes - etaVertex);
+      m_histogramFills.fill(m_hDiffEtaResWeight2point, newEtaErrorRes2point - etaVertex);
       for(uint iLayer = 0; iLayer < m_numLayers; iLayer++) {
-        m_hDiffEtaLayer[iLayer]->Fill(sumEtaLayer[iLayer] - etaVertex);
+        m_histogramFills.fill(m_hDiffEtaLayer[iLayer], sumEtaLayer[iLayer] - etaVertex);
         if (energy > 0)
-          m_hEnergyFractionInLayers->Fill(iLayer+1, sumEnLayer[iLayer] / energy);
+          m_histogramFills.fill(m_hEnergyFractionInLayers, iLayer+1, sumEnLayer[iLayer] / energy);
       }
-      m_hDiffPhi->Fill(phi - phiVertex);
+      m_histogramFills.fill(m_hDiffPhi, phi - phiVertex);
     }
   }
 
   return StatusCode::SUCCESS;
 }
 
-StatusCode CorrectECalBarrelSliWinCluster::finalize() { return GaudiAlgorithm::finalize(); }
+StatusCode CorrectECalBarrelSliWinCluster::finalize() {
+  m_histogramFills.flush();
+  return GaudiAlgorithm::finalize();
+}
 
 StatusCode CorrectECalBarrelSliWinCluster::initNoiseFromFile() {
   // check if file exists
@@ -30,6 +30,8 @@ class BitFieldCoder;
 
 #include "TH1F.h"
 
+#include "HistogramFillBuffer.h"
+
 /** @class CorrectECalBarrelSliWinCluster
  *
  *  Apply corrections to a reconstructed cluster in EMCal barrel.
@@ -159,6 +161,8 @@ private:
   std::map<uint, dd4hep::DDSegmentation::BitFieldCoder*> m_decoder;
   /// Histogram of pileup noise added to energy of clusters
   TH1F* m_hPileupEnergy;
+  /// Buffer of the histogram fills in the event loop, merged into the histograms at the latest in finalize
+  HistogramFillBuffer m_histogramFills{this};
   /// Random Number Service
   IRndmGenSvc* m_randSvc;
   /// Gaussian random number generator used for the generation of random noise hits
@@ -0,0 +1,57 @@
+#include "CreateCaloCellSoA.h"
+
+// datamodel
+#include "edm4hep/CalorimeterHitCollection.h"
+
+DECLARE_COMPONENT(CreateCaloCellSoA)
+
+CreateCaloCellSoA::CreateCaloCellSoA(const std::string& name, ISvcLocator* svcLoc) : GaudiAlgorithm(name, svcLoc) {
+  declareProperty("cellSoA", m_cellSoA, "The cells as structure of arrays (output)");
+}
+
+StatusCode CreateCaloCellSoA::initialize() {
+  StatusCode sc = GaudiAlgorithm::initialize();
+  if (sc.isFailure()) return sc;
+  if (m_cellCollectionNames.empty()) {
+    error() << "No cell collections to convert, set property cells!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  for (const auto& name : m_cellCollectionNames) {
+    m_cellCollections.push_back(
+        new DataHandle<edm4hep::CalorimeterHitCollection>(name, Gaudi::DataHandle::Reader, this));
+  }
+  info() << "Converting " << m_cellCollectionNames.size() << " cell collections to " << m_cellSoA.objKey()
+         << (m_time ? " with" : " without") << " times and" << (m_positions ? " with" : " without") << " positions"
+         << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CreateCaloCellSoA::execute() {
+  StageTimer timer(m_timeConvert);
+  unsigned columns = (m_time ? CaloCellSoA::kTime : 0) | (m_positions ? CaloCellSoA::kPosition : 0);
+  CaloCellSoA* cells = new CaloCellSoA(columns);
+  std::vector<const edm4hep::CalorimeterHitCollection*> inCells;
+  size_t numCells = 0;
+  for (auto handle : m_cellCollections) {
+    inCells.push_back(handle->get());
+    numCells += inCells.back()->size();
+  }
+  cells->reserve(numCells);
+  for (auto collection : inCells) {
+    cells->append(*collection);
+  }
+  // the cells of the collections are in no particular order (e.g. of an unordered map in CreateCaloCells)
+  cells->sortByCellId();
+  timer.stop();
+  debug() << "Converted " << cells->size() << " cells" << endmsg;
+  m_numCells += cells->size();
+  m_memoryCells += MemoryUsage::kiloBytes(cells->heapBytes());
+  m_cellSoA.put(cells);
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CreateCaloCellSoA::finalize() {
+  for (auto handle : m_cellCollections) delete handle;
+  m_cellCollections.clear();
+  return GaudiAlgorithm::finalize();
+}
@@ -0,0 +1,55 @@
+#ifndef RECCALORIMETER_CREATECALOCELLSOA_H
+#define RECCALORIMETER_CREATECALOCELLSOA_H
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+
+// Gaudi
+#include "GaudiAlg/GaudiAlgorithm.h"
+
+#include "CaloCellSoA.h"
+#include "MemoryUsage.h"
+#include "StageTimer.h"
+
+/** @class CreateCaloCellSoA
+ *
+ *  Algorithm converting calorimeter cell collections into one CaloCellSoA object of the event store (see
+ *  CaloCellSoA.h), sorted by cellID, so that the following algorithms and tools read the cells of all systems from
+ *  contiguous columns instead of building their own maps.
+ *  The time and position columns are filled only if "time" and "positions" are set.
+ *
+ *  The cells, the heap memory of the columns and the conversion time are recorded in counters.
+ *
+ */
+
+class CreateCaloCellSoA : public GaudiAlgorithm {
+
+public:
+  CreateCaloCellSoA(const std::string& name, ISvcLocator* svcLoc);
+
+  StatusCode initialize();
+
+  StatusCode execute();
+
+  StatusCode finalize();
+
+private:
+  /// Handles for the calo cells (input collections)
+  std::vector<DataHandle<edm4hep::CalorimeterHitCollection>*> m_cellCollections;
+  /// Names of the cell collections to convert
+  Gaudi::Property<std::vector<std::string>> m_cellCollectionNames{this, "cells", {}, "Names of the cell collections to convert"};
+  /// Handle for the cells as structure of arrays (output)
+  DataHandle<CaloCellSoA> m_cellSoA{"cellSoA", Gaudi::DataHandle::Writer, this};
+  /// Fill the time column
+  Gaudi::Property<bool> m_time{this, "time", false, "Fill the time column"};
+  /// Fill the position columns
+  Gaudi::Property<bool> m_positions{this, "positions", false, "Fill the position columns"};
+  /// Number of cells per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numCells{this, "Cells"};
+  /// Heap memory of the columns per event
+  MemoryUsage::Counter m_memoryCells{this, "Memory cell SoA [kB]"};
+  /// Time to convert the collections
+  StageTimer::Counter m_timeConvert{this, "Time convert [us]"};
+};
+
+#endif /* RECCALORIMETER_CREATECALOCELLSOA_H */
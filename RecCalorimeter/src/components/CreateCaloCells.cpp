@@ -53,11 +53,20 @@ StatusCode CreateCaloCells::initialize() {
       error() << "Unable to retrieve the geometry tool!!!" << endmsg;
       return StatusCode::FAILURE;
     }
-    // Prepare map of all existing cells in calorimeter to add noise to all
-    StatusCode sc_prepareCells = m_geoTool->prepareEmptyCells(m_cellsMap);
-    if (sc_prepareCells.isFailure()) {
-      error() << "Unable to create empty cells!" << endmsg;
-      return StatusCode::FAILURE;
+    // Prepare map of all existing cells in calorimeter to add noise to all, checked at start
+    bool async = m_emptyCellsLoad.start(
+        [this]() {
+          StatusCode sc_prepareCells = m_geoTool->prepareEmptyCells(m_cellsMap.emptyCells());
+          if (sc_prepareCells.isFailure()) return sc_prepareCells;
+          double memory = MemoryUsage::kiloBytes(MemoryUsage::heapBytes(m_cellsMap.emptyCells()));
+          m_memoryEmptyCells += memory;
+          info() << "Map of empty cells: " << m_cellsMap.emptyCells().size() << " cells, " << memory << " kB" << endmsg;
+          return StatusCode::SUCCESS;
+        },
+        m_asyncInitialize);
+    if (!async && m_asyncInitialize) {
+      warning() << "ROOT thread safety is not enabled in the job options (ROOT.EnableThreadSafety()), "
+              << "the map of all cells is prepared serially" << endmsg;
     }
   }
   if (m_addPosition){
@@ -66,43 +75,58 @@ StatusCode CreateCaloCells::initialize() {
   return StatusCode::SUCCESS;
 }
 
+StatusCode CreateCaloCells::start() {
+  StatusCode sc = GaudiAlgorithm::start();
+  if (sc.isFailure()) return sc;
+  if (m_emptyCellsLoad.wait().isFailure()) {
+    error() << "Unable to create empty cells!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return sc;
+}
+
 StatusCode CreateCaloCells::execute() {
   // Get the input collection with Geant4 hits
   const edm4hep::SimCalorimeterHitCollection* hits = m_hits.get();
   debug() << "Input Hit collection size: " << hits->size() << endmsg;
+  m_numHits += hits->size();
 
-  // 0. Clear all cells
-  if (m_addCellNoise) {
-    std::for_each(m_cellsMap.begin(), m_cellsMap.end(), [](std::pair<const uint64_t, double>& p) { p.second = 0; });
-  } else {
-    m_cellsMap.clear();
-  }
+  // 0. Start from all cells with zero energy if noise is added, from no cells otherwise
+  StageTimer resetTimer(m_timeReset);
+  std::unordered_map<uint64_t, double>& cellsMap = m_cellsMap.reset();
+  resetTimer.stop();
 
   // 1. Merge energy deposits into cells
   // If running with noise map already was prepared. Otherwise it is being
   // created below
+  StageTimer mergeTimer(m_timeMerge);
   for (const auto& hit : *hits) {
     verbose() << "CellID : " << hit.getCellID() << endmsg;
-    m_cellsMap[hit.getCellID()] += hit.getEnergy();
+    m_cellsMap.add(hit.getCellID(), hit.getEnergy());
   }
-  debug() << "Number of calorimeter cells after merging of hits: " << m_cellsMap.size() << endmsg;
+  mergeTimer.stop();
+  debug() << "Number of calorimeter cells after merging of hits: " << cellsMap.size() << endmsg;
 
   // 2. Calibrate simulation energy to EM scale
   if (m_doCellCalibration) {
-    m_calibTool->calibrate(m_cellsMap);
+    StageTimer timer(m_timeCalibration);
+    m_calibTool->calibrate(cellsMap);
   }
 
   // 3. Add noise to all cells
   if (m_addCellNoise) {
-    m_noiseTool->addRandomCellNoise(m_cellsMap);
+    StageTimer timer(m_timeNoise);
+    m_noiseTool->addRandomCellNoise(cellsMap);
     if (m_filterCellNoise) {
-      m_noiseTool->filterCellNoise(m_cellsMap);
+      m_noiseTool->filterCellNoise(cellsMap);
     }
   }
+  m_memoryCells += MemoryUsage::kiloBytes(MemoryUsage::heapBytes(cellsMap));
 
   // 4. Copy information to CaloHitCollection
+  StageTimer outputTimer(m_timeOutput);
   edm4hep::CalorimeterHitCollection* edmCellsCollection = new edm4hep::CalorimeterHitCollection();
-  for (const auto& cell : m_cellsMap) {
+  for (const auto& cell : cellsMap) {
     if (m_addCellNoise || (!m_addCellNoise && cell.second != 0)) {
       auto newCell = edmCellsCollection->create();
       newCell.setEnergy(cell.second);
@@ -122,9 +146,14 @@ StatusCode CreateCaloCells::execute() {
 
   // push the CaloHitCollection to event store
   m_cells.put(edmCellsCollection);
+  outputTimer.stop();
+  m_numCells += edmCellsCollection->size();
   debug() << "Output Cell collection size: " << edmCellsCollection->size() << endmsg;
 
   return StatusCode::SUCCESS;
 }
 
-StatusCode CreateCaloCells::finalize() { return GaudiAlgorithm::finalize(); }
+StatusCode CreateCaloCells::finalize() {
+  info() << "Peak memory of the cells map: " << m_memoryCells.max() << " kB" << endmsg;
+  return GaudiAlgorithm::finalize();
+}
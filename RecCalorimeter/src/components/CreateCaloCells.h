@@ -7,6 +7,11 @@
 #include "k4Interface/ICalorimeterTool.h"
 #include "k4Interface/INoiseCaloCellsTool.h"
 
+#include "AsyncLoad.h"
+#include "CellsMapScratch.h"
+#include "MemoryUsage.h"
+#include "StageTimer.h"
+
 // Gaudi
 #include "GaudiAlg/GaudiAlgorithm.h"
 #include "GaudiKernel/ToolHandle.h"
@@ -33,6 +38,12 @@ class IGeoSvc;
  *  3/ Add random noise to each cell (if noise switched on)
  *  4/ Filter cells and remove those with energy below threshold (if noise +
  * filtering switched on)
+ *  The time of each step and the number of hits and cells per event are recorded in counters printed at finalize.
+ *  With noise, each event starts from all cells with zero energy: the map of the cells is kept from event to event
+ *  and reset in place (see CellsMapScratch), the cells removed by the filtering of one event are inserted back, so
+ *  that they still get noise in the next events. The reset is timed in "Time reset cells map".
+ *  With '\b asyncInitialize', the map of all cells needed for the noise is prepared asynchronously (see AsyncLoad),
+ *  joined at start.
  *
  *  Tools called:
  *    - CalibrateCaloHitsTool
@@ -51,6 +62,8 @@ public:
 
   StatusCode initialize();
 
+  StatusCode start();
+
   StatusCode execute();
 
   StatusCode finalize();
@@ -72,6 +85,32 @@ private:
                                           "Save only cells with energy above threshold?"};
   // Add position information to the cells? (based on Volumes, not cells, could be improved)
   Gaudi::Property<bool> m_addPosition{this, "addPosition", false, "Add position information to the cells?"};
+  /// Prepare the map of all cells asynchronously
+  Gaudi::Property<bool> m_asyncInitialize{this, "asyncInitialize", false,
+                                          "Prepare the map of all cells asynchronously, joined before the first event"};
+
+  /// Time to reset the map of the cells at the start of an event
+  StageTimer::Counter m_timeReset{this, "Time reset cells map [us]"};
+  /// Time to merge the hits into cells
+  StageTimer::Counter m_timeMerge{this, "Time merge [us]"};
+  /// Time to calibrate the cells
+  StageTimer::Counter m_timeCalibration{this, "Time calibration [us]"};
+  /// Time to add the noise and filter the cells
+  StageTimer::Counter m_timeNoise{this, "Time noise [us]"};
+  /// Time to create the output cells
+  StageTimer::Counter m_timeOutput{this, "Time output [us]"};
+  /// Number of input hits per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numHits{this, "Hits"};
+  /// Number of output cells per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numCells{this, "Cells"};
+  /// Estimated memory of the map of empty cells
+  MemoryUsage::Counter m_memoryEmptyCells{this, "Memory empty cells map [kB]"};
+  /// Estimated memory of the cells map per event
+  MemoryUsage::Counter m_memoryCells{this, "Memory cells map [kB]"};
+  /// Time to prepare the map of all cells
+  StageTimer::Counter m_timeEmptyCells{this, "Time empty cells map [us]"};
+  /// Time spent waiting for the map of all cells
+  StageTimer::Counter m_timeWaitEmptyCells{this, "Time wait for empty cells map [us]"};
 
   /// Handle for calo hits (input collection)
   DataHandle<edm4hep::SimCalorimeterHitCollection> m_hits{"hits", Gaudi::DataHandle::Reader, this};
@@ -108,8 +147,10 @@ private:
   /// Pointer to the geometry service
   ServiceHandle<IGeoSvc> m_geoSvc;
   dd4hep::VolumeManager m_volman;
-  /// Map of cell IDs (corresponding to DD4hep IDs) and energy
-  std::unordered_map<uint64_t, double> m_cellsMap;
+  /// Map of the cells of the event, starting from all existing cell IDs with zero energy when noise is added
+  CellsMapScratch m_cellsMap;
+  /// Preparation of the map of all cells
+  AsyncLoad m_emptyCellsLoad{m_timeEmptyCells, m_timeWaitEmptyCells};
 };
 
 #endif /* RECCALORIMETER_CREATECALOCELLS_H */
@@ -0,0 +1,24 @@
+#include "CreateCaloCellsFromSoA.h"
+
+// datamodel
+#include "edm4hep/CalorimeterHitCollection.h"
+
+DECLARE_COMPONENT(CreateCaloCellsFromSoA)
+
+CreateCaloCellsFromSoA::CreateCaloCellsFromSoA(const std::string& name, ISvcLocator* svcLoc)
+    : GaudiAlgorithm(name, svcLoc) {
+  declareProperty("cellSoA", m_cellSoA, "The cells as structure of arrays (input)");
+  declareProperty("cells", m_cells, "The calorimeter cells (output)");
+}
+
+StatusCode CreateCaloCellsFromSoA::initialize() { return GaudiAlgorithm::initialize(); }
+
+StatusCode CreateCaloCellsFromSoA::execute() {
+  const CaloCellSoA* cellSoA = m_cellSoA.get();
+  auto edmCells = m_cells.createAndPut();
+  cellSoA->toCollection(*edmCells);
+  debug() << "Output cell collection size: " << edmCells->size() << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CreateCaloCellsFromSoA::finalize() { return GaudiAlgorithm::finalize(); }
@@ -0,0 +1,44 @@
+#ifndef RECCALORIMETER_CREATECALOCELLSFROMSOA_H
+#define RECCALORIMETER_CREATECALOCELLSFROMSOA_H
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+
+// Gaudi
+#include "GaudiAlg/GaudiAlgorithm.h"
+
+#include "CaloCellSoA.h"
+
+// datamodel
+namespace edm4hep {
+class CalorimeterHitCollection;
+}
+
+/** @class CreateCaloCellsFromSoA
+ *
+ *  Algorithm converting the cells of a CaloCellSoA object of the event store (see CaloCellSoA.h) back into a
+ *  CalorimeterHitCollection, e.g. to write them to the output file or to run algorithms reading cell collections.
+ *  The cells are written in the order of the columns (by cellID), time and position are set if their columns are
+ *  filled.
+ *
+ */
+
+class CreateCaloCellsFromSoA : public GaudiAlgorithm {
+
+public:
+  CreateCaloCellsFromSoA(const std::string& name, ISvcLocator* svcLoc);
+
+  StatusCode initialize();
+
+  StatusCode execute();
+
+  StatusCode finalize();
+
+private:
+  /// Handle for the cells as structure of arrays (input)
+  DataHandle<CaloCellSoA> m_cellSoA{"cellSoA", Gaudi::DataHandle::Reader, this};
+  /// Handle for the calo cells (output collection)
+  DataHandle<edm4hep::CalorimeterHitCollection> m_cells{"cells", Gaudi::DataHandle::Writer, this};
+};
+
+#endif /* RECCALORIMETER_CREATECALOCELLSFROMSOA_H */
@@ -175,7 +175,7 @@ StatusCode CreateCaloClusters::execute() {
 
   if(m_doCalibration) { 
     for (auto cluster : *clusters) {
-      m_clusterEnergy->Fill(cluster.getEnergy());
+      m_histogramFills.fill(m_clusterEnergy, cluster.getEnergy());
       // 1. Identify clusters with cells in different sub-systems
       bool cellsInBoth = false;
       std::map<uint,double> energyBoth;
@@ -185,11 +185,11 @@ StatusCode CreateCaloClusters::execute() {
       double lastBenchmarkTerm = 0.;
       if (cluster.getEnergy() > 1){
 	nClusters_1GeV++;
-	m_energyCalibCluster_1GeV->Fill(cluster.getEnergy());
+	m_histogramFills.fill(m_energyCalibCluster_1GeV, cluster.getEnergy());
       }
       if (cluster.getEnergy() > Etruth/2.){
 	nClusters_halfTrueEnergy++;
-	m_energyCalibCluster_halfTrueEnergy->Fill(cluster.getEnergy());
+	m_histogramFills.fill(m_energyCalibCluster_halfTrueEnergy, cluster.getEnergy());
       }
       // Loop over cluster cells 
       for (uint it = 0; it < cluster.hits_size(); it++){
@@ -225,7 +225,7 @@ StatusCode CreateCaloClusters::execute() {
       // 2. Calibrate the cluster if it contains cells in both systems
       if(cellsInBoth) {
 	sharedClusters ++;
-	m_sharedClusterEnergy->Fill(cluster.getEnergy());
+	m_histogramFills.fill(m_sharedClusterEnergy, cluster.getEnergy());
 	// Calculate the fraction of energy in ECal
 	auto energyFraction = energyBoth[m_systemIdECal] / cluster.getEnergy();
 	debug() << "Energy fraction in ECal : " << energyFraction << endmsg;
@@ -234,8 +234,8 @@ StatusCode CreateCaloClusters::execute() {
 	energyBoth[m_systemIdECal] = energyBoth[m_systemIdECal] * m_ehECal;
 	bool calibECal = true;
 	clustersHad++;
-	m_energyScale->Fill(1);
-	m_energyScaleVsClusterEnergy->Fill(1.,cluster.getEnergy());
+	m_histogramFills.fill(m_energyScale, 1);
+	m_histogramFills.fill(m_energyScaleVsClusterEnergy, 1.,cluster.getEnergy());
 	totClusterEnergy += cluster.getEnergy();
 	
 	// Building new calibrated cluster
@@ -285,7 +285,7 @@ StatusCode CreateCaloClusters::execute() {
 	  energy += cellEnergy;
 	}
 	// Fill histogram with calibrated energy
-	m_clusterEnergyCalibrated->Fill(energy);
+	m_histogramFills.fill(m_clusterEnergyCalibrated, energy);
 	totCalibClusterEnergy += energy;
 
   edm4hep::Vector3f newClusterPosition = edm4hep::Vector3f(posX / energy, posY / energy, posZ / energy);
@@ -303,7 +303,7 @@ StatusCode CreateCaloClusters::execute() {
 	  
 	  totBenchmarkCorr += corr;
 	  // Fill histogram with corrected energy
-	  m_clusterEnergyBenchmark->Fill(energy);
+	  m_histogramFills.fill(m_clusterEnergyBenchmark, energy);
 	  totBenchmarkEnergy += energy;
 	}
 	newCluster.setEnergy(energy);
@@ -335,22 +335,23 @@ StatusCode CreateCaloClusters::execute() {
   if (sharedClusters > 0){
     info() << "Clusters calibrated to EM scale       : " << clustersEM/float(sharedClusters)*100 << " % " << endmsg;
     info() << "Clusters calibrated to hadron scale : " << clustersHad/float(sharedClusters)*100 << " % " << endmsg;
-    m_fractionEMcluster->Fill(clustersEM/float(sharedClusters));
+    m_histogramFills.fill(m_fractionEMcluster, clustersEM/float(sharedClusters));
   }
   debug() << "Output Cluster collection size: " << edmClusters->size() << endmsg;
 
-  m_totEnergy->Fill( totClusterEnergy/std::floor(Etruth) );
-  m_totCalibEnergy->Fill( totCalibClusterEnergy/std::floor(Etruth) );
-  m_totBenchmarkEnergy->Fill( totBenchmarkEnergy/std::floor(Etruth) );
-  m_benchmark->Fill(totBenchmarkCorr);
+  m_histogramFills.fill(m_totEnergy,  totClusterEnergy/std::floor(Etruth) );
+  m_histogramFills.fill(m_totCalibEnergy,  totCalibClusterEnergy/std::floor(Etruth) );
+  m_histogramFills.fill(m_totBenchmarkEnergy,  totBenchmarkEnergy/std::floor(Etruth) );
+  m_histogramFills.fill(m_benchmark, totBenchmarkCorr);
 
-  m_nCluster_1GeV->Fill(nClusters_1GeV);
-  m_nCluster_halfTrueEnergy->Fill(nClusters_halfTrueEnergy);
+  m_histogramFills.fill(m_nCluster_1GeV, nClusters_1GeV);
+  m_histogramFills.fill(m_nCluster_halfTrueEnergy, nClusters_halfTrueEnergy);
 
   return StatusCode::SUCCESS;
 }
 
 StatusCode CreateCaloClusters::finalize() { 
+  m_histogramFills.flush();
   float allCluster = m_totEnergy->GetEntries();
   m_clusterEnergy->Scale(1/allCluster);
   m_sharedClusterEnergy->Scale(1/allCluster);
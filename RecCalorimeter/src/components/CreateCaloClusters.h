@@ -32,6 +32,8 @@ class Segmentation;
 class TH2F;
 class TH1F;
 
+#include "HistogramFillBuffer.h"
+
 /** @class CreateCaloClusters
  *
  * Applies hadronic calibration to cluster.
@@ -97,6 +99,8 @@ private:
   TH1F* m_nCluster_halfTrueEnergy;
   TH1F* m_energyCalibCluster_1GeV;
   TH1F* m_energyCalibCluster_halfTrueEnergy;
+  /// Buffer of the histogram fills in the event loop, merged into the histograms at the latest in finalize
+  HistogramFillBuffer m_histogramFills{this};
 
   /// bool if calibration is applied
   bool m_doCalibration =  true;
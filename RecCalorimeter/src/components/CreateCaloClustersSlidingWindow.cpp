@@ -29,6 +29,10 @@ StatusCode CreateCaloClustersSlidingWindow::initialize() {
   m_nEtaTower = towerMapSize.eta;
   m_nPhiTower = towerMapSize.phi;
   debug() << "Number of calorimeter towers (eta x phi) : " << m_nEtaTower << " x " << m_nPhiTower << endmsg;
+  if (!m_towerGeometry.reset(*m_towerTool, m_nEtaTower, m_nPhiTower)) {
+    info() << "The tower tool does not describe its grid, the tower IDs are derived from the centres of the towers"
+           << endmsg;
+  }
   // make sure that the number of towers in eta is larger than the seeding sliding window
   if (m_nEtaTower < m_nEtaWindow) {
     debug() << "Window size in eta too small!!! Window " << m_nEtaWindow << " # of eta towers " << m_nEtaTower
@@ -41,25 +45,31 @@ StatusCode CreateCaloClustersSlidingWindow::initialize() {
 
 StatusCode CreateCaloClustersSlidingWindow::execute() {
   // 1. Create calorimeter towers (calorimeter grid in eta phi, all layers merged)
-  m_towers.assign(m_nEtaTower, std::vector<float>(m_nPhiTower, 0));
+  // towers and pre-clusters are local to the event, the algorithm keeps no state between events
+  // the tower IDs and centres are taken from a copy of the grid descriptor, without virtual calls to the tool
+  const TowerGeometry geometry = m_towerGeometry.get();
+  std::vector<std::vector<float>> towers(m_nEtaTower, std::vector<float>(m_nPhiTower, 0));
   // Create an output collection
   auto edmClusters = m_clusters.createAndPut();
   auto edmClusterCells = m_clusterCells.createAndPut();
   // Check if the tower building succeeded
-  if (m_towerTool->buildTowers(m_towers) == 0) {
+  StageTimer towersTimer(m_timeTowers);
+  if (m_towerTool->buildTowers(towers) == 0) {
     debug() << "Empty cell collection." << endmsg;
     return StatusCode::SUCCESS;
   }
+  towersTimer.stop();
+  StageTimer preClustersTimer(m_timePreClusters);
   // 2. Find local maxima with sliding window, build preclusters, calculate their barycentre position
   // calculate the sum of first m_nEtaWindow bins in eta, for each phi tower
   std::vector<float> sumOverEta(m_nPhiTower, 0);
   for (int iEta = 0; iEta < m_nEtaWindow; iEta++) {
-    std::transform(sumOverEta.begin(), sumOverEta.end(), m_towers[iEta].begin(), sumOverEta.begin(),
+    std::transform(sumOverEta.begin(), sumOverEta.end(), towers[iEta].begin(), sumOverEta.begin(),
                    std::plus<float>());
   }
 
   // preclusters with phi, eta weighted position and transverse energy
-  m_preClusters.clear();
+  std::vector<cluster> preClusters;
   int halfEtaPos = floor(m_nEtaPosition / 2.);
   int halfPhiPos = floor(m_nPhiPosition / 2.);
   float posEta = 0;
@@ -106,8 +116,8 @@ StatusCode CreateCaloClustersSlidingWindow::execute() {
         if (iEta > halfEtaWin) {
           for (int iPhiWindowLocalCheck = iPhi - halfPhiWin; iPhiWindowLocalCheck <= iPhi + halfPhiWin;
                iPhiWindowLocalCheck++) {
-            sumPhiSlicePrevEtaWin += m_towers[iEta - halfEtaWin - 1][phiNeighbour(iPhiWindowLocalCheck)];
-            sumLastPhiSlice += m_towers[iEta + halfEtaWin][phiNeighbour(iPhiWindowLocalCheck)];
+            sumPhiSlicePrevEtaWin += towers[iEta - halfEtaWin - 1][phiNeighbour(iPhiWindowLocalCheck)];
+            sumLastPhiSlice += towers[iEta + halfEtaWin][phiNeighbour(iPhiWindowLocalCheck)];
           }
           if (sumPhiSlicePrevEtaWin > sumLastPhiSlice) {
             toRemove = true;
@@ -117,8 +127,8 @@ StatusCode CreateCaloClustersSlidingWindow::execute() {
         if (iEta < m_nEtaTower - halfEtaWin - 1) {
           for (int iPhiWindowLocalCheck = iPhi - halfPhiWin; iPhiWindowLocalCheck <= iPhi + halfPhiWin;
                iPhiWindowLocalCheck++) {
-            sumPhiSliceNextEtaWin += m_towers[iEta + halfEtaWin + 1][phiNeighbour(iPhiWindowLocalCheck)];
-            sumFirstPhiSlice += m_towers[iEta - halfEtaWin][phiNeighbour(iPhiWindowLocalCheck)];
+            sumPhiSliceNextEtaWin += towers[iEta + halfEtaWin + 1][phiNeighbour(iPhiWindowLocalCheck)];
+            sumFirstPhiSlice += towers[iEta - halfEtaWin][phiNeighbour(iPhiWindowLocalCheck)];
           }
           if (sumPhiSliceNextEtaWin > sumFirstPhiSlice) {
             toRemove = true;
@@ -137,9 +147,9 @@ StatusCode CreateCaloClustersSlidingWindow::execute() {
           // weighted mean for position in eta and phi
           for (int ipEta = iEta - halfEtaPos; ipEta <= iEta + halfEtaPos; ipEta++) {
             for (int ipPhi = iPhi - halfPhiPos; ipPhi <= iPhi + halfPhiPos; ipPhi++) {
-              posEta += m_towerTool->eta(ipEta) * m_towers[ipEta][phiNeighbour(ipPhi)];
-              posPhi += m_towerTool->phi(ipPhi) * m_towers[ipEta][phiNeighbour(ipPhi)];
-              sumEnergyPos += m_towers[ipEta][phiNeighbour(ipPhi)];
+              posEta += geometry.eta(ipEta) * towers[ipEta][phiNeighbour(ipPhi)];
+              posPhi += geometry.phi(ipPhi) * towers[ipEta][phiNeighbour(ipPhi)];
+              sumEnergyPos += towers[ipEta][phiNeighbour(ipPhi)];
             }
           }
           // If too small energy in the position window, calculate the position in the whole sliding window
@@ -153,9 +163,9 @@ StatusCode CreateCaloClustersSlidingWindow::execute() {
             sumEnergyPos = 0;
             for (int ipEta = iEta - halfEtaWin; ipEta <= iEta + halfEtaWin; ipEta++) {
               for (int ipPhi = iPhi - halfPhiWin; ipPhi <= iPhi + halfPhiWin; ipPhi++) {
-                posEta += m_towerTool->eta(ipEta) * m_towers[ipEta][phiNeighbour(ipPhi)];
-                posPhi += m_towerTool->phi(ipPhi) * m_towers[ipEta][phiNeighbour(ipPhi)];
-                sumEnergyPos += m_towers[ipEta][phiNeighbour(ipPhi)];
+                posEta += geometry.eta(ipEta) * towers[ipEta][phiNeighbour(ipPhi)];
+                posPhi += geometry.phi(ipPhi) * towers[ipEta][phiNeighbour(ipPhi)];
+                sumEnergyPos += towers[ipEta][phiNeighbour(ipPhi)];
               }
             }
             posEta /= sumEnergyPos;
@@ -167,18 +177,18 @@ StatusCode CreateCaloClustersSlidingWindow::execute() {
           // Calculate final cluster energy
           sumEnergyFin = 0;
           // Final cluster position
-          idEtaFin = m_towerTool->idEta(posEta);
-          idPhiFin = m_towerTool->idPhi(posPhi);
+          idEtaFin = geometry.idEta(posEta);
+          idPhiFin = geometry.idPhi(posPhi);
           // Recalculating the energy within the final cluster size
           for (int ipEta = idEtaFin - halfEtaFin; ipEta <= idEtaFin + halfEtaFin; ipEta++) {
             for (int ipPhi = idPhiFin - halfPhiFin; ipPhi <= idPhiFin + halfPhiFin; ipPhi++) {
               if (ipEta >= 0 && ipEta < m_nEtaTower) {  // check if we are not outside of map in eta
                 if (m_ellipseFinalCluster) {
                   if (pow( (ipEta - idEtaFin) / (m_nEtaFinal / 2.), 2) + pow( (ipPhi - idPhiFin) / (m_nPhiFinal / 2.), 2) < 1) {
-                    sumEnergyFin += m_towers[ipEta][phiNeighbour(ipPhi)];
+                    sumEnergyFin += towers[ipEta][phiNeighbour(ipPhi)];
                   }
                 } else {
-                  sumEnergyFin += m_towers[ipEta][phiNeighbour(ipPhi)];
+                  sumEnergyFin += towers[ipEta][phiNeighbour(ipPhi)];
                 }
               }
             }
@@ -189,7 +199,7 @@ StatusCode CreateCaloClustersSlidingWindow::execute() {
             newPreCluster.eta = posEta;
             newPreCluster.phi = posPhi;
             newPreCluster.transEnergy = sumEnergyFin;
-            m_preClusters.push_back(newPreCluster);
+            preClusters.push_back(newPreCluster);
           }
         }
       }
@@ -204,51 +214,56 @@ StatusCode CreateCaloClustersSlidingWindow::execute() {
     // finish processing that slice, shift window to next eta tower
     if (iEta < m_nEtaTower - halfEtaWin - 1) {
       // substract first eta slice in current window
-      std::transform(sumOverEta.begin(), sumOverEta.end(), m_towers[iEta - halfEtaWin].begin(), sumOverEta.begin(),
+      std::transform(sumOverEta.begin(), sumOverEta.end(), towers[iEta - halfEtaWin].begin(), sumOverEta.begin(),
                      std::minus<float>());
       // add next eta slice to the window
-      std::transform(sumOverEta.begin(), sumOverEta.end(), m_towers[iEta + halfEtaWin + 1].begin(), sumOverEta.begin(),
+      std::transform(sumOverEta.begin(), sumOverEta.end(), towers[iEta + halfEtaWin + 1].begin(), sumOverEta.begin(),
                      std::plus<float>());
     }
   }
 
-  debug() << "Pre-clusters size before duplicates removal: " << m_preClusters.size() << endmsg;
+  preClustersTimer.stop();
+  m_numPreClusters += preClusters.size();
+  debug() << "Pre-clusters size before duplicates removal: " << preClusters.size() << endmsg;
+  StageTimer duplicatesTimer(m_timeDuplicates);
 
   // 4. Sort the preclusters according to the transverse energy (descending)
-  std::sort(m_preClusters.begin(), m_preClusters.end(),
+  std::sort(preClusters.begin(), preClusters.end(),
             [](cluster clu1, cluster clu2) { return clu1.transEnergy > clu2.transEnergy; });
 
   // 5. Remove duplicates
-  for (auto it1 = m_preClusters.begin(); it1 != m_preClusters.end(); it1++) {
+  for (auto it1 = preClusters.begin(); it1 != preClusters.end(); it1++) {
     // loop over all clusters with energy lower than it1 (sorting), erase if too close
-    for (auto it2 = it1 + 1; it2 != m_preClusters.end();) {
-      if ((abs(m_towerTool->idEta((*it1).eta) - m_towerTool->idEta((*it2).eta)) < m_nEtaDuplicates) &&
-          ((abs(m_towerTool->idPhi((*it1).phi) - m_towerTool->idPhi((*it2).phi)) < m_nPhiDuplicates) ||
-           (abs(m_towerTool->idPhi((*it1).phi) - m_towerTool->idPhi((*it2).phi)) > m_nPhiTower - m_nPhiDuplicates))) {
-        m_preClusters.erase(it2);
+    for (auto it2 = it1 + 1; it2 != preClusters.end();) {
+      if ((abs(geometry.idEta((*it1).eta) - geometry.idEta((*it2).eta)) < m_nEtaDuplicates) &&
+          ((abs(geometry.idPhi((*it1).phi) - geometry.idPhi((*it2).phi)) < m_nPhiDuplicates) ||
+           (abs(geometry.idPhi((*it1).phi) - geometry.idPhi((*it2).phi)) > m_nPhiTower - m_nPhiDuplicates))) {
+        preClusters.erase(it2);
       } else {
         it2++;
       }
     }
   }
-  debug() << "Pre-clusters size after duplicates removal: " << m_preClusters.size() << endmsg;
+  duplicatesTimer.stop();
+  debug() << "Pre-clusters size after duplicates removal: " << preClusters.size() << endmsg;
+  StageTimer outputTimer(m_timeOutput);
 
   // 6. Create final clusters
   // currently only role of r is to calculate x,y,z position
-  double radius = m_towerTool->radiusForPosition();
-  for (const auto clu : m_preClusters) {
+  double radius = geometry.radius();
+  for (const auto clu : preClusters) {
     float clusterEnergy = clu.transEnergy * cosh(clu.eta);
     // apply energy sharing correction (if flag set to true)
     if (m_energySharingCorrection) {
-      int idEtaCl = m_towerTool->idEta(clu.eta);
-      int idPhiCl = m_towerTool->idPhi(clu.phi);
+      int idEtaCl = geometry.idEta(clu.eta);
+      int idPhiCl = geometry.idPhi(clu.phi);
       // sum of energies in other clusters in each eta-phi tower of our current cluster (idEtaCl, idPhiCl)
       std::vector<std::vector<float>> sumEnergySharing;
       sumEnergySharing.assign(m_nEtaFinal, std::vector<float>(m_nPhiFinal, 0));
       // loop over all clusters and check if they have any tower in common with our current cluster
-      for (const auto cluSharing : m_preClusters) {
-        int idEtaClShare = m_towerTool->idEta(cluSharing.eta);
-        int idPhiClShare = m_towerTool->idPhi(cluSharing.phi);
+      for (const auto cluSharing : preClusters) {
+        int idEtaClShare = geometry.idEta(cluSharing.eta);
+        int idPhiClShare = geometry.idPhi(cluSharing.phi);
         if (idEtaCl != idEtaClShare && idPhiCl != idPhiClShare) {
           // check for overlap between clusters
           if (abs(idEtaClShare - idEtaCl) < m_nEtaFinal &&
@@ -263,7 +278,7 @@ StatusCode CreateCaloClustersSlidingWindow::execute() {
                    iPhi++) {
                 if (iEta >= 0 && iEta < m_nEtaTower) {  // check if we are not outside of map in eta
                   sumEnergySharing[iEta - idEtaCl + halfEtaFin][phiNeighbour(iPhi - idPhiCl + halfPhiFin)] +=
-                      m_towers[iEta][phiNeighbour(iPhi)] * cosh(m_towerTool->eta(iEta));
+                      towers[iEta][phiNeighbour(iPhi)] * geometry.coshEta(iEta);
                 }
               }
             }
@@ -276,7 +291,7 @@ StatusCode CreateCaloClustersSlidingWindow::execute() {
           if(iEta - idEtaCl + halfEtaFin >= 0)
             if (sumEnergySharing[iEta - idEtaCl + halfEtaFin][phiNeighbour(iPhi - idPhiCl + halfPhiFin)] != 0) {
               float sumButOne = sumEnergySharing[iEta - idEtaCl + halfEtaFin][phiNeighbour(iPhi - idPhiCl + halfPhiFin)];
-            float towerEnergy = m_towers[iEta][phiNeighbour(iPhi)] * cosh(m_towerTool->eta(iEta));
+            float towerEnergy = towers[iEta][phiNeighbour(iPhi)] * geometry.coshEta(iEta);
             clusterEnergy -= towerEnergy * sumButOne / (sumButOne + towerEnergy);
           }
         }
@@ -295,6 +310,8 @@ StatusCode CreateCaloClustersSlidingWindow::execute() {
               << " energy: " << edmCluster.getEnergy() << " contains: " << edmCluster.hits_size() << " cells" << endmsg;
     }
   }
+  outputTimer.stop();
+  m_numClusters += edmClusters->size();
   return StatusCode::SUCCESS;
 }
 
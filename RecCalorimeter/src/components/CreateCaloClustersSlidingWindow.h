@@ -9,6 +9,9 @@
 #include "k4FWCore/DataHandle.h"
 #include "k4Interface/ITowerTool.h"
 
+#include "StageTimer.h"
+#include "TowerGeometry.h"
+
 // datamodel
 namespace edm4hep {
 class ClusterCollection;
@@ -55,6 +58,10 @@ struct cluster {
  *     Radius may be defined by user ('\b radiusForPosition') or (if not defined) taken from det::utils::tubeDimensions.
  *     The second approach may be used for sensitive cylindrical geometries.
  *     For each cluster the cell collection is searched and all those inside the cluster are attached.
+ *  The tower IDs and centres are taken from a copy of the TowerGeometry of the tower tool, made once per event.
+ *
+ *  The time of each step and the number of pre-clusters and clusters per event are recorded in counters printed at
+ *  finalize.
  *
  *  Note: Sliding window performs well for electrons/gamma reconstruction. Topological clusters should be better for
  *jets.
@@ -94,10 +101,8 @@ private:
   DataHandle<edm4hep::CalorimeterHitCollection> m_clusterCells{"calo/clusterCells", Gaudi::DataHandle::Writer, this};
   /// Handle for the tower building tool
   ToolHandle<ITowerTool> m_towerTool;
-  // calorimeter towers
-  std::vector<std::vector<float>> m_towers;
-  /// Vector of pre-clusters
-  std::vector<cluster> m_preClusters;
+  /// Descriptor of the tower grid of the tool, copied once per event for the loops over towers
+  TowerGeometry::Source m_towerGeometry;
   /// number of towers in eta (calculated from m_deltaEtaTower and the eta size of the first layer)
   int m_nEtaTower;
   /// Number of towers in phi (calculated from m_deltaPhiTower)
@@ -128,6 +133,18 @@ private:
   Gaudi::Property<bool> m_ellipseFinalCluster{this, "ellipse", false};
   /// Flag if cells should be attached to clusters
   Gaudi::Property<bool> m_attachCells{this, "attachCells", false};
+  /// Time to build the towers
+  StageTimer::Counter m_timeTowers{this, "Time towers [us]"};
+  /// Time to find the local maxima and build the pre-clusters
+  StageTimer::Counter m_timePreClusters{this, "Time pre-clusters [us]"};
+  /// Time to remove the duplicates
+  StageTimer::Counter m_timeDuplicates{this, "Time duplicates [us]"};
+  /// Time to create the output clusters
+  StageTimer::Counter m_timeOutput{this, "Time output [us]"};
+  /// Number of pre-clusters per event, before the removal of duplicates
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numPreClusters{this, "Pre-clusters"};
+  /// Number of clusters per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numClusters{this, "Clusters"};
 };
 
 #endif /* RECCALORIMETER_CREATECALOCLUSTERSSLIDINGWINDOW_H */
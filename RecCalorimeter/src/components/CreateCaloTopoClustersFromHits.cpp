@@ -0,0 +1,165 @@
+#include "CreateCaloTopoClustersFromHits.h"
+#include "TopoClusterBuilder.h"
+
+// DD4hep
+#include "DD4hep/Detector.h"
+
+// EDM4HEP
+#include "edm4hep/CalorimeterHit.h"
+#include "edm4hep/CalorimeterHitCollection.h"
+#include "edm4hep/Cluster.h"
+#include "edm4hep/ClusterCollection.h"
+#include "edm4hep/SimCalorimeterHitCollection.h"
+
+#include <map>
+
+DECLARE_COMPONENT(CreateCaloTopoClustersFromHits)
+
+CreateCaloTopoClustersFromHits::CreateCaloTopoClustersFromHits(const std::string& name, ISvcLocator* svcLoc)
+    : GaudiAlgorithm(name, svcLoc) {
+  declareProperty("hits", m_hits, "Hits from which to create cells (input)");
+  declareProperty("cells", m_cells, "The created calorimeter cells (output)");
+  declareProperty("clusters", m_clusterCollection, "Handle for calo clusters (output collection)");
+  declareProperty("clusterCells", m_clusterCellsCollection, "Handle for clusters (output collection)");
+  declareProperty("clusterSummaries", m_clusterSummaries,
+                  "Handle for summaries of clusters below the full evaluation thresholds (output collection)");
+
+  declareProperty("calibTool", m_calibTool, "Handle for tool to calibrate Geant4 energy to EM scale tool");
+  declareProperty("noiseTool", m_noiseTool, "Handle for the calorimeter cells noise tool");
+  declareProperty("geometryTool", m_geoTool, "Handle for the geometry tool");
+  declareProperty("positionsTool", m_cellPositionsTool, "Handle for tool to retrieve cell positions");
+  declareProperty("noiseMapTool", m_noiseMapTool, "Handle for the cells noise map tool of the clustering");
+  declareProperty("neigboursTool", m_neighboursTool, "Handle for tool to retrieve cell neighbours");
+}
+
+StatusCode CreateCaloTopoClustersFromHits::initialize() {
+  StatusCode sc = GaudiAlgorithm::initialize();
+  if (sc.isFailure()) return sc;
+
+  info() << "do calibration : " << m_doCellCalibration << endmsg;
+  info() << "add cell noise      : " << m_addCellNoise << endmsg;
+  info() << "remove noise cells below threshold : " << m_filterCellNoise << endmsg;
+  info() << "add position information to the cell : " << m_addCellPositions << endmsg;
+  info() << "topo-cluster thresholds (seed, neighbours, last neighbours) : " << m_seedSigma << ", "
+         << m_neighbourSigma << ", " << m_lastNeighbourSigma << endmsg;
+
+  if (m_doCellCalibration) {
+    if (!m_calibTool.retrieve()) {
+      error() << "Unable to retrieve the calo cells calibration tool!!!" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  if (m_addCellNoise) {
+    if (!m_noiseTool.retrieve()) {
+      error() << "Unable to retrieve the calo cells noise tool!!!" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    if (!m_geoTool.retrieve()) {
+      error() << "Unable to retrieve the geometry tool!!!" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    // Prepare map of all existing cells in calorimeter to add noise to all
+    StatusCode sc_prepareCells = m_geoTool->prepareEmptyCells(m_cellsMap.emptyCells());
+    if (sc_prepareCells.isFailure()) {
+      error() << "Unable to create empty cells!" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  if (!m_cellPositionsTool.retrieve()) {
+    error() << "Unable to retrieve the cell positions tool!!!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!m_neighboursTool.retrieve()) {
+    error() << "Unable to retrieve the cells neighbours tool!!!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!m_noiseMapTool.retrieve()) {
+    error() << "Unable to retrieve the cells noise map tool!!!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CreateCaloTopoClustersFromHits::execute() {
+  // limits of the work in this event, including the cell creation
+  EventBudget budget(m_maxNeighbourLookups, m_maxClusterCells, m_maxEventTime);
+
+  const edm4hep::SimCalorimeterHitCollection* hits = m_hits.get();
+  debug() << "Input Hit collection size: " << hits->size() << endmsg;
+
+  // 1. Cells as in CreateCaloCells
+  StageTimer resetTimer(m_timeReset);
+  std::unordered_map<uint64_t, double>& cellsMap = m_cellsMap.reset();
+  resetTimer.stop();
+  for (const auto& hit : *hits) {
+    m_cellsMap.add(hit.getCellID(), hit.getEnergy());
+  }
+  debug() << "Number of calorimeter cells after merging of hits: " << cellsMap.size() << endmsg;
+  if (m_doCellCalibration) {
+    m_calibTool->calibrate(cellsMap);
+  }
+  if (m_addCellNoise) {
+    m_noiseTool->addRandomCellNoise(cellsMap);
+    if (m_filterCellNoise) {
+      m_noiseTool->filterCellNoise(cellsMap);
+    }
+  }
+
+  // 2. Output cells with positions, and input map of the clustering
+  // the energies are stored as float in the cells, the clustering sees the same values as when reading the cells
+  std::map<uint64_t, double> allCells;
+  std::unordered_map<uint64_t, dd4hep::Position> positions;
+  auto edmCellsCollection = m_cells.createAndPut();
+  for (const auto& cell : cellsMap) {
+    if (m_addCellNoise || cell.second != 0) {
+      auto newCell = edmCellsCollection->create();
+      newCell.setEnergy(cell.second);
+      newCell.setCellID(cell.first);
+      if (m_addCellPositions) {
+        auto posCell = m_cellPositionsTool->xyzPosition(cell.first);
+        newCell.setPosition(
+            edm4hep::Vector3f(posCell.x() / dd4hep::mm, posCell.y() / dd4hep::mm, posCell.z() / dd4hep::mm));
+        positions.emplace(cell.first, posCell);
+      }
+      allCells.emplace(cell.first, newCell.getEnergy());
+    }
+  }
+  debug() << "Output Cell collection size: " << edmCellsCollection->size() << endmsg;
+
+  // 3. Topo-clusters as in CaloTopoCluster
+  auto edmClusters = m_clusterCollection.createAndPut();
+  edm4hep::CalorimeterHitCollection* edmClusterCells = new edm4hep::CalorimeterHitCollection();
+  auto edmClusterSummaries = m_clusterSummaries.createAndPut();
+  // once the event is over budget, the clusters grow only with cells above this threshold
+  int budgetNumSigma = m_budgetNeighbourSigma >= 0 ? int(m_budgetNeighbourSigma) : int(m_seedSigma);
+  TopoClusterBuilder builder(allCells, &(*m_neighboursTool), &(*m_noiseMapTool),
+                             {{int(m_seedSigma), int(m_neighbourSigma), int(m_lastNeighbourSigma), budgetNumSigma}});
+  debug() << "Number of seeds found :    " << builder.findingSeeds().size() << endmsg;
+  std::vector<TopoClusterBuilder::PreClusterCollection> preClusterCollections;
+  if (!builder.buildingProtoClusters(preClusterCollections, {&budget})) {
+    error() << "No neighbours for cellID found! " << endmsg;
+    error() << "to cellID :  " << builder.missingNeighboursCell() << endmsg;
+    error() << "Building of cluster is stopped due to missing id in neighbours map." << endmsg;
+  }
+  m_budgetCounters += budget;
+  if (budget.exceeded() != EventBudget::kNone) {
+    warning() << "Event over budget (" << budget.exceededNames() << " ) after " << budget.lookups()
+              << " neighbour lookups, clusters built with reduced growth" << endmsg;
+  }
+  debug() << "Building " << preClusterCollections[0].size() << " cluster." << endmsg;
+  auto position = [this, &positions](uint64_t aCellId) -> const dd4hep::Position& {
+    auto itPosition = positions.find(aCellId);
+    if (itPosition == positions.end()) {
+      itPosition = positions.emplace(aCellId, m_cellPositionsTool->xyzPosition(aCellId)).first;
+    }
+    return itPosition->second;
+  };
+  builder.writeClusters(preClusterCollections[0], position, m_minEnergyFullCluster, m_minCellsFullCluster,
+                        *edmClusters, *edmClusterCells, *edmClusterSummaries);
+  m_clusterCellsCollection.put(edmClusterCells);
+  debug() << "Output cluster collection size: " << edmClusters->size() << ", summaries: "
+          << edmClusterSummaries->size() << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CreateCaloTopoClustersFromHits::finalize() { return GaudiAlgorithm::finalize(); }
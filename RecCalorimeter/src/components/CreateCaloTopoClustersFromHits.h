@@ -0,0 +1,131 @@
+#ifndef RECCALORIMETER_CREATECALOTOPOCLUSTERSFROMHITS_H
+#define RECCALORIMETER_CREATECALOTOPOCLUSTERSFROMHITS_H
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+#include "k4Interface/ICaloReadCellNoiseMap.h"
+#include "k4Interface/ICaloReadNeighboursMap.h"
+#include "k4Interface/ICalibrateCaloHitsTool.h"
+#include "k4Interface/ICalorimeterTool.h"
+#include "k4Interface/ICellPositionsTool.h"
+#include "k4Interface/INoiseCaloCellsTool.h"
+
+// Gaudi
+#include "GaudiAlg/GaudiAlgorithm.h"
+#include "GaudiKernel/ToolHandle.h"
+
+#include "CellsMapScratch.h"
+#include "EventBudget.h"
+#include "StageTimer.h"
+
+// datamodel
+namespace edm4hep {
+class CalorimeterHitCollection;
+class ClusterCollection;
+class SimCalorimeterHitCollection;
+}
+
+/** @class CreateCaloTopoClustersFromHits
+ *
+ *  Algorithm running the cell creation and the topological clustering of one calorimeter in one step, without
+ *  writing and reading the intermediate cell collections:
+ *  1/ cells are created from the Geant4 hits as in CreateCaloCells (merging, calibration, noise, filtering),
+ *  2/ the cell positions are added as in CreateCaloCellPositions (if "addCellPositions"),
+ *  3/ the topo-clusters are built as in CaloTopoCluster (see TopoClusterBuilder).
+ *
+ *  The algorithm is configured with the same tools and the same clustering properties as the separate algorithms
+ *  (including the per-event budget and the summaries of the clusters below "minEnergyFullCluster" and
+ *  "minCellsFullCluster", see CaloTopoCluster.h), and gives the same cells and clusters as the sequence
+ *  CreateCaloCells, CreateCaloCellPositions, CaloTopoClusterInputTool + CaloTopoCluster with only this calorimeter as
+ *  input, the clustering being done by the same builder. The noise added to the cells is random, so the outputs of
+ *  the two paths can only be compared without noise or with the same noise; the comparison without noise is part of
+ *  RecCalorimeter/tests/options/runSyntheticGrid_GoldenOutput.py. The cell energies are rounded to float before
+ *  clustering, as when they are read from the cell collection. All stages work on one cell map per event, the cell
+ *  positions are computed once and shared between the cell collection and the cluster barycentres. With noise, the
+ *  cell map is reset in place to all cells with zero energy at the start of each event, as in CreateCaloCells (see
+ *  CellsMapScratch); the reset is timed in "Time reset cells map".
+ *
+ *  Outputs: "cells" (all cells, as CreateCaloCells / CreateCaloCellPositions), "clusters", "clusterCells" and
+ *  "clusterSummaries" (as CaloTopoCluster).
+ *
+ */
+
+class CreateCaloTopoClustersFromHits : public GaudiAlgorithm {
+
+public:
+  CreateCaloTopoClustersFromHits(const std::string& name, ISvcLocator* svcLoc);
+
+  StatusCode initialize();
+
+  StatusCode execute();
+
+  StatusCode finalize();
+
+private:
+  /// Handle for tool to calibrate Geant4 energy to EM scale tool
+  ToolHandle<ICalibrateCaloHitsTool> m_calibTool{"CalibrateCaloHitsTool", this};
+  /// Handle for the calorimeter cells noise tool
+  ToolHandle<INoiseCaloCellsTool> m_noiseTool{"NoiseCaloCellsFlatTool", this};
+  /// Handle for the geometry tool
+  ToolHandle<ICalorimeterTool> m_geoTool{"TubeLayerPhiEtaCaloTool", this};
+  /// Handle for the cell positions tool
+  ToolHandle<ICellPositionsTool> m_cellPositionsTool{"CellPositionsECalBarrelTool", this};
+  /// Handle for the cells noise map tool used for the clustering thresholds
+  ToolHandle<ICaloReadCellNoiseMap> m_noiseMapTool{"TopoCaloNoisyCells", this};
+  /// Handle for neighbours tool
+  ToolHandle<ICaloReadNeighboursMap> m_neighboursTool{"TopoCaloNeighbours", this};
+
+  /// Calibrate to EM scale?
+  Gaudi::Property<bool> m_doCellCalibration{this, "doCellCalibration", true, "Calibrate to EM scale?"};
+  /// Add noise to cells?
+  Gaudi::Property<bool> m_addCellNoise{this, "addCellNoise", true, "Add noise to cells?"};
+  /// Save only cells with energy above threshold?
+  Gaudi::Property<bool> m_filterCellNoise{this, "filterCellNoise", false,
+                                          "Save only cells with energy above threshold?"};
+  /// Add the position to the output cells?
+  Gaudi::Property<bool> m_addCellPositions{this, "addCellPositions", true, "Add position information to the output cells?"};
+  /// Seed threshold in sigma
+  Gaudi::Property<int> m_seedSigma{this, "seedSigma", 4, "number of sigma in noise threshold"};
+  /// Neighbour threshold in sigma
+  Gaudi::Property<int> m_neighbourSigma{this, "neighbourSigma", 2, "number of sigma in noise threshold"};
+  /// Last neighbour threshold in sigma
+  Gaudi::Property<int> m_lastNeighbourSigma{this, "lastNeighbourSigma", 0, "number of sigma in noise threshold"};
+  /// Energy threshold above which the cluster position, shape and cells are evaluated (disabled if <= 0)
+  Gaudi::Property<double> m_minEnergyFullCluster{this, "minEnergyFullCluster", 0.,
+                                                  "cluster energy [GeV] for full evaluation, <= 0 to disable"};
+  /// Cell-count threshold above which the cluster position, shape and cells are evaluated (disabled if <= 0)
+  Gaudi::Property<int> m_minCellsFullCluster{this, "minCellsFullCluster", 0,
+                                             "number of cells for full evaluation, <= 0 to disable"};
+  /// Maximal number of neighbour lookups per event (disabled if <= 0)
+  Gaudi::Property<long> m_maxNeighbourLookups{this, "maxNeighbourLookups", 0,
+                                              "maximal number of neighbour lookups per event, <= 0 to disable"};
+  /// Maximal number of cells of a cluster (disabled if <= 0)
+  Gaudi::Property<long> m_maxClusterCells{this, "maxClusterCells", 0,
+                                          "maximal number of cells of a cluster, <= 0 to disable"};
+  /// Maximal time per event (disabled if <= 0)
+  Gaudi::Property<double> m_maxEventTime{this, "maxEventTime", 0., "maximal time [ms] per event, <= 0 to disable"};
+  /// Neighbour threshold in sigma for the rest of an event over budget
+  Gaudi::Property<int> m_budgetNeighbourSigma{this, "budgetNeighbourSigma", -1,
+                                              "neighbour threshold of an event over budget, seedSigma if < 0"};
+
+  /// Handle for calo hits (input collection)
+  DataHandle<edm4hep::SimCalorimeterHitCollection> m_hits{"hits", Gaudi::DataHandle::Reader, this};
+  /// Handle for calo cells (output collection)
+  DataHandle<edm4hep::CalorimeterHitCollection> m_cells{"cells", Gaudi::DataHandle::Writer, this};
+  /// Handle for the clusters (output collection)
+  DataHandle<edm4hep::ClusterCollection> m_clusterCollection{"calo/clusters", Gaudi::DataHandle::Writer, this};
+  /// Handle for the cells of the clusters (output collection)
+  DataHandle<edm4hep::CalorimeterHitCollection> m_clusterCellsCollection{"calo/clusterCells", Gaudi::DataHandle::Writer, this};
+  /// Handle for the summaries of the clusters below the thresholds for full evaluation (output collection)
+  DataHandle<edm4hep::ClusterCollection> m_clusterSummaries{"calo/clusterSummaries", Gaudi::DataHandle::Writer, this};
+
+  /// Events over budget
+  EventBudget::Counters m_budgetCounters{this};
+  /// Time to reset the map of the cells at the start of an event
+  StageTimer::Counter m_timeReset{this, "Time reset cells map [us]"};
+
+  /// Map of the cells of the event, starting from all existing cell IDs with zero energy when noise is added
+  CellsMapScratch m_cellsMap;
+};
+
+#endif /* RECCALORIMETER_CREATECALOTOPOCLUSTERSFROMHITS_H */
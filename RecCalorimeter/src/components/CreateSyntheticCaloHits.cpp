@@ -0,0 +1,119 @@
+#include "CreateSyntheticCaloHits.h"
+
+// datamodel
+#include "edm4hep/SimCalorimeterHitCollection.h"
+
+#include <algorithm>
+#include <cmath>
+
+DECLARE_COMPONENT(CreateSyntheticCaloHits)
+
+CreateSyntheticCaloHits::CreateSyntheticCaloHits(const std::string& name, ISvcLocator* svcLoc)
+    : GaudiAlgorithm(name, svcLoc) {
+  declareProperty("hits", m_hits, "Synthetic calorimeter hits (output)");
+}
+
+StatusCode CreateSyntheticCaloHits::initialize() {
+  StatusCode sc = GaudiAlgorithm::initialize();
+  if (sc.isFailure()) return sc;
+  // eta range and radii do not matter for the cell IDs
+  m_grid = std::make_unique<SyntheticCaloGrid>(m_systemId, m_numLayers, m_numEta, m_numPhi, 1., 1., 1.);
+  if (!m_grid->valid()) {
+    error() << "Grid dimensions do not fit into the cell ID (system:4,layer:8,eta:12,phi:12)!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  // longitudinal profiles: gaussian around a third of the layers (electromagnetic) or two thirds (hadronic)
+  m_emLayerFractions = longitudinalProfile(m_numLayers / 3., std::max(1., m_numLayers / 4.));
+  m_hadLayerFractions = longitudinalProfile(2. * m_numLayers / 3., std::max(1., m_numLayers / 3.));
+  // lateral profile: exponential in the distance to the axis (in bins), within m_lateralHalfSize bins
+  double sum = 0;
+  m_lateralFractions.clear();
+  for (int iEta = -m_lateralHalfSize; iEta <= m_lateralHalfSize; iEta++) {
+    for (int iPhi = -m_lateralHalfSize; iPhi <= m_lateralHalfSize; iPhi++) {
+      m_lateralFractions.push_back(exp(-sqrt(iEta * iEta + iPhi * iPhi) / 0.7));
+      sum += m_lateralFractions.back();
+    }
+  }
+  for (auto& fraction : m_lateralFractions) {
+    fraction /= sum;
+  }
+  m_eventNumber = m_firstEvent;
+  info() << "Synthetic hits: " << m_numShowers << " showers of " << m_showerEnergy << " GeV, " << m_numJets
+         << " jets of " << m_jetEnergy << " GeV, pileup " << m_pileup << " x " << m_pileupHitsPerEvent
+         << " hits, seed " << m_seed << ", first event " << m_firstEvent << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CreateSyntheticCaloHits::execute() {
+  auto hits = m_hits.createAndPut();
+  // the random numbers of an event depend only on the seed and the event number
+  std::seed_seq seeds{uint64_t(m_seed), m_eventNumber++};
+  std::mt19937_64 engine(seeds);
+  std::uniform_real_distribution<double> flat(0., 1.);
+  // random bin in [0, aNumBins)
+  auto randomBin = [&](uint aNumBins) { return std::min(uint(flat(engine) * aNumBins), aNumBins - 1); };
+
+  for (uint iShower = 0; iShower < m_numShowers; iShower++) {
+    addShower(*hits, m_showerEnergy, randomBin(m_numEta), randomBin(m_numPhi), m_emLayerFractions);
+  }
+  std::normal_distribution<double> jetSpread(0., m_jetWidth);
+  for (uint iJet = 0; iJet < m_numJets; iJet++) {
+    int jetEta = randomBin(m_numEta);
+    int jetPhi = randomBin(m_numPhi);
+    // the jet energy is shared between the particles with random weights
+    std::vector<double> weights(m_numJetParticles);
+    double sumWeights = 0;
+    for (auto& weight : weights) {
+      weight = flat(engine);
+      sumWeights += weight;
+    }
+    for (uint iParticle = 0; iParticle < m_numJetParticles; iParticle++) {
+      int particleEta = std::lround(jetEta + jetSpread(engine));
+      if (particleEta < 0 || particleEta >= int(m_numEta)) continue;
+      int particlePhi = std::lround(jetPhi + jetSpread(engine));
+      addShower(*hits, m_jetEnergy * weights[iParticle] / sumWeights, particleEta, particlePhi,
+                // a third of the particles are photons (electromagnetic showers)
+                iParticle % 3 == 0 ? m_emLayerFractions : m_hadLayerFractions);
+    }
+  }
+  std::exponential_distribution<double> pileupEnergy(1. / m_pileupHitEnergy);
+  uint numPileupHits = m_pileup * m_pileupHitsPerEvent;
+  for (uint iHit = 0; iHit < numPileupHits; iHit++) {
+    auto hit = hits->create();
+    hit.setCellID(m_grid->cellId(randomBin(m_numLayers), randomBin(m_numEta), randomBin(m_numPhi)));
+    hit.setEnergy(pileupEnergy(engine) * m_samplingFraction);
+  }
+  debug() << "Number of synthetic hits: " << hits->size() << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CreateSyntheticCaloHits::finalize() { return GaudiAlgorithm::finalize(); }
+
+std::vector<double> CreateSyntheticCaloHits::longitudinalProfile(double aPeak, double aWidth) const {
+  std::vector<double> fractions(m_numLayers);
+  double sum = 0;
+  for (uint iLayer = 0; iLayer < m_numLayers; iLayer++) {
+    fractions[iLayer] = exp(-0.5 * pow((iLayer + 0.5 - aPeak) / aWidth, 2));
+    sum += fractions[iLayer];
+  }
+  for (auto& fraction : fractions) {
+    fraction /= sum;
+  }
+  return fractions;
+}
+
+void CreateSyntheticCaloHits::addShower(edm4hep::SimCalorimeterHitCollection& aHits, double aEnergy, int aIdEta,
+                                        int aIdPhi, const std::vector<double>& aLayerFractions) const {
+  int numPhi = m_numPhi;
+  for (uint iLayer = 0; iLayer < m_numLayers; iLayer++) {
+    size_t iFraction = 0;
+    for (int iEta = aIdEta - m_lateralHalfSize; iEta <= aIdEta + m_lateralHalfSize; iEta++) {
+      for (int iPhi = aIdPhi - m_lateralHalfSize; iPhi <= aIdPhi + m_lateralHalfSize; iPhi++, iFraction++) {
+        if (iEta < 0 || iEta >= int(m_numEta)) continue;
+        auto hit = aHits.create();
+        hit.setCellID(m_grid->cellId(iLayer, iEta, (iPhi % numPhi + numPhi) % numPhi));
+        hit.setEnergy(aEnergy * m_samplingFraction * aLayerFractions[iLayer] * m_lateralFractions[iFraction]);
+      }
+    }
+  }
+}
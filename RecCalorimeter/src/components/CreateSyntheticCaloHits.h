@@ -0,0 +1,120 @@
+#ifndef RECCALORIMETER_CREATESYNTHETICCALOHITS_H
+#define RECCALORIMETER_CREATESYNTHETICCALOHITS_H
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+
+// Gaudi
+#include "GaudiAlg/GaudiAlgorithm.h"
+
+#include "SyntheticCaloGrid.h"
+
+#include <memory>
+#include <random>
+
+// datamodel
+namespace edm4hep {
+class SimCalorimeterHitCollection;
+}
+
+/** @class CreateSyntheticCaloHits
+ *
+ *  Algorithm creating synthetic calorimeter hits on a regular grid (see SyntheticCaloGrid), to run and time the
+ *  reconstruction without a detector description or simulated events.
+ *
+ *  An event consists of:
+ *  - '\b numShowers' electromagnetic showers (single electrons) of energy '\b showerEnergy', at random positions of
+ *    the grid. The energy is shared between the layers with a gaussian profile peaking at a third of the layers, and
+ *    laterally between the cells within two bins in eta and phi from the shower axis, falling exponentially with the
+ *    distance.
+ *  - '\b numJets' jets of energy '\b jetEnergy', made of '\b numJetParticles' showers of random energy, spread
+ *    around the jet axis with a gaussian of '\b jetWidth' bins. One third of the showers are electromagnetic, the
+ *    others hadronic, with a longitudinal profile peaking at two thirds of the layers.
+ *  - '\b pileup' x '\b pileupHitsPerEvent' hits of exponentially distributed energy (mean '\b pileupHitEnergy') in
+ *    random cells, mimicking the occupancy of the minimum-bias pileup interactions.
+ *  The events are reproducible: the random numbers of an event depend only on '\b seed' and on the event number,
+ *  counted from '\b firstEvent'. A sample can therefore be split between jobs by their first event.
+ *  All energies are at the electromagnetic scale multiplied by '\b samplingFraction', as the deposits of Geant4 in
+ *  the active material, so they are calibrated back by CalibrateCaloHitsTool with invSamplingFraction =
+ *  1/samplingFraction. Several hits may be created in the same cell, they are merged when the cells are created.
+ *
+ *  The grid properties have to be the same as for SyntheticCaloGridTool and SyntheticCaloTowerTool.
+ */
+
+class CreateSyntheticCaloHits : public GaudiAlgorithm {
+public:
+  CreateSyntheticCaloHits(const std::string& name, ISvcLocator* svcLoc);
+
+  StatusCode initialize();
+
+  StatusCode execute();
+
+  StatusCode finalize();
+
+private:
+  /** Gaussian longitudinal profile, normalised to one.
+   *   @param[in] aPeak Position of the maximum, in layers.
+   *   @param[in] aWidth Width of the profile, in layers.
+   *   @return Fraction of the shower energy in each layer.
+   */
+  std::vector<double> longitudinalProfile(double aPeak, double aWidth) const;
+  /** Create the hits of a shower.
+   *   @param[out] aHits Hit collection.
+   *   @param[in] aEnergy Energy of the shower.
+   *   @param[in] aIdEta Eta bin of the shower axis.
+   *   @param[in] aIdPhi Phi bin of the shower axis, may be outside of [0, numPhi).
+   *   @param[in] aLayerFractions Longitudinal profile.
+   */
+  void addShower(edm4hep::SimCalorimeterHitCollection& aHits, double aEnergy, int aIdEta, int aIdPhi,
+                 const std::vector<double>& aLayerFractions) const;
+  /// Handle for the created hits (output collection)
+  DataHandle<edm4hep::SimCalorimeterHitCollection> m_hits{"hits", Gaudi::DataHandle::Writer, this};
+  /// System ID of the grid cells
+  Gaudi::Property<uint> m_systemId{this, "systemId", 5, "System ID of the grid cells"};
+  /// Number of layers
+  Gaudi::Property<uint> m_numLayers{this, "numLayers", 8, "Number of layers"};
+  /// Number of bins in eta
+  Gaudi::Property<uint> m_numEta{this, "numEta", 150, "Number of bins in eta"};
+  /// Number of bins in phi
+  Gaudi::Property<uint> m_numPhi{this, "numPhi", 352, "Number of bins in phi"};
+  /// Number of showers per event
+  Gaudi::Property<uint> m_numShowers{this, "numShowers", 5, "Number of electromagnetic showers per event"};
+  /// Energy of a shower
+  Gaudi::Property<double> m_showerEnergy{this, "showerEnergy", 50., "Energy of a shower in GeV"};
+  /// Number of jets per event
+  Gaudi::Property<uint> m_numJets{this, "numJets", 0, "Number of jets per event"};
+  /// Energy of a jet
+  Gaudi::Property<double> m_jetEnergy{this, "jetEnergy", 100., "Energy of a jet in GeV"};
+  /// Number of particles (showers) of a jet
+  Gaudi::Property<uint> m_numJetParticles{this, "numJetParticles", 20, "Number of particles of a jet"};
+  /// Spread of the jet particles around the jet axis
+  Gaudi::Property<double> m_jetWidth{this, "jetWidth", 5., "Spread of the jet particles in eta and phi, in bins"};
+  /// Number of pileup interactions
+  Gaudi::Property<uint> m_pileup{this, "pileup", 0, "Number of pileup interactions per event"};
+  /// Number of hits per pileup interaction
+  Gaudi::Property<uint> m_pileupHitsPerEvent{this, "pileupHitsPerEvent", 100,
+                                             "Number of hits per pileup interaction"};
+  /// Mean energy of a pileup hit
+  Gaudi::Property<double> m_pileupHitEnergy{this, "pileupHitEnergy", 0.05, "Mean energy of a pileup hit in GeV"};
+  /// Fraction of the energy deposited in the active material
+  Gaudi::Property<double> m_samplingFraction{this, "samplingFraction", 1.,
+                                             "Fraction of the energy deposited in the active material"};
+  /// Seed of the random numbers
+  Gaudi::Property<uint> m_seed{this, "seed", 1234, "Seed of the random numbers"};
+  /// Number of the first event
+  Gaudi::Property<uint> m_firstEvent{this, "firstEvent", 0, "Number of the first event, to split a sample between jobs"};
+  /// Number of the next event
+  uint64_t m_eventNumber = 0;
+  /// Grid of the cells
+  std::unique_ptr<SyntheticCaloGrid> m_grid;
+  /// Fraction of the energy of an electromagnetic shower in each layer
+  std::vector<double> m_emLayerFractions;
+  /// Fraction of the energy of a hadronic shower in each layer
+  std::vector<double> m_hadLayerFractions;
+  /// Number of bins in eta and phi from the shower axis with shower energy
+  static constexpr int m_lateralHalfSize = 2;
+  /// Fraction of the layer energy in each cell around the shower axis (eta-major)
+  std::vector<double> m_lateralFractions;
+};
+
+#endif /* RECCALORIMETER_CREATESYNTHETICCALOHITS_H */
@@ -0,0 +1,115 @@
+#ifndef RECCALORIMETER_EVENTBUDGET_H
+#define RECCALORIMETER_EVENTBUDGET_H
+
+// Gaudi
+#include "Gaudi/Accumulators.h"
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+/** @class EventBudget Reconstruction/RecCalorimeter/src/components/EventBudget.h
+ *
+ *  Per-event limits of the work of a clustering algorithm, so that a pathological event (noise burst, extreme pileup)
+ *  cannot stall the processing by growing enormous clusters:
+ *   - the number of neighbour lookups;
+ *   - the number of cells of one cluster;
+ *   - the wall time since the start of the event (checked every kTimeCheckInterval lookups).
+ *  A limit <= 0 is disabled, all limits are disabled by default. The budget only records which limits were hit, the
+ *  algorithm decides how to degrade (e.g. raise the neighbour threshold for the rest of the event). As long as no limit
+ *  is hit the algorithm does the same work as without budget, so the results of normal events do not change.
+ *
+ *  The budget lives on the stack of execute(); the events over budget are counted in EventBudget::Counters,
+ *  declared as members of the algorithm and printed at finalize with the other counters.
+ */
+
+class EventBudget {
+public:
+  /// Limits that can be hit
+  enum Limit : unsigned { kNone = 0, kLookups = 1, kClusterCells = 2, kTime = 4 };
+
+  /** Start the budget of an event.
+   *   @param[in] aMaxLookups, maximal number of neighbour lookups.
+   *   @param[in] aMaxClusterCells, maximal number of cells of a cluster.
+   *   @param[in] aMaxTime, maximal time of the event, in ms.
+   */
+  EventBudget(long aMaxLookups, long aMaxClusterCells, double aMaxTime)
+      : m_maxLookups(aMaxLookups), m_maxClusterCells(aMaxClusterCells), m_maxTime(aMaxTime),
+        m_start(std::chrono::steady_clock::now()) {}
+
+  /// Count one neighbour lookup, return false if the event is over its lookup or time budget
+  bool lookup() {
+    m_lookups++;
+    if (m_maxLookups > 0 && m_lookups > m_maxLookups) m_exceeded |= kLookups;
+    if (m_maxTime > 0 && m_lookups % kTimeCheckInterval == 0) checkTime();
+    return withinEvent();
+  }
+  /// Check the time of the event, return false if the event is over its lookup or time budget
+  bool checkTime() {
+    if (m_maxTime > 0 &&
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count() > m_maxTime) {
+      m_exceeded |= kTime;
+    }
+    return withinEvent();
+  }
+  /// Check the size of a cluster, return false (and record it) if the cluster has reached the maximal size
+  bool clusterWithin(size_t aNumCells) {
+    if (m_maxClusterCells > 0 && aNumCells >= size_t(m_maxClusterCells)) {
+      m_exceeded |= kClusterCells;
+      return false;
+    }
+    return true;
+  }
+  /// Whether the event is within its lookup and time budget
+  bool withinEvent() const { return (m_exceeded & (kLookups | kTime)) == 0; }
+  /// Limits hit so far (combination of Limit)
+  unsigned exceeded() const { return m_exceeded; }
+  /// Number of lookups counted
+  long lookups() const { return m_lookups; }
+  /// Names of the limits hit, for the messages
+  std::string exceededNames() const {
+    std::string names;
+    if (m_exceeded & kLookups) names += " neighbour lookups";
+    if (m_exceeded & kClusterCells) names += " cluster cells";
+    if (m_exceeded & kTime) names += " time";
+    return names;
+  }
+
+  /** @class EventBudget::Counters
+   *
+   *  Status counters of the budget: fraction of events over budget, and number of events per limit hit.
+   */
+  class Counters {
+  public:
+    template <typename OWNER>
+    explicit Counters(OWNER* aOwner)
+        : m_overBudget{aOwner, "Events over budget"}, m_overLookups{aOwner, "Over budget: neighbour lookups"},
+          m_overClusterCells{aOwner, "Over budget: cluster cells"}, m_overTime{aOwner, "Over budget: time"} {}
+    /// Record the status of an event
+    Counters& operator+=(const EventBudget& aBudget) {
+      m_overBudget += aBudget.exceeded() != kNone;
+      if (aBudget.exceeded() & kLookups) ++m_overLookups;
+      if (aBudget.exceeded() & kClusterCells) ++m_overClusterCells;
+      if (aBudget.exceeded() & kTime) ++m_overTime;
+      return *this;
+    }
+
+  private:
+    Gaudi::Accumulators::BinomialCounter<> m_overBudget;
+    Gaudi::Accumulators::Counter<> m_overLookups;
+    Gaudi::Accumulators::Counter<> m_overClusterCells;
+    Gaudi::Accumulators::Counter<> m_overTime;
+  };
+
+private:
+  /// Number of lookups between two checks of the time
+  static constexpr long kTimeCheckInterval = 64;
+  long m_maxLookups;
+  long m_maxClusterCells;
+  double m_maxTime;
+  std::chrono::steady_clock::time_point m_start;
+  long m_lookups = 0;
+  unsigned m_exceeded = kNone;
+};
+
+#endif /* RECCALORIMETER_EVENTBUDGET_H */
@@ -0,0 +1,106 @@
+#ifndef RECCALORIMETER_HISTOGRAMFILLBUFFER_H
+#define RECCALORIMETER_HISTOGRAMFILLBUFFER_H
+
+// Gaudi
+#include "Gaudi/Property.h"
+
+// ROOT
+#include "TH1.h"
+#include "TH2.h"
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+/** @class HistogramFillBuffer Reconstruction/RecCalorimeter/src/components/HistogramFillBuffer.h
+ *
+ *  Buffer for the monitoring histograms filled by an algorithm in its event loop.
+ *  The fills are appended to a flat array (histogram, x, y, weight) without touching the histograms, and are merged
+ *  into the registered TH1/TH2 objects by flush(): automatically once "histogramFlushSize" fills are buffered, and at
+ *  the latest when the algorithm calls flush() in finalize, before the histograms are read or written.
+ *
+ *  Each algorithm owns its buffer as a member and fills it from execute(), which is not re-entrant, so the buffer has
+ *  no lock and no lookup per fill. The buffer declares the property "histogramFlushSize" of its owner.
+ *
+ *  At the flush the fills are grouped per histogram and passed to TH1::FillN/TH2::FillN, keeping their order within
+ *  each histogram, so the histograms are identical (bin contents, errors, entries and statistics) to histograms
+ *  filled directly with TH1::Fill. TimeHistogramFills checks this and times the buffered against the direct fills
+ *  (RecCalorimeter/tests/options/runTimeHistogramFills.py).
+ *
+ *  The histograms have to stay alive until the last flush (as for histograms registered in THistSvc).
+ *
+ *  Used by CorrectECalBarrelSliWinCluster, MassInv, CreateCaloClusters and PreparePileup.
+ */
+
+class HistogramFillBuffer {
+public:
+  /// @param[in] aOwner Algorithm owning the buffer, declaring the property "histogramFlushSize"
+  template <typename OWNER>
+  explicit HistogramFillBuffer(OWNER* aOwner)
+      : m_flushSize{aOwner, "histogramFlushSize", 100000,
+                    "Number of buffered histogram fills before merging into the histograms (0: at finalize)"} {}
+  HistogramFillBuffer(const HistogramFillBuffer&) = delete;
+  HistogramFillBuffer& operator=(const HistogramFillBuffer&) = delete;
+
+  /// Buffer TH1::Fill(aX, aWeight)
+  void fill(TH1* aHistogram, double aX, double aWeight = 1.) { add(aHistogram, aX, 0., aWeight); }
+
+  /// Buffer TH2::Fill(aX, aY, aWeight)
+  void fill(TH2* aHistogram, double aX, double aY, double aWeight = 1.) { add(aHistogram, aX, aY, aWeight); }
+
+  /// Merge the buffered fills into the histograms
+  void flush() {
+    // group the fills per histogram, in order of first use
+    std::vector<TH1*> histograms;
+    std::unordered_map<TH1*, std::vector<size_t>> fills;
+    for (size_t i = 0; i < m_histogram.size(); i++) {
+      auto& indices = fills[m_histogram[i]];
+      if (indices.empty()) {
+        histograms.push_back(m_histogram[i]);
+      }
+      indices.push_back(i);
+    }
+    std::vector<double> x, y, weight;
+    for (auto histogram : histograms) {
+      const auto& indices = fills[histogram];
+      x.clear();
+      y.clear();
+      weight.clear();
+      for (auto i : indices) {
+        x.push_back(m_x[i]);
+        y.push_back(m_y[i]);
+        weight.push_back(m_weight[i]);
+      }
+      if (histogram->GetDimension() == 2) {
+        static_cast<TH2*>(histogram)->FillN(indices.size(), x.data(), y.data(), weight.data());
+      } else {
+        histogram->FillN(indices.size(), x.data(), weight.data());
+      }
+    }
+    m_histogram.clear();
+    m_x.clear();
+    m_y.clear();
+    m_weight.clear();
+  }
+
+private:
+  void add(TH1* aHistogram, double aX, double aY, double aWeight) {
+    m_histogram.push_back(aHistogram);
+    m_x.push_back(aX);
+    m_y.push_back(aY);
+    m_weight.push_back(aWeight);
+    if (m_flushSize.value() > 0 && m_histogram.size() >= m_flushSize.value()) {
+      flush();
+    }
+  }
+
+  /// Number of buffered fills after which they are merged
+  Gaudi::Property<uint> m_flushSize;
+  /// Buffered fills: histogram, x, y (0 for TH1) and weight
+  std::vector<TH1*> m_histogram;
+  std::vector<double> m_x;
+  std::vector<double> m_y;
+  std::vector<double> m_weight;
+};
+
+#endif /* RECCALORIMETER_HISTOGRAMFILLBUFFER_H */
@@ -0,0 +1,371 @@
+#ifndef RECCALORIMETER_LARGETABLEMEMORY_H
+#define RECCALORIMETER_LARGETABLEMEMORY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/** @namespace large_table Reconstruction/RecCalorimeter/src/components/LargeTableMemory.h
+ *
+ *  Placement of the large read-only tables (neighbours and noise maps, see SystemPartitionedMap, and the cell position
+ *  caches, see CaloCellPositionCache) in the memory of a multi-socket node, selected at initialize with the properties
+ *  '\b tablePlacement' and '\b hugePages' of the components holding them:
+ *   - placement "default": the pages are placed by the kernel, usually on the node of the thread reading the table;
+ *     "interleave": the pages are spread over all NUMA nodes, so that the threads of all sockets see the same latency
+ *     and share the memory bandwidth of all nodes; "replicate": one copy of the table per NUMA node, each thread reads
+ *     the copy of the node it runs on (the memory of the table is multiplied by the number of nodes);
+ *   - huge pages "none": pages of 4 kB; "transparent": the table is allocated in chunks aligned to 2 MB and advised
+ *     for transparent huge pages (MADV_HUGEPAGE); "explicit": the chunks are taken from the pool of huge pages reserved
+ *     by the administrator (vm.nr_hugepages), with a fallback to transparent huge pages if the pool is empty.
+ *  The containers of a table allocate from an Arena through ArenaAllocator. The small allocations of an arena are only
+ *  released with the arena: the tables are filled once and not modified afterwards. The large ones (bucket arrays of
+ *  the maps) are released when they are freed, so that the rehashes of a growing map do not keep the old arrays.
+ *  The default policy ("default", "none") does not use an arena, the tables are allocated as before.
+ *
+ *  The policies are set with the system calls of Linux (mbind, set_mempolicy), without libnuma. They are hints: if a
+ *  call is not permitted (e.g. in a container) or the node has a single NUMA node, the tables are allocated as with
+ *  the default policy and stay valid. Memory allocated with the standard allocator inside the values of a table (e.g.
+ *  the vectors of neighbours) follows the policy of the thread filling the table, set with ScopedPolicy, but not
+ *  the huge pages.
+ */
+
+namespace large_table {
+
+/// Placement of a table over the NUMA nodes
+enum class Placement { kDefault, kInterleave, kReplicate };
+/// Page size of a table
+enum class HugePages { kNone, kTransparent, kExplicit };
+
+/// Memory policies of the kernel (linux/mempolicy.h)
+constexpr int kMpolDefault = 0;
+constexpr int kMpolPreferred = 1;
+constexpr int kMpolInterleave = 3;
+/// Size of a huge page on x86-64 and aarch64 (with 4 kB pages)
+constexpr size_t kHugePageSize = size_t(2) << 20;
+/// Largest chunk of an arena for small allocations
+constexpr size_t kMaxChunkSize = size_t(64) << 20;
+/// Smallest allocation of an arena taking its own chunk, released when it is freed
+constexpr size_t kOwnChunkSize = kHugePageSize / 4;
+/// Number of NUMA nodes in the masks read from the kernel, at least the number of nodes it supports
+constexpr unsigned long kMaxNumNodes = 1024;
+
+/** @struct large_table::Policy
+ *
+ *  Placement and page size of the tables of a component.
+ */
+struct Policy {
+  Placement placement = Placement::kDefault;
+  HugePages hugePages = HugePages::kNone;
+
+  /// Whether the tables are allocated with the standard allocator
+  bool isDefault() const { return placement == Placement::kDefault && hugePages == HugePages::kNone; }
+
+  /** Set the policy from the values of the properties.
+   *   return empty string on success, the error message otherwise.
+   */
+  std::string parse(const std::string& aPlacement, const std::string& aHugePages) {
+    if (aPlacement == "default") {
+      placement = Placement::kDefault;
+    } else if (aPlacement == "interleave") {
+      placement = Placement::kInterleave;
+    } else if (aPlacement == "replicate") {
+      placement = Placement::kReplicate;
+    } else {
+      return "unknown table placement '" + aPlacement + "', expected default, interleave or replicate";
+    }
+    if (aHugePages == "none") {
+      hugePages = HugePages::kNone;
+    } else if (aHugePages == "transparent") {
+      hugePages = HugePages::kTransparent;
+    } else if (aHugePages == "explicit") {
+      hugePages = HugePages::kExplicit;
+    } else {
+      return "unknown huge pages '" + aHugePages + "', expected none, transparent or explicit";
+    }
+    return "";
+  }
+
+  /// Description for the messages
+  std::string description() const {
+    static const char* placements[] = {"default placement", "interleaved over the NUMA nodes",
+                                       "replicated per NUMA node"};
+    static const char* pages[] = {"4 kB pages", "transparent huge pages", "explicit huge pages"};
+    return std::string(placements[int(placement)]) + ", " + pages[int(hugePages)];
+  }
+};
+
+/// NUMA nodes online, read once from /sys/devices/system/node/online ("0-1", "0,2-3"); {0} if unknown
+inline const std::vector<int>& onlineNodes() {
+  static const std::vector<int> nodes = []() {
+    std::vector<int> online;
+    std::ifstream file("/sys/devices/system/node/online");
+    std::string range;
+    while (std::getline(file, range, ',')) {
+      try {
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int node = first; node <= last && node < 1024; node++) {
+          online.push_back(node);
+        }
+      } catch (const std::exception&) {
+        break;
+      }
+    }
+    if (online.empty()) online.push_back(0);
+    return online;
+  }();
+  return nodes;
+}
+
+/// Mask of NUMA nodes in the format of the system calls
+class NodeMask {
+public:
+  /// Mask of one node
+  explicit NodeMask(int aNode) { set(aNode); }
+  /// Mask of all nodes online
+  NodeMask() {
+    for (int node : onlineNodes()) {
+      set(node);
+    }
+  }
+  const unsigned long* data() const { return m_bits.data(); }
+  /// Number of bits, as expected by the system calls
+  unsigned long maxNode() const { return m_bits.size() * kBitsPerWord + 1; }
+
+private:
+  static constexpr int kBitsPerWord = 8 * sizeof(unsigned long);
+  void set(int aNode) {
+    if (size_t(aNode / kBitsPerWord) >= m_bits.size()) m_bits.resize(aNode / kBitsPerWord + 1, 0);
+    m_bits[aNode / kBitsPerWord] |= 1UL << (aNode % kBitsPerWord);
+  }
+  std::vector<unsigned long> m_bits;
+};
+
+/** NUMA node of the calling thread.
+ *  The node is cached per thread and read again every kNodeCheckInterval calls, so that the lookups of the tables do
+ *  not make a system call each, and a thread moved to another socket reads the copy of its new node soon after.
+ */
+inline int currentNode() {
+  constexpr unsigned kNodeCheckInterval = 4096;
+  thread_local unsigned calls = 0;
+  thread_local int node = 0;
+  if (calls++ % kNodeCheckInterval == 0) {
+    unsigned cpu = 0, currentNode = 0;
+    node = syscall(SYS_getcpu, &cpu, &currentNode, nullptr) == 0 ? int(currentNode) : 0;
+  }
+  return node;
+}
+
+/** @class large_table::ScopedPolicy
+ *
+ *  Memory policy of the calling thread while a table is filled: the pages allocated by the thread, also with the
+ *  standard allocator, are interleaved over all nodes, or preferably taken from one node (replicate). The previous
+ *  policy of the thread (e.g. set with numactl for the whole job) is restored at the end of the scope; if it cannot
+ *  be read, the policy is not changed.
+ */
+class ScopedPolicy {
+public:
+  /** Set the policy of the thread.
+   *   @param[in] aPlacement, placement of the table; nothing is done for the default placement.
+   *   @param[in] aNode, node of the copy of the table (replicate).
+   */
+  ScopedPolicy(Placement aPlacement, int aNode) : m_previousNodes(kMaxNumNodes / kBitsPerWord, 0) {
+    if (aPlacement == Placement::kDefault) return;
+    if (syscall(SYS_get_mempolicy, &m_previousMode, m_previousNodes.data(), kMaxNumNodes, nullptr, 0) != 0) return;
+    if (aPlacement == Placement::kInterleave) {
+      NodeMask mask;
+      m_active = syscall(SYS_set_mempolicy, kMpolInterleave, mask.data(), mask.maxNode()) == 0;
+    } else if (aPlacement == Placement::kReplicate) {
+      NodeMask mask(aNode);
+      m_active = syscall(SYS_set_mempolicy, kMpolPreferred, mask.data(), mask.maxNode()) == 0;
+    }
+  }
+  ~ScopedPolicy() {
+    if (m_active) syscall(SYS_set_mempolicy, m_previousMode, m_previousNodes.data(), kMaxNumNodes);
+  }
+  ScopedPolicy(const ScopedPolicy&) = delete;
+  ScopedPolicy& operator=(const ScopedPolicy&) = delete;
+
+  /// Whether the policy was accepted by the kernel
+  bool active() const { return m_active; }
+
+private:
+  static constexpr unsigned long kBitsPerWord = 8 * sizeof(unsigned long);
+  bool m_active = false;
+  /// Policy of the thread before the scope, with its mode flags
+  int m_previousMode = kMpolDefault;
+  std::vector<unsigned long> m_previousNodes;
+};
+
+/** @class large_table::Arena
+ *
+ *  Memory of one table (or one copy of a table): chunks mapped with the page size and bound to the NUMA nodes of the
+ *  policy, from which the allocations are taken in order. The chunks grow from 2 MB up to kMaxChunkSize, and are
+ *  unmapped with the arena; deallocations in them are ignored. Allocations of at least kOwnChunkSize (bucket arrays)
+ *  get their own chunk, unmapped when they are deallocated.
+ *  An arena is filled by one thread at a time.
+ */
+class Arena {
+public:
+  /** Create an empty arena.
+   *   @param[in] aPolicy, placement and page size.
+   *   @param[in] aNode, node of the copy of the table (replicate).
+   */
+  Arena(const Policy& aPolicy, int aNode) : m_policy(aPolicy), m_node(aNode) {}
+  ~Arena() {
+    for (const auto& chunk : m_chunks) {
+      munmap(chunk.first, chunk.second);
+    }
+    for (const auto& chunk : m_ownChunks) {
+      munmap(chunk.first, chunk.second);
+    }
+  }
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /// Allocate aBytes aligned to aAlignment (a power of two, at most the page size)
+  void* allocate(size_t aBytes, size_t aAlignment) {
+    if (aBytes >= kOwnChunkSize) {
+      m_ownChunks.push_back(mapChunk(aBytes));
+      return m_ownChunks.back().first;
+    }
+    size_t offset = (m_used + aAlignment - 1) & ~(aAlignment - 1);
+    if (m_chunks.empty() || offset + aBytes > m_chunks.back().second) {
+      m_nextChunkSize = std::min(m_nextChunkSize * 2, kMaxChunkSize);
+      m_chunks.push_back(mapChunk(m_nextChunkSize));
+      offset = 0;
+    }
+    m_used = offset + aBytes;
+    return static_cast<char*>(m_chunks.back().first) + offset;
+  }
+  /// Release an allocation of aBytes if it has its own chunk, otherwise its memory stays in the arena
+  void deallocate(void* aPointer, size_t aBytes) {
+    if (aBytes < kOwnChunkSize) return;
+    auto chunk = std::find_if(m_ownChunks.begin(), m_ownChunks.end(),
+                              [aPointer](const std::pair<void*, size_t>& aChunk) { return aChunk.first == aPointer; });
+    if (chunk == m_ownChunks.end()) return;
+    munmap(chunk->first, chunk->second);
+    m_ownChunks.erase(chunk);
+  }
+
+  /// Memory mapped by the arena, in bytes
+  size_t mappedBytes() const {
+    size_t bytes = 0;
+    for (const auto& chunk : m_chunks) {
+      bytes += chunk.second;
+    }
+    for (const auto& chunk : m_ownChunks) {
+      bytes += chunk.second;
+    }
+    return bytes;
+  }
+  /// Whether explicit huge pages were requested but not available, transparent huge pages are used instead
+  bool hugePagesFallback() const { return m_hugePagesFallback; }
+
+private:
+  /// Map a chunk of at least aBytes, rounded up to huge pages, and set its placement
+  std::pair<void*, size_t> mapChunk(size_t aBytes) {
+    size_t size = (aBytes + kHugePageSize - 1) & ~(kHugePageSize - 1);
+    void* chunk = MAP_FAILED;
+    if (m_policy.hugePages == HugePages::kExplicit && !m_hugePagesFallback) {
+      chunk = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      m_hugePagesFallback = chunk == MAP_FAILED;
+    }
+    if (chunk == MAP_FAILED) {
+      // aligned to a huge page, so that the kernel can back the whole chunk with transparent huge pages
+      size_t mapped = size + kHugePageSize;
+      char* region =
+          static_cast<char*>(mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+      if (region == MAP_FAILED) throw std::bad_alloc();
+      char* aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(region) + kHugePageSize - 1) &
+                                              ~uintptr_t(kHugePageSize - 1));
+      if (aligned > region) munmap(region, aligned - region);
+      if (region + mapped > aligned + size) munmap(aligned + size, region + mapped - aligned - size);
+      chunk = aligned;
+      if (m_policy.hugePages != HugePages::kNone) madvise(chunk, size, MADV_HUGEPAGE);
+    }
+    // placement of the pages, applied when they are first written
+    if (m_policy.placement == Placement::kInterleave) {
+      NodeMask mask;
+      syscall(SYS_mbind, chunk, size, kMpolInterleave, mask.data(), mask.maxNode(), 0);
+    } else if (m_policy.placement == Placement::kReplicate) {
+      NodeMask mask(m_node);
+      syscall(SYS_mbind, chunk, size, kMpolPreferred, mask.data(), mask.maxNode(), 0);
+    }
+    return std::make_pair(chunk, size);
+  }
+
+  Policy m_policy;
+  int m_node;
+  /// Mapped chunks of the small allocations and their sizes, the last one is filled
+  std::vector<std::pair<void*, size_t>> m_chunks;
+  /// Chunks of the large allocations and their sizes
+  std::vector<std::pair<void*, size_t>> m_ownChunks;
+  /// Bytes used in the last chunk
+  size_t m_used = 0;
+  /// Size of the next chunk for small allocations
+  size_t m_nextChunkSize = kHugePageSize / 2;
+  bool m_hugePagesFallback = false;
+};
+
+/** @class large_table::ArenaAllocator
+ *
+ *  Allocator of the containers of a table, taking the memory from an arena, or from the standard allocator if the
+ *  arena is null (default policy, and default-constructed containers).
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+  typedef T value_type;
+  /// A container assigned from another one takes its arena
+  typedef std::true_type propagate_on_container_copy_assignment;
+  typedef std::true_type propagate_on_container_move_assignment;
+  typedef std::true_type propagate_on_container_swap;
+
+  ArenaAllocator() = default;
+  explicit ArenaAllocator(Arena* aArena) : m_arena(aArena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& aOther) : m_arena(aOther.arena()) {}
+
+  T* allocate(size_t aNum) {
+    if (m_arena == nullptr) return std::allocator<T>().allocate(aNum);
+    return static_cast<T*>(m_arena->allocate(aNum * sizeof(T), alignof(T)));
+  }
+  void deallocate(T* aPointer, size_t aNum) {
+    if (m_arena == nullptr) {
+      std::allocator<T>().deallocate(aPointer, aNum);
+    } else {
+      m_arena->deallocate(aPointer, aNum * sizeof(T));
+    }
+  }
+  Arena* arena() const { return m_arena; }
+
+private:
+  Arena* m_arena = nullptr;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& aLeft, const ArenaAllocator<U>& aRight) {
+  return aLeft.arena() == aRight.arena();
+}
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& aLeft, const ArenaAllocator<U>& aRight) {
+  return !(aLeft == aRight);
+}
+
+}  // namespace large_table
+
+#endif /* RECCALORIMETER_LARGETABLEMEMORY_H */
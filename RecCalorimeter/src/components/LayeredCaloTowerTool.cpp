@@ -76,6 +76,9 @@ tower LayeredCaloTowerTool::towersNumber() {
   m_nEtaTower = ceil(2 * (m_etaMax - epsilon) / m_deltaEtaTower);
   debug() << "etaMax " << m_etaMax << ", deltaEtaTower " << m_deltaEtaTower << ", nEtaTower " << m_nEtaTower << endmsg;
   debug() << "phiMax " << m_phiMax << ", deltaPhiTower " << m_deltaPhiTower << ", nPhiTower " << m_nPhiTower << endmsg;
+  // the tower IDs and centres are given by the descriptor of the grid, the tables are reused if the grid is the same
+  m_geometry = TowerGeometry(m_nEtaTower, m_nPhiTower, -m_etaMax, m_deltaEtaTower, -m_phiMax, m_deltaPhiTower, m_radius,
+                             false, m_geometryTables);
 
   tower total;
   total.eta = m_nEtaTower;
@@ -179,34 +182,23 @@ uint LayeredCaloTowerTool::buildTowers(std::vector<std::vector<float>>& aTowers)
   return cells->size();
 }
 
-uint LayeredCaloTowerTool::idEta(float aEta) const {
-  uint id = floor((aEta + m_etaMax) / m_deltaEtaTower);
-  return id;
-}
+uint LayeredCaloTowerTool::idEta(float aEta) const { return m_geometry.idEta(aEta); }
 
-uint LayeredCaloTowerTool::idPhi(float aPhi) const {
-  uint id = floor((aPhi + m_phiMax) / m_deltaPhiTower);
-  return id;
-}
+uint LayeredCaloTowerTool::idPhi(float aPhi) const { return m_geometry.idPhi(aPhi); }
 
 float LayeredCaloTowerTool::eta(int aIdEta) const {
   // middle of the tower
-  return ((aIdEta + 0.5) * m_deltaEtaTower - m_etaMax);
+  return m_geometry.eta(aIdEta);
 }
 
 float LayeredCaloTowerTool::phi(int aIdPhi) const {
   // middle of the tower
-  return ((aIdPhi + 0.5) * m_deltaPhiTower - m_phiMax);
+  return m_geometry.phi(aIdPhi);
 }
 
-uint LayeredCaloTowerTool::phiNeighbour(int aIPhi) const {
-  if (aIPhi < 0) {
-    return m_nPhiTower + aIPhi;
-  } else if (aIPhi >= m_nPhiTower) {
-    return aIPhi % m_nPhiTower;
-  }
-  return aIPhi;
-}
+const TowerGeometry& LayeredCaloTowerTool::towerGeometry() const { return m_geometry; }
+
+uint LayeredCaloTowerTool::phiNeighbour(int aIPhi) const { return m_geometry.phiNeighbour(aIPhi); }
 
 float LayeredCaloTowerTool::radiusForPosition() const { return m_radius; }
 
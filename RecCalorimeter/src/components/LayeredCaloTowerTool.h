@@ -8,6 +8,8 @@
 #include "DetSegmentation/FCCSWGridPhiEta.h"
 #include "k4FWCore/DataHandle.h"
 #include "k4Interface/ITowerTool.h"
+
+#include "TowerGeometry.h"
 class IGeoSvc;
 
 // datamodel
@@ -41,6 +43,8 @@ class Segmentation;
  *  It will only consider cells within the defined layers of the calorimeter, if the layers are defined by 'layer'
  * bitfield. By default it uses 0 to 130th layer.
  *
+ *  The grid of the towers is described by a TowerGeometry, computed by towersNumber().
+ *
  *  For more explanation please [see reconstruction documentation](@ref
  * md_reconstruction_doc_reccalorimeter).
  *
@@ -48,7 +52,7 @@ class Segmentation;
  *  @author Jana Faltova
  */
 
-class LayeredCaloTowerTool : public GaudiTool, virtual public ITowerTool {
+class LayeredCaloTowerTool : public GaudiTool, virtual public ITowerTool, public TowerGeometry::Provider {
 public:
   LayeredCaloTowerTool(const std::string& type, const std::string& name, const IInterface* parent);
   virtual ~LayeredCaloTowerTool() = default;
@@ -108,6 +112,10 @@ public:
    *   @return Position of the centre of the tower
    */
   virtual float phi(int aIdPhi) const final;
+  /**  Get the descriptor of the tower grid, with the queries above as inline functions (see TowerGeometry.h).
+   *   @return Descriptor of the grid computed by towersNumber()
+   */
+  virtual const TowerGeometry& towerGeometry() const final;
   /**  Correct way to access the neighbour of the phi tower, taking into account
    * the full coverage in phi.
    *   Full coverage means that first tower in phi, with ID = 0 is a direct
@@ -161,6 +169,10 @@ private:
   int m_nEtaTower;
   /// Number of towers in phi (calculated from m_deltaPhiTower)
   int m_nPhiTower;
+  /// Descriptor of the tower grid, computed by towersNumber()
+  TowerGeometry m_geometry;
+  /// Tables of the tower centres of the descriptor
+  TowerGeometry::Tables m_geometryTables;
 };
 
 #endif /* RECCALORIMETER_LAYEREDCALOTOWERTOOL_H */
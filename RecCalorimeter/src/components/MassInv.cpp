@@ -371,6 +371,10 @@ StatusCode MassInv::initialize() {
   m_nEtaTower = towerMapSize.eta;
   m_nPhiTower = towerMapSize.phi;
   debug() << "Number of calorimeter towers (eta x phi) : " << m_nEtaTower << " x " << m_nPhiTower << endmsg;
+  if (!m_towerGeometry.reset(*m_towerTool, m_nEtaTower, m_nPhiTower)) {
+    info() << "The tower tool does not describe its grid, the tower IDs are derived from the centres of the towers"
+           << endmsg;
+  }
 
   return StatusCode::SUCCESS;
 }
@@ -491,7 +495,7 @@ StatusCode MassInv::execute() {
         double eta = segmentation->eta(cell->getCellID());
         sumEtaLayer[layer] += (weightLog * eta);
         sumWeightLayer[layer] += weightLog;
-        m_hDiffEtaHitLayer[layer]->Fill(eta - etaVertex);
+        m_histogramFills.fill(m_hDiffEtaHitLayer[layer], eta - etaVertex);
       }
       // calculate eta position weighting with energy deposited in layer
       // this energy is a good estimator of 1/sigma^2 of (eta_barycentre-eta_MC) distribution
@@ -499,7 +503,7 @@ StatusCode MassInv::execute() {
         if (sumWeightLayer[iLayer] > 1e-10) {
           sumEtaLayer[iLayer] /= sumWeightLayer[iLayer];
           newEta += sumEtaLayer[iLayer] * sumEnLayer[iLayer];
-          m_hDiffEtaLayer[iLayer]->Fill(sumEtaLayer[iLayer] - etaVertex);
+          m_histogramFills.fill(m_hDiffEtaLayer[iLayer], sumEtaLayer[iLayer] - etaVertex);
         }
       }
       newEta /= energy;
@@ -531,7 +535,7 @@ StatusCode MassInv::execute() {
         double presamplerShift = P00 + P01 * cluster.getEnergy();
         double presamplerScale = P10 + P11 * sqrt(cluster.getEnergy());
         double energyFront = presamplerShift + presamplerScale * sumEnFirstLayer * m_samplingFraction[0];
-        m_hUpstreamEnergy->Fill(energyFront);
+        m_histogramFills.fill(m_hUpstreamEnergy, energyFront);
         newCluster.setEnergy(newCluster.getEnergy() + energyFront);
       }
     }
@@ -547,19 +551,19 @@ StatusCode MassInv::execute() {
       noise = m_constPileupNoise * m_gauss.shoot() * std::sqrt(static_cast<int>(m_mu));
     }
     newCluster.setEnergy(newCluster.getEnergy() + noise);
-    m_hPileupEnergy->Fill(noise);
+    m_histogramFills.fill(m_hPileupEnergy, noise);
 
     // Fill histograms
-    m_hEnergyPreAnyCorrections->Fill(oldEnergy);
-    m_hEnergyPostAllCorrections->Fill(newCluster.getEnergy());
-    m_hEnergyPostAllCorrectionsAndScaling->Fill(newCluster.getEnergy() / m_response);
+    m_histogramFills.fill(m_hEnergyPreAnyCorrections, oldEnergy);
+    m_histogramFills.fill(m_hEnergyPostAllCorrections, newCluster.getEnergy());
+    m_histogramFills.fill(m_hEnergyPostAllCorrectionsAndScaling, newCluster.getEnergy() / m_response);
 
     // Position resolution
-    m_hEta->Fill(newEta);
-    m_hPhi->Fill(oldPhi);
+    m_histogramFills.fill(m_hEta, newEta);
+    m_histogramFills.fill(m_hPhi, oldPhi);
     verbose() << " energy " << energy << "   numCells = " << numCells << " old energy = " << oldEnergy <<
       " newEta " << newEta << "   phi = " << oldPhi << " theta = " << 2 * atan( exp( - newEta ) ) << endmsg;
-    m_hNumCells->Fill(numCells);
+    m_histogramFills.fill(m_hNumCells, numCells);
     // // Calculate pointing resolution
     // TGraphErrors gZR = TGraphErrors();
     // for (uint iLayer = 0; iLayer < m_numLayers; iLayer++) {
@@ -572,9 +576,9 @@ StatusCode MassInv::execute() {
 
     // Fill histograms for single particle events
     if (particle->size() == 1) {
-      m_hDiffEta->Fill(newEta - etaVertex);
-      m_hDiffPhi->Fill(oldPhi - phiVertex);
-      m_hDiffTheta->Fill( 2 * atan( exp( - newEta ) ) - thetaVertex);
+      m_histogramFills.fill(m_hDiffEta, newEta - etaVertex);
+      m_histogramFills.fill(m_hDiffPhi, oldPhi - phiVertex);
+      m_histogramFills.fill(m_hDiffTheta,  2 * atan( exp( - newEta ) ) - thetaVertex);
     }
 
     // For invariant mass calculation
@@ -615,8 +619,8 @@ StatusCode MassInv::execute() {
   for (const auto candidate1: clustersMassInv) {
     for (const auto candidate2: clustersMassInv) {
       if ( candidate1 != candidate2) {
-        m_hMassInv->Fill((candidate1 + candidate2).Mag() * m_massInvCorrection);
-        m_hDiPT->Fill((candidate1 + candidate2).Pt());
+        m_histogramFills.fill(m_hMassInv, (candidate1 + candidate2).Mag() * m_massInvCorrection);
+        m_histogramFills.fill(m_hDiPT, (candidate1 + candidate2).Pt());
       }
     }
   }
@@ -626,22 +630,23 @@ StatusCode MassInv::execute() {
     std::sort(clustersMassInvScaled.begin(), clustersMassInvScaled.end(), [](TLorentzVector photon1, TLorentzVector photon2) { return photon1.Pt() > photon2.Pt(); });
     double diPhotonMass = (clustersMassInvScaled[0] + clustersMassInvScaled[1]).Mag() * m_massInvCorrection;
     double diPhotonPt = (clustersMassInvScaled[0] + clustersMassInvScaled[1]).Pt();
-    m_hDiPTScaled->Fill(diPhotonPt);
-    m_hMassInvScaled->Fill(diPhotonMass);
-    m_hMassInvScaledPt->Fill(diPhotonMass, diPhotonPt);
+    m_histogramFills.fill(m_hDiPTScaled, diPhotonPt);
+    m_histogramFills.fill(m_hMassInvScaled, diPhotonMass);
+    m_histogramFills.fill(m_hMassInvScaledPt, diPhotonMass, diPhotonPt);
     if ( diPhotonPt > 100) {
-      m_hMassInvScaled100->Fill(diPhotonMass);
+      m_histogramFills.fill(m_hMassInvScaled100, diPhotonMass);
     }
     if ( diPhotonPt > 200) {
-      m_hMassInvScaled200->Fill(diPhotonMass);
+      m_histogramFills.fill(m_hMassInvScaled200, diPhotonMass);
     }
     if ( diPhotonPt > 300) {
-      m_hMassInvScaled300->Fill(diPhotonMass);
+      m_histogramFills.fill(m_hMassInvScaled300, diPhotonMass);
     }
 
     // create towers
     m_towers.assign(m_nEtaTower, std::vector<float>(m_nPhiTower, 0));
     m_towerTool->buildTowers(m_towers);
+    const TowerGeometry geometry = m_towerGeometry.get();
     // check all isolation windows around photons
     debug() << "Number of photon candidates: " << clustersMassInvScaled.size() << endmsg;
     for (uint iCluster = 0; iCluster < m_etaSizes.size(); iCluster++) {
@@ -651,80 +656,80 @@ StatusCode MassInv::execute() {
       int halfPhiWin = floor(m_phiSizes[iCluster] / 2.);
       debug() << "Half-size of the reconstruction window (eta,phi) " << halfEtaWin << ", " << halfPhiWin << endmsg;
       for ( auto photonCandidate = clustersMassInvScaled.begin(); photonCandidate != clustersMassInvScaled.end(); photonCandidate++ ) {
-        uint photonIdEta = m_towerTool->idEta(photonCandidate->Eta());
-        uint photonIdPhi = m_towerTool->idPhi(photonCandidate->Phi());
+        uint photonIdEta = geometry.idEta(photonCandidate->Eta());
+        uint photonIdPhi = geometry.idPhi(photonCandidate->Phi());
         // LOOK AROUND
         double sumWindow = 0;
         for (int iEtaWindow = photonIdEta - halfEtaWin; iEtaWindow <= photonIdEta + halfEtaWin; iEtaWindow++) {
           for (int iPhiWindow = photonIdPhi - halfPhiWin; iPhiWindow <= photonIdPhi + halfPhiWin; iPhiWindow++) {
-            sumWindow += m_towers[iEtaWindow][phiNeighbour(iPhiWindow, m_nPhiTower)];
+            sumWindow += m_towers[iEtaWindow][geometry.phiNeighbour(iPhiWindow)];
           }
         }
-        m_hHCalEnergy->Fill(sumWindow);
+        m_histogramFills.fill(m_hHCalEnergy, sumWindow);
         if(sumWindow > m_hcalEnergyThreshold) {
           clustersMassInvScaled.erase(photonCandidate);
           photonCandidate--;
         }
       }
       for ( auto photonCandidate = clustersMassInvScaled2.begin(); photonCandidate != clustersMassInvScaled2.end(); photonCandidate++ ) {
-        uint photonIdEta = m_towerTool->idEta(photonCandidate->Eta());
-        uint photonIdPhi = m_towerTool->idPhi(photonCandidate->Phi());
+        uint photonIdEta = geometry.idEta(photonCandidate->Eta());
+        uint photonIdPhi = geometry.idPhi(photonCandidate->Phi());
         // LOOK AROUND
         double sumWindow = 0;
         for (int iEtaWindow = photonIdEta - halfEtaWin; iEtaWindow <= photonIdEta + halfEtaWin; iEtaWindow++) {
           for (int iPhiWindow = photonIdPhi - halfPhiWin; iPhiWindow <= photonIdPhi + halfPhiWin; iPhiWindow++) {
-            sumWindow += m_towers[iEtaWindow][phiNeighbour(iPhiWindow, m_nPhiTower)];
+            sumWindow += m_towers[iEtaWindow][geometry.phiNeighbour(iPhiWindow)];
           }
         }
-        m_hHCalEnergy->Fill(sumWindow);
+        m_histogramFills.fill(m_hHCalEnergy, sumWindow);
         if(sumWindow > m_hcalEnergyThreshold * 0.1) {
           clustersMassInvScaled2.erase(photonCandidate);
           photonCandidate--;
         }
       }
       for ( auto photonCandidate = clustersMassInvScaled3.begin(); photonCandidate != clustersMassInvScaled3.end(); photonCandidate++ ) {
-        uint photonIdEta = m_towerTool->idEta(photonCandidate->Eta());
-        uint photonIdPhi = m_towerTool->idPhi(photonCandidate->Phi());
+        uint photonIdEta = geometry.idEta(photonCandidate->Eta());
+        uint photonIdPhi = geometry.idPhi(photonCandidate->Phi());
         // LOOK AROUND
         double sumWindow = 0;
         for (int iEtaWindow = photonIdEta - halfEtaWin; iEtaWindow <= photonIdEta + halfEtaWin; iEtaWindow++) {
           for (int iPhiWindow = photonIdPhi - halfPhiWin; iPhiWindow <= photonIdPhi + halfPhiWin; iPhiWindow++) {
-            sumWindow += m_towers[iEtaWindow][phiNeighbour(iPhiWindow, m_nPhiTower)];
+            sumWindow += m_towers[iEtaWindow][geometry.phiNeighbour(iPhiWindow)];
           }
         }
-        m_hHCalEnergy->Fill(sumWindow);
+        m_histogramFills.fill(m_hHCalEnergy, sumWindow);
         if(sumWindow > m_hcalEnergyThreshold * 0.2) {
           clustersMassInvScaled3.erase(photonCandidate);
           photonCandidate--;
         }
       }
       for ( auto photonCandidate = clustersMassInvScaled4.begin(); photonCandidate != clustersMassInvScaled4.end(); photonCandidate++ ) {
-        uint photonIdEta = m_towerTool->idEta(photonCandidate->Eta());
-        uint photonIdPhi = m_towerTool->idPhi(photonCandidate->Phi());
+        uint photonIdEta = geometry.idEta(photonCandidate->Eta());
+        uint photonIdPhi = geometry.idPhi(photonCandidate->Phi());
         // LOOK AROUND
         double sumWindow = 0;
         for (int iEtaWindow = photonIdEta - halfEtaWin; iEtaWindow <= photonIdEta + halfEtaWin; iEtaWindow++) {
           for (int iPhiWindow = photonIdPhi - halfPhiWin; iPhiWindow <= photonIdPhi + halfPhiWin; iPhiWindow++) {
-            sumWindow += m_towers[iEtaWindow][phiNeighbour(iPhiWindow, m_nPhiTower)];
+            sumWindow += m_towers[iEtaWindow][geometry.phiNeighbour(iPhiWindow)];
           }
         }
-        m_hHCalEnergy->Fill(sumWindow);
+        m_histogramFills.fill(m_hHCalEnergy, sumWindow);
         if(sumWindow > m_hcalEnergyThreshold * 0.3) {
           clustersMassInvScaled4.erase(photonCandidate);
           photonCandidate--;
         }
       }
       for ( auto photonCandidate = clustersMassInvScaled5.begin(); photonCandidate != clustersMassInvScaled5.end(); photonCandidate++ ) {
-        uint photonIdEta = m_towerTool->idEta(photonCandidate->Eta());
-        uint photonIdPhi = m_towerTool->idPhi(photonCandidate->Phi());
+        uint photonIdEta = geometry.idEta(photonCandidate->Eta());
+        uint photonIdPhi = geometry.idPhi(photonCandidate->Phi());
         // LOOK AROUND
         double sumWindow = 0;
         for (int iEtaWindow = photonIdEta - halfEtaWin; iEtaWindow <= photonIdEta + halfEtaWin; iEtaWindow++) {
           for (int iPhiWindow = photonIdPhi - halfPhiWin; iPhiWindow <= photonIdPhi + halfPhiWin; iPhiWindow++) {
-            sumWindow += m_towers[iEtaWindow][phiNeighbour(iPhiWindow, m_nPhiTower)];
+            sumWindow += m_towers[iEtaWindow][geometry.phiNeighbour(iPhiWindow)];
           }
         }
-        m_hHCalEnergy->Fill(sumWindow);
+        m_histogramFills.fill(m_hHCalEnergy, sumWindow);
         if(sumWindow > m_hcalEnergyThreshold * 0.4) {
           clustersMassInvScaled5.erase(photonCandidate);
           photonCandidate--;
@@ -733,63 +738,63 @@ StatusCode MassInv::execute() {
     }
     double diPhotonMassIsolated = (clustersMassInvScaled[0] + clustersMassInvScaled[1]).Mag() * m_massInvCorrection;
     double diPhotonPtIsolated = (clustersMassInvScaled[0] + clustersMassInvScaled[1]).Pt();
-    m_hMassInvScaledIsolated->Fill(diPhotonMassIsolated);
+    m_histogramFills.fill(m_hMassInvScaledIsolated, diPhotonMassIsolated);
     if ( diPhotonPtIsolated > 100) {
-      m_hMassInvScaledIsolated100->Fill(diPhotonMassIsolated);
+      m_histogramFills.fill(m_hMassInvScaledIsolated100, diPhotonMassIsolated);
     }
     if ( diPhotonPtIsolated > 200) {
-      m_hMassInvScaledIsolated200->Fill(diPhotonMassIsolated);
+      m_histogramFills.fill(m_hMassInvScaledIsolated200, diPhotonMassIsolated);
     }
     if ( diPhotonPtIsolated > 300) {
-      m_hMassInvScaledIsolated300->Fill(diPhotonMassIsolated);
+      m_histogramFills.fill(m_hMassInvScaledIsolated300, diPhotonMassIsolated);
     }
     double diPhotonMassIsolated2 = (clustersMassInvScaled2[0] + clustersMassInvScaled2[1]).Mag() * m_massInvCorrection;
     double diPhotonPtIsolated2 = (clustersMassInvScaled2[0] + clustersMassInvScaled2[1]).Pt();
-    m_hMassInvScaledIsolated2->Fill(diPhotonMassIsolated2);
+    m_histogramFills.fill(m_hMassInvScaledIsolated2, diPhotonMassIsolated2);
     if ( diPhotonPtIsolated2 > 100) {
-      m_hMassInvScaledIsolated2100->Fill(diPhotonMassIsolated2);
+      m_histogramFills.fill(m_hMassInvScaledIsolated2100, diPhotonMassIsolated2);
     }
     if ( diPhotonPtIsolated2 > 200) {
-      m_hMassInvScaledIsolated2200->Fill(diPhotonMassIsolated2);
+      m_histogramFills.fill(m_hMassInvScaledIsolated2200, diPhotonMassIsolated2);
     }
     if ( diPhotonPtIsolated2 > 300) {
-      m_hMassInvScaledIsolated2300->Fill(diPhotonMassIsolated2);
+      m_histogramFills.fill(m_hMassInvScaledIsolated2300, diPhotonMassIsolated2);
     }
     double diPhotonMassIsolated3 = (clustersMassInvScaled3[0] + clustersMassInvScaled3[1]).Mag() * m_massInvCorrection;
     double diPhotonPtIsolated3 = (clustersMassInvScaled3[0] + clustersMassInvScaled3[1]).Pt();
-    m_hMassInvScaledIsolated3->Fill(diPhotonMassIsolated3);
+    m_histogramFills.fill(m_hMassInvScaledIsolated3, diPhotonMassIsolated3);
     if ( diPhotonPtIsolated3 > 100) {
-      m_hMassInvScaledIsolated3100->Fill(diPhotonMassIsolated3);
+      m_histogramFills.fill(m_hMassInvScaledIsolated3100, diPhotonMassIsolated3);
     }
     if ( diPhotonPtIsolated3 > 200) {
-      m_hMassInvScaledIsolated3200->Fill(diPhotonMassIsolated3);
+      m_histogramFills.fill(m_hMassInvScaledIsolated3200, diPhotonMassIsolated3);
     }
     if ( diPhotonPtIsolated3 > 300) {
-      m_hMassInvScaledIsolated3300->Fill(diPhotonMassIsolated3);
+      m_histogramFills.fill(m_hMassInvScaledIsolated3300, diPhotonMassIsolated3);
     }
     double diPhotonMassIsolated4 = (clustersMassInvScaled4[0] + clustersMassInvScaled4[1]).Mag() * m_massInvCorrection;
     double diPhotonPtIsolated4 = (clustersMassInvScaled4[0] + clustersMassInvScaled4[1]).Pt();
-    m_hMassInvScaledIsolated4->Fill(diPhotonMassIsolated4);
+    m_histogramFills.fill(m_hMassInvScaledIsolated4, diPhotonMassIsolated4);
     if ( diPhotonPtIsolated4 > 100) {
-      m_hMassInvScaledIsolated4100->Fill(diPhotonMassIsolated4);
+      m_histogramFills.fill(m_hMassInvScaledIsolated4100, diPhotonMassIsolated4);
     }
     if ( diPhotonPtIsolated4 > 200) {
-      m_hMassInvScaledIsolated4200->Fill(diPhotonMassIsolated4);
+      m_histogramFills.fill(m_hMassInvScaledIsolated4200, diPhotonMassIsolated4);
     }
     if ( diPhotonPtIsolated4 > 300) {
-      m_hMassInvScaledIsolated4300->Fill(diPhotonMassIsolated4);
+      m_histogramFills.fill(m_hMassInvScaledIsolated4300, diPhotonMassIsolated4);
     }
     double diPhotonMassIsolated5 = (clustersMassInvScaled5[0] + clustersMassInvScaled5[1]).Mag() * m_massInvCorrection;
     double diPhotonPtIsolated5 = (clustersMassInvScaled5[0] + clustersMassInvScaled5[1]).Pt();
-    m_hMassInvScaledIsolated5->Fill(diPhotonMassIsolated5);
+    m_histogramFills.fill(m_hMassInvScaledIsolated5, diPhotonMassIsolated5);
     if ( diPhotonPtIsolated5 > 100) {
-      m_hMassInvScaledIsolated5100->Fill(diPhotonMassIsolated5);
+      m_histogramFills.fill(m_hMassInvScaledIsolated5100, diPhotonMassIsolated5);
     }
     if ( diPhotonPtIsolated5 > 200) {
-      m_hMassInvScaledIsolated5200->Fill(diPhotonMassIsolated5);
+      m_histogramFills.fill(m_hMassInvScaledIsolated5200, diPhotonMassIsolated5);
     }
     if ( diPhotonPtIsolated5 > 300) {
-      m_hMassInvScaledIsolated5300->Fill(diPhotonMassIsolated5);
+      m_histogramFills.fill(m_hMassInvScaledIsolated5300, diPhotonMassIsolated5);
     }
     debug() << "Number of photon candidates: " << clustersMassInvScaled.size() << endmsg;
     debug() << "Number of photon candidates: " << clustersMassInvScaled2.size() << endmsg;
@@ -800,7 +805,10 @@ StatusCode MassInv::execute() {
   return StatusCode::SUCCESS;
 }
 
-StatusCode MassInv::finalize() { return GaudiAlgorithm::finalize(); }
+StatusCode MassInv::finalize() {
+  m_histogramFills.flush();
+  return GaudiAlgorithm::finalize();
+}
 
 StatusCode MassInv::initNoiseFromFile() {
   // check if file exists
@@ -9,6 +9,9 @@
 // Key4HEP
 #include "k4FWCore/DataHandle.h"
 #include "k4Interface/ITowerTool.h"
+
+#include "TowerGeometry.h"
+
 class IGeoSvc;
 class IRndmGenSvc;
 class ITHistSvc;
@@ -31,6 +34,8 @@ class BitFieldCoder;
 #include "TH1F.h"
 #include "TH2F.h"
 
+#include "HistogramFillBuffer.h"
+
 /** @class MassInv
  *
  *  Apply corrections to a reconstructed cluster.
@@ -264,6 +269,8 @@ private:
 // ISOLATION
   /// Handle for the tower building tool
   ToolHandle<ITowerTool> m_towerTool;
+  /// Descriptor of the tower grid of the tool, copied once per event for the isolation windows
+  TowerGeometry::Source m_towerGeometry;
   // calorimeter towers
   std::vector<std::vector<float>> m_towers;
   /// number of towers in eta (calculated from m_deltaEtaTower and the eta size of the first layer)
@@ -279,6 +286,8 @@ private:
   /// Histogram of total HCal energy
   TH1F* m_hHCalEnergy;
   TH1F* m_hHCalTotalEnergy;
+  /// Buffer of the histogram fills in the event loop, merged into the histograms at the latest in finalize
+  HistogramFillBuffer m_histogramFills{this};
 };
 
 #endif /* RECCALORIMETER_CORRECTCLUSTER_H */
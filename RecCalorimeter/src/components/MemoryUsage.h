@@ -0,0 +1,105 @@
+#ifndef RECCALORIMETER_MEMORYUSAGE_H
+#define RECCALORIMETER_MEMORYUSAGE_H
+
+// Gaudi
+#include "Gaudi/Accumulators.h"
+
+#include <cstddef>
+#include <map>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/** @namespace MemoryUsage Reconstruction/RecCalorimeter/src/components/MemoryUsage.h
+ *
+ *  Estimates of the heap memory of the standard containers used for the maps and transient data of the calorimeter
+ *  reconstruction (neighbours and noise maps, cell maps, cells in towers, proto-clusters).
+ *
+ *  The estimate counts the allocated elements (capacity of vectors, nodes of maps including the pointers
+ *  of the libstdc++ node layout, bucket arrays of unordered maps) and, recursively, the memory of nested containers.
+ *  It does not include the overhead of the allocator, so it is a lower bound of the resident memory, but it allows to
+ *  attribute the memory of a job to its tables.
+ *  The sizes are recorded in kB, in counters declared as members of the algorithms and tools: one entry at initialize
+ *  for the tables of a tool, one entry per event for the transient containers, so that the maximum of the counter is
+ *  the high-water mark. They are printed at finalize with the other counters.
+ */
+
+namespace MemoryUsage {
+/// Counter of the memory, in kB
+typedef Gaudi::Accumulators::StatCounter<double> Counter;
+
+/// Conversion of an estimate in bytes to the unit of the counters
+inline double kiloBytes(size_t aBytes) { return aBytes / 1024.; }
+
+/// Whether a type owns heap memory that is counted by heapBytes
+template <typename T>
+struct OwnsHeap : std::false_type {};
+template <typename T, typename A>
+struct OwnsHeap<std::vector<T, A>> : std::true_type {};
+template <typename K, typename V, typename C, typename A>
+struct OwnsHeap<std::map<K, V, C, A>> : std::true_type {};
+template <typename K, typename V, typename H, typename E, typename A>
+struct OwnsHeap<std::unordered_map<K, V, H, E, A>> : std::true_type {};
+template <typename T1, typename T2>
+struct OwnsHeap<std::pair<T1, T2>> : std::integral_constant<bool, OwnsHeap<T1>::value || OwnsHeap<T2>::value> {};
+
+/// Heap memory of a value without owned memory
+template <typename T>
+size_t heapBytes(const T&) {
+  return 0;
+}
+template <typename T1, typename T2>
+size_t heapBytes(const std::pair<T1, T2>& aPair);
+template <typename T, typename A>
+size_t heapBytes(const std::vector<T, A>& aVector);
+template <typename K, typename V, typename C, typename A>
+size_t heapBytes(const std::map<K, V, C, A>& aMap);
+template <typename K, typename V, typename H, typename E, typename A>
+size_t heapBytes(const std::unordered_map<K, V, H, E, A>& aMap);
+
+/// Heap memory of the members of a pair
+template <typename T1, typename T2>
+size_t heapBytes(const std::pair<T1, T2>& aPair) {
+  return heapBytes(aPair.first) + heapBytes(aPair.second);
+}
+
+/// Heap memory of a vector: allocated elements and their own memory
+template <typename T, typename A>
+size_t heapBytes(const std::vector<T, A>& aVector) {
+  size_t bytes = aVector.capacity() * sizeof(T);
+  if constexpr (OwnsHeap<T>::value) {
+    for (const auto& element : aVector) {
+      bytes += heapBytes(element);
+    }
+  }
+  return bytes;
+}
+
+/// Heap memory of a map: one node (colour, parent, left and right pointers) per element, and its own memory
+template <typename K, typename V, typename C, typename A>
+size_t heapBytes(const std::map<K, V, C, A>& aMap) {
+  size_t bytes = aMap.size() * (sizeof(typename std::map<K, V, C, A>::value_type) + 4 * sizeof(void*));
+  if constexpr (OwnsHeap<K>::value || OwnsHeap<V>::value) {
+    for (const auto& element : aMap) {
+      bytes += heapBytes(element.first) + heapBytes(element.second);
+    }
+  }
+  return bytes;
+}
+
+/// Heap memory of an unordered map: bucket array, one node (next pointer) per element, and its own memory
+template <typename K, typename V, typename H, typename E, typename A>
+size_t heapBytes(const std::unordered_map<K, V, H, E, A>& aMap) {
+  size_t bytes = aMap.bucket_count() * sizeof(void*) +
+                 aMap.size() * (sizeof(typename std::unordered_map<K, V, H, E, A>::value_type) + sizeof(void*));
+  if constexpr (OwnsHeap<K>::value || OwnsHeap<V>::value) {
+    for (const auto& element : aMap) {
+      bytes += heapBytes(element.first) + heapBytes(element.second);
+    }
+  }
+  return bytes;
+}
+}
+
+#endif /* RECCALORIMETER_MEMORYUSAGE_H */
@@ -0,0 +1,22 @@
+#ifndef RECCALORIMETER_NONEIGHBOURS_H
+#define RECCALORIMETER_NONEIGHBOURS_H
+
+#include <cstdint>
+#include <vector>
+
+/** Neighbours returned by the neighbours maps (ICaloReadNeighboursMap) for a cell that is not in the map.
+ *
+ *  The interface returns a non-const reference, so the empty vector cannot be a member shared by the threads doing
+ *  the lookups: a caller adding to it would change the neighbours of all missing cells, and race with the other
+ *  threads. Each thread has its own vector instead, emptied at every miss.
+ */
+
+namespace calo_neighbours {
+inline std::vector<uint64_t>& noNeighbours() {
+  static thread_local std::vector<uint64_t> empty;
+  empty.clear();
+  return empty;
+}
+}
+
+#endif /* RECCALORIMETER_NONEIGHBOURS_H */
@@ -41,10 +41,10 @@ StatusCode NoiseCaloCellsFromFileTool::initialize() {
   }
 
 
-  // open and check file, read the histograms with noise constants
-  if (initNoiseFromFile().isFailure()) {
-    error() << "Couldn't open file with noise constants!!!" << endmsg;
-    return StatusCode::FAILURE;
+  // open and check file, read the histograms with noise constants, checked at start
+  if (!m_load.start([this]() { return initNoiseFromFile(); }, m_asyncInitialize) && m_asyncInitialize) {
+    warning() << "ROOT thread safety is not enabled in the job options (ROOT.EnableThreadSafety()), "
+              << "the histograms are read serially" << endmsg;
   }
   // Check if cell position tool available
   if (!m_cellPositionsTool.retrieve() and !m_useSeg) {
@@ -89,6 +89,16 @@ StatusCode NoiseCaloCellsFromFileTool::initialize() {
   return sc;
 }
 
+StatusCode NoiseCaloCellsFromFileTool::start() {
+  StatusCode sc = GaudiTool::start();
+  if (sc.isFailure()) return sc;
+  if (m_load.wait().isFailure()) {
+    error() << "Couldn't open file with noise constants!!!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return sc;
+}
+
 void NoiseCaloCellsFromFileTool::addRandomCellNoise(std::unordered_map<uint64_t, double>& aCells) {
   std::for_each(aCells.begin(), aCells.end(), [this](std::pair<const uint64_t, double>& p) {
     p.second += (getNoiseConstantPerCell(p.first) * m_gauss.shoot());
@@ -15,6 +15,8 @@ class IGeoSvc;
 //DD4hep
 #include "DDSegmentation/MultiSegmentation.h"
 
+#include "AsyncLoad.h"
+
 // Root
 class TH1F;
 
@@ -24,6 +26,7 @@ class TH1F;
  *  Access noise constants from TH1F histogram (noise vs. |eta|)
  *  createRandomCellNoise: Create random CaloHits (gaussian distribution) for the vector of cells
  *  filterCellNoise: remove cells with energy bellow threshold*sigma from the vector of cells
+ *  With '\b asyncInitialize', the histograms are read asynchronously (see AsyncLoad) and are available from start.
  *
  *  @author Jana Faltova
  *  @date   2016-09
@@ -35,6 +38,9 @@ public:
   NoiseCaloCellsFromFileTool(const std::string& type, const std::string& name, const IInterface* parent);
   virtual ~NoiseCaloCellsFromFileTool() = default;
   virtual StatusCode initialize() final;
+  /** Wait for the histograms to be read.
+   */
+  virtual StatusCode start() final;
   virtual StatusCode finalize() final;
 
   /** @brief Create random CaloHits (gaussian distribution) for the vector of cells (aCells).
@@ -76,6 +82,9 @@ private:
       this, "filterNoiseThreshold", 3, " Energy threshold (cells with Ecell < filterThreshold*m_cellNoise removed)"};
   /// Number of radial layers
   Gaudi::Property<uint> m_numRadialLayers{this, "numRadialLayers", 3, "Number of radial layers"};
+  /// Read the histograms asynchronously
+  Gaudi::Property<bool> m_asyncInitialize{this, "asyncInitialize", false,
+                                          "Read the histograms asynchronously, joined before the first event"};
   /// Histograms with pileup constants (index in array - radial layer)
   std::vector<TH1F> m_histoPileupConst;
   /// Histograms with electronics noise constants (index in array - radial layer)
@@ -92,6 +101,12 @@ private:
   dd4hep::DDSegmentation::FCCSWGridPhiEta* m_segmentationPhiEta;
   /// Multi segmentation
   dd4hep::DDSegmentation::MultiSegmentation* m_segmentationMulti;
+  /// Time to read the histograms
+  StageTimer::Counter m_timeLoad{this, "Time load [us]"};
+  /// Time spent waiting for the histograms
+  StageTimer::Counter m_timeWait{this, "Time wait for load [us]"};
+  /// Reading of the histograms
+  AsyncLoad m_load{m_timeLoad, m_timeWait};
 };
 
 #endif /* RECCALORIMETER_NOISECALOCELLSFROMFILETOOL_H */
@@ -0,0 +1,69 @@
+#ifndef RECCALORIMETER_OUTPUTDIFF_H
+#define RECCALORIMETER_OUTPUTDIFF_H
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <string>
+
+/** @class OutputDiff Reconstruction/RecCalorimeter/src/components/OutputDiff.h
+ *
+ *  Readable list of the differences between a reference and a candidate output, written by the comparison algorithms
+ *  (CompareCaloCells, CompareCaloClusters) to a text file, one line per difference prefixed with the event number.
+ *  At most aMaxPerEvent lines are written per event, the number of the other differences of the event is written
+ *  after them. Without a file name, the differences are only counted.
+ */
+
+class OutputDiff {
+public:
+  /** Open the file and write its header.
+   *   @param[in] aFileName, name of the file, no file if empty.
+   *   @param[in] aTitle, first line of the file (compared collections and tolerances).
+   *   @param[in] aMaxPerEvent, maximal number of differences written per event.
+   *   @return false if the file cannot be written.
+   */
+  bool open(const std::string& aFileName, const std::string& aTitle, unsigned aMaxPerEvent) {
+    m_maxPerEvent = aMaxPerEvent;
+    if (aFileName.empty()) return true;
+    m_file.open(aFileName);
+    m_file << "# " << aTitle << '\n';
+    return m_file.good();
+  }
+
+  /// Start the differences of an event
+  void startEvent(unsigned long aEvent) {
+    m_event = aEvent;
+    m_numDiffs = 0;
+  }
+  /// Record a difference, written if the limit of the event is not reached
+  void add(const std::string& aMessage) {
+    if (m_file.is_open() && m_numDiffs < m_maxPerEvent) {
+      m_file << "Event " << m_event << ": " << aMessage << '\n';
+    }
+    m_numDiffs++;
+  }
+  /// End the differences of an event, return their number
+  unsigned endEvent() {
+    if (m_file.is_open() && m_numDiffs > m_maxPerEvent) {
+      m_file << "Event " << m_event << ": " << m_numDiffs - m_maxPerEvent << " more differences\n";
+    }
+    return m_numDiffs;
+  }
+  void close() {
+    if (m_file.is_open()) m_file.close();
+  }
+
+  /// Whether two values agree within an absolute or a relative tolerance
+  static bool agree(double aReference, double aCandidate, double aRelative, double aAbsolute) {
+    return std::abs(aReference - aCandidate) <=
+           aAbsolute + aRelative * std::max(std::abs(aReference), std::abs(aCandidate));
+  }
+
+private:
+  std::ofstream m_file;
+  unsigned m_maxPerEvent = 0;
+  unsigned long m_event = 0;
+  unsigned m_numDiffs = 0;
+};
+
+#endif /* RECCALORIMETER_OUTPUTDIFF_H */
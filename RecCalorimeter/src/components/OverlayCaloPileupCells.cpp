@@ -0,0 +1,106 @@
+#include "OverlayCaloPileupCells.h"
+
+// Gaudi
+#include "GaudiKernel/ThreadLocalContext.h"
+
+// datamodel
+#include "edm4hep/SimCalorimeterHitCollection.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+DECLARE_COMPONENT(OverlayCaloPileupCells)
+
+OverlayCaloPileupCells::OverlayCaloPileupCells(const std::string& name, ISvcLocator* svcLoc)
+    : GaudiAlgorithm(name, svcLoc) {
+  declareProperty("hits", m_hits, "Signal hits (input)");
+  declareProperty("mergedHits", m_mergedHits, "Hits merged into cells with pileup (output)");
+  declareProperty("geometryTool", m_geoTool, "Handle for the geometry tool");
+}
+
+StatusCode OverlayCaloPileupCells::initialize() {
+  StatusCode sc = GaudiAlgorithm::initialize();
+  if (sc.isFailure()) return sc;
+  if (!m_geoTool.retrieve()) {
+    error() << "Unable to retrieve the geometry tool!!!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  std::unordered_map<uint64_t, double> cells;
+  if (m_geoTool->prepareEmptyCells(cells).isFailure()) {
+    error() << "Unable to create empty cells!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_cellIndex.build(cells);
+
+  std::string err = m_file.open(m_fileName);
+  if (!err.empty()) {
+    error() << "Unable to read pileup bank: " << err << endmsg;
+    return StatusCode::FAILURE;
+  }
+  const auto& header = m_file.header();
+  if (header.numCells != m_cellIndex.size() || header.cellsChecksum != m_cellIndex.checksum()) {
+    error() << "Pileup bank " << m_fileName << " was written for other cells (" << header.numCells
+            << " cells) than those of the geometry tool (" << m_cellIndex.size() << " cells)!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_file.numEntries() == 0) {
+    error() << "Pileup bank " << m_fileName << " has no entries!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+
+  if (m_randomEntries) {
+    if (service("RndmGenSvc", m_randSvc).isFailure()) {
+      error() << "Couldn't get RndmGenSvc" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    m_flat.initialize(m_randSvc, Rndm::Flat(0., 1.));
+  }
+  info() << "Pileup bank " << m_fileName << " with " << m_file.numEntries() << " entries of " << header.pileup
+         << " events (" << m_file.size() << " bytes)" << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode OverlayCaloPileupCells::execute() {
+  const edm4hep::SimCalorimeterHitCollection* hits = m_hits.get();
+  auto mergedHits = m_mergedHits.createAndPut();
+
+  StageTimer timer(m_timeOverlay);
+  size_t entry;
+  if (m_randomEntries) {
+    entry = std::min(size_t(m_flat.shoot() * m_file.numEntries()), m_file.numEntries() - 1);
+  } else {
+    entry = (m_firstEntry + Gaudi::Hive::currentContext().evt()) % m_file.numEntries();
+  }
+  std::vector<float> energies(m_cellIndex.size(), 0);
+  m_numPileupCells += m_file.addTo(entry, energies.data());
+
+  size_t outside = 0;
+  for (const auto& hit : *hits) {
+    uint32_t index = m_cellIndex.index(hit.getCellID());
+    if (index == calo_pileup::CellIndex::npos) {
+      auto outHit = mergedHits->create();
+      outHit.setCellID(hit.getCellID());
+      outHit.setEnergy(hit.getEnergy());
+      outside++;
+      continue;
+    }
+    energies[index] += hit.getEnergy();
+  }
+  for (uint32_t i = 0; i < energies.size(); i++) {
+    if (energies[i] == 0) continue;
+    auto outHit = mergedHits->create();
+    outHit.setCellID(m_cellIndex.cellId(i));
+    outHit.setEnergy(energies[i]);
+  }
+  timer.stop();
+  debug() << "Pileup entry " << entry << ": " << mergedHits->size() << " cells from " << hits->size()
+          << " signal hits" << endmsg;
+  m_numCells += mergedHits->size();
+  m_numHitsOutside += outside;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode OverlayCaloPileupCells::finalize() {
+  m_file.close();
+  return GaudiAlgorithm::finalize();
+}
@@ -0,0 +1,80 @@
+#ifndef RECCALORIMETER_OVERLAYCALOPILEUPCELLS_H
+#define RECCALORIMETER_OVERLAYCALOPILEUPCELLS_H
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+#include "k4Interface/ICalorimeterTool.h"
+
+// Gaudi
+#include "GaudiAlg/GaudiAlgorithm.h"
+#include "GaudiKernel/IRndmGenSvc.h"
+#include "GaudiKernel/RndmGenerators.h"
+#include "GaudiKernel/ToolHandle.h"
+
+#include "CaloPileupBankFormat.h"
+#include "StageTimer.h"
+
+// datamodel
+namespace edm4hep {
+class SimCalorimeterHitCollection;
+}
+
+/** @class OverlayCaloPileupCells
+ *
+ *  Algorithm overlaying pileup on the signal hits at cell level: the signal hits are merged into the cells of the
+ *  geometry tool and the energies of one entry of a pileup bank (see CaloPileupBankFormat.h, written by
+ *  WriteCaloPileupBank with the same geometry tool) are added. The output contains one hit per cell with energy,
+ *  it is the input of CreateCaloCells, which applies the calibration and the noise as usual.
+ *
+ *  The pileup entry is chosen at random ("randomEntries", default), or event N of the job uses entry
+ *  (firstEntry + N) modulo the number of entries. The energies of all cells are held in a buffer indexed by the dense
+ *  index of the cells, dense entries of the bank are added to it in one contiguous loop.
+ *  Signal hits outside the cells of the geometry tool are copied to the output without pileup.
+ *  The time of the overlay and the number of pileup cells are recorded in counters.
+ *
+ */
+
+class OverlayCaloPileupCells : public GaudiAlgorithm {
+
+public:
+  OverlayCaloPileupCells(const std::string& name, ISvcLocator* svcLoc);
+
+  StatusCode initialize();
+
+  StatusCode execute();
+
+  StatusCode finalize();
+
+private:
+  /// Handle for the signal hits (input collection)
+  DataHandle<edm4hep::SimCalorimeterHitCollection> m_hits{"hits", Gaudi::DataHandle::Reader, this};
+  /// Handle for the hits merged into cells with pileup (output collection)
+  DataHandle<edm4hep::SimCalorimeterHitCollection> m_mergedHits{"mergedHits", Gaudi::DataHandle::Writer, this};
+  /// Handle for the geometry tool, providing all cells
+  ToolHandle<ICalorimeterTool> m_geoTool{"TubeLayerPhiEtaCaloTool", this};
+  /// Name of the pileup bank file
+  Gaudi::Property<std::string> m_fileName{this, "filename", "caloPileupBank.bin", "Name of the pileup bank file"};
+  /// Choose the pileup entry at random
+  Gaudi::Property<bool> m_randomEntries{this, "randomEntries", true,
+                                        "Choose the pileup entry at random, otherwise one entry after the other"};
+  /// First entry of the bank if the entries are not chosen at random
+  Gaudi::Property<unsigned int> m_firstEntry{this, "firstEntry", 0, "First entry if not chosen at random"};
+  /// Dense index of the cells
+  calo_pileup::CellIndex m_cellIndex;
+  /// Mapped pileup bank
+  calo_pileup::File m_file;
+  /// Random number service
+  IRndmGenSvc* m_randSvc;
+  /// Flat distribution to choose the entries
+  Rndm::Numbers m_flat;
+  /// Time of the overlay
+  StageTimer::Counter m_timeOverlay{this, "Time overlay [us]"};
+  /// Number of pileup cells per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numPileupCells{this, "Pileup cells"};
+  /// Number of output hits per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numCells{this, "Cells"};
+  /// Number of signal hits outside the cells of the geometry tool per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numHitsOutside{this, "Hits outside the geometry"};
+};
+
+#endif /* RECCALORIMETER_OVERLAYCALOPILEUPCELLS_H */
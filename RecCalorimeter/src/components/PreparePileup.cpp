@@ -173,7 +173,7 @@ StatusCode PreparePileup::execute() {
                 << ". Filling the last histogram." << endmsg;
     }
     double cellEta = m_segmentation->eta(cID);
-    m_energyVsAbsEta[layerId]->Fill(fabs(cellEta), cellEnergy);
+    m_histogramFills.fill(m_energyVsAbsEta[layerId], fabs(cellEta), cellEnergy);
     // add energy of this cell to any optimised cluster where it is included
     if (!(m_nEtaFinal.size() == 0 && m_nPhiFinal.size() == 0) ) {
       uint etaId = m_decoder->get(cID, "eta");
@@ -198,7 +198,7 @@ StatusCode PreparePileup::execute() {
   double etaGridOffset = m_segmentation->offsetEta();
   for (int iEta = 0; iEta < m_nEtaTower ; iEta++) {
     for (int iPhi = 0; iPhi < m_nPhiTower ; iPhi++) {
-      m_energyVsAbsEtaClusterOptimised->Fill(fabs(  iEta * etaGridSize + etaGridOffset ), m_energyOptimised[iEta][iPhi]);
+      m_histogramFills.fill(m_energyVsAbsEtaClusterOptimised, fabs(  iEta * etaGridSize + etaGridOffset ), m_energyOptimised[iEta][iPhi]);
     }
   }
 
@@ -226,7 +226,7 @@ StatusCode PreparePileup::execute() {
       }
       // loop over all the phi slices
       for (int iPhi = 0; iPhi < m_nPhiTower; iPhi++) {
-        m_energyVsAbsEtaClusters[iCluster]->Fill(fabs(m_towerTool->eta(iEta)),
+        m_histogramFills.fill(m_energyVsAbsEtaClusters[iCluster], fabs(m_towerTool->eta(iEta)),
                                                  sumWindow * cosh(fabs(m_towerTool->eta(iEta))));
         // finish processing that window in phi, shift window to the next phi tower
         // substract first phi tower in current window
@@ -260,6 +260,7 @@ unsigned int PreparePileup::phiNeighbour(int aIPhi) const {
 }
 
 StatusCode PreparePileup::finalize() {
+  m_histogramFills.flush();
   // Fill 2D histogram per layer (sum of energy in all events per cell)
   for (const auto& cell : m_sumEnergyCellsMap) {
     double cellEnergy = cell.second;
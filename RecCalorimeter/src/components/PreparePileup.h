@@ -20,6 +20,8 @@ class IGeoSvc;
 
 #include "DDSegmentation/BitFieldCoder.h"
 
+#include "HistogramFillBuffer.h"
+
 class TH2F;
 class TH1F;
 class ITHistSvc;
@@ -92,6 +94,8 @@ private:
   /// 2D histogram with abs(eta) on x-axis and energy per cluster(s) per event on y-axis
   std::vector<TH2F*> m_energyVsAbsEtaClusters;
   TH2F* m_energyVsAbsEtaClusterOptimised;
+  /// Buffer of the histogram fills in the event loop, merged into the histograms at the latest in finalize
+  HistogramFillBuffer m_histogramFills{this};
 
   /// Maximum energy in the m_energyVsAbsEta histogram, in GeV
   Gaudi::Property<uint> m_maxEnergy{this, "maxEnergy", 20., "Maximum energy in the pile-up plot"};
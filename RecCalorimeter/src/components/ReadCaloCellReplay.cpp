@@ -0,0 +1,78 @@
+#include "ReadCaloCellReplay.h"
+
+// Gaudi
+#include "GaudiKernel/ThreadLocalContext.h"
+
+// datamodel
+#include "edm4hep/CalorimeterHitCollection.h"
+
+#include <algorithm>
+
+DECLARE_COMPONENT(ReadCaloCellReplay)
+
+ReadCaloCellReplay::ReadCaloCellReplay(const std::string& name, ISvcLocator* svcLoc) : GaudiAlgorithm(name, svcLoc) {}
+
+StatusCode ReadCaloCellReplay::initialize() {
+  StatusCode sc = GaudiAlgorithm::initialize();
+  if (sc.isFailure()) return sc;
+  std::string err = m_file.open(m_fileName);
+  if (!err.empty()) {
+    error() << "Unable to read cell replay file: " << err << endmsg;
+    return StatusCode::FAILURE;
+  }
+  const auto& storedNames = m_file.collectionNames();
+  if (!m_cellCollectionNames.empty() && m_cellCollectionNames.size() != storedNames.size()) {
+    error() << "File " << m_fileName << " contains " << storedNames.size() << " collections, but "
+            << m_cellCollectionNames.size() << " output names are given!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  for (size_t i = 0; i < storedNames.size(); i++) {
+    const auto& name = m_cellCollectionNames.empty() ? storedNames[i] : m_cellCollectionNames[i];
+    m_cellCollections.push_back(
+        new DataHandle<edm4hep::CalorimeterHitCollection>(name, Gaudi::DataHandle::Writer, this));
+    info() << "Stored collection " << storedNames[i] << " -> " << name << endmsg;
+  }
+  info() << "Cell replay file " << m_fileName << " with " << m_file.numEvents() << " events (" << m_file.size()
+         << " bytes)" << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode ReadCaloCellReplay::execute() {
+  size_t event = m_firstEvent + Gaudi::Hive::currentContext().evt();
+  if (event >= m_file.numEvents()) {
+    error() << "Event " << event << " not found in " << m_fileName << " (" << m_file.numEvents() << " events)"
+            << endmsg;
+    return StatusCode::FAILURE;
+  }
+  StageTimer timer(m_timeRead);
+  size_t numCells = 0;
+  for (size_t i = 0; i < m_cellCollections.size(); i++) {
+    auto edmCells = m_cellCollections[i]->createAndPut();
+    m_file.forEachCell(event, i, [&edmCells](uint64_t aCellId, float aEnergy) {
+      auto cell = edmCells->create();
+      cell.setCellID(aCellId);
+      cell.setEnergy(aEnergy);
+    });
+    numCells += edmCells->size();
+    debug() << "Read " << edmCells->size() << " cells for collection " << m_cellCollections[i]->objKey() << endmsg;
+  }
+  timer.stop();
+  m_cellsRead += numCells;
+  m_bytesRead += m_file.eventSize(event);
+  return StatusCode::SUCCESS;
+}
+
+StatusCode ReadCaloCellReplay::finalize() {
+  double seconds = m_timeRead.sum() * 1e-6;
+  if (seconds > 0) {
+    double cells = m_cellsRead.sum();
+    double bytes = m_bytesRead.sum();
+    info() << "Read " << cells << " cells (" << bytes / std::max(cells, 1.) << " bytes per cell) in " << seconds
+           << " s: " << cells / seconds / 1e6 << " Mcells/s, " << bytes / seconds / (1 << 20) << " MB/s of file"
+           << endmsg;
+  }
+  m_file.close();
+  for (auto handle : m_cellCollections) delete handle;
+  m_cellCollections.clear();
+  return GaudiAlgorithm::finalize();
+}
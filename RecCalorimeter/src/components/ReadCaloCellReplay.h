@@ -0,0 +1,62 @@
+#ifndef RECCALORIMETER_READCALOCELLREPLAY_H
+#define RECCALORIMETER_READCALOCELLREPLAY_H
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+
+// Gaudi
+#include "GaudiAlg/GaudiAlgorithm.h"
+
+#include "CaloCellReplayFormat.h"
+#include "StageTimer.h"
+
+// datamodel
+namespace edm4hep {
+class CalorimeterHitCollection;
+}
+
+/** @class ReadCaloCellReplay
+ *
+ *  Algorithm reading the calorimeter cells from a cell replay file written by WriteCaloCellReplay
+ *  (see CaloCellReplayFormat.h), to run the reconstruction (e.g. CaloTowerTool, CaloTopoClusterInputTool) on stored
+ *  cells without the upstream digitisation.
+ *
+ *  The file is memory-mapped, event N of the job reads event (firstEvent + N) of the file.
+ *  One CalorimeterHitCollection is written per stored collection, named as in the file unless "cells" is given
+ *  (same size and order as the stored collections). Only cellID and energy of the cells are set.
+ *  The time to decode an event and fill the collections is added to the counter "Time read [us]", the read throughput
+ *  (cells and bytes of the file per second) is printed at finalize.
+ *
+ */
+
+class ReadCaloCellReplay : public GaudiAlgorithm {
+
+public:
+  ReadCaloCellReplay(const std::string& name, ISvcLocator* svcLoc);
+
+  StatusCode initialize();
+
+  StatusCode execute();
+
+  StatusCode finalize();
+
+private:
+  /// Handles for the calo cells (output collections)
+  std::vector<DataHandle<edm4hep::CalorimeterHitCollection>*> m_cellCollections;
+  /// Names of the output cell collections, the names stored in the file are used if empty
+  Gaudi::Property<std::vector<std::string>> m_cellCollectionNames{this, "cells", {}, "Names of the output cell collections, by default as stored in the file"};
+  /// Name of the input file
+  Gaudi::Property<std::string> m_fileName{this, "filename", "caloCellReplay.bin", "Name of the input file"};
+  /// First event of the file to read
+  Gaudi::Property<unsigned int> m_firstEvent{this, "firstEvent", 0, "First event of the file to read"};
+  /// Mapped input file
+  calo_replay::File m_file;
+  /// Time to read an event
+  StageTimer::Counter m_timeRead{this, "Time read [us]"};
+  /// Number of cells read per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_cellsRead{this, "Cells read"};
+  /// Bytes of the file read per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_bytesRead{this, "Bytes read"};
+};
+
+#endif /* RECCALORIMETER_READCALOCELLREPLAY_H */
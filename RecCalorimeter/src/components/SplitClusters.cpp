@@ -1,7 +1,5 @@
 #include "SplitClusters.h"
-
-// Key4HEP
-#include "k4Interface/IGeoSvc.h"
+#include "ClusterMomentsAccumulator.h"
 
 // FCC Detectors
 #include "DetCommon/DetUtils.h"
@@ -9,6 +7,9 @@
 // DD4hep
 #include "DD4hep/Detector.h"
 
+// EDM4HEP
+#include "edm4hep/CalorimeterHitData.h"
+
 // ROOT
 #include "TH1F.h"
 #include "TH2F.h"
@@ -42,15 +43,6 @@ SplitClusters::SplitClusters(const std::string& name, ISvcLocator* svcLoc) : Gau
 StatusCode SplitClusters::initialize() {
   StatusCode sc = GaudiAlgorithm::initialize();
   if (sc.isFailure()) return sc;
-  m_geoSvc = service("GeoSvc");
-  if (!m_geoSvc) {
-    error() << "Unable to locate Geometry service." << endmsg;
-    return StatusCode::FAILURE;
-  }
-  
-  m_decoderECal = m_geoSvc->lcdd()->readout(m_readoutECal).idSpec().decoder();  
-  m_decoderHCal = m_geoSvc->lcdd()->readout(m_readoutHCal).idSpec().decoder();  
-
   // Read neighbours map
   if (!m_neighboursTool.retrieve()) {
     error() << "Unable to retrieve the cells neighbours tool!!!" << endmsg;
@@ -77,6 +69,8 @@ StatusCode SplitClusters::initialize() {
 }
 
 StatusCode SplitClusters::execute() {
+  // limits of the work in this event
+  EventBudget budget(m_maxNeighbourLookups, m_maxClusterCells, m_maxEventTime);
   // Get the input collection with Geant4 hits
   const edm4hep::ClusterCollection* clusters = m_clusters.get();
   debug() << "Input Cluster collection size: " << clusters->size() << endmsg;
@@ -86,16 +80,23 @@ StatusCode SplitClusters::execute() {
 
   debug() << "Loop through " << clusters->size() << " clusters, " <<  endmsg;
   std::map<uint64_t, int> allCells;
+  // accumulator of the cluster moments, its buffers are reused for all clusters
+  ClusterMomentsAccumulator clusterMoments;
   uint totSplitClusters=0;
   uint totCellsBefore=0;
   uint totCellsAfter=0;
   double totEnergyBefore=0.;
   double totEnergyAfter=0.;
+  // largest memory of the maps of a cluster
+  size_t clusterMapsBytes = 0;
 
   for (auto cluster : *clusters) {
     // sanity checks
     totEnergyBefore += cluster.getEnergy();
     totCellsBefore += cluster.hits_size();
+    // once the event is over budget, and for clusters reaching the maximal size, the cluster is copied without
+    // splitting; if the event goes over budget while the cluster is split, the partial split is dropped
+    bool splitCluster = budget.checkTime() && budget.clusterWithin(cluster.hits_size());
     
     std::map<uint64_t, int> cellsType;
     std::vector<std::pair<uint64_t, double> > cellsEnergy; 
@@ -104,6 +105,8 @@ StatusCode SplitClusters::execute() {
     std::map<uint, std::vector<std::pair<uint64_t, int> > > preClusterCollection;
     std::map<uint, TLorentzVector> clusterPositions;
 
+    // memory of the maps only used for splitting
+    size_t splittingBytes = 0;
     // number of new clusters
     uint newClusters=0;
     std::vector<std::pair<uint64_t, double> > newSeeds;
@@ -113,6 +116,11 @@ StatusCode SplitClusters::execute() {
       auto cell = *it;
       cellsType.emplace( cell.getCellID(), cell.getType() );
       cellsEnergy.push_back( std::make_pair(cell.getCellID(), cell.getEnergy()) );
+      // the positions are only needed to split the cluster
+      if (!splitCluster) {
+        allCells.emplace(cell.getCellID(), cell.getType());
+        continue;
+      }
 
       // get cell position by cellID
       // identify calo system
@@ -147,12 +155,16 @@ StatusCode SplitClusters::execute() {
       auto itCell = cellsType.find(cell.first);
       auto fCell = *itCell;
       
-      if (itCell != cellsType.end() && fCell.second == 1 && cell.second > m_threshold){
+      if (splitCluster && itCell != cellsType.end() && fCell.second == 1 && cell.second > m_threshold){
 	
 	verbose() << "..... ... cell is seed type. " << fCell.second << endmsg;
 	// start counting neighbours
 	int countNeighbours=0;
 	auto neighboursVector = m_neighboursTool->neighbours(fCell.first);
+	if (!budget.lookup()) {
+	  splitCluster = false;
+	  break;
+	}
 	verbose() << "..... ... found " << neighboursVector.size() << " neighbours." << endmsg;
 	// test if neighbouring cells are of type 2, and lower energy
 	for (auto nCellId : neighboursVector){
@@ -198,9 +210,10 @@ StatusCode SplitClusters::execute() {
     verbose() << "Elements in cells types before sub-cluster building: " << cellsType.size() << endmsg;
     
     // Build new clusters, if more than 2 new seeds have been found.
-    if (newClusters>1){
-      totSplitClusters++;
-
+    std::map<uint64_t, uint> clusterOfCell;
+    // map of clusterID to next neighbours vector to find next cells
+    std::map<uint, std::vector<std::vector<std::pair<uint64_t, uint> > > > mapVecNextNeighbours;
+    if (splitCluster && newClusters>1){
       debug() << "..... split cluster into " << newSeeds.size() << ". " << endmsg;
       debug() << "################################### " << endmsg;
       debug() << "##  Start building sub-clusters ###" << endmsg;
@@ -209,9 +222,6 @@ StatusCode SplitClusters::execute() {
       // build clusters in multiple iterations
       int iter = 0;
       uint clusterID = clusters->size() + 1;
-      std::map<uint64_t, uint> clusterOfCell;
-      // map of clusterID to next neighbours vector to find next cells
-      std::map<uint, std::vector<std::vector<std::pair<uint64_t, uint> > > > mapVecNextNeighbours;
       
       debug() << "Iteration 0: " << endmsg;
       while (iter == 0){
@@ -233,6 +243,10 @@ StatusCode SplitClusters::execute() {
 							 cellsPosition, 
 							 clusterPositions
 							 );
+	  if (!budget.lookup()) {
+	    splitCluster = false;
+	    break;
+	  }
 	  std::vector<std::vector<std::pair<uint64_t, uint> > > vecVec;
 	  vecVec.resize(1000); // number of maximum iterations
 	  vecVec.insert(vecVec.begin(), vec);
@@ -250,12 +264,12 @@ StatusCode SplitClusters::execute() {
 
       debug() << "Start iteration: ";
 
-      while(iter>0){
+      while(iter>0 && splitCluster){
 	// iterate for adding cells to clusters
 	debug() << iter << endmsg;
 	bool foundNewNeighbours = false;
 	// loop through new clusters for every iteration
-	for (uint newCluster = 1; newCluster <= newSeeds.size(); newCluster++){
+	for (uint newCluster = 1; newCluster <= newSeeds.size() && splitCluster; newCluster++){
 	  clusterID = clusters->size() + newCluster;
 	  // if neighbours have been found, continue...
 	  if (mapVecNextNeighbours[clusterID][iter-1].size() > 0) {
@@ -278,6 +292,10 @@ StatusCode SplitClusters::execute() {
 							    cellsPosition, 
 							    clusterPositions
 							    );
+	      if (!budget.lookup()) {
+		splitCluster = false;
+		break;
+	      }
 	      // add the next neighbours at end of already found neighbours in this round.
               verbose() << "Size before additional vec : " << mapVecNextNeighbours[clusterID][iter].size() << endmsg;
 	      mapVecNextNeighbours[clusterID][iter].reserve(mapVecNextNeighbours[clusterID][iter].size() + vec.size());
@@ -292,6 +310,12 @@ StatusCode SplitClusters::execute() {
 	  iter = -1;
 	}
       }
+      splittingBytes = MemoryUsage::heapBytes(clusterOfCell) + MemoryUsage::heapBytes(mapVecNextNeighbours);
+      if (!splitCluster) debug() << "..... event over budget, cluster not split. " << endmsg;
+    }
+
+    if (splitCluster && newClusters>1){
+      totSplitClusters++;
       // TEST NEW CLUSTERS      
       uint allClusteredCells = 0;
       for (auto i : clusterOfCell) {
@@ -305,10 +329,8 @@ StatusCode SplitClusters::execute() {
 	warning() << "Elements in cells types after sub-cluster building: " << cellsType.size() << endmsg;                                                                        
 	
 	auto l_cluster = edmClusters->create();
-	double posX = 0.;
-        double posY = 0.;
-        double posZ = 0.;
-	double energy = 0.;
+	clusterMoments.clear();
+	clusterMoments.reserve(cellsType.size());
 	std::map<uint64_t, int>::iterator it;
 	for ( it = cellsType.begin(); it != cellsType.end(); it++ ){
 	  totCellsAfter++;
@@ -333,18 +355,15 @@ StatusCode SplitClusters::execute() {
             else{
               posCell = m_cellPositionsHCalBarrelTool->xyzPosition(cID);
             }}
-	  posX += posCell.X() * newCell.getEnergy();
-          posY += posCell.Y() * newCell.getEnergy();
-          posZ += posCell.Z() * newCell.getEnergy();
+	  clusterMoments.add(newCell.getEnergy(), posCell.X(), posCell.Y(), posCell.Z());
 	  // left over cells
 	  newCell.setType(4);
-	  energy += fNEnergy.second;
 	}
+	auto moments = clusterMoments.compute();
 	l_cluster.setType(3);
-	l_cluster.setEnergy(energy);
-        auto clusterPosition = edm4hep::Vector3f(posX/energy, posY/energy, posZ/energy);
-        l_cluster.setPosition(clusterPosition);
-        totEnergyAfter += energy;
+	ClusterMomentsAccumulator::setEnergyAndPosition(moments, l_cluster);
+	ClusterMomentsAccumulator::addShapeParameters(moments, l_cluster);
+        totEnergyAfter += moments.energy;
 
 	debug() << "Left-over cluster energy:     " << l_cluster.getEnergy() << endmsg;
       }
@@ -352,10 +371,8 @@ StatusCode SplitClusters::execute() {
       // fill clusters into edm format
       for (auto i : preClusterCollection) {
 	edm4hep::MutableCluster cluster;
-	double posX = 0.;
-	double posY = 0.;
-	double posZ = 0.;
-	double energy = 0.;
+	clusterMoments.clear();
+	clusterMoments.reserve(i.second.size());
 	std::map<int,int> system;
 
 	for (auto pair : i.second) {
@@ -371,7 +388,6 @@ StatusCode SplitClusters::execute() {
 	  newCell.setEnergy(fNEnergy.second);
 	  newCell.setCellID(cID);
 	  newCell.setType(pair.second);
-	  energy += fNEnergy.second;
 
 	  // get cell position by cellID
 	  // identify calo system
@@ -389,29 +405,23 @@ StatusCode SplitClusters::execute() {
 	  else
 	    warning() << "No cell positions tool found for system id " << systemId << ". " << endmsg;
 
-	  posX += posCell.X() * newCell.getEnergy();
-	  posY += posCell.Y() * newCell.getEnergy();
-	  posZ += posCell.Z() * newCell.getEnergy();
+	  clusterMoments.add(newCell.getEnergy(), posCell.X(), posCell.Y(), posCell.Z());
 	  
 	  cluster.addToHits(newCell);
 	  auto check = allCells.erase(cID);
 	  if (check!=1)
 	    error() << "Cell id is not deleted from map. " << endmsg;
 	}
-	cluster.setEnergy(energy);
-  auto clusterPosition = edm4hep::Vector3f(posX/energy, posY/energy, posZ/energy);
-	cluster.setPosition(clusterPosition);
+	auto moments = clusterMoments.compute();
+	ClusterMomentsAccumulator::setEnergyAndPosition(moments, cluster);
+	ClusterMomentsAccumulator::addShapeParameters(moments, cluster);
 	cluster.setType(2);
 	debug() << "Cluster energy:     " << cluster.getEnergy() << endmsg;
-	totEnergyAfter += energy;
+	totEnergyAfter += moments.energy;
 	edmClusters->push_back(cluster);
       }
       if(cellsType.size()>0)
 	info() << "Not all cluster cells have been assigned. " << cellsType.size() << endmsg;
-      
-      // clear maps
-      clusterOfCell.clear();
-      mapVecNextNeighbours.clear();
     }
     
     else{
@@ -430,6 +440,11 @@ StatusCode SplitClusters::execute() {
       }
     }
 
+    clusterMapsBytes = std::max(clusterMapsBytes, splittingBytes + MemoryUsage::heapBytes(cellsType) +
+                                                      MemoryUsage::heapBytes(cellsEnergy) +
+                                                      MemoryUsage::heapBytes(cellsPosition) +
+                                                      MemoryUsage::heapBytes(preClusterCollection) +
+                                                      MemoryUsage::heapBytes(clusterPositions));
     // Clear maps and vectors 
     cellsType.clear();
     cellsEnergy.clear();
@@ -450,7 +465,14 @@ StatusCode SplitClusters::execute() {
   if (totCellsBefore!=totCellsAfter)
     warning() << "After cluster splitting, cells ( " << totCellsAfter << " ) is not what is was before ( " << totCellsBefore << " )." << endmsg;
   
+  m_budgetCounters += budget;
+  if (budget.exceeded() != EventBudget::kNone) {
+    warning() << "Event over budget (" << budget.exceededNames() << " ) after " << budget.lookups()
+              << " neighbour lookups, remaining clusters not split" << endmsg;
+  }
   m_newCells.put(edmClusterCells);
+  m_memoryClusterMaps += MemoryUsage::kiloBytes(clusterMapsBytes);
+  m_memoryCells += MemoryUsage::kiloBytes(edmClusterCells->size() * sizeof(edm4hep::CalorimeterHitData));
 
   return StatusCode::SUCCESS;
 }
@@ -458,9 +480,9 @@ StatusCode SplitClusters::execute() {
 std::vector<std::pair<uint64_t, uint> >
 SplitClusters::searchForNeighbours(const uint64_t aCellId,
 				   const uint aClusterID,
-				   const std::map<uint64_t, int> aCellsType,
+				   const std::map<uint64_t, int>& aCellsType,
 				   std::map<uint64_t, uint>& aClusterOfCell,
-				   std::map<uint64_t, TLorentzVector> aCellPosition,
+				   const std::map<uint64_t, TLorentzVector>& aCellPosition,
 				   std::map<uint, TLorentzVector>& aClusterPosition
 				   ){
   // Fill vector to be returned, next cell ids and cluster id for which neighbours are found
@@ -481,39 +503,39 @@ SplitClusters::searchForNeighbours(const uint64_t aCellId,
       uint64_t neighbourID = itr;
       // Find the neighbour in the Calo cells list
       auto itAllCellTypes = aCellsType.find( neighbourID );
-      auto fCellType = *itAllCellTypes;
       auto itAllUsedCells = aClusterOfCell.find( neighbourID );
-      auto fCellCluster = *itAllUsedCells;
 
       // If cell has type.. is found in the list of clustered cells
       if (itAllCellTypes != aCellsType.end()){
 	verbose() << "Found neighbour with CellID: " << neighbourID << endmsg;
-	verbose() << "Neighbour is of cell type " << fCellType.second << ". " << endmsg;
+	verbose() << "Neighbour is of cell type " << itAllCellTypes->second << ". " << endmsg;
+	auto itCellPosition = aCellPosition.find( neighbourID );
+	const TLorentzVector neighbourPosition = itCellPosition != aCellPosition.end() ? itCellPosition->second : TLorentzVector();
 	
 	// and is not assigned to a cluster
 	if (itAllUsedCells == aClusterOfCell.end()) {
 	  verbose() << "Add neighbour to cluster " << aClusterID << endmsg;
 	  // add neighbour to cells of cluster
-	  aClusterPosition[aClusterID] += aCellPosition[neighbourID]; // add lorentz vector
+	  aClusterPosition[aClusterID] += neighbourPosition; // add lorentz vector
 	  aClusterOfCell.emplace( neighbourID, aClusterID );
 	  
 	  addedNeighbourIds.push_back(std::make_pair(neighbourID, aClusterID));
 	}
 	// and is already assigned to cluster, check if its assigned to different clusterID 
-	else if ( itAllUsedCells != aClusterOfCell.end() && fCellCluster.second != aClusterID ) { 
-	  uint clusterIDToMerge = fCellCluster.second;
+	else if ( itAllUsedCells != aClusterOfCell.end() && itAllUsedCells->second != aClusterID ) { 
+	  uint clusterIDToMerge = itAllUsedCells->second;
 	  verbose() << "This neighbour was found in cluster " << clusterIDToMerge << ", and cluster " << aClusterID
 		    << ". It will be evaluate which one has higher geomertrical significance!" << endmsg;
-	  verbose() << "Distances to cluster core: " << aClusterPosition[clusterIDToMerge].DeltaR(aCellPosition[neighbourID]) << ", and this cluster: " << aClusterPosition[aClusterID].DeltaR(aCellPosition[neighbourID]) << endmsg;
+	  verbose() << "Distances to cluster core: " << aClusterPosition[clusterIDToMerge].DeltaR(neighbourPosition) << ", and this cluster: " << aClusterPosition[aClusterID].DeltaR(neighbourPosition) << endmsg;
 	  
 	  // get distance of cell from cog of clusters, and test if the cell is closer to current cluster
-	  if ( aClusterPosition[aClusterID].DeltaR(aCellPosition[neighbourID]) <= aClusterPosition[clusterIDToMerge].DeltaR(aCellPosition[neighbourID]) ){
+	  if ( aClusterPosition[aClusterID].DeltaR(neighbourPosition) <= aClusterPosition[clusterIDToMerge].DeltaR(neighbourPosition) ){
 	    verbose() << "Neighbour is assigned to cluster1. " << endmsg;	      
 	    addedNeighbourIds.push_back(std::make_pair(neighbourID, aClusterID));
 	    // remove the cell from the other cluster
-	    aClusterPosition[clusterIDToMerge] -= aCellPosition[neighbourID]; // remove lorentz vector
+	    aClusterPosition[clusterIDToMerge] -= neighbourPosition; // remove lorentz vector
 	    // add cell to correct cluster         
-	    aClusterPosition[aClusterID] += aCellPosition[neighbourID]; // add lorentz vector
+	    aClusterPosition[aClusterID] += neighbourPosition; // add lorentz vector
             
 	    aClusterOfCell[neighbourID] = aClusterID;
 	  }
@@ -530,5 +552,6 @@ SplitClusters::searchForNeighbours(const uint64_t aCellId,
 }
 
 StatusCode SplitClusters::finalize() { 
-
-return GaudiAlgorithm::finalize(); }
+  info() << "Peak memory of the cluster maps: " << m_memoryClusterMaps.max() << " kB, of the output cells: "
+         << m_memoryCells.max() << " kB" << endmsg;
+  return GaudiAlgorithm::finalize(); }
@@ -23,7 +23,9 @@
 #include "edm4hep/ClusterCollection.h"
 #include "edm4hep/MCParticleCollection.h"
 
-class IGeoSvc;
+#include "EventBudget.h"
+#include "MemoryUsage.h"
+
 namespace DD4hep {
 namespace DDSegmentation {
 class Segmentation;
@@ -50,6 +52,12 @@ class TLorentzVector;
  * (a) check of energy and number cells conservation
  * (b) write new collection of clusters
  *
+ * Optional per-event budget (see EventBudget.h), disabled by default: "maxNeighbourLookups", "maxClusterCells" and
+ * "maxEventTime". Once the lookups or the time of an event exceed their limit, the following clusters are copied
+ * without splitting, as are the clusters reaching "maxClusterCells" cells; if the limit is hit while a cluster is
+ * split, its partial split is dropped and the cluster is copied without splitting.
+ * The events over budget are counted in "Events over budget".
+ *
  *  Tools called:
  *    - ICaloReadNeighboursMap
  *    - ICellPositionsTool
@@ -78,9 +86,9 @@ public:
   std::vector<std::pair<uint64_t, uint>> 
     searchForNeighbours(const uint64_t aCellId,
 			uint aClusterID, 
-			const std::map<uint64_t, int> aCellType,
+			const std::map<uint64_t, int>& aCellType,
 			std::map<uint64_t, uint>& aClusterOfCell,
-                        std::map<uint64_t, TLorentzVector> aCellPosition,
+                        const std::map<uint64_t, TLorentzVector>& aCellPosition,
 			std::map<uint, TLorentzVector>& aClusterPositions
 			);
 
@@ -89,9 +97,6 @@ public:
   StatusCode finalize();
 
 private:
-  /// Pointer to the geometry service
-  SmartIF<IGeoSvc> m_geoSvc;
-
   /// Handle for calo clusters (input collection)
   DataHandle<edm4hep::ClusterCollection> m_clusters{"calo/clusters", Gaudi::DataHandle::Reader, this};
   /// Handle for calo clusters (output collection)
@@ -116,8 +121,6 @@ private:
   // Energy threshold to find local maxima
   Gaudi::Property<double> m_threshold{this, "threshold", 0.5, "Threshold for local maxima."};
   
-  dd4hep::DDSegmentation::BitFieldCoder* m_decoderECal;
-  dd4hep::DDSegmentation::BitFieldCoder* m_decoderHCal;
                                                                                       
   /// specify if segmentation is used in HCal (defines eta granularity)
   Gaudi::Property<bool> m_noSegmentationHCal{this, "noSegmentationHCal", true, "HCal readout w/o eta-phi segementation?"};
@@ -126,9 +129,26 @@ private:
 
   Gaudi::Property<uint> m_systemIdECal{this, "systemECal", 5, "System id of ECal"};
   Gaudi::Property<uint> m_systemIdHCal{this, "systemHCal", 8, "System id of HCal"};
+  /// Readout names, not used (the geometry is only accessed through the positions tools), kept for existing job options
   Gaudi::Property<std::string> m_readoutECal{this, "readoutECal", "Readout of ECal"};
   Gaudi::Property<std::string> m_readoutHCal{this, "readoutHCal", "Readout of HCal"};
 
+  /// Maximal number of neighbour lookups per event (disabled if <= 0)
+  Gaudi::Property<long> m_maxNeighbourLookups{this, "maxNeighbourLookups", 0,
+                                              "maximal number of neighbour lookups per event, <= 0 to disable"};
+  /// Maximal number of cells of a cluster to split (disabled if <= 0)
+  Gaudi::Property<long> m_maxClusterCells{this, "maxClusterCells", 0,
+                                          "maximal number of cells of a cluster to split, <= 0 to disable"};
+  /// Maximal time per event (disabled if <= 0)
+  Gaudi::Property<double> m_maxEventTime{this, "maxEventTime", 0., "maximal time [ms] per event, <= 0 to disable"};
+  /// Events over budget
+  EventBudget::Counters m_budgetCounters{this};
+
+  /// Estimated memory of the maps of the cluster being split per event (largest cluster)
+  MemoryUsage::Counter m_memoryClusterMaps{this, "Memory cluster maps [kB]"};
+  /// Estimated memory of the data of the output cells per event, cloned or new
+  MemoryUsage::Counter m_memoryCells{this, "Memory output cells [kB]"};
+
 };
 
 #endif /* RECCALORIMETER_SPLITCLUSTERS_H */
@@ -0,0 +1,114 @@
+#ifndef RECCALORIMETER_SYNTHETICCALOGRID_H
+#define RECCALORIMETER_SYNTHETICCALOGRID_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/** @class SyntheticCaloGrid Reconstruction/RecCalorimeter/src/components/SyntheticCaloGrid.h
+ *
+ *  Regular calorimeter grid in layer x eta x phi, without any detector description, used to run the reconstruction
+ *  on synthetic events (benchmarks, tests).
+ *  The grid covers |eta| < etaMax in nEta bins and the full azimuth in nPhi bins; layer i is a cylinder at radius
+ *  rMin + (i + 0.5) * layerDepth (in mm).
+ *
+ *  Cell IDs are encoded as "system:4,layer:8,eta:12,phi:12" (bits from the least significant one), so the system is
+ *  decoded as in the other tools ("system:4") and the cells are routed to the positions tool of that system.
+ *  The neighbours of a cell are the cells with a layer, eta and phi index differing by at most one (26 in the bulk),
+ *  phi being periodic.
+ */
+
+class SyntheticCaloGrid {
+public:
+  SyntheticCaloGrid(uint aSystemId, uint aNumLayers, uint aNumEta, uint aNumPhi, double aEtaMax, double aRMin,
+                    double aLayerDepth)
+      : m_systemId(aSystemId), m_numLayers(aNumLayers), m_numEta(aNumEta), m_numPhi(aNumPhi), m_etaMax(aEtaMax),
+        m_rMin(aRMin), m_layerDepth(aLayerDepth), m_deltaEta(2. * aEtaMax / aNumEta), m_deltaPhi(2. * M_PI / aNumPhi) {}
+
+  /// Check if the dimensions fit into the bit fields of the cell ID
+  bool valid() const {
+    return m_systemId < (1u << 4) && m_numLayers > 0 && m_numLayers <= (1u << 8) && m_numEta > 0 &&
+           m_numEta <= (1u << 12) && m_numPhi >= 3 && m_numPhi <= (1u << 12) && m_etaMax > 0 && m_layerDepth > 0;
+  }
+
+  uint numLayers() const { return m_numLayers; }
+  uint numEta() const { return m_numEta; }
+  uint numPhi() const { return m_numPhi; }
+  size_t numCells() const { return size_t(m_numLayers) * m_numEta * m_numPhi; }
+  double deltaEta() const { return m_deltaEta; }
+  double deltaPhi() const { return m_deltaPhi; }
+  double etaMax() const { return m_etaMax; }
+
+  uint64_t cellId(uint aLayer, uint aIdEta, uint aIdPhi) const {
+    return uint64_t(m_systemId) | (uint64_t(aLayer) << 4) | (uint64_t(aIdEta) << 12) | (uint64_t(aIdPhi) << 24);
+  }
+  uint system(uint64_t aCellId) const { return aCellId & 0xF; }
+  uint layer(uint64_t aCellId) const { return (aCellId >> 4) & 0xFF; }
+  uint idEta(uint64_t aCellId) const { return (aCellId >> 12) & 0xFFF; }
+  uint idPhi(uint64_t aCellId) const { return (aCellId >> 24) & 0xFFF; }
+
+  /// Check if the cell ID belongs to the grid
+  bool contains(uint64_t aCellId) const {
+    return (aCellId >> 36) == 0 && system(aCellId) == m_systemId && layer(aCellId) < m_numLayers &&
+           idEta(aCellId) < m_numEta && idPhi(aCellId) < m_numPhi;
+  }
+
+  /// Eta of the centre of the eta bin
+  double eta(uint aIdEta) const { return (aIdEta + 0.5) * m_deltaEta - m_etaMax; }
+  /// Phi of the centre of the phi bin
+  double phi(uint aIdPhi) const { return (aIdPhi + 0.5) * m_deltaPhi - M_PI; }
+  /// Radius of the layer (mm)
+  double radius(uint aLayer) const { return m_rMin + (aLayer + 0.5) * m_layerDepth; }
+  /// Index of the eta bin, clamped to the grid
+  uint binEta(double aEta) const { return clamp(std::floor((aEta + m_etaMax) / m_deltaEta), m_numEta); }
+  /// Index of the phi bin, phi is taken modulo 2pi
+  uint binPhi(double aPhi) const {
+    long bin = long(std::floor((aPhi + M_PI) / m_deltaPhi)) % long(m_numPhi);
+    return bin < 0 ? bin + m_numPhi : bin;
+  }
+
+  /// Position of the centre of the cell (mm)
+  void position(uint64_t aCellId, double& aX, double& aY, double& aZ) const {
+    double r = radius(layer(aCellId));
+    double cellPhi = phi(idPhi(aCellId));
+    aX = r * std::cos(cellPhi);
+    aY = r * std::sin(cellPhi);
+    aZ = r * std::sinh(eta(idEta(aCellId)));
+  }
+
+  /// Append the neighbours of the cell to the vector
+  void neighbours(uint64_t aCellId, std::vector<uint64_t>& aNeighbours) const {
+    int cellLayer = layer(aCellId);
+    int cellEta = idEta(aCellId);
+    int cellPhi = idPhi(aCellId);
+    for (int iLayer = cellLayer - 1; iLayer <= cellLayer + 1; iLayer++) {
+      if (iLayer < 0 || iLayer >= int(m_numLayers)) continue;
+      for (int iEta = cellEta - 1; iEta <= cellEta + 1; iEta++) {
+        if (iEta < 0 || iEta >= int(m_numEta)) continue;
+        for (int iPhi = cellPhi - 1; iPhi <= cellPhi + 1; iPhi++) {
+          if (iLayer == cellLayer && iEta == cellEta && iPhi == cellPhi) continue;
+          aNeighbours.push_back(cellId(iLayer, iEta, (iPhi + m_numPhi) % m_numPhi));
+        }
+      }
+    }
+  }
+
+private:
+  static uint clamp(double aBin, uint aNumBins) {
+    if (aBin < 0) return 0;
+    if (aBin >= aNumBins) return aNumBins - 1;
+    return uint(aBin);
+  }
+
+  uint m_systemId;
+  uint m_numLayers;
+  uint m_numEta;
+  uint m_numPhi;
+  double m_etaMax;
+  double m_rMin;
+  double m_layerDepth;
+  double m_deltaEta;
+  double m_deltaPhi;
+};
+
+#endif /* RECCALORIMETER_SYNTHETICCALOGRID_H */
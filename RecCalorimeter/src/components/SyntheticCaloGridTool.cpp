@@ -0,0 +1,144 @@
+#include "SyntheticCaloGridTool.h"
+
+// DD4hep
+#include "DD4hep/DD4hepUnits.h"
+
+// datamodel
+#include "edm4hep/CalorimeterHitCollection.h"
+
+DECLARE_COMPONENT(SyntheticCaloGridTool)
+
+SyntheticCaloGridTool::SyntheticCaloGridTool(const std::string& type, const std::string& name,
+                                             const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareInterface<ICaloReadNeighboursMap>(this);
+  declareInterface<ICaloReadCellNoiseMap>(this);
+  declareInterface<ICellPositionsTool>(this);
+  declareInterface<ICalorimeterTool>(this);
+  declareInterface<INoiseConstTool>(this);
+}
+
+template <typename F>
+void SyntheticCaloGridTool::forEachCell(F&& aFunction) const {
+  for (uint iLayer = 0; iLayer < m_grid->numLayers(); iLayer++) {
+    for (uint iEta = 0; iEta < m_grid->numEta(); iEta++) {
+      for (uint iPhi = 0; iPhi < m_grid->numPhi(); iPhi++) {
+        aFunction(m_grid->cellId(iLayer, iEta, iPhi));
+      }
+    }
+  }
+}
+
+StatusCode SyntheticCaloGridTool::initialize() {
+  StatusCode sc = GaudiTool::initialize();
+  if (sc.isFailure()) return sc;
+  m_grid = std::make_unique<SyntheticCaloGrid>(m_systemId, m_numLayers, m_numEta, m_numPhi, m_etaMax, m_rMin,
+                                               m_layerDepth);
+  if (!m_grid->valid()) {
+    error() << "Grid dimensions do not fit into the cell ID (system:4,layer:8,eta:12,phi:12)!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  info() << "Synthetic grid: " << m_grid->numLayers() << " layers x " << m_grid->numEta() << " eta x "
+         << m_grid->numPhi() << " phi bins = " << m_grid->numCells() << " cells in system " << m_systemId << endmsg;
+  large_table::Policy policy;
+  std::string policyError = policy.parse(m_tablePlacement, m_hugePages);
+  if (!policyError.empty()) {
+    error() << policyError << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_neighbours.configure("system:4",
+                         [this](uint, SystemPartitionedMap<std::vector<uint64_t>>::Map& aMap) {
+                           aMap.reserve(m_grid->numCells());
+                           forEachCell([this, &aMap](uint64_t aCellId) { m_grid->neighbours(aCellId, aMap[aCellId]); });
+                           return StatusCode::SUCCESS;
+                         },
+                         false, policy);
+  m_noise.configure("system:4",
+                    [this](uint, SystemPartitionedMap<std::pair<double, double>>::Map& aMap) {
+                      aMap.reserve(m_grid->numCells());
+                      forEachCell([this, &aMap](uint64_t aCellId) {
+                        aMap.emplace(aCellId, std::make_pair(m_cellNoise.value(), m_cellNoiseOffset.value()));
+                      });
+                      return StatusCode::SUCCESS;
+                    },
+                    false, policy);
+  m_neighbours.addSystem(m_systemId);
+  m_noise.addSystem(m_systemId);
+  // the maps are built without ROOT
+  m_load.start([this]() { return buildMaps(); }, m_asyncInitialize, false);
+  return sc;
+}
+
+StatusCode SyntheticCaloGridTool::start() {
+  StatusCode sc = GaudiTool::start();
+  if (sc.isFailure()) return sc;
+  return m_load.wait();
+}
+
+StatusCode SyntheticCaloGridTool::buildMaps() {
+  if (m_neighbours.loadAll().isFailure() || m_noise.loadAll().isFailure()) return StatusCode::FAILURE;
+  double memoryNeighbours = MemoryUsage::kiloBytes(MemoryUsage::heapBytes(*m_neighbours.partition(m_systemId)));
+  double memoryNoise = MemoryUsage::kiloBytes(MemoryUsage::heapBytes(*m_noise.partition(m_systemId)));
+  m_memoryNeighbours += memoryNeighbours;
+  m_memoryNoise += memoryNoise;
+  info() << "Neighbours map: " << m_neighbours.size() << " cells, " << memoryNeighbours << " kB, noise map: "
+         << m_noise.size() << " cells, " << memoryNoise << " kB" << endmsg;
+  if (!m_neighbours.policy().isDefault()) {
+    info() << "Maps " << m_neighbours.policy().description() << ": " << m_neighbours.copies() << " copies, "
+           << MemoryUsage::kiloBytes(m_neighbours.mappedBytes() + m_noise.mappedBytes()) << " kB mapped" << endmsg;
+  }
+  if (m_neighbours.hugePagesFallback()) {
+    warning() << "No explicit huge pages available (vm.nr_hugepages), transparent huge pages used instead" << endmsg;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SyntheticCaloGridTool::finalize() { return GaudiTool::finalize(); }
+
+std::vector<uint64_t>& SyntheticCaloGridTool::neighbours(uint64_t aCellId) {
+  std::vector<uint64_t>* cellNeighbours = m_neighbours.find(aCellId);
+  return cellNeighbours == nullptr ? calo_neighbours::noNeighbours() : *cellNeighbours;
+}
+
+double SyntheticCaloGridTool::noiseRMS(uint64_t aCellId) {
+  const std::pair<double, double>* noise = m_noise.find(aCellId);
+  return noise == nullptr ? 0. : noise->first;
+}
+
+double SyntheticCaloGridTool::noiseOffset(uint64_t aCellId) {
+  const std::pair<double, double>* noise = m_noise.find(aCellId);
+  return noise == nullptr ? 0. : noise->second;
+}
+
+double SyntheticCaloGridTool::getNoiseConstantPerCell(uint64_t aCellId) { return noiseRMS(aCellId); }
+
+double SyntheticCaloGridTool::getNoiseOffsetPerCell(uint64_t aCellId) { return noiseOffset(aCellId); }
+
+void SyntheticCaloGridTool::getPositions(const edm4hep::CalorimeterHitCollection& aCells,
+                                         edm4hep::CalorimeterHitCollection& outputColl) {
+  for (const auto& cell : aCells) {
+    auto position = xyzPosition(cell.getCellID());
+    auto positionedHit = cell.clone();
+    positionedHit.setPosition(edm4hep::Vector3f(position.x() / dd4hep::mm, position.y() / dd4hep::mm,
+                                                position.z() / dd4hep::mm));
+    outputColl.push_back(positionedHit);
+  }
+}
+
+dd4hep::Position SyntheticCaloGridTool::xyzPosition(const uint64_t& aCellId) const {
+  double x, y, z;
+  m_grid->position(aCellId, x, y, z);
+  return dd4hep::Position(x * dd4hep::mm, y * dd4hep::mm, z * dd4hep::mm);
+}
+
+int SyntheticCaloGridTool::layerId(const uint64_t& aCellId) { return m_grid->layer(aCellId); }
+
+StatusCode SyntheticCaloGridTool::prepareEmptyCells(std::unordered_map<uint64_t, double>& aCells) {
+  // may be called from the initialize of another component, before start
+  if (m_load.wait().isFailure()) return StatusCode::FAILURE;
+  aCells.reserve(aCells.size() + m_grid->numCells());
+  for (const auto& cell : *m_neighbours.partition(m_systemId)) {
+    aCells.emplace(cell.first, 0);
+  }
+  return StatusCode::SUCCESS;
+}
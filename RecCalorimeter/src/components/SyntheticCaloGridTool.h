@@ -0,0 +1,143 @@
+#ifndef RECCALORIMETER_SYNTHETICCALOGRIDTOOL_H
+#define RECCALORIMETER_SYNTHETICCALOGRIDTOOL_H
+
+// from Gaudi
+#include "GaudiAlg/GaudiTool.h"
+
+// FCCSW
+#include "k4Interface/ICaloReadCellNoiseMap.h"
+#include "k4Interface/ICaloReadNeighboursMap.h"
+#include "k4Interface/ICalorimeterTool.h"
+#include "k4Interface/ICellPositionsTool.h"
+#include "k4Interface/INoiseConstTool.h"
+
+#include "AsyncLoad.h"
+#include "MemoryUsage.h"
+#include "NoNeighbours.h"
+#include "SyntheticCaloGrid.h"
+#include "SystemPartitionedMap.h"
+
+#include <memory>
+
+/** @class SyntheticCaloGridTool Reconstruction/RecCalorimeter/src/components/SyntheticCaloGridTool.h
+ *
+ *  Geometry tool of a regular synthetic grid (see SyntheticCaloGrid), replacing the tools that need the detector
+ *  description or the neighbours and noise files when the reconstruction runs on synthetic events:
+ *  - neighbours map (instead of TopoCaloNeighbours),
+ *  - noise map, with the same noise ('\b cellNoise') and offset ('\b cellNoiseOffset') for all cells (instead of
+ *    TopoCaloNoisyCells, or of the noise tools when the noise level map is created with CreateFCChhCaloNoiseLevelMap),
+ *  - cell positions (instead of the CellPositions* tools),
+ *  - list of all cells of the grid, to add the noise (instead of TubeLayerPhiEtaCaloTool and alike).
+ *  The neighbours and noise maps are built at initialize and stored in hash maps as in the file-based tools, so the
+ *  cost of the lookups in the clustering is comparable. As the file-based maps, they may be built asynchronously (see
+ *  AsyncLoad, '\b asyncInitialize') and are complete at start; prepareEmptyCells waits for them. They are stored in a
+ *  SystemPartitionedMap with a single system, and placed in memory with '\b tablePlacement' and '\b hugePages' as the
+ *  file-based maps.
+ *
+ *  The grid properties have to be the same as for SyntheticCaloTowerTool and CreateSyntheticCaloHits.
+ */
+
+class SyntheticCaloGridTool : public GaudiTool,
+                              virtual public ICaloReadNeighboursMap,
+                              virtual public ICaloReadCellNoiseMap,
+                              virtual public ICellPositionsTool,
+                              virtual public ICalorimeterTool,
+                              virtual public INoiseConstTool {
+public:
+  SyntheticCaloGridTool(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SyntheticCaloGridTool() = default;
+
+  /** Start building the neighbours and noise maps of the grid.
+   */
+  virtual StatusCode initialize() final;
+  /** Wait for the neighbours and noise maps.
+   */
+  virtual StatusCode start() final;
+  virtual StatusCode finalize() final;
+
+  /** Neighbours of a cell.
+   *   @param[in] aCellId, cellid of the cell of interest.
+   *   @return vector of cellIDs, corresponding to the cells neighbours, empty if the cell is not in the grid (see
+   *   NoNeighbours.h).
+   */
+  virtual std::vector<uint64_t>& neighbours(uint64_t aCellId) final;
+  /** Noise of a cell, 0 if the cell is not in the grid.
+   */
+  virtual double noiseRMS(uint64_t aCellId) final;
+  /** Noise offset of a cell, 0 if the cell is not in the grid.
+   */
+  virtual double noiseOffset(uint64_t aCellId) final;
+  /** Noise of a cell (as noiseRMS), used to create the noise level map of the grid.
+   */
+  virtual double getNoiseConstantPerCell(uint64_t aCellId) final;
+  /** Noise offset of a cell (as noiseOffset), used to create the noise level map of the grid.
+   */
+  virtual double getNoiseOffsetPerCell(uint64_t aCellId) final;
+  /** Copy the cells to the output collection, adding their positions.
+   */
+  virtual void getPositions(const edm4hep::CalorimeterHitCollection& aCells,
+                            edm4hep::CalorimeterHitCollection& outputColl) final;
+  /** Position of the centre of a cell.
+   */
+  virtual dd4hep::Position xyzPosition(const uint64_t& aCellId) const final;
+  /** Layer of a cell.
+   */
+  virtual int layerId(const uint64_t& aCellId) final;
+  /** Prepare a map of all cells of the grid, with zero energy.
+   *   @param[in] aCells, map to be filled with the cellIDs.
+   *   @return Status code.
+   */
+  virtual StatusCode prepareEmptyCells(std::unordered_map<uint64_t, double>& aCells) final;
+
+private:
+  /// System ID of the grid cells
+  Gaudi::Property<uint> m_systemId{this, "systemId", 5, "System ID of the grid cells"};
+  /// Number of layers
+  Gaudi::Property<uint> m_numLayers{this, "numLayers", 8, "Number of layers"};
+  /// Number of bins in eta
+  Gaudi::Property<uint> m_numEta{this, "numEta", 150, "Number of bins in eta"};
+  /// Number of bins in phi
+  Gaudi::Property<uint> m_numPhi{this, "numPhi", 352, "Number of bins in phi"};
+  /// Maximum |eta| of the grid
+  Gaudi::Property<double> m_etaMax{this, "etaMax", 1.5, "Maximum |eta| of the grid"};
+  /// Inner radius of the first layer (mm)
+  Gaudi::Property<double> m_rMin{this, "rMin", 1920., "Inner radius of the first layer (mm)"};
+  /// Depth of a layer (mm)
+  Gaudi::Property<double> m_layerDepth{this, "layerDepth", 50., "Depth of a layer (mm)"};
+  /// Noise of the cells
+  Gaudi::Property<double> m_cellNoise{this, "cellNoise", 0.003, "Noise of the cells in GeV"};
+  /// Noise offset of the cells
+  Gaudi::Property<double> m_cellNoiseOffset{this, "cellNoiseOffset", 0., "Noise offset of the cells in GeV"};
+  /// Build the maps asynchronously
+  Gaudi::Property<bool> m_asyncInitialize{this, "asyncInitialize", false,
+                                          "Build the maps asynchronously, joined before the first event"};
+  /// Placement of the maps over the NUMA nodes
+  Gaudi::Property<std::string> m_tablePlacement{this, "tablePlacement", "default",
+                                                "Placement of the maps: default, interleave, replicate"};
+  /// Page size of the maps
+  Gaudi::Property<std::string> m_hugePages{this, "hugePages", "none",
+                                           "Huge pages for the maps: none, transparent, explicit (vm.nr_hugepages)"};
+  /// Build the neighbours and noise maps
+  StatusCode buildMaps();
+  /// Call aFunction for the cellID of each cell of the grid
+  template <typename F>
+  void forEachCell(F&& aFunction) const;
+  /// Grid of the cells
+  std::unique_ptr<SyntheticCaloGrid> m_grid;
+  /// Neighbours of all cells of the grid
+  SystemPartitionedMap<std::vector<uint64_t>> m_neighbours;
+  /// Noise and noise offset of all cells of the grid
+  SystemPartitionedMap<std::pair<double, double>> m_noise;
+  /// Estimated memory of the neighbours map
+  MemoryUsage::Counter m_memoryNeighbours{this, "Memory neighbours map [kB]"};
+  /// Estimated memory of the noise map
+  MemoryUsage::Counter m_memoryNoise{this, "Memory noise map [kB]"};
+  /// Time to build the maps
+  StageTimer::Counter m_timeLoad{this, "Time load [us]"};
+  /// Time spent waiting for the maps
+  StageTimer::Counter m_timeWait{this, "Time wait for load [us]"};
+  /// Building of the maps
+  AsyncLoad m_load{m_timeLoad, m_timeWait};
+};
+
+#endif /* RECCALORIMETER_SYNTHETICCALOGRIDTOOL_H */
@@ -0,0 +1,99 @@
+#include "SyntheticCaloTowerTool.h"
+
+// datamodel
+#include "edm4hep/CalorimeterHitCollection.h"
+#include "edm4hep/MutableCluster.h"
+
+#include <cmath>
+
+DECLARE_COMPONENT(SyntheticCaloTowerTool)
+
+SyntheticCaloTowerTool::SyntheticCaloTowerTool(const std::string& type, const std::string& name,
+                                               const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareProperty("cells", m_cells, "Cells to create towers from (input)");
+  declareInterface<ITowerTool>(this);
+}
+
+StatusCode SyntheticCaloTowerTool::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  m_grid = std::make_unique<SyntheticCaloGrid>(m_systemId, m_numLayers, m_numEta, m_numPhi, m_etaMax, m_rMin,
+                                               m_layerDepth);
+  if (!m_grid->valid()) {
+    error() << "Grid dimensions do not fit into the cell ID (system:4,layer:8,eta:12,phi:12)!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_cellsInTowers.resize(m_grid->numEta() * m_grid->numPhi());
+  m_geometry = TowerGeometry(m_grid->numEta(), m_grid->numPhi(), -m_grid->etaMax(), m_grid->deltaEta(), -M_PI,
+                             m_grid->deltaPhi(), m_rMin, true, m_geometryTables);
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SyntheticCaloTowerTool::finalize() { return GaudiTool::finalize(); }
+
+tower SyntheticCaloTowerTool::towersNumber() {
+  tower total;
+  total.eta = m_grid->numEta();
+  total.phi = m_grid->numPhi();
+  return total;
+}
+
+uint SyntheticCaloTowerTool::buildTowers(std::vector<std::vector<float>>& aTowers) {
+  StageTimer timer(m_timeTowers);
+  for (auto& towerCells : m_cellsInTowers) {
+    towerCells.clear();
+  }
+  const edm4hep::CalorimeterHitCollection* cells = m_cells.get();
+  debug() << "Input cell collection size: " << cells->size() << endmsg;
+  for (const auto& cell : *cells) {
+    uint64_t cellId = cell.getCellID();
+    if (!m_grid->contains(cellId)) continue;
+    uint iEta = m_grid->idEta(cellId);
+    uint iPhi = m_grid->idPhi(cellId);
+    aTowers[iEta][iPhi] += cell.getEnergy() / cosh(m_grid->eta(iEta));
+    m_cellsInTowers[iEta * m_grid->numPhi() + iPhi].push_back(cell);
+  }
+  m_numCells += cells->size();
+  return cells->size();
+}
+
+float SyntheticCaloTowerTool::radiusForPosition() const { return m_rMin; }
+
+uint SyntheticCaloTowerTool::idEta(float aEta) const { return m_geometry.idEta(aEta); }
+
+uint SyntheticCaloTowerTool::idPhi(float aPhi) const { return m_geometry.idPhi(aPhi); }
+
+float SyntheticCaloTowerTool::eta(int aIdEta) const {
+  // middle of the tower
+  return m_geometry.eta(aIdEta);
+}
+
+float SyntheticCaloTowerTool::phi(int aIdPhi) const {
+  // middle of the tower
+  return m_geometry.phi(aIdPhi);
+}
+
+const TowerGeometry& SyntheticCaloTowerTool::towerGeometry() const { return m_geometry; }
+
+void SyntheticCaloTowerTool::attachCells(float aEta, float aPhi, uint aHalfEtaFinal, uint aHalfPhiFinal,
+                                         edm4hep::MutableCluster& aEdmCluster,
+                                         edm4hep::CalorimeterHitCollection* aEdmClusterCells, bool aEllipse) {
+  int etaId = idEta(aEta);
+  int phiId = idPhi(aPhi);
+  int numPhi = m_grid->numPhi();
+  for (int iEta = etaId - int(aHalfEtaFinal); iEta <= etaId + int(aHalfEtaFinal); iEta++) {
+    if (iEta < 0 || iEta >= int(m_grid->numEta())) continue;
+    for (int iPhi = phiId - int(aHalfPhiFinal); iPhi <= phiId + int(aHalfPhiFinal); iPhi++) {
+      if (aEllipse && pow((etaId - iEta) / (aHalfEtaFinal + 0.5), 2) + pow((phiId - iPhi) / (aHalfPhiFinal + 0.5), 2) >= 1) {
+        continue;
+      }
+      for (const auto& cell : m_cellsInTowers[iEta * numPhi + (iPhi % numPhi + numPhi) % numPhi]) {
+        auto cellclone = cell.clone();
+        aEdmClusterCells->push_back(cellclone);
+        aEdmCluster.addToHits(cellclone);
+      }
+    }
+  }
+}
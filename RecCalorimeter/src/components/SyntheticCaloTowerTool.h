@@ -0,0 +1,122 @@
+#ifndef RECCALORIMETER_SYNTHETICCALOTOWERTOOL_H
+#define RECCALORIMETER_SYNTHETICCALOTOWERTOOL_H
+
+// from Gaudi
+#include "GaudiAlg/GaudiTool.h"
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+#include "k4Interface/ITowerTool.h"
+
+#include "StageTimer.h"
+#include "SyntheticCaloGrid.h"
+#include "TowerGeometry.h"
+
+#include <memory>
+
+// datamodel
+namespace edm4hep {
+class CalorimeterHitCollection;
+class CalorimeterHit;
+}
+
+/** @class SyntheticCaloTowerTool Reconstruction/RecCalorimeter/src/components/SyntheticCaloTowerTool.h
+ *
+ *  Tool building the calorimeter towers of a regular synthetic grid (see SyntheticCaloGrid) for the sliding window
+ *  algorithm, replacing CaloTowerTool (which needs the DD4hep segmentations) when the reconstruction runs on
+ *  synthetic events.
+ *  A tower is one eta-phi bin of the grid, with the transverse energy of the cells summed over all layers.
+ *  The cells of the collection '\b cells' that are not in the grid are skipped.
+ *  The radius for the cluster position is the radius of the first layer.
+ *  The time to fill the cells into towers and the number of cells per event are recorded in counters.
+ *  The tower IDs are the bins of the grid: clamped in eta, modulo the number of bins in phi.
+ *
+ *  The grid properties have to be the same as for SyntheticCaloGridTool and CreateSyntheticCaloHits.
+ */
+
+class SyntheticCaloTowerTool : public GaudiTool, virtual public ITowerTool, public TowerGeometry::Provider {
+public:
+  SyntheticCaloTowerTool(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SyntheticCaloTowerTool() = default;
+  virtual StatusCode initialize() final;
+  virtual StatusCode finalize() final;
+  /**  Number of calorimeter towers, equal to the number of eta and phi bins of the grid.
+   *   @return Struct containing number of towers in eta and phi.
+   */
+  virtual tower towersNumber() final;
+  /**  Build calorimeter towers.
+   *   @param[out] aTowers Calorimeter towers.
+   *   @return Size of the cell collection.
+   */
+  virtual uint buildTowers(std::vector<std::vector<float>>& aTowers) final;
+  /**  Get the radius for the position calculation.
+   *   @return Radius
+   */
+  virtual float radiusForPosition() const final;
+  /**  Get the tower IDs in eta.
+   *   @param[in] aEta Position of the calorimeter cell in eta
+   *   @return ID (eta) of a tower
+   */
+  virtual uint idEta(float aEta) const final;
+  /**  Get the tower IDs in phi.
+   *   @param[in] aPhi Position of the calorimeter cell in phi
+   *   @return ID (phi) of a tower
+   */
+  virtual uint idPhi(float aPhi) const final;
+  /**  Get the eta position of the centre of the tower.
+   *   @param[in] aIdEta ID (eta) of a tower
+   *   @return Position of the centre of the tower
+   */
+  virtual float eta(int aIdEta) const final;
+  /**  Get the phi position of the centre of the tower.
+   *   @param[in] aIdPhi ID (phi) of a tower
+   *   @return Position of the centre of the tower
+   */
+  virtual float phi(int aIdPhi) const final;
+  /**  Get the descriptor of the tower grid, with the queries above as inline functions (see TowerGeometry.h).
+   *   @return Descriptor of the grid
+   */
+  virtual const TowerGeometry& towerGeometry() const final;
+  /**  Find cells belonging to a cluster.
+   *   @param[in] aEta Position of the middle tower of a cluster in eta
+   *   @param[in] aPhi Position of the middle tower of a cluster in phi
+   *   @param[in] aHalfEtaFinal Half size of cluster in eta (in units of tower size). Cluster size is 2*aHalfEtaFinal+1
+   *   @param[in] aHalfPhiFinal Half size of cluster in phi (in units of tower size). Cluster size is 2*aHalfPhiFinal+1
+   *   @param[out] aEdmCluster Cluster where cells are attached to
+   */
+  virtual void attachCells(float aEta, float aPhi, uint aHalfEtaFinal, uint aHalfPhiFinal,
+                           edm4hep::MutableCluster& aEdmCluster, edm4hep::CalorimeterHitCollection* aEdmClusterCells,
+                           bool aEllipse = false) final;
+
+private:
+  /// Handle for the cells (input collection)
+  DataHandle<edm4hep::CalorimeterHitCollection> m_cells{"cells", Gaudi::DataHandle::Reader, this};
+  /// System ID of the grid cells
+  Gaudi::Property<uint> m_systemId{this, "systemId", 5, "System ID of the grid cells"};
+  /// Number of layers
+  Gaudi::Property<uint> m_numLayers{this, "numLayers", 8, "Number of layers"};
+  /// Number of bins in eta
+  Gaudi::Property<uint> m_numEta{this, "numEta", 150, "Number of bins in eta"};
+  /// Number of bins in phi
+  Gaudi::Property<uint> m_numPhi{this, "numPhi", 352, "Number of bins in phi"};
+  /// Maximum |eta| of the grid
+  Gaudi::Property<double> m_etaMax{this, "etaMax", 1.5, "Maximum |eta| of the grid"};
+  /// Inner radius of the first layer (mm)
+  Gaudi::Property<double> m_rMin{this, "rMin", 1920., "Inner radius of the first layer (mm)"};
+  /// Depth of a layer (mm)
+  Gaudi::Property<double> m_layerDepth{this, "layerDepth", 50., "Depth of a layer (mm)"};
+  /// Grid of the cells
+  std::unique_ptr<SyntheticCaloGrid> m_grid;
+  /// Descriptor of the tower grid
+  TowerGeometry m_geometry;
+  /// Tables of the tower centres of the descriptor
+  TowerGeometry::Tables m_geometryTables;
+  /// Cells of each tower (index: eta * number of phi bins + phi) to be attached to the clusters
+  std::vector<std::vector<edm4hep::CalorimeterHit>> m_cellsInTowers;
+  /// Time to fill the cells into towers
+  StageTimer::Counter m_timeTowers{this, "Time towers [us]"};
+  /// Number of cells filled into towers per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numCells{this, "Cells"};
+};
+
+#endif /* RECCALORIMETER_SYNTHETICCALOTOWERTOOL_H */
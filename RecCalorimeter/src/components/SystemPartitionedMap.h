@@ -0,0 +1,271 @@
+#ifndef RECCALORIMETER_SYSTEMPARTITIONEDMAP_H
+#define RECCALORIMETER_SYSTEMPARTITIONEDMAP_H
+
+// Gaudi
+#include "GaudiKernel/StatusCode.h"
+
+// DD4hep
+#include "DDSegmentation/BitFieldCoder.h"
+
+#include "LargeTableMemory.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/** @class SystemPartitionedMap Reconstruction/RecCalorimeter/src/components/SystemPartitionedMap.h
+ *
+ *  Map from cell ID to a value (neighbours, noise), partitioned by the system ID of the cells, so that only the tables
+ *  of the systems used by a job are held in memory.
+ *
+ *  The systems available in the input are declared with addSystem(). A partition is filled by the loader, either
+ *  at once with load() (at initialize), or at the first lookup of one of its cells with find() if the map is lazy.
+ *  The lazy load is protected by a mutex, so lookups may be done concurrently; a partition is not modified after it
+ *  is loaded, so the returned pointers stay valid. Tables stored without partitioning are filled with insert() and
+ *  markLoaded().
+ *  The system is decoded from the cell ID with the given encoding (the field "system", e.g. "system:4").
+ *
+ *  The memory of the partitions follows the policy given to configure (see LargeTableMemory.h): each partition is
+ *  allocated from its own arena, interleaved over the NUMA nodes or on huge pages; with the placement "replicate" a
+ *  partition is copied to every NUMA node once it is loaded, and find() returns the value from the copy of the node
+ *  of the calling thread.
+ */
+
+template <typename T>
+class SystemPartitionedMap {
+public:
+  /// Allocator of the maps, from the arena of the partition
+  typedef large_table::ArenaAllocator<std::pair<const uint64_t, T>> Allocator;
+  typedef std::unordered_map<uint64_t, T, std::hash<uint64_t>, std::equal_to<uint64_t>, Allocator> Map;
+  /// Fills the map of one system
+  typedef std::function<StatusCode(uint aSystem, Map& aMap)> Loader;
+
+  SystemPartitionedMap() = default;
+  SystemPartitionedMap(const SystemPartitionedMap&) = delete;
+  SystemPartitionedMap& operator=(const SystemPartitionedMap&) = delete;
+
+  /** Set the encoding of the cell IDs, the loader of the partitions, whether they are loaded at the first lookup,
+   *  and the memory policy of the partitions, before the systems are declared.
+   */
+  void configure(const std::string& aEncoding, Loader aLoader, bool aLazy,
+                 const large_table::Policy& aPolicy = large_table::Policy()) {
+    m_decoder = std::make_unique<dd4hep::DDSegmentation::BitFieldCoder>(aEncoding);
+    m_systemIndex = m_decoder->index("system");
+    m_loader = std::move(aLoader);
+    m_lazy = aLazy;
+    m_policy = aPolicy;
+  }
+
+  /// Memory policy of the partitions
+  const large_table::Policy& policy() const { return m_policy; }
+
+  /// System of a cell
+  uint system(uint64_t aCellId) const { return m_decoder->get(aCellId, m_systemIndex); }
+
+  /// Declare a system of the input, before the lookups
+  void addSystem(uint aSystem) {
+    if (aSystem >= m_partitions.size()) m_partitions.resize(aSystem + 1);
+    if (m_partitions[aSystem] == nullptr) m_partitions[aSystem] = std::make_unique<Partition>(m_policy, firstNode());
+  }
+
+  /// Systems declared
+  std::vector<uint> systems() const {
+    std::vector<uint> systems;
+    for (uint iSystem = 0; iSystem < m_partitions.size(); iSystem++) {
+      if (m_partitions[iSystem] != nullptr) systems.push_back(iSystem);
+    }
+    return systems;
+  }
+
+  /// Systems of aRequested that are not declared
+  std::vector<uint> missingSystems(const std::vector<uint>& aRequested) const {
+    std::vector<uint> missing;
+    for (uint iSystem : aRequested) {
+      if (iSystem >= m_partitions.size() || m_partitions[iSystem] == nullptr) missing.push_back(iSystem);
+    }
+    return missing;
+  }
+
+  /// Fill the partition of a system with the loader, if not done yet
+  StatusCode load(uint aSystem) {
+    Partition& partition = *m_partitions.at(aSystem);
+    if (partition.loaded.load(std::memory_order_acquire)) return partition.status;
+    std::lock_guard<std::mutex> lock(partition.mutex);
+    if (!partition.loaded.load(std::memory_order_relaxed)) {
+      {
+        large_table::ScopedPolicy scope(m_policy.placement, firstNode());
+        partition.status = m_loader(aSystem, partition.table.map);
+      }
+      if (partition.status.isSuccess()) replicate(partition);
+      partition.loaded.store(true, std::memory_order_release);
+    }
+    return partition.status;
+  }
+
+  /// Fill the partitions of all declared systems
+  StatusCode loadAll() {
+    for (uint iSystem : systems()) {
+      if (load(iSystem).isFailure()) return StatusCode::FAILURE;
+    }
+    return StatusCode::SUCCESS;
+  }
+
+  /** Policy of the calling thread while the partitions are filled with insert, so that the memory allocated inside
+   *  the values follows the placement of the map.
+   */
+  std::unique_ptr<large_table::ScopedPolicy> insertPolicy() const {
+    return std::make_unique<large_table::ScopedPolicy>(m_policy.placement, firstNode());
+  }
+
+  /// Insert a cell into the partition of its system, which has to be declared (tables stored without partitioning)
+  void insert(uint64_t aCellId, const T& aValue) {
+    m_partitions.at(system(aCellId))->table.map.emplace(aCellId, aValue);
+  }
+
+  /// Mark the declared partitions as loaded, after they are filled with insert
+  void markLoaded() {
+    for (auto& partition : m_partitions) {
+      if (partition == nullptr) continue;
+      replicate(*partition);
+      partition->loaded.store(true, std::memory_order_release);
+    }
+  }
+
+  /// Map of a loaded system, nullptr if the system is not declared or not loaded yet
+  const Map* partition(uint aSystem) const {
+    if (aSystem >= m_partitions.size() || m_partitions[aSystem] == nullptr) return nullptr;
+    return m_partitions[aSystem]->loaded.load(std::memory_order_acquire) ? &m_partitions[aSystem]->table.map : nullptr;
+  }
+
+  /// Value of a cell, nullptr if its system is not declared or the cell is not in the map
+  T* find(uint64_t aCellId) {
+    uint cellSystem = system(aCellId);
+    if (cellSystem >= m_partitions.size() || m_partitions[cellSystem] == nullptr) return nullptr;
+    Partition& partition = *m_partitions[cellSystem];
+    if (!partition.loaded.load(std::memory_order_acquire)) {
+      if (!m_lazy || load(cellSystem).isFailure()) return nullptr;
+    }
+    Map& map = partition.local().map;
+    auto it = map.find(aCellId);
+    return it == map.end() ? nullptr : &it->second;
+  }
+
+  /// Number of cells in the loaded partitions
+  size_t size() const {
+    size_t cells = 0;
+    for (const auto& partition : m_partitions) {
+      if (partition != nullptr && partition->loaded.load(std::memory_order_acquire)) {
+        cells += partition->table.map.size();
+      }
+    }
+    return cells;
+  }
+
+  /// Number of copies of the loaded partitions: one per partition, one per NUMA node and partition if replicated
+  size_t copies() const {
+    size_t copies = 0;
+    for (const auto& partition : m_partitions) {
+      if (partition == nullptr || !partition->loaded.load(std::memory_order_acquire)) continue;
+      for (const auto& replica : partition->replicas) {
+        copies += replica != nullptr;
+      }
+      copies++;
+    }
+    return copies;
+  }
+
+  /// Memory mapped for the loaded partitions and their copies, in bytes (0 with the default policy)
+  size_t mappedBytes() const {
+    size_t bytes = 0;
+    for (const auto& partition : m_partitions) {
+      if (partition == nullptr || !partition->loaded.load(std::memory_order_acquire)) continue;
+      bytes += partition->table.mappedBytes();
+      for (const auto& replica : partition->replicas) {
+        if (replica != nullptr) bytes += replica->mappedBytes();
+      }
+    }
+    return bytes;
+  }
+
+  /// Whether the explicit huge pages were not available for one of the loaded partitions
+  bool hugePagesFallback() const {
+    for (const auto& partition : m_partitions) {
+      if (partition == nullptr || !partition->loaded.load(std::memory_order_acquire)) continue;
+      if (partition->table.arena != nullptr && partition->table.arena->hugePagesFallback()) return true;
+    }
+    return false;
+  }
+
+private:
+  /// One copy of the cells of a system, with its memory
+  struct Table {
+    Table(const large_table::Policy& aPolicy, int aNode)
+        : arena(aPolicy.isDefault() ? nullptr : std::make_unique<large_table::Arena>(aPolicy, aNode)),
+          map(0, std::hash<uint64_t>(), std::equal_to<uint64_t>(), Allocator(arena.get())) {}
+    size_t mappedBytes() const { return arena == nullptr ? 0 : arena->mappedBytes(); }
+    /// Memory of the map, declared first so that it outlives the map
+    std::unique_ptr<large_table::Arena> arena;
+    Map map;
+  };
+  struct Partition {
+    Partition(const large_table::Policy& aPolicy, int aNode) : table(aPolicy, aNode) {}
+    /// Copy of the NUMA node of the calling thread
+    Table& local() {
+      if (replicas.empty()) return table;
+      size_t node = large_table::currentNode();
+      return node < replicas.size() && replicas[node] != nullptr ? *replicas[node] : table;
+    }
+    /// Cells of the system, on the first NUMA node if replicated
+    Table table;
+    /// Copies of the table, indexed by NUMA node (replicate), nullptr for the first node
+    std::vector<std::unique_ptr<Table>> replicas;
+    /// Whether the map is filled, it is not modified afterwards
+    std::atomic<bool> loaded{false};
+    /// Status of the loader
+    StatusCode status = StatusCode::SUCCESS;
+    /// Serialises the load
+    std::mutex mutex;
+  };
+  /// Node of the first copy of the replicated partitions
+  int firstNode() const {
+    return m_policy.placement == large_table::Placement::kReplicate ? large_table::onlineNodes().front() : -1;
+  }
+
+  /// Copy a filled partition to the other NUMA nodes (replicate)
+  void replicate(Partition& aPartition) {
+    if (m_policy.placement != large_table::Placement::kReplicate || !aPartition.replicas.empty()) return;
+    const std::vector<int>& nodes = large_table::onlineNodes();
+    if (nodes.size() < 2) return;
+    aPartition.replicas.resize(nodes.back() + 1);
+    const Map& source = aPartition.table.map;
+    for (auto node = std::next(nodes.begin()); node != nodes.end(); ++node) {
+      // the copy, also the memory allocated inside the values, is written by this thread with the policy of the node
+      large_table::ScopedPolicy scope(m_policy.placement, *node);
+      auto replica = std::make_unique<Table>(m_policy, *node);
+      replica->map.reserve(source.size());
+      replica->map.insert(source.begin(), source.end());
+      aPartition.replicas[*node] = std::move(replica);
+    }
+  }
+
+  /// Decoder of the system
+  std::unique_ptr<dd4hep::DDSegmentation::BitFieldCoder> m_decoder;
+  /// Index of the system field
+  size_t m_systemIndex = 0;
+  /// Loader of the partitions
+  Loader m_loader;
+  /// Load the partitions at the first lookup
+  bool m_lazy = true;
+  /// Memory policy of the partitions
+  large_table::Policy m_policy;
+  /// Partitions, indexed by system
+  std::vector<std::unique_ptr<Partition>> m_partitions;
+};
+
+#endif /* RECCALORIMETER_SYSTEMPARTITIONEDMAP_H */
@@ -0,0 +1,70 @@
+#include "ThroughputReport.h"
+
+// Gaudi
+#include "GaudiKernel/ChronoEntity.h"
+#include "GaudiKernel/IChronoStatSvc.h"
+
+#include <sys/resource.h>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+DECLARE_COMPONENT(ThroughputReport)
+
+ThroughputReport::ThroughputReport(const std::string& name, ISvcLocator* svcLoc) : GaudiAlgorithm(name, svcLoc) {}
+
+StatusCode ThroughputReport::initialize() {
+  StatusCode sc = GaudiAlgorithm::initialize();
+  if (sc.isFailure()) return sc;
+  m_numEvents = 0;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode ThroughputReport::execute() {
+  if (m_numEvents == 0) {
+    m_start = std::chrono::steady_clock::now();
+  }
+  m_numEvents++;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode ThroughputReport::finalize() {
+  double wallTime = 0;
+  if (m_numEvents > 0) {
+    wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+  }
+  double eventsPerSecond = wallTime > 0 ? m_numEvents / wallTime : 0;
+  // peak resident memory of the process, in kB on Linux
+  struct rusage usage;
+  long peakRSS = getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : 0;
+
+  info() << "Events: " << m_numEvents << ", event loop time: " << wallTime << " s, " << eventsPerSecond
+         << " events/s, peak RSS: " << peakRSS / 1024. << " MB" << endmsg;
+  std::ostringstream json;
+  json << std::setprecision(6) << "{\"events\": " << m_numEvents << ", \"wallTime\": " << wallTime
+       << ", \"eventsPerSecond\": " << eventsPerSecond << ", \"peakRSSkB\": " << peakRSS << ", \"algorithms\": {";
+  for (size_t i = 0; i < m_algorithms.size(); i++) {
+    const auto& name = m_algorithms[i];
+    // total elapsed time of the algorithm in microseconds, as recorded by the ChronoAuditor
+    const ChronoEntity* chrono = chronoSvc()->chrono(name + ":Execute");
+    double time = chrono != nullptr ? chrono->eTotalTime() * 1e-6 : 0;
+    double share = wallTime > 0 ? time / wallTime : 0;
+    if (chrono == nullptr) {
+      warning() << "No ChronoAuditor time for " << name << ", is AuditExecute set?" << endmsg;
+    }
+    info() << std::setw(40) << std::left << name << std::right << std::setw(10) << std::fixed << std::setprecision(3)
+           << time << " s " << std::setw(6) << std::setprecision(1) << 100 * share << " %" << endmsg;
+    json << (i > 0 ? ", " : "") << "\"" << name << "\": " << time;
+  }
+  json << "}}";
+  if (!m_outputFile.empty()) {
+    std::ofstream file(m_outputFile.value());
+    if (!file) {
+      error() << "Unable to write the report to " << m_outputFile.value() << endmsg;
+      return StatusCode::FAILURE;
+    }
+    file << json.str() << std::endl;
+  }
+  return GaudiAlgorithm::finalize();
+}
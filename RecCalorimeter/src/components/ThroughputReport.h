@@ -0,0 +1,43 @@
+#ifndef RECCALORIMETER_THROUGHPUTREPORT_H
+#define RECCALORIMETER_THROUGHPUTREPORT_H
+
+// Gaudi
+#include "GaudiAlg/GaudiAlgorithm.h"
+
+#include <chrono>
+
+/** @class ThroughputReport
+ *
+ *  Algorithm reporting the throughput of a job at finalize: number of events, wall-clock time of the event loop,
+ *  events per second, peak resident memory of the process and the share of the event loop time spent in each of the
+ *  algorithms '\b algorithms'.
+ *  The algorithm has to be the first one of the event loop: the time is counted from the start of the first event to
+ *  finalize. The times of the algorithms are the "Execute" times of the ChronoAuditor, which has to be enabled for them
+ *  (AuditExecute = True).
+ *  If '\b outputFile' is set, the report is also written to this file as one JSON object, to be collected from several
+ *  jobs (e.g. by RecCalorimeter/tests/scripts/runSyntheticChainScaling.py).
+ */
+
+class ThroughputReport : public GaudiAlgorithm {
+public:
+  ThroughputReport(const std::string& name, ISvcLocator* svcLoc);
+
+  StatusCode initialize();
+
+  StatusCode execute();
+
+  StatusCode finalize();
+
+private:
+  /// Names of the algorithms for which the time share is reported
+  Gaudi::Property<std::vector<std::string>> m_algorithms{
+      this, "algorithms", {}, "Names of the algorithms for which the time share is reported"};
+  /// Name of the JSON file with the report
+  Gaudi::Property<std::string> m_outputFile{this, "outputFile", "", "Name of the JSON file with the report"};
+  /// Number of processed events
+  unsigned long m_numEvents = 0;
+  /// Start of the first event
+  std::chrono::steady_clock::time_point m_start;
+};
+
+#endif /* RECCALORIMETER_THROUGHPUTREPORT_H */
@@ -0,0 +1,95 @@
+#include "TimeCaloTableLookups.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <random>
+#include <unordered_map>
+
+DECLARE_COMPONENT(TimeCaloTableLookups)
+
+TimeCaloTableLookups::TimeCaloTableLookups(const std::string& name, ISvcLocator* svcLoc)
+    : GaudiAlgorithm(name, svcLoc) {
+  declareProperty("neighboursTool", m_neighboursTool, "Handle for tool to retrieve cell neighbours");
+  declareProperty("noiseTool", m_noiseTool, "Handle for the cells noise tool");
+  declareProperty("geometryTool", m_geoTool, "Handle for the geometry tool listing all cells");
+}
+
+StatusCode TimeCaloTableLookups::initialize() {
+  StatusCode sc = GaudiAlgorithm::initialize();
+  if (sc.isFailure()) return sc;
+  // the tools are called from several threads, they are retrieved here instead of at their first use
+  if (!m_neighboursTool.retrieve() || !m_noiseTool.retrieve() || !m_geoTool.retrieve()) {
+    error() << "Unable to retrieve the neighbours, noise or geometry tool" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  std::unordered_map<uint64_t, double> cells;
+  if (m_geoTool->prepareEmptyCells(cells).isFailure() || cells.empty()) {
+    error() << "Unable to get the cells from the geometry tool" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  std::vector<uint64_t> cellIds;
+  cellIds.reserve(cells.size());
+  for (const auto& cell : cells) {
+    cellIds.push_back(cell.first);
+  }
+  // same order of the cells in all jobs, then shuffled per thread
+  std::sort(cellIds.begin(), cellIds.end());
+  m_cellIds.assign(std::max(1u, m_numThreads.value()), std::vector<uint64_t>());
+  for (size_t iThread = 0; iThread < m_cellIds.size(); iThread++) {
+    std::mt19937_64 generator(m_seed + iThread);
+    std::uniform_int_distribution<size_t> index(0, cellIds.size() - 1);
+    m_cellIds[iThread].resize(m_lookupsPerThread);
+    for (auto& cellId : m_cellIds[iThread]) {
+      cellId = cellIds[index(generator)];
+    }
+  }
+  info() << m_cellIds.size() << " threads looking up " << m_lookupsPerThread << " of " << cellIds.size()
+         << " cells per event" << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode TimeCaloTableLookups::execute() {
+  struct Result {
+    unsigned long numNeighbourIds = 0;
+    double noiseSum = 0;
+    double time = 0;
+  };
+  auto lookups = [this](const std::vector<uint64_t>& aCellIds) {
+    Result result;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t cellId : aCellIds) {
+      result.numNeighbourIds += m_neighboursTool->neighbours(cellId).size();
+      result.noiseSum += m_noiseTool->noiseRMS(cellId);
+    }
+    result.time = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return result;
+  };
+
+  StageTimer timer(m_timeLookups);
+  std::vector<std::future<Result>> threads;
+  for (size_t iThread = 1; iThread < m_cellIds.size(); iThread++) {
+    threads.push_back(std::async(std::launch::async, lookups, std::cref(m_cellIds[iThread])));
+  }
+  std::vector<Result> results(1, lookups(m_cellIds[0]));
+  for (auto& thread : threads) {
+    results.push_back(thread.get());
+  }
+  timer.stop();
+
+  // summed in the order of the threads, so that the sum does not depend on the timing
+  Result total;
+  for (const auto& result : results) {
+    total.numNeighbourIds += result.numNeighbourIds;
+    total.noiseSum += result.noiseSum;
+    total.time += result.time;
+  }
+  m_numNeighbourIds += total.numNeighbourIds;
+  m_noiseSum += total.noiseSum;
+  size_t numLookups = m_cellIds.size() * m_lookupsPerThread;
+  if (numLookups > 0) m_timePerLookup += total.time / numLookups;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode TimeCaloTableLookups::finalize() { return GaudiAlgorithm::finalize(); }
@@ -0,0 +1,67 @@
+#ifndef RECCALORIMETER_TIMECALOTABLELOOKUPS_H
+#define RECCALORIMETER_TIMECALOTABLELOOKUPS_H
+
+// Gaudi
+#include "GaudiAlg/GaudiAlgorithm.h"
+#include "GaudiKernel/ToolHandle.h"
+
+// FCCSW
+#include "k4Interface/ICaloReadCellNoiseMap.h"
+#include "k4Interface/ICaloReadNeighboursMap.h"
+#include "k4Interface/ICalorimeterTool.h"
+
+#include "StageTimer.h"
+
+#include <cstdint>
+#include <vector>
+
+/** @class TimeCaloTableLookups
+ *
+ *  Benchmark of the lookups in the neighbours and noise maps from several threads, as done by the clustering of
+ *  concurrent events, to measure the effect of the placement of the maps in memory ('\b tablePlacement' and
+ *  '\b hugePages' of TopoCaloNeighbours, TopoCaloNoisyCells and SyntheticCaloGridTool, see LargeTableMemory.h).
+ *
+ *  In every event '\b numThreads' threads look up '\b lookupsPerThread' cells each, in a random order fixed at
+ *  initialize (from '\b seed'), among all cells of the geometry tool: the neighbours of the cell and its noise. The
+ *  wall time of the event is recorded in "Time lookups [us]" and the time per lookup, summed over the threads, in
+ *  "Time per lookup [ns]". "Neighbour IDs" and "Noise sum" do not depend on the placement, they check that all
+ *  configurations read the same tables.
+ */
+
+class TimeCaloTableLookups : public GaudiAlgorithm {
+public:
+  TimeCaloTableLookups(const std::string& name, ISvcLocator* svcLoc);
+
+  StatusCode initialize();
+
+  StatusCode execute();
+
+  StatusCode finalize();
+
+private:
+  /// Handle for the neighbours map
+  ToolHandle<ICaloReadNeighboursMap> m_neighboursTool{"TopoCaloNeighbours", this};
+  /// Handle for the noise map
+  ToolHandle<ICaloReadCellNoiseMap> m_noiseTool{"TopoCaloNoisyCells", this};
+  /// Handle for the geometry tool listing all cells
+  ToolHandle<ICalorimeterTool> m_geoTool{"TubeLayerPhiEtaCaloTool", this};
+  /// Number of threads doing the lookups
+  Gaudi::Property<unsigned> m_numThreads{this, "numThreads", 4, "Number of threads doing the lookups"};
+  /// Number of cells looked up per thread and event
+  Gaudi::Property<unsigned> m_lookupsPerThread{this, "lookupsPerThread", 1000000,
+                                               "Number of cells looked up per thread and event"};
+  /// Seed of the order of the lookups
+  Gaudi::Property<unsigned> m_seed{this, "seed", 12345, "Seed of the order of the lookups"};
+  /// CellIDs looked up by each thread, in order
+  std::vector<std::vector<uint64_t>> m_cellIds;
+  /// Wall time of the lookups per event
+  StageTimer::Counter m_timeLookups{this, "Time lookups [us]"};
+  /// Time per lookup, summed over the threads
+  Gaudi::Accumulators::StatCounter<double> m_timePerLookup{this, "Time per lookup [ns]"};
+  /// Number of neighbour IDs read per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numNeighbourIds{this, "Neighbour IDs"};
+  /// Sum of the noise of the cells looked up per event
+  Gaudi::Accumulators::StatCounter<double> m_noiseSum{this, "Noise sum"};
+};
+
+#endif /* RECCALORIMETER_TIMECALOTABLELOOKUPS_H */
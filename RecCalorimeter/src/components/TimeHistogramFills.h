@@ -0,0 +1,75 @@
+#ifndef RECCALORIMETER_TIMEHISTOGRAMFILLS_H
+#define RECCALORIMETER_TIMEHISTOGRAMFILLS_H
+
+// Gaudi
+#include "GaudiAlg/GaudiAlgorithm.h"
+
+#include "HistogramFillBuffer.h"
+#include "StageTimer.h"
+
+#include <memory>
+#include <vector>
+
+class TH1;
+
+/** @class TimeHistogramFills
+ *
+ *  Test and benchmark of HistogramFillBuffer: the same fills are done directly with TH1::Fill/TH2::Fill in one set
+ *  of histograms and through the buffer in a second, identical set.
+ *
+ *  '\b numHistograms' histograms are created per set, alternately TH1D and TH2D, filled with unit weights (the first
+ *  pair) and with random weights (the second pair, with sumw2), and so on. In every event '\b fillsPerEvent' random
+ *  fills (histogram, x, y, weight, from '\b seed'), partly outside of the axis ranges, are generated first, then done
+ *  directly ("Time direct fills [us]") and through the buffer ("Time buffered fills [us]", including the flushes
+ *  when "histogramFlushSize" fills are buffered).
+ *
+ *  At finalize the buffer is flushed ("Time final flush [us]") and each buffered histogram is compared exactly to
+ *  its directly filled twin: bin contents, sum of squared weights, number of entries and statistics. The number of
+ *  differing histograms is in "Histogram differences", the job fails if it is not zero.
+ */
+
+class TimeHistogramFills : public GaudiAlgorithm {
+public:
+  TimeHistogramFills(const std::string& name, ISvcLocator* svcLoc);
+
+  StatusCode initialize();
+
+  StatusCode execute();
+
+  StatusCode finalize();
+
+private:
+  /// One fill of the event
+  struct Fill {
+    unsigned histogram;
+    double x;
+    double y;
+    double weight;
+  };
+  /// Number of histograms per set
+  Gaudi::Property<unsigned> m_numHistograms{this, "numHistograms", 4, "Number of histograms per set"};
+  /// Number of fills per event
+  Gaudi::Property<unsigned> m_fillsPerEvent{this, "fillsPerEvent", 100000, "Number of fills per event"};
+  /// Seed of the fills
+  Gaudi::Property<unsigned> m_seed{this, "seed", 12345, "Seed of the fills"};
+  /// Histograms filled directly
+  std::vector<std::unique_ptr<TH1>> m_direct;
+  /// Histograms filled through the buffer
+  std::vector<std::unique_ptr<TH1>> m_buffered;
+  /// Fills of the event, generated before the timed fills
+  std::vector<Fill> m_fills;
+  /// Number of the event, for the seed of its fills
+  unsigned long m_event = 0;
+  /// Buffer of the fills
+  HistogramFillBuffer m_histogramFills{this};
+  /// Time of the direct fills per event
+  StageTimer::Counter m_timeDirect{this, "Time direct fills [us]"};
+  /// Time of the buffered fills per event
+  StageTimer::Counter m_timeBuffered{this, "Time buffered fills [us]"};
+  /// Time of the flush at finalize
+  StageTimer::Counter m_timeFinalFlush{this, "Time final flush [us]"};
+  /// Number of buffered histograms different from their twin
+  Gaudi::Accumulators::Counter<> m_numDifferences{this, "Histogram differences"};
+};
+
+#endif /* RECCALORIMETER_TIMEHISTOGRAMFILLS_H */
@@ -1,9 +1,12 @@
 #include "TopoCaloNeighbours.h"
 
 #include "TFile.h"
+#include "TKey.h"
 #include "TTree.h"
 #include "TBranch.h"
 
+#include <algorithm>
+
 DECLARE_COMPONENT(TopoCaloNeighbours)
 
 TopoCaloNeighbours::TopoCaloNeighbours(const std::string& type, const std::string& name,
@@ -15,35 +18,155 @@ TopoCaloNeighbours::TopoCaloNeighbours(const std::string& type, const std::strin
 StatusCode TopoCaloNeighbours::initialize() {
   StatusCode sc = GaudiTool::initialize();
   if (sc.isFailure()) return sc;
+  large_table::Policy policy;
+  std::string policyError = policy.parse(m_tablePlacement, m_hugePages);
+  if (!policyError.empty()) {
+    error() << policyError << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_map.configure(m_systemEncoding,
+                  [this](uint aSystem, NeighboursMap::Map& aMap) {
+                    return readSystem(aSystem, aMap);
+                  },
+                  m_lazyLoading, policy);
+  if (!m_load.start([this]() { return readMap(); }, m_asyncInitialize) && m_asyncInitialize) {
+    warning() << "ROOT thread safety is not enabled in the job options (ROOT.EnableThreadSafety()), "
+              << "the map is read serially" << endmsg;
+  }
+  return sc;
+}
+
+StatusCode TopoCaloNeighbours::start() {
+  StatusCode sc = GaudiTool::start();
+  if (sc.isFailure()) return sc;
+  if (m_load.wait().isFailure()) {
+    error() << "Unable to read the neighbours map from " << m_fileName.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!m_map.policy().isDefault()) {
+    info() << "Neighbours map " << m_map.policy().description() << ": " << m_map.copies()
+           << " copies of the systems read, " << MemoryUsage::kiloBytes(m_map.mappedBytes()) << " kB mapped" << endmsg;
+  }
+  if (m_map.hugePagesFallback()) {
+    warning() << "No explicit huge pages available (vm.nr_hugepages), transparent huge pages used instead" << endmsg;
+  }
+  return sc;
+}
+
+StatusCode TopoCaloNeighbours::readMap() {
   std::unique_ptr<TFile> file(TFile::Open(m_fileName.value().c_str(),"READ"));
+  if (file == nullptr || file->IsZombie()) {
+    error() << "Unable to open the file " << m_fileName.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  auto selected = [this](uint aSystem) {
+    return m_systems.empty() || std::find(m_systems.begin(), m_systems.end(), aSystem) != m_systems.end();
+  };
+  // one tree per system
+  const std::string prefix = "neighbours_system";
+  TIter nextKey(file->GetListOfKeys());
+  while (TKey* key = static_cast<TKey*>(nextKey())) {
+    std::string name = key->GetName();
+    if (name.size() == prefix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+        name.find_first_not_of("0123456789", prefix.size()) != std::string::npos) {
+      continue;
+    }
+    uint system = std::stoul(name.substr(prefix.size()));
+    if (selected(system)) m_map.addSystem(system);
+  }
+  if (!m_map.systems().empty()) {
+    // a missing system would only be found at its first lookup in the event loop
+    for (uint system : m_map.missingSystems(m_systems)) {
+      error() << "No tree of system " << system << " in the file " << m_fileName.value() << endmsg;
+      return StatusCode::FAILURE;
+    }
+    file->Close();
+    info() << "Neighbours map with " << m_map.systems().size() << " systems"
+           << (m_lazyLoading ? ", read at the first lookup" : "") << endmsg;
+    return m_lazyLoading ? StatusCode::SUCCESS : m_map.loadAll();
+  }
+  // single tree, read at once
+  auto insertPolicy = m_map.insertPolicy();
+  StatusCode sc = readTree(*file, "neighbours",
+                           [this, &selected](uint64_t aCellId, const std::vector<uint64_t>& aNeighbours) {
+                             uint system = m_map.system(aCellId);
+                             if (!selected(system)) return;
+                             m_map.addSystem(system);
+                             m_map.insert(aCellId, aNeighbours);
+                           });
+  file->Close();
+  insertPolicy.reset();
+  if (sc.isFailure()) return sc;
+  // as for the trees per system, a selected system has to be in the map
+  for (uint system : m_map.missingSystems(m_systems)) {
+    error() << "No cells of system " << system << " in the tree neighbours of the file " << m_fileName.value()
+            << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_map.markLoaded();
+  for (uint system : m_map.systems()) {
+    report(system, *m_map.partition(system));
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode TopoCaloNeighbours::readSystem(uint aSystem, NeighboursMap::Map& aMap) {
+  std::unique_ptr<TFile> file(TFile::Open(m_fileName.value().c_str(),"READ"));
+  if (file == nullptr || file->IsZombie()) {
+    error() << "Unable to open the file " << m_fileName.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  StatusCode sc = readTree(*file, "neighbours_system" + std::to_string(aSystem),
+                           [&aMap](uint64_t aCellId, const std::vector<uint64_t>& aNeighbours) {
+                             aMap.emplace(aCellId, aNeighbours);
+                           });
+  file->Close();
+  if (sc.isSuccess()) report(aSystem, aMap);
+  return sc;
+}
+
+StatusCode TopoCaloNeighbours::readTree(TFile& aFile, const std::string& aTreeName,
+                                        const std::function<void(uint64_t, const std::vector<uint64_t>&)>& aInsert) {
   TTree* tree = nullptr;
-  file->GetObject("neighbours",tree);
+  aFile.GetObject(aTreeName.c_str(), tree);
+  if (tree == nullptr) {
+    error() << "No tree " << aTreeName << " in the file " << m_fileName.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
   ULong64_t readCellId;
   std::vector<uint64_t>* readNeighbours = nullptr;
   tree->SetBranchAddress("cellId",&readCellId);
   tree->SetBranchAddress("neighbours",&readNeighbours);
   for (uint i = 0; i < tree->GetEntries(); i++) {
       tree->GetEntry(i);
-      m_map.insert(std::pair<uint64_t, std::vector<uint64_t>>(readCellId, *readNeighbours));
+      aInsert(readCellId, *readNeighbours);
   }
+  delete tree;
+  delete readNeighbours;
+  return StatusCode::SUCCESS;
+}
+
+void TopoCaloNeighbours::report(uint aSystem, const NeighboursMap::Map& aMap) {
   std::vector<int> counterL;
   counterL.assign(100,0);
-  for(const auto& item: m_map) {
-    counterL[item.second.size()] ++;
+  for(const auto& item: aMap) {
+    counterL[std::min<size_t>(item.second.size(), counterL.size() - 1)] ++;
   }
   for(uint iCount = 0; iCount < counterL.size(); iCount++) {
     if (counterL[iCount] != 0) {
-      info() << counterL[iCount] << " cells have " << iCount << " neighbours" << endmsg;
+      info() << "System " << aSystem << ": " << counterL[iCount] << " cells have " << iCount << " neighbours" << endmsg;
     }
   }
-  delete tree;
-  delete readNeighbours;
-  file->Close();
-  return sc;
+  double memory = MemoryUsage::kiloBytes(MemoryUsage::heapBytes(aMap));
+  m_memoryMap += memory;
+  info() << "Neighbours map of system " << aSystem << ": " << aMap.size() << " cells, " << memory << " kB" << endmsg;
 }
-
 StatusCode TopoCaloNeighbours::finalize() { return GaudiTool::finalize(); }
 
 std::vector<uint64_t>& TopoCaloNeighbours::neighbours(uint64_t aCellId) {
-  return m_map[aCellId];
+  std::vector<uint64_t>* cellNeighbours = m_map.find(aCellId);
+  if (cellNeighbours == nullptr) {
+    return calo_neighbours::noNeighbours();
+  }
+  return *cellNeighbours;
 }
@@ -7,6 +7,13 @@
 // FCCSW
 #include "k4Interface/ICaloReadNeighboursMap.h"
 
+#include "AsyncLoad.h"
+#include "MemoryUsage.h"
+#include "NoNeighbours.h"
+#include "SystemPartitionedMap.h"
+
+class TFile;
+
 class IGeoSvc;
 
 /** @class TopoCaloNeighbours Reconstruction/RecCalorimeter/src/components/TopoCaloNeighbours.h
@@ -14,6 +21,17 @@ class IGeoSvc;
  *
  *  Tool that reads a ROOT file containing the TTree with branch "cellId" and branch "neighbours".
  *  This tools reads the tree, creates a map, and allows a lookup of all neighbours of a cell.
+ *  With '\b asyncInitialize', the map is read asynchronously (see AsyncLoad), in parallel to the initialisation of the
+ *  other components, and is complete at start.
+ *
+ *  The map is partitioned by system ID (see SystemPartitionedMap). Files written per system contain one tree per
+ *  system, "neighbours_system<ID>": with '\b lazyLoading' (off by default) the tree of a system is read at the first
+ *  lookup of one of its cells, so that only the systems used by the job are held in memory; the first event then
+ *  pays the reading, and a tree that cannot be read is only reported by an empty lookup. '\b systems' restricts the
+ *  systems read, also for files with a single tree "neighbours", which are read at initialize; a requested system
+ *  without its tree is an error at initialize.
+ *  '\b tablePlacement' and '\b hugePages' place the map in the memory of multi-socket nodes (interleaved or replicated
+ *  per NUMA node, on huge pages, see LargeTableMemory.h).
  *
  *  @author Anna Zaborowska
  *  @author Coralie Neubueser
@@ -24,22 +42,62 @@ public:
   TopoCaloNeighbours(const std::string& type, const std::string& name, const IInterface* parent);
   virtual ~TopoCaloNeighbours() = default;
  
-  /** Read a map of cellIDs to vector of cellIDs (neighbours).
+  /** Read a map of cellIDs to vector of cellIDs (neighbours), or the list of systems in the file if lazy.
    */
   virtual StatusCode initialize() final;
+  /** Wait for the map to be read.
+   */
+  virtual StatusCode start() final;
   virtual StatusCode finalize() final;
   
   /** Function to be called for the neighbours of a cell.
+   *  The lookup can be done concurrently, also when it reads the tree of a system.
    *   @param[in] aCellId, cellid of the cell of interest.
-   *   @return vector of cellIDs, corresponding to the cells neighbours.
+   *   @return vector of cellIDs, corresponding to the cells neighbours, empty if the cell is not in the map (a vector
+   *   of the calling thread, see NoNeighbours.h).
    */
   virtual std::vector<uint64_t>& neighbours(uint64_t aCellId) final;
 
 private:
+  typedef SystemPartitionedMap<std::vector<uint64_t>> NeighboursMap;
+  /// Read the map, or the list of systems, from the file
+  StatusCode readMap();
+  /// Read the tree of one system
+  StatusCode readSystem(uint aSystem, NeighboursMap::Map& aMap);
+  /// Read a tree of the file, the cells are passed to aInsert
+  StatusCode readTree(TFile& aFile, const std::string& aTreeName,
+                      const std::function<void(uint64_t, const std::vector<uint64_t>&)>& aInsert);
+  /// Print the number of neighbours and the memory of the map of a system
+  void report(uint aSystem, const NeighboursMap::Map& aMap);
   /// Name of input root file that contains the TTree with cellID->vec<neighboursCellID>
   Gaudi::Property<std::string> m_fileName{this, "fileName", "neighbours_map.root"};
+  /// Read the map asynchronously
+  Gaudi::Property<bool> m_asyncInitialize{this, "asyncInitialize", false,
+                                          "Read the map asynchronously, joined before the first event"};
+  /// Systems to be read, all systems of the file if empty
+  Gaudi::Property<std::vector<uint>> m_systems{this, "systems", {}, "Systems to be read, all if empty"};
+  /// Read the tree of a system at the first lookup
+  Gaudi::Property<bool> m_lazyLoading{this, "lazyLoading", false,
+                                      "Read the tree of a system at the first lookup of one of its cells"};
+  /// Placement of the map over the NUMA nodes
+  Gaudi::Property<std::string> m_tablePlacement{this, "tablePlacement", "default",
+                                                "Placement of the map: default, interleave, replicate (per NUMA node)"};
+  /// Page size of the map
+  Gaudi::Property<std::string> m_hugePages{this, "hugePages", "none",
+                                           "Huge pages for the map: none, transparent, explicit (vm.nr_hugepages)"};
+  /// Encoding of the system in the cell IDs
+  Gaudi::Property<std::string> m_systemEncoding{this, "systemEncoding", "system:4",
+                                                "Encoding of the field system in the cell IDs"};
   /// Output map to be used for the fast lookup in the topo-clusering algorithm
-  std::unordered_map<uint64_t, std::vector<uint64_t>> m_map;
+  NeighboursMap m_map;
+  /// Estimated memory of the map, one entry per system read
+  MemoryUsage::Counter m_memoryMap{this, "Memory neighbours map [kB]"};
+  /// Time to read the map
+  StageTimer::Counter m_timeLoad{this, "Time load [us]"};
+  /// Time spent waiting for the map
+  StageTimer::Counter m_timeWait{this, "Time wait for load [us]"};
+  /// Reading of the map
+  AsyncLoad m_load{m_timeLoad, m_timeWait};
 };
 
 #endif /* RECCALORIMETER_TOPOCALONEIGHBOURS_H */
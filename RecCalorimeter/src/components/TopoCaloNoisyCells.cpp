@@ -2,8 +2,12 @@
 
 #include "TBranch.h"
 #include "TFile.h"
+#include "TKey.h"
 #include "TTree.h"
 
+#include <algorithm>
+#include <fstream>
+
 DECLARE_COMPONENT(TopoCaloNoisyCells)
 
 TopoCaloNoisyCells::TopoCaloNoisyCells(const std::string& type, const std::string& name, const IInterface* parent)
@@ -14,9 +18,160 @@ TopoCaloNoisyCells::TopoCaloNoisyCells(const std::string& type, const std::strin
 StatusCode TopoCaloNoisyCells::initialize() {
   StatusCode sc = GaudiTool::initialize();
   if (sc.isFailure()) return sc;
+  large_table::Policy policy;
+  std::string policyError = policy.parse(m_tablePlacement, m_hugePages);
+  if (!policyError.empty()) {
+    error() << policyError << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_map.configure(m_systemEncoding,
+                  [this](uint aSystem, NoiseMap::Map& aMap) {
+                    return readSystem(aSystem, aMap);
+                  },
+                  m_lazyLoading, policy);
+  if (!m_load.start([this]() { return readMap(); }, m_asyncInitialize) && m_asyncInitialize) {
+    warning() << "ROOT thread safety is not enabled in the job options (ROOT.EnableThreadSafety()), "
+              << "the map is read serially" << endmsg;
+  }
+  return sc;
+}
+
+StatusCode TopoCaloNoisyCells::start() {
+  StatusCode sc = GaudiTool::start();
+  if (sc.isFailure()) return sc;
+  if (m_load.wait().isFailure()) {
+    error() << "Unable to read the noise map from " << m_fileName.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!m_map.policy().isDefault()) {
+    info() << "Noise map " << m_map.policy().description() << ": " << m_map.copies()
+           << " copies of the systems read, " << MemoryUsage::kiloBytes(m_map.mappedBytes()) << " kB mapped" << endmsg;
+  }
+  if (m_map.hugePagesFallback()) {
+    warning() << "No explicit huge pages available (vm.nr_hugepages), transparent huge pages used instead" << endmsg;
+  }
+  return sc;
+}
+
+bool TopoCaloNoisyCells::binaryTable() const {
+  const std::string extension = ".bin";
+  const std::string& name = m_fileName.value();
+  return name.size() > extension.size() &&
+         name.compare(name.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+StatusCode TopoCaloNoisyCells::readMap() {
+  auto selected = [this](uint aSystem) {
+    return m_systems.empty() || std::find(m_systems.begin(), m_systems.end(), aSystem) != m_systems.end();
+  };
+  if (binaryTable()) {
+    std::ifstream table(m_fileName.value(), std::ios::binary);
+    std::string err = table ? calo_noise::readHeader(table, m_tableSystems) : "cannot open the file";
+    if (!err.empty()) {
+      error() << "Unable to read the noise table " << m_fileName.value() << ": " << err << endmsg;
+      return StatusCode::FAILURE;
+    }
+    for (const auto& system : m_tableSystems) {
+      if (selected(system.system)) m_map.addSystem(system.system);
+    }
+    // a missing system would only be found at its first lookup in the event loop
+    for (uint system : m_map.missingSystems(m_systems)) {
+      error() << "No entry of system " << system << " in the file " << m_fileName.value() << endmsg;
+      return StatusCode::FAILURE;
+    }
+    info() << "Noise table with " << m_map.systems().size() << " systems"
+           << (m_lazyLoading ? ", read at the first lookup" : "") << endmsg;
+    return m_lazyLoading ? StatusCode::SUCCESS : m_map.loadAll();
+  }
+  std::unique_ptr<TFile> file(TFile::Open(m_fileName.value().c_str(), "READ"));
+  if (file == nullptr || file->IsZombie()) {
+    error() << "Unable to open the file " << m_fileName.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  // one tree per system
+  const std::string prefix = "noisyCells_system";
+  TIter nextKey(file->GetListOfKeys());
+  while (TKey* key = static_cast<TKey*>(nextKey())) {
+    std::string name = key->GetName();
+    if (name.size() == prefix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+        name.find_first_not_of("0123456789", prefix.size()) != std::string::npos) {
+      continue;
+    }
+    uint system = std::stoul(name.substr(prefix.size()));
+    if (selected(system)) m_map.addSystem(system);
+  }
+  if (!m_map.systems().empty()) {
+    // a missing system would only be found at its first lookup in the event loop
+    for (uint system : m_map.missingSystems(m_systems)) {
+      error() << "No tree of system " << system << " in the file " << m_fileName.value() << endmsg;
+      return StatusCode::FAILURE;
+    }
+    file->Close();
+    info() << "Noise map with " << m_map.systems().size() << " systems"
+           << (m_lazyLoading ? ", read at the first lookup" : "") << endmsg;
+    return m_lazyLoading ? StatusCode::SUCCESS : m_map.loadAll();
+  }
+  // single tree, read at once
+  StatusCode sc = readTree(*file, "noisyCells",
+                           [this, &selected](uint64_t aCellId, const std::pair<double, double>& aNoise) {
+                             uint system = m_map.system(aCellId);
+                             if (!selected(system)) return;
+                             m_map.addSystem(system);
+                             m_map.insert(aCellId, aNoise);
+                           });
+  file->Close();
+  if (sc.isFailure()) return sc;
+  // as for the trees per system, a selected system has to be in the map
+  for (uint system : m_map.missingSystems(m_systems)) {
+    error() << "No cells of system " << system << " in the tree noisyCells of the file " << m_fileName.value()
+            << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_map.markLoaded();
+  for (uint system : m_map.systems()) {
+    report(system, *m_map.partition(system));
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode TopoCaloNoisyCells::readSystem(uint aSystem, NoiseMap::Map& aMap) {
+  if (binaryTable()) {
+    auto entry = std::find_if(m_tableSystems.begin(), m_tableSystems.end(),
+                              [aSystem](const calo_noise::SystemEntry& aEntry) { return aEntry.system == aSystem; });
+    std::ifstream table(m_fileName.value(), std::ios::binary);
+    aMap.reserve(entry->numCells);
+    if (!table || !calo_noise::readSystem(table, *entry, [&aMap](uint64_t aCellId, float aNoise, float aOffset) {
+          aMap.emplace(aCellId, std::make_pair(aNoise, aOffset));
+        })) {
+      error() << "Unable to read system " << aSystem << " from the noise table " << m_fileName.value() << endmsg;
+      return StatusCode::FAILURE;
+    }
+    report(aSystem, aMap);
+    return StatusCode::SUCCESS;
+  }
   std::unique_ptr<TFile> file(TFile::Open(m_fileName.value().c_str(), "READ"));
+  if (file == nullptr || file->IsZombie()) {
+    error() << "Unable to open the file " << m_fileName.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  StatusCode sc = readTree(*file, "noisyCells_system" + std::to_string(aSystem),
+                           [&aMap](uint64_t aCellId, const std::pair<double, double>& aNoise) {
+                             aMap.emplace(aCellId, aNoise);
+                           });
+  file->Close();
+  if (sc.isSuccess()) report(aSystem, aMap);
+  return sc;
+}
+
+StatusCode TopoCaloNoisyCells::readTree(
+    TFile& aFile, const std::string& aTreeName,
+    const std::function<void(uint64_t, const std::pair<double, double>&)>& aInsert) {
   TTree* tree = nullptr;
-  file->GetObject("noisyCells", tree);
+  aFile.GetObject(aTreeName.c_str(), tree);
+  if (tree == nullptr) {
+    error() << "No tree " << aTreeName << " in the file " << m_fileName.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
   ULong64_t readCellId;
   double readNoisyCells;
   double readNoisyCellsOffset;
@@ -25,14 +180,26 @@ StatusCode TopoCaloNoisyCells::initialize() {
   tree->SetBranchAddress("noiseOffset", &readNoisyCellsOffset);
   for (uint i = 0; i < tree->GetEntries(); i++) {
     tree->GetEntry(i);
-    m_map.insert(std::pair<uint64_t, std::pair<double, double>>(readCellId, std::make_pair(readNoisyCells, readNoisyCellsOffset)));
+    aInsert(readCellId, std::make_pair(readNoisyCells, readNoisyCellsOffset));
   }
   delete tree;
-  file->Close();
-  return sc;
+  return StatusCode::SUCCESS;
+}
+
+void TopoCaloNoisyCells::report(uint aSystem, const NoiseMap::Map& aMap) {
+  double memory = MemoryUsage::kiloBytes(MemoryUsage::heapBytes(aMap));
+  m_memoryMap += memory;
+  info() << "Noise map of system " << aSystem << ": " << aMap.size() << " cells, " << memory << " kB" << endmsg;
 }
 
 StatusCode TopoCaloNoisyCells::finalize() { return GaudiTool::finalize(); }
 
-double TopoCaloNoisyCells::noiseRMS(uint64_t aCellId) { return m_map[aCellId].first; }
-double TopoCaloNoisyCells::noiseOffset(uint64_t aCellId) { return m_map[aCellId].second; }
+double TopoCaloNoisyCells::noiseRMS(uint64_t aCellId) {
+  const std::pair<double, double>* noise = m_map.find(aCellId);
+  return noise == nullptr ? 0. : noise->first;
+}
+
+double TopoCaloNoisyCells::noiseOffset(uint64_t aCellId) {
+  const std::pair<double, double>* noise = m_map.find(aCellId);
+  return noise == nullptr ? 0. : noise->second;
+}
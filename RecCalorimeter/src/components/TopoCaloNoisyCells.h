@@ -7,6 +7,13 @@
 // FCCSW
 #include "k4Interface/ICaloReadCellNoiseMap.h"
 
+#include "AsyncLoad.h"
+#include "CaloNoiseTableFormat.h"
+#include "MemoryUsage.h"
+#include "SystemPartitionedMap.h"
+
+class TFile;
+
 class IGeoSvc;
 
 /** @class TopoCaloNoisyCells Reconstruction/RecCalorimeter/src/components/TopoCaloNoisyCells.h
@@ -14,6 +21,15 @@ class IGeoSvc;
  *
  *  Tool that reads a ROOT file containing the TTree with branchs "cellId", "noiseLevel", and "noiseOffset".
  *  This tool reads the tree, creates a map, and allows a lookup of noise level and mean noise of a cell, by its cellID.
+ *  With '\b asyncInitialize', the map is read asynchronously (see AsyncLoad), in parallel to the initialisation of the
+ *  other components, and is complete at start.
+ *
+ *  The map is partitioned by system ID as in TopoCaloNeighbours: files with one tree per system,
+ *  "noisyCells_system<ID>", are read per system at the first lookup with '\b lazyLoading' (off by default), and
+ *  '\b systems' restricts the systems read; a requested system without its tree is an error at initialize.
+ *  A file with the extension ".bin" is read as a binary noise table (see CaloNoiseTableFormat.h), with the same
+ *  partitioning by system.
+ *  The memory of the map is placed as in TopoCaloNeighbours, with '\b tablePlacement' and '\b hugePages'.
  *
  *  @author Coralie Neubueser
  */
@@ -26,25 +42,68 @@ public:
    * return StatusCode
    */
   virtual StatusCode initialize() final;
+  /** Wait for the map to be read.
+   */
+  virtual StatusCode start() final;
   virtual StatusCode finalize() final;
  
   /** Expected noise per cell in terms of sigma of Gaussian distibution.
+   *  The lookup can be done concurrently, also when it reads the tree of a system.
    *   @param[in] aCellId of the cell of interest.
-   *   return double.
+   *   return double, 0 if the cell is not in the map.
    */
   virtual double noiseRMS(uint64_t aCellId) final;
   
   /** Expected noise per cell in terms of mean of distibution.
    *   @param[in] aCellId of the cell of interest.
-   *   return double.
+   *   return double, 0 if the cell is not in the map.
    */ 
   virtual double noiseOffset(uint64_t aCellId) final;
 
 private:
+  typedef SystemPartitionedMap<std::pair<double, double>> NoiseMap;
+  /// Whether the file is a binary noise table
+  bool binaryTable() const;
+  /// Read the map, or the list of systems, from the file
+  StatusCode readMap();
+  /// Read the tree of one system
+  StatusCode readSystem(uint aSystem, NoiseMap::Map& aMap);
+  /// Read a tree of the file, the cells are passed to aInsert
+  StatusCode readTree(TFile& aFile, const std::string& aTreeName,
+                      const std::function<void(uint64_t, const std::pair<double, double>&)>& aInsert);
+  /// Print the memory of the map of a system
+  void report(uint aSystem, const NoiseMap::Map& aMap);
   /// Name
   Gaudi::Property<std::string> m_fileName{this, "fileName",
                                           "/afs/cern.ch/user/c/cneubuse/public/FCChh/cellNoise_map_segHcal.root"};
-  std::unordered_map<uint64_t, std::pair<double,double>> m_map;
+  /// Read the map asynchronously
+  Gaudi::Property<bool> m_asyncInitialize{this, "asyncInitialize", false,
+                                          "Read the map asynchronously, joined before the first event"};
+  /// Systems to be read, all systems of the file if empty
+  Gaudi::Property<std::vector<uint>> m_systems{this, "systems", {}, "Systems to be read, all if empty"};
+  /// Read the tree of a system at the first lookup
+  Gaudi::Property<bool> m_lazyLoading{this, "lazyLoading", false,
+                                      "Read the tree of a system at the first lookup of one of its cells"};
+  /// Placement of the map over the NUMA nodes
+  Gaudi::Property<std::string> m_tablePlacement{this, "tablePlacement", "default",
+                                                "Placement of the map: default, interleave, replicate (per NUMA node)"};
+  /// Page size of the map
+  Gaudi::Property<std::string> m_hugePages{this, "hugePages", "none",
+                                           "Huge pages for the map: none, transparent, explicit (vm.nr_hugepages)"};
+  /// Encoding of the system in the cell IDs
+  Gaudi::Property<std::string> m_systemEncoding{this, "systemEncoding", "system:4",
+                                                "Encoding of the field system in the cell IDs"};
+  NoiseMap m_map;
+  /// Systems of a binary noise table
+  std::vector<calo_noise::SystemEntry> m_tableSystems;
+  /// Estimated memory of the map, one entry per system read
+  MemoryUsage::Counter m_memoryMap{this, "Memory noise map [kB]"};
+  /// Time to read the map
+  StageTimer::Counter m_timeLoad{this, "Time load [us]"};
+  /// Time spent waiting for the map
+  StageTimer::Counter m_timeWait{this, "Time wait for load [us]"};
+  /// Reading of the map
+  AsyncLoad m_load{m_timeLoad, m_timeWait};
 };
 
 #endif /* RECCALORIMETER_TOPOCALONOISYCELLS_H */
@@ -0,0 +1,216 @@
+#include "TopoClusterBuilder.h"
+
+#include "MemoryUsage.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+TopoClusterBuilder::TopoClusterBuilder(const std::map<uint64_t, double>& aCells,
+                                       ICaloReadNeighboursMap* aNeighboursTool, ICaloReadCellNoiseMap* aNoiseTool,
+                                       const std::vector<Thresholds>& aConfigs)
+    : m_cells(aCells), m_neighboursTool(aNeighboursTool), m_noiseTool(aNoiseTool) {
+  for (const auto& thresholds : aConfigs) {
+    Config config;
+    config.thresholds = thresholds;
+    m_configs.push_back(std::move(config));
+    m_levels.insert(m_levels.end(), {thresholds.seedSigma, thresholds.neighbourSigma, thresholds.lastNeighbourSigma,
+                                     thresholds.budgetNeighbourSigma});
+  }
+  std::sort(m_levels.begin(), m_levels.end());
+  m_levels.erase(std::unique(m_levels.begin(), m_levels.end()), m_levels.end());
+  if (m_levels.size() > kMaxThresholds) {
+    throw std::length_error("TopoClusterBuilder: more than 64 distinct thresholds");
+  }
+}
+
+bool TopoClusterBuilder::passes(uint64_t aCellId, int aNumSigma) const {
+  size_t level = std::lower_bound(m_levels.begin(), m_levels.end(), aNumSigma) - m_levels.begin();
+  return (m_classes.at(aCellId) >> level) & 1;
+}
+
+const std::vector<uint64_t>& TopoClusterBuilder::neighbours(uint64_t aCellId) {
+  auto it = m_neighbours.find(aCellId);
+  if (it == m_neighbours.end()) {
+    it = m_neighbours.emplace(aCellId, &m_neighboursTool->neighbours(aCellId)).first;
+  }
+  return *(it->second);
+}
+
+const TopoClusterBuilder::Seeds& TopoClusterBuilder::findingSeeds() {
+  if (m_seedsFound) return m_seeds;
+  m_seedsFound = true;
+  uint64_t seedLevels = 0;
+  for (const auto& config : m_configs) {
+    seedLevels |= uint64_t(1) << (std::lower_bound(m_levels.begin(), m_levels.end(), config.thresholds.seedSigma) -
+                                  m_levels.begin());
+  }
+  m_classes.reserve(m_cells.size());
+  for (const auto& cell : m_cells) {
+    // noise read once per cell, compared to all thresholds
+    double offset = m_noiseTool->noiseOffset(cell.first);
+    double rms = m_noiseTool->noiseRMS(cell.first);
+    uint64_t classes = 0;
+    for (size_t level = 0; level < m_levels.size(); level++) {
+      if (std::fabs(cell.second) > offset + (rms * m_levels[level])) classes |= uint64_t(1) << level;
+    }
+    m_classes.emplace(cell.first, classes);
+    if (classes & seedLevels) m_seeds.emplace_back(cell.first, cell.second);
+  }
+  // same ordering as in CaloTopoCluster, the seeds of a configuration keep their order in the seeds of all of them
+  std::sort(m_seeds.begin(), m_seeds.end(),
+            [](const std::pair<uint64_t, double>& lhs, const std::pair<uint64_t, double>& rhs) {
+              return lhs.second < rhs.second || (lhs.second == rhs.second && lhs.first < rhs.first);
+            });
+  for (auto& config : m_configs) {
+    config.stats.seeds = std::count_if(m_seeds.begin(), m_seeds.end(), [this, &config](const auto& seed) {
+      return passes(seed.first, config.thresholds.seedSigma);
+    });
+  }
+  return m_seeds;
+}
+
+bool TopoClusterBuilder::buildingProtoClusters(std::vector<PreClusterCollection>& aPreClusterCollections,
+                                               const std::vector<EventBudget*>& aBudgets) {
+  findingSeeds();
+  aPreClusterCollections.resize(m_configs.size());
+  for (const auto& seed : m_seeds) {
+    for (size_t iConfig = 0; iConfig < m_configs.size(); iConfig++) {
+      Config& config = m_configs[iConfig];
+      if (config.stopped || !passes(seed.first, config.thresholds.seedSigma)) continue;
+      EventBudget* budget = iConfig < aBudgets.size() ? aBudgets[iConfig] : nullptr;
+      if (!growCluster(config, seed.first, aPreClusterCollections[iConfig], budget)) {
+        config.stopped = true;
+      }
+    }
+  }
+  bool complete = true;
+  for (size_t iConfig = 0; iConfig < m_configs.size(); iConfig++) {
+    Config& config = m_configs[iConfig];
+    config.stats.memoryBytes =
+        MemoryUsage::heapBytes(config.clusterOfCell) + MemoryUsage::heapBytes(aPreClusterCollections[iConfig]) +
+        MemoryUsage::heapBytes(config.currentNeighbours) + MemoryUsage::heapBytes(config.nextNeighbours);
+    complete = complete && !config.stopped;
+  }
+  return complete;
+}
+
+bool TopoClusterBuilder::growCluster(Config& aConfig, uint64_t aSeedId, PreClusterCollection& aPreClusterCollection,
+                                     EventBudget* aBudget) {
+  const Thresholds& thresholds = aConfig.thresholds;
+  // once the event is over budget, the clusters grow only with cells above the budget threshold
+  auto numSigma = [&]() {
+    return aBudget == nullptr || aBudget->withinEvent() ? thresholds.neighbourSigma : thresholds.budgetNeighbourSigma;
+  };
+  uint iSeeds = ++aConfig.numSeeds;
+  if (aConfig.clusterOfCell.find(aSeedId) != aConfig.clusterOfCell.end()) {
+    // seed is already assigned to another cluster
+    return true;
+  }
+  // new cluster starts with seed, cell type 1
+  aPreClusterCollection[iSeeds].push_back(std::make_pair(aSeedId, 1));
+  uint clusterId = iSeeds;
+  aConfig.clusterOfCell[aSeedId] = clusterId;
+
+  auto& currentNeighbours = aConfig.currentNeighbours;
+  auto& nextNeighbours = aConfig.nextNeighbours;
+  currentNeighbours.clear();
+  searchForNeighbours(aSeedId, clusterId, numSigma(), thresholds.lastNeighbourSigma, aConfig.clusterOfCell,
+                      aPreClusterCollection, true, currentNeighbours);
+  aConfig.stats.lookups++;
+  if (aBudget != nullptr) aBudget->lookup();
+  // the cluster ID changes when the cluster is merged into another one
+  if (clusterId != iSeeds) aConfig.stats.merges++;
+  // the cluster stops growing when it reaches the maximal size
+  bool clusterComplete = true;
+  // the found neighbours are the next seeds, until no more neighbours are found
+  while (currentNeighbours.size() > 0 && clusterComplete) {
+    nextNeighbours.clear();
+    for (const auto& id : currentNeighbours) {
+      if (id.first == 0) {
+        // stop building, a cell has no entry in the neighbours map
+        return false;
+      }
+      uint previousClusterId = clusterId;
+      searchForNeighbours(id.first, clusterId, numSigma(), thresholds.lastNeighbourSigma, aConfig.clusterOfCell,
+                          aPreClusterCollection, true, nextNeighbours);
+      aConfig.stats.lookups++;
+      if (clusterId != previousClusterId) aConfig.stats.merges++;
+      if (aBudget != nullptr) {
+        aBudget->lookup();
+        if (!aBudget->clusterWithin(aPreClusterCollection[clusterId].size())) {
+          clusterComplete = false;
+          break;
+        }
+      }
+    }
+    std::swap(currentNeighbours, nextNeighbours);
+  }
+  // last try with different condition on neighbours, skipped if the cluster or the event is over budget
+  if (clusterComplete && (aBudget == nullptr || aBudget->withinEvent())) {
+    auto clusteredCells = aPreClusterCollection[clusterId];
+    std::vector<std::pair<uint64_t, uint>> lastNeighbours;
+    for (const auto& id : clusteredCells) {
+      if (id.second <= 2) {
+        searchForNeighbours(id.first, clusterId, thresholds.lastNeighbourSigma, thresholds.lastNeighbourSigma,
+                            aConfig.clusterOfCell, aPreClusterCollection, false, lastNeighbours);
+        aConfig.stats.lookups++;
+        if (aBudget != nullptr) aBudget->lookup();
+      }
+    }
+  }
+  return true;
+}
+
+void TopoClusterBuilder::searchForNeighbours(const uint64_t aCellId, uint& aClusterID, int aNumSigma,
+                                             int aLastNumSigma, std::unordered_map<uint64_t, uint>& aClusterOfCell,
+                                             PreClusterCollection& aPreClusterCollection, bool aAllowClusterMerge,
+                                             std::vector<std::pair<uint64_t, uint>>& aAddedNeighbours) {
+  // next cell ids and cluster id for which neighbours are found are appended to aAddedNeighbours
+  const auto& neighboursVec = neighbours(aCellId);
+  if (neighboursVec.size() == 0) {
+    m_missingNeighboursCell = aCellId;
+    aAddedNeighbours.push_back(std::make_pair(0, 0));
+    return;
+  }
+  for (const auto& neighbourID : neighboursVec) {
+    // Find the neighbour in the Calo cells list
+    auto itAllCells = m_cells.find(neighbourID);
+    auto itAllUsedCells = aClusterOfCell.find(neighbourID);
+
+    // If cell is hit.. and is not assigned to a cluster
+    if (itAllCells != m_cells.end() && itAllUsedCells == aClusterOfCell.end()) {
+      // if threshold is 0, collect the cell independent on its energy
+      bool addNeighbour = (aNumSigma == 0) || passes(neighbourID, aNumSigma);
+      // give cell type according to threshold
+      int cellType = (aNumSigma == aLastNumSigma) ? 3 : 2;
+      if (addNeighbour) {
+        aPreClusterCollection[aClusterID].push_back(std::make_pair(neighbourID, cellType));
+        aClusterOfCell[neighbourID] = aClusterID;
+        aAddedNeighbours.push_back(std::make_pair(neighbourID, aClusterID));
+      }
+    }
+    // If cell is hit.. but is assigned to another cluster
+    else if (itAllUsedCells != aClusterOfCell.end() && itAllUsedCells->second != aClusterID && aAllowClusterMerge) {
+      uint clusterIDToMerge = itAllUsedCells->second;
+      // Fill all cells into cluster, and assigned cells to new cluster
+      aClusterOfCell[neighbourID] = clusterIDToMerge;
+      auto& cellsToMerge = aPreClusterCollection[clusterIDToMerge];
+      for (const auto& i : aPreClusterCollection.find(aClusterID)->second) {
+        aClusterOfCell[i.first] = clusterIDToMerge;
+        // make sure that already assigned cells are not added
+        bool found = std::any_of(cellsToMerge.begin(), cellsToMerge.end(),
+                                 [&i](const std::pair<uint64_t, int>& j) { return j.first == i.first; });
+        if (!found) {
+          cellsToMerge.push_back(i);
+        }
+      }
+      aPreClusterCollection.erase(aClusterID);
+      // changed clusterId -> if more neighbours are found, correct assignment
+      aClusterID = clusterIDToMerge;
+      aAddedNeighbours.push_back(std::make_pair(neighbourID, aClusterID));
+      // end loop to ensure correct cluster assignment
+      break;
+    }
+  }
+}
@@ -0,0 +1,226 @@
+#ifndef RECCALORIMETER_TOPOCLUSTERBUILDER_H
+#define RECCALORIMETER_TOPOCLUSTERBUILDER_H
+
+// FCCSW
+#include "k4Interface/ICaloReadCellNoiseMap.h"
+#include "k4Interface/ICaloReadNeighboursMap.h"
+
+// EDM4HEP
+#include "edm4hep/CalorimeterHitCollection.h"
+#include "edm4hep/ClusterCollection.h"
+
+#include "ClusterMomentsAccumulator.h"
+#include "EventBudget.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/** @class TopoClusterBuilder Reconstruction/RecCalorimeter/src/components/TopoClusterBuilder.h
+ *
+ *  Topological clustering of the cells of one event (see CaloTopoCluster.h for the algorithm), shared by
+ *  CaloTopoCluster, CaloTopoClusterMultiThreshold and CreateCaloTopoClustersFromHits.
+ *
+ *  The builder is created with one or several threshold configurations. Each cell is classified once: its noise is
+ *  read once from the tool and compared once to all thresholds of all configurations, the result is kept as one bit
+ *  per threshold. The neighbours of a cell are read once from the tool and cached (the cached vectors point to the
+ *  storage of the neighbours tool).
+ *
+ *  The proto-clusters of all configurations are built in one traversal (buildingProtoClusters): the seeds of all
+ *  configurations are visited once, sorted by energy as in CaloTopoCluster (ties by cellID), and each seed grows the
+ *  cluster of every configuration it is a seed of, with the thresholds of that configuration. The seeds of a
+ *  configuration are visited in the same order as if it were alone, so each configuration gives exactly the
+ *  proto-clusters of a builder with only this configuration.
+ *
+ *  Optional per-event budget of each configuration (see EventBudget.h): once the lookups or the time of the event
+ *  exceed their limit, the neighbour threshold is raised to budgetNeighbourSigma and the last round with
+ *  lastNeighbourSigma is skipped for the rest of the event; a cluster reaching the maximal size stops growing.
+ *  The time budget counts the time of all configurations.
+ *
+ *  writeClusters evaluates the proto-clusters in two phases: the energy and size of each proto-cluster first, then
+ *  the position, shape and cells only for the clusters passing one of the thresholds of full evaluation. The others
+ *  are written as summaries (energy, seed position, number of cells).
+ */
+
+class TopoClusterBuilder {
+public:
+  /// Proto-clusters: clusterID pointing to the associated cells, in a pair of cellID and cellType
+  typedef std::map<uint, std::vector<std::pair<uint64_t, int>>> PreClusterCollection;
+  /// Seeds: cellID and energy, sorted
+  typedef std::vector<std::pair<uint64_t, double>> Seeds;
+  /// Maximal number of distinct thresholds of all configurations (one bit per threshold and cell)
+  static constexpr size_t kMaxThresholds = 64;
+
+  /// Thresholds of one configuration, in number of sigma of the noise
+  struct Thresholds {
+    int seedSigma;
+    int neighbourSigma;
+    int lastNeighbourSigma;
+    /// Neighbour threshold for the rest of an event over budget
+    int budgetNeighbourSigma;
+  };
+
+  /// Work done to build the proto-clusters of one configuration
+  struct Stats {
+    /// Number of seeds
+    unsigned long seeds = 0;
+    /// Number of neighbour searches
+    unsigned long lookups = 0;
+    /// Number of cluster merges
+    unsigned long merges = 0;
+    /// Memory of the proto-clusters: cluster of each cell, proto-clusters and next neighbours
+    size_t memoryBytes = 0;
+  };
+
+  /** Constructor.
+   *   @param[in] aCells, map of all cells of the event (cellID -> energy), has to outlive the builder.
+   *   @param[in] aNeighboursTool, tool to retrieve the cell neighbours.
+   *   @param[in] aNoiseTool, tool to retrieve the cell noise.
+   *   @param[in] aConfigs, threshold configurations, throws std::length_error above kMaxThresholds thresholds.
+   */
+  TopoClusterBuilder(const std::map<uint64_t, double>& aCells, ICaloReadNeighboursMap* aNeighboursTool,
+                     ICaloReadCellNoiseMap* aNoiseTool, const std::vector<Thresholds>& aConfigs);
+
+  /** Classify all cells and find the seeds of all configurations, done once.
+   *   return seeds of all configurations, sorted by energy.
+   */
+  const Seeds& findingSeeds();
+
+  /** Build the proto-clusters of all configurations in one traversal of the seeds (found first if not done yet).
+   *   @param[out] aPreClusterCollections, proto-clusters, one collection per configuration.
+   *   @param[in] aBudgets, budget of each configuration (nullptr or empty for no limit).
+   *   return false if a cell without neighbours was found, the building of its configurations is then stopped (see
+   *   missingNeighboursCell).
+   */
+  bool buildingProtoClusters(std::vector<PreClusterCollection>& aPreClusterCollections,
+                             const std::vector<EventBudget*>& aBudgets = {});
+
+  /** Write the proto-clusters of a configuration, with their cells.
+   *   @param[in] aPreClusterCollection, proto-clusters.
+   *   @param[in] aPosition, position of a cell: dd4hep::Position (const) aPosition(uint64_t).
+   *   @param[in] aMinEnergyFull, energy above which a cluster is fully evaluated (disabled if <= 0).
+   *   @param[in] aMinCellsFull, number of cells above which a cluster is fully evaluated (disabled if <= 0).
+   *   @param[out] aClusters, fully evaluated clusters.
+   *   @param[out] aClusterCells, cells of the fully evaluated clusters.
+   *   @param[out] aSummaries, summaries of the other clusters.
+   *   return total energy of the clusters.
+   */
+  template <typename POSITION>
+  double writeClusters(const PreClusterCollection& aPreClusterCollection, POSITION&& aPosition,
+                       double aMinEnergyFull, int aMinCellsFull, edm4hep::ClusterCollection& aClusters,
+                       edm4hep::CalorimeterHitCollection& aClusterCells, edm4hep::ClusterCollection& aSummaries);
+
+  /// Work done for a configuration
+  const Stats& stats(size_t aConfig) const { return m_configs[aConfig].stats; }
+  /// CellID of the last cell for which no neighbours were found (0 if none)
+  uint64_t missingNeighboursCell() const { return m_missingNeighboursCell; }
+  /// Number of neighbour lookups done with the tool
+  size_t numNeighbourLookups() const { return m_neighbours.size(); }
+  /// Number of noise lookups done with the tool
+  size_t numNoiseLookups() const { return m_classes.size(); }
+
+private:
+  /// State of the building of one configuration
+  struct Config {
+    Thresholds thresholds;
+    /// Cluster of each clustered cell
+    std::unordered_map<uint64_t, uint> clusterOfCell;
+    /// Neighbours found in the current and in the previous iteration
+    std::vector<std::pair<uint64_t, uint>> currentNeighbours;
+    std::vector<std::pair<uint64_t, uint>> nextNeighbours;
+    /// Number of seeds of the configuration visited, ID of the next cluster
+    uint numSeeds = 0;
+    /// Building stopped on a cell without neighbours
+    bool stopped = false;
+    Stats stats;
+  };
+  /// Whether the cell exceeds the threshold of aNumSigma
+  bool passes(uint64_t aCellId, int aNumSigma) const;
+  /// Neighbours of the cell, cached
+  const std::vector<uint64_t>& neighbours(uint64_t aCellId);
+  /// Grow the cluster of a seed for one configuration, false if a cell has no neighbours
+  bool growCluster(Config& aConfig, uint64_t aSeedId, PreClusterCollection& aPreClusterCollection,
+                   EventBudget* aBudget);
+  /// Search for neighbours and add them to the proto-clusters, see CaloTopoCluster.h
+  void searchForNeighbours(const uint64_t aCellId, uint& aClusterID, int aNumSigma, int aLastNumSigma,
+                           std::unordered_map<uint64_t, uint>& aClusterOfCell,
+                           PreClusterCollection& aPreClusterCollection, bool aAllowClusterMerge,
+                           std::vector<std::pair<uint64_t, uint>>& aAddedNeighbours);
+
+  /// All cells of the event
+  const std::map<uint64_t, double>& m_cells;
+  /// Neighbours tool
+  ICaloReadNeighboursMap* m_neighboursTool;
+  /// Noise tool
+  ICaloReadCellNoiseMap* m_noiseTool;
+  /// Configurations
+  std::vector<Config> m_configs;
+  /// Distinct thresholds of all configurations, in sigma, one bit each in the classes of the cells
+  std::vector<int> m_levels;
+  /// Bits of the thresholds exceeded by each cell
+  std::unordered_map<uint64_t, uint64_t> m_classes;
+  /// Seeds of all configurations
+  Seeds m_seeds;
+  /// Whether the cells are classified and the seeds found
+  bool m_seedsFound = false;
+  /// Cached neighbours per cell
+  std::unordered_map<uint64_t, const std::vector<uint64_t>*> m_neighbours;
+  /// Cell without neighbours
+  uint64_t m_missingNeighboursCell = 0;
+  /// Accumulator of the cluster moments, its buffers are reused for all clusters
+  ClusterMomentsAccumulator m_clusterMoments;
+};
+
+template <typename POSITION>
+double TopoClusterBuilder::writeClusters(const PreClusterCollection& aPreClusterCollection, POSITION&& aPosition,
+                                         double aMinEnergyFull, int aMinCellsFull,
+                                         edm4hep::ClusterCollection& aClusters,
+                                         edm4hep::CalorimeterHitCollection& aClusterCells,
+                                         edm4hep::ClusterCollection& aSummaries) {
+  bool useEnergy = aMinEnergyFull > 0;
+  bool useCells = aMinCellsFull > 0;
+  double totalEnergy = 0.;
+  for (const auto& i : aPreClusterCollection) {
+    // cheap pass: energy and size of the proto-cluster
+    double sumEnergy = 0.;
+    for (const auto& pair : i.second) {
+      sumEnergy += m_cells.at(pair.first);
+    }
+    // a cluster is fully evaluated as soon as it passes one of the enabled thresholds
+    bool summary = (useEnergy || useCells) && !(useEnergy && sumEnergy >= aMinEnergyFull) &&
+                   !(useCells && i.second.size() >= size_t(aMinCellsFull));
+    if (summary) {
+      auto clusterSummary = aSummaries.create();
+      clusterSummary.setEnergy(sumEnergy);
+      // the first cell of a proto-cluster is its seed
+      const auto& posSeed = aPosition(i.second.front().first);
+      clusterSummary.setPosition(edm4hep::Vector3f(posSeed.X(), posSeed.Y(), posSeed.Z()));
+      clusterSummary.addToShapeParameters(i.second.size());
+      totalEnergy += sumEnergy;
+      continue;
+    }
+    edm4hep::MutableCluster cluster;
+    m_clusterMoments.clear();
+    m_clusterMoments.reserve(i.second.size());
+    for (const auto& pair : i.second) {
+      auto newCell = aClusterCells.create();
+      newCell.setEnergy(m_cells.at(pair.first));
+      newCell.setCellID(pair.first);
+      newCell.setType(pair.second);
+      const auto& posCell = aPosition(pair.first);
+      m_clusterMoments.add(newCell.getEnergy(), posCell.X(), posCell.Y(), posCell.Z());
+      cluster.addToHits(newCell);
+    }
+    auto moments = m_clusterMoments.compute();
+    ClusterMomentsAccumulator::setEnergyAndPosition(moments, cluster);
+    ClusterMomentsAccumulator::addShapeParameters(moments, cluster);
+    totalEnergy += cluster.getEnergy();
+    aClusters.push_back(cluster);
+  }
+  return totalEnergy;
+}
+
+#endif /* RECCALORIMETER_TOPOCLUSTERBUILDER_H */
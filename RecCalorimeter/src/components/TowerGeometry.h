@@ -0,0 +1,208 @@
+#ifndef RECCALORIMETER_TOWERGEOMETRY_H
+#define RECCALORIMETER_TOWERGEOMETRY_H
+
+// FCCSW
+#include "k4Interface/ITowerTool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+/** @class TowerGeometry Reconstruction/RecCalorimeter/src/components/TowerGeometry.h
+ *
+ *  Immutable description of the eta-phi grid of the calorimeter towers, with the queries of ITowerTool (tower IDs,
+ *  centres of the towers) and the neighbour in phi as inline functions, and cosh/sinh of the tower centres in eta,
+ *  so that the loops over the towers of the sliding window algorithms make no virtual call.
+ *
+ *  The descriptor is trivially copyable, the algorithms take a copy of it once per event. The tables of the centres
+ *  and of cosh/sinh are owned by a TowerGeometry::Tables of the tool describing the grid; they stay valid as long as
+ *  the grid of the tool does not change (towersNumber() of CaloTowerTool recomputes it with the same parameters).
+ *
+ *  The tower tools describing their grid (CaloTowerTool, LayeredCaloTowerTool, SyntheticCaloTowerTool) inherit from
+ *  TowerGeometry::Provider and answer their own ITowerTool queries with the descriptor, so that the tool and the
+ *  descriptor always give the same towers. For the other tower tools, TowerGeometry::Source derives the grid from the
+ *  tower centres of the tool (e.g. CaloTowerSummaryTool).
+ */
+
+class TowerGeometry {
+public:
+  /// Tables of the tower centres, owned by the tool (or algorithm) describing the grid
+  struct Tables {
+    std::vector<float> etaCentres;
+    std::vector<float> phiCentres;
+    std::vector<double> coshEta;
+    std::vector<double> sinhEta;
+  };
+
+  /** @class TowerGeometry::Provider
+   *
+   *  Interface of the tower tools describing their grid.
+   */
+  class Provider {
+  public:
+    virtual ~Provider() = default;
+    /// Descriptor of the grid, valid after towersNumber()
+    virtual const TowerGeometry& towerGeometry() const = 0;
+  };
+
+  class Source;
+
+  TowerGeometry() = default;
+  /** Describe a regular grid and fill its tables.
+   *   @param[in] aNumEta, aNumPhi, numbers of towers in eta and phi.
+   *   @param[in] aEtaLow, aPhiLow, lower edges of the first tower in eta and phi.
+   *   @param[in] aDeltaEta, aDeltaPhi, sizes of the towers.
+   *   @param[in] aRadius, radius for the cluster positions.
+   *   @param[in] aBounded, whether the IDs are computed in double precision, clamped to the grid in eta and taken
+   *   modulo the number of towers in phi (as SyntheticCaloGrid), or in single precision and returned as they are
+   *   outside of the grid (as CaloTowerTool).
+   *   @param[out] aTables, tables of the centres, kept by the caller as long as the descriptor is used.
+   */
+  TowerGeometry(int aNumEta, int aNumPhi, double aEtaLow, double aDeltaEta, double aPhiLow, double aDeltaPhi,
+                float aRadius, bool aBounded, Tables& aTables)
+      : m_numEta(aNumEta), m_numPhi(aNumPhi), m_etaLow(aEtaLow), m_deltaEta(aDeltaEta), m_phiLow(aPhiLow),
+        m_deltaPhi(aDeltaPhi), m_etaLowFloat(aEtaLow), m_deltaEtaFloat(aDeltaEta), m_phiLowFloat(aPhiLow),
+        m_deltaPhiFloat(aDeltaPhi), m_radius(aRadius), m_bounded(aBounded) {
+    aTables.etaCentres.resize(std::max(aNumEta, 0));
+    aTables.phiCentres.resize(std::max(aNumPhi, 0));
+    for (int iEta = 0; iEta < aNumEta; iEta++) {
+      aTables.etaCentres[iEta] = etaFormula(iEta);
+    }
+    for (int iPhi = 0; iPhi < aNumPhi; iPhi++) {
+      aTables.phiCentres[iPhi] = phiFormula(iPhi);
+    }
+    fillTables(aTables);
+  }
+
+  /// Number of towers in eta
+  int numEta() const { return m_numEta; }
+  /// Number of towers in phi
+  int numPhi() const { return m_numPhi; }
+  /// Radius for the cluster positions
+  float radius() const { return m_radius; }
+  /// ID (eta) of the tower containing aEta
+  uint idEta(float aEta) const {
+    if (m_bounded) {
+      double bin = std::floor((aEta - m_etaLow) / m_deltaEta);
+      if (bin < 0) return 0;
+      return bin >= m_numEta ? m_numEta - 1 : uint(bin);
+    }
+    return uint(long(std::floor((aEta - m_etaLowFloat) / m_deltaEtaFloat)));
+  }
+  /// ID (phi) of the tower containing aPhi
+  uint idPhi(float aPhi) const {
+    if (m_bounded) {
+      long bin = long(std::floor((aPhi - m_phiLow) / m_deltaPhi)) % m_numPhi;
+      return bin < 0 ? bin + m_numPhi : bin;
+    }
+    return uint(long(std::floor((aPhi - m_phiLowFloat) / m_deltaPhiFloat)));
+  }
+  /// Eta of the centre of the tower, also outside of the grid
+  float eta(int aIdEta) const {
+    return unsigned(aIdEta) < unsigned(m_numEta) ? m_etaCentres[aIdEta] : etaFormula(aIdEta);
+  }
+  /// Phi of the centre of the tower, also outside of the grid (not taken modulo 2pi)
+  float phi(int aIdPhi) const {
+    return unsigned(aIdPhi) < unsigned(m_numPhi) ? m_phiCentres[aIdPhi] : phiFormula(aIdPhi);
+  }
+  /// cosh of the eta of the centre of the tower
+  double coshEta(int aIdEta) const {
+    return unsigned(aIdEta) < unsigned(m_numEta) ? m_coshEta[aIdEta] : std::cosh(double(eta(aIdEta)));
+  }
+  /// sinh of the eta of the centre of the tower
+  double sinhEta(int aIdEta) const {
+    return unsigned(aIdEta) < unsigned(m_numEta) ? m_sinhEta[aIdEta] : std::sinh(double(eta(aIdEta)));
+  }
+  /**  ID of the phi tower aIPhi, taking into account the full coverage in phi: the first tower (ID = 0) is a direct
+   *   neighbour of the last tower (ID = numPhi - 1).
+   *   @param[in] aIPhi requested ID of a phi tower, may be < 0 or >= numPhi
+   *   @return ID of a tower in [0, numPhi)
+   */
+  uint phiNeighbour(int aIPhi) const {
+    if (aIPhi < 0) {
+      return m_numPhi + aIPhi;
+    } else if (aIPhi >= m_numPhi) {
+      return aIPhi % m_numPhi;
+    }
+    return aIPhi;
+  }
+
+private:
+  float etaFormula(int aIdEta) const { return (aIdEta + 0.5) * m_deltaEta + m_etaLow; }
+  float phiFormula(int aIdPhi) const { return (aIdPhi + 0.5) * m_deltaPhi + m_phiLow; }
+  /// Fill cosh/sinh from the centres in eta and point to the tables
+  void fillTables(Tables& aTables) {
+    aTables.coshEta.resize(aTables.etaCentres.size());
+    aTables.sinhEta.resize(aTables.etaCentres.size());
+    for (size_t iEta = 0; iEta < aTables.etaCentres.size(); iEta++) {
+      aTables.coshEta[iEta] = std::cosh(double(aTables.etaCentres[iEta]));
+      aTables.sinhEta[iEta] = std::sinh(double(aTables.etaCentres[iEta]));
+    }
+    m_etaCentres = aTables.etaCentres.data();
+    m_phiCentres = aTables.phiCentres.data();
+    m_coshEta = aTables.coshEta.data();
+    m_sinhEta = aTables.sinhEta.data();
+  }
+
+  int m_numEta = 0;
+  int m_numPhi = 0;
+  double m_etaLow = 0;
+  double m_deltaEta = 1;
+  double m_phiLow = 0;
+  double m_deltaPhi = 1;
+  float m_etaLowFloat = 0;
+  float m_deltaEtaFloat = 1;
+  float m_phiLowFloat = 0;
+  float m_deltaPhiFloat = 1;
+  float m_radius = 0;
+  bool m_bounded = false;
+  const float* m_etaCentres = nullptr;
+  const float* m_phiCentres = nullptr;
+  const double* m_coshEta = nullptr;
+  const double* m_sinhEta = nullptr;
+};
+
+static_assert(std::is_trivially_copyable<TowerGeometry>::value, "TowerGeometry is copied once per event");
+
+/** @class TowerGeometry::Source
+ *
+ *  Descriptor of the grid of a tower tool, kept by the algorithms: the descriptor of the tool if it is a
+ *  TowerGeometry::Provider, otherwise a descriptor derived once from the tower centres and the radius of the tool.
+ *  The tower centres of the derived descriptor are the ones of the tool, its tower IDs use the size of the towers
+ *  estimated from the centres.
+ */
+
+class TowerGeometry::Source {
+public:
+  /** Set the tool, after its towersNumber().
+   *   @param[in] aTool, tower tool.
+   *   @param[in] aNumEta, aNumPhi, numbers of towers returned by towersNumber().
+   *   @return false if the descriptor is derived from the tower centres.
+   */
+  bool reset(const ITowerTool& aTool, int aNumEta, int aNumPhi) {
+    m_provider = dynamic_cast<const Provider*>(&aTool);
+    if (m_provider != nullptr) return true;
+    double deltaEta = aNumEta > 1 ? (double(aTool.eta(aNumEta - 1)) - aTool.eta(0)) / (aNumEta - 1) : 1.;
+    double deltaPhi = aNumPhi > 1 ? (double(aTool.phi(aNumPhi - 1)) - aTool.phi(0)) / (aNumPhi - 1) : 1.;
+    m_derived = TowerGeometry(aNumEta, aNumPhi, aTool.eta(0) - 0.5 * deltaEta, deltaEta, aTool.phi(0) - 0.5 * deltaPhi,
+                              deltaPhi, aTool.radiusForPosition(), false, m_tables);
+    for (int iEta = 0; iEta < aNumEta; iEta++) {
+      m_tables.etaCentres[iEta] = aTool.eta(iEta);
+    }
+    for (int iPhi = 0; iPhi < aNumPhi; iPhi++) {
+      m_tables.phiCentres[iPhi] = aTool.phi(iPhi);
+    }
+    m_derived.fillTables(m_tables);
+    return false;
+  }
+  /// Copy of the descriptor of the current grid
+  TowerGeometry get() const { return m_provider != nullptr ? m_provider->towerGeometry() : m_derived; }
+
+private:
+  const Provider* m_provider = nullptr;
+  TowerGeometry m_derived;
+  Tables m_tables;
+};
+
+#endif /* RECCALORIMETER_TOWERGEOMETRY_H */
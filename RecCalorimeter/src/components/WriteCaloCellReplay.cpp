@@ -0,0 +1,101 @@
+#include "WriteCaloCellReplay.h"
+#include "CaloCellReplayFormat.h"
+
+// datamodel
+#include "edm4hep/CalorimeterHitCollection.h"
+
+#include <algorithm>
+
+DECLARE_COMPONENT(WriteCaloCellReplay)
+
+WriteCaloCellReplay::WriteCaloCellReplay(const std::string& name, ISvcLocator* svcLoc) : GaudiAlgorithm(name, svcLoc) {}
+
+StatusCode WriteCaloCellReplay::initialize() {
+  StatusCode sc = GaudiAlgorithm::initialize();
+  if (sc.isFailure()) return sc;
+  if (m_energyPrecision < 0) {
+    error() << "Property energyPrecision must not be negative!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_cellCollectionNames.empty()) {
+    error() << "No cell collections to store, set property cells!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  for (const auto& name : m_cellCollectionNames) {
+    m_cellCollections.push_back(
+        new DataHandle<edm4hep::CalorimeterHitCollection>(name, Gaudi::DataHandle::Reader, this));
+  }
+  m_file.open(m_fileName, std::ios::binary | std::ios::trunc);
+  if (!m_file) {
+    error() << "Unable to open output file " << m_fileName << endmsg;
+    return StatusCode::FAILURE;
+  }
+  // file header and collection names
+  std::vector<char> buffer;
+  calo_replay::FileHeader header;
+  std::copy(std::begin(calo_replay::kMagic), std::end(calo_replay::kMagic), header.magic);
+  header.version = calo_replay::kVersion;
+  header.numCollections = m_cellCollectionNames.size();
+  buffer.insert(buffer.end(), reinterpret_cast<const char*>(&header),
+                reinterpret_cast<const char*>(&header) + sizeof(header));
+  for (const auto& name : m_cellCollectionNames) {
+    uint32_t length = name.size();
+    buffer.insert(buffer.end(), reinterpret_cast<const char*>(&length),
+                  reinterpret_cast<const char*>(&length) + sizeof(length));
+    buffer.insert(buffer.end(), name.begin(), name.end());
+  }
+  buffer.resize(calo_replay::padded(buffer.size()), 0);
+  m_file.write(buffer.data(), buffer.size());
+  m_bytesWritten = buffer.size();
+  info() << "Writing " << m_cellCollectionNames.size() << " cell collections to " << m_fileName
+         << (m_deltaCoding ? " with" : " without") << " delta-coded cellIDs";
+  if (m_energyPrecision > 0) {
+    info() << " and energies quantised in steps of " << m_energyPrecision << " GeV";
+  }
+  info() << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode WriteCaloCellReplay::execute() {
+  std::vector<char> buffer(sizeof(calo_replay::EventHeader));
+  std::vector<std::pair<uint64_t, float>> cells;
+  for (auto handle : m_cellCollections) {
+    const edm4hep::CalorimeterHitCollection* inCells = handle->get();
+    cells.clear();
+    cells.reserve(inCells->size());
+    for (const auto& cell : *inCells) {
+      cells.emplace_back(cell.getCellID(), cell.getEnergy());
+    }
+    std::sort(cells.begin(), cells.end(),
+              [](const std::pair<uint64_t, float>& lhs, const std::pair<uint64_t, float>& rhs) {
+                return lhs.first < rhs.first;
+              });
+    calo_replay::encodeColumn(cells, m_deltaCoding ? calo_replay::kDeltaVarintIds : calo_replay::kRawIds,
+                              m_energyPrecision, buffer);
+    m_cellsWritten += cells.size();
+  }
+  calo_replay::EventHeader header{calo_replay::kEventMagic, static_cast<uint32_t>(m_cellCollections.size()),
+                                  buffer.size() - sizeof(calo_replay::EventHeader)};
+  std::copy(reinterpret_cast<const char*>(&header), reinterpret_cast<const char*>(&header) + sizeof(header),
+            buffer.begin());
+  m_file.write(buffer.data(), buffer.size());
+  if (!m_file) {
+    error() << "Unable to write to " << m_fileName << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_bytesWritten += buffer.size();
+  debug() << "Event block of " << buffer.size() << " bytes written" << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode WriteCaloCellReplay::finalize() {
+  m_file.close();
+  info() << "Written " << m_cellsWritten << " cells in " << m_bytesWritten << " bytes to " << m_fileName;
+  if (m_cellsWritten > 0) {
+    info() << " (" << double(m_bytesWritten) / m_cellsWritten << " bytes per cell)";
+  }
+  info() << endmsg;
+  for (auto handle : m_cellCollections) delete handle;
+  m_cellCollections.clear();
+  return GaudiAlgorithm::finalize();
+}
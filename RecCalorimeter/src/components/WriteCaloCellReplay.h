@@ -0,0 +1,63 @@
+#ifndef RECCALORIMETER_WRITECALOCELLREPLAY_H
+#define RECCALORIMETER_WRITECALOCELLREPLAY_H
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+
+// Gaudi
+#include "GaudiAlg/GaudiAlgorithm.h"
+
+#include <fstream>
+
+// datamodel
+namespace edm4hep {
+class CalorimeterHitCollection;
+}
+
+/** @class WriteCaloCellReplay
+ *
+ *  Algorithm writing calorimeter cell collections to a cell replay file (see CaloCellReplayFormat.h).
+ *  It is meant to be run after the digitisation (CreateCaloCells with calibration and noise), so that the clustering
+ *  can be re-run on the same cells with ReadCaloCellReplay or CaloCellReplayInputTool, without the simulation hits
+ *  and the upstream algorithms.
+ *
+ *  Only the cellID and the energy (as float) of the cells are stored, the cells are sorted by cellID.
+ *  With "deltaCoding" the sorted cellIDs are stored as differences to the previous cellID in a variable-length
+ *  encoding, which is much smaller for the dense cell collections with noise.
+ *  With "energyPrecision" > 0 the energies are rounded to multiples of this step (in GeV) and stored as
+ *  variable-length integers, e.g. 1-2 bytes instead of 4 for noise cells with a precision well below the noise.
+ *
+ */
+
+class WriteCaloCellReplay : public GaudiAlgorithm {
+
+public:
+  WriteCaloCellReplay(const std::string& name, ISvcLocator* svcLoc);
+
+  StatusCode initialize();
+
+  StatusCode execute();
+
+  StatusCode finalize();
+
+private:
+  /// Handles for the calo cells (input collections)
+  std::vector<DataHandle<edm4hep::CalorimeterHitCollection>*> m_cellCollections;
+  /// Names of the cell collections to store
+  Gaudi::Property<std::vector<std::string>> m_cellCollectionNames{this, "cells", {}, "Names of the cell collections to store"};
+  /// Name of the output file
+  Gaudi::Property<std::string> m_fileName{this, "filename", "caloCellReplay.bin", "Name of the output file"};
+  /// Delta-code the cellIDs
+  Gaudi::Property<bool> m_deltaCoding{this, "deltaCoding", true, "Store the sorted cellIDs as variable-length differences"};
+  /// Step of the quantised energies
+  Gaudi::Property<double> m_energyPrecision{this, "energyPrecision", 0.,
+                                            "Step of the stored energies in GeV, energies stored as float if 0"};
+  /// Output file
+  std::ofstream m_file;
+  /// Number of bytes written
+  size_t m_bytesWritten = 0;
+  /// Number of cells written
+  size_t m_cellsWritten = 0;
+};
+
+#endif /* RECCALORIMETER_WRITECALOCELLREPLAY_H */
@@ -0,0 +1,93 @@
+#include "WriteCaloPileupBank.h"
+
+// datamodel
+#include "edm4hep/SimCalorimeterHitCollection.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+DECLARE_COMPONENT(WriteCaloPileupBank)
+
+WriteCaloPileupBank::WriteCaloPileupBank(const std::string& name, ISvcLocator* svcLoc) : GaudiAlgorithm(name, svcLoc) {
+  declareProperty("hits", m_hits, "Minimum-bias hits (input)");
+  declareProperty("geometryTool", m_geoTool, "Handle for the geometry tool");
+}
+
+StatusCode WriteCaloPileupBank::initialize() {
+  StatusCode sc = GaudiAlgorithm::initialize();
+  if (sc.isFailure()) return sc;
+  if (m_pileup == 0) {
+    error() << "Property pileup must be at least 1!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!m_geoTool.retrieve()) {
+    error() << "Unable to retrieve the geometry tool!!!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  std::unordered_map<uint64_t, double> cells;
+  if (m_geoTool->prepareEmptyCells(cells).isFailure()) {
+    error() << "Unable to create empty cells!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_cellIndex.build(cells);
+  m_energies.assign(m_cellIndex.size(), 0);
+
+  m_file.open(m_fileName, std::ios::binary | std::ios::trunc);
+  if (!m_file) {
+    error() << "Unable to open output file " << m_fileName << endmsg;
+    return StatusCode::FAILURE;
+  }
+  calo_pileup::FileHeader header;
+  std::copy(std::begin(calo_pileup::kMagic), std::end(calo_pileup::kMagic), header.magic);
+  header.version = calo_pileup::kVersion;
+  header.numCells = m_cellIndex.size();
+  header.cellsChecksum = m_cellIndex.checksum();
+  header.pileup = m_pileup;
+  header.reserved = 0;
+  m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  m_bytesWritten = sizeof(header);
+  info() << "Writing pileup bank " << m_fileName << ": " << m_pileup << " events per entry, " << m_cellIndex.size()
+         << " cells" << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode WriteCaloPileupBank::execute() {
+  const edm4hep::SimCalorimeterHitCollection* hits = m_hits.get();
+  size_t outside = 0;
+  for (const auto& hit : *hits) {
+    uint32_t index = m_cellIndex.index(hit.getCellID());
+    if (index == calo_pileup::CellIndex::npos) {
+      outside++;
+      continue;
+    }
+    m_energies[index] += hit.getEnergy();
+  }
+  m_numHits += hits->size();
+  m_numHitsOutside += outside;
+  if (++m_eventsInEntry < m_pileup) {
+    return StatusCode::SUCCESS;
+  }
+
+  std::vector<char> buffer;
+  m_numCells += calo_pileup::encodeEntry(m_energies, m_denseFraction, buffer);
+  m_file.write(buffer.data(), buffer.size());
+  if (!m_file) {
+    error() << "Unable to write to " << m_fileName << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_bytesWritten += buffer.size();
+  m_entriesWritten++;
+  std::fill(m_energies.begin(), m_energies.end(), 0);
+  m_eventsInEntry = 0;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode WriteCaloPileupBank::finalize() {
+  m_file.close();
+  if (m_eventsInEntry > 0) {
+    info() << "Hits of the last " << m_eventsInEntry << " events dropped, they do not fill an entry" << endmsg;
+  }
+  info() << "Wrote " << m_entriesWritten << " entries of " << m_pileup << " events (" << m_bytesWritten
+         << " bytes) to " << m_fileName << endmsg;
+  return GaudiAlgorithm::finalize();
+}
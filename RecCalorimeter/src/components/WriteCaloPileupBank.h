@@ -0,0 +1,77 @@
+#ifndef RECCALORIMETER_WRITECALOPILEUPBANK_H
+#define RECCALORIMETER_WRITECALOPILEUPBANK_H
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+#include "k4Interface/ICalorimeterTool.h"
+
+// Gaudi
+#include "GaudiAlg/GaudiAlgorithm.h"
+#include "GaudiKernel/ToolHandle.h"
+
+#include "CaloPileupBankFormat.h"
+
+#include <fstream>
+
+// datamodel
+namespace edm4hep {
+class SimCalorimeterHitCollection;
+}
+
+/** @class WriteCaloPileupBank
+ *
+ *  Algorithm writing a pileup bank file (see CaloPileupBankFormat.h) from a sample of minimum-bias events: the hits of
+ *  "pileup" consecutive events are merged into the cells of the geometry tool, and stored as one entry of the bank.
+ *  The bank is overlaid on the signal events by OverlayCaloPileupCells, with the same geometry tool.
+ *
+ *  The energies are the deposited energies of the hits, calibration and noise are applied after the overlay.
+ *  Entries in which more than "denseFraction" of the cells have energy are stored as the energies of all cells.
+ *  Hits outside the cells of the geometry tool are counted and ignored. The hits of the last events are dropped if
+ *  they do not fill an entry.
+ *
+ */
+
+class WriteCaloPileupBank : public GaudiAlgorithm {
+
+public:
+  WriteCaloPileupBank(const std::string& name, ISvcLocator* svcLoc);
+
+  StatusCode initialize();
+
+  StatusCode execute();
+
+  StatusCode finalize();
+
+private:
+  /// Handle for the minimum-bias hits (input collection)
+  DataHandle<edm4hep::SimCalorimeterHitCollection> m_hits{"hits", Gaudi::DataHandle::Reader, this};
+  /// Handle for the geometry tool, providing all cells
+  ToolHandle<ICalorimeterTool> m_geoTool{"TubeLayerPhiEtaCaloTool", this};
+  /// Name of the output file
+  Gaudi::Property<std::string> m_fileName{this, "filename", "caloPileupBank.bin", "Name of the output file"};
+  /// Number of events merged in an entry
+  Gaudi::Property<uint> m_pileup{this, "pileup", 200, "Number of minimum-bias events merged in an entry"};
+  /// Fraction of cells with energy above which the entries are stored dense
+  Gaudi::Property<double> m_denseFraction{this, "denseFraction", 0.25,
+                                          "Store the energies of all cells if more than this fraction has energy"};
+  /// Dense index of the cells
+  calo_pileup::CellIndex m_cellIndex;
+  /// Energies of the entry being merged, indexed by the dense index
+  std::vector<float> m_energies;
+  /// Number of events merged in the current entry
+  uint m_eventsInEntry = 0;
+  /// Output file
+  std::ofstream m_file;
+  /// Number of bytes written
+  size_t m_bytesWritten = 0;
+  /// Number of entries written
+  size_t m_entriesWritten = 0;
+  /// Number of hits per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numHits{this, "Hits"};
+  /// Number of hits outside the cells of the geometry tool per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numHitsOutside{this, "Hits outside the geometry"};
+  /// Number of cells with energy per entry
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numCells{this, "Cells per entry"};
+};
+
+#endif /* RECCALORIMETER_WRITECALOPILEUPBANK_H */
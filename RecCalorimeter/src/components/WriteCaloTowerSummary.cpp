@@ -0,0 +1,114 @@
+#include "WriteCaloTowerSummary.h"
+#include "CaloTowerSummaryFormat.h"
+
+#include <algorithm>
+#include <cmath>
+
+DECLARE_COMPONENT(WriteCaloTowerSummary)
+
+WriteCaloTowerSummary::WriteCaloTowerSummary(const std::string& name, ISvcLocator* svcLoc)
+    : GaudiAlgorithm(name, svcLoc) {
+  declareProperty("towerTool", m_towerTool, "Handle for the tower building tool");
+  declareProperty("layerGroupTools", m_layerGroupTools, "Handles for the tower building tools of the layer groups");
+}
+
+StatusCode WriteCaloTowerSummary::initialize() {
+  StatusCode sc = GaudiAlgorithm::initialize();
+  if (sc.isFailure()) return sc;
+  if (!m_towerTool.retrieve()) {
+    error() << "Unable to retrieve the tower building tool." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!m_layerGroupTools.retrieve()) {
+    error() << "Unable to retrieve the tower building tools of the layer groups." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  auto towerMapSize = m_towerTool->towersNumber();
+  m_nEtaTower = towerMapSize.eta;
+  m_nPhiTower = towerMapSize.phi;
+  if (m_nEtaTower == 0 || m_nPhiTower == 0) {
+    error() << "Empty tower grid!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  for (auto& tool : m_layerGroupTools) {
+    auto groupSize = tool->towersNumber();
+    if (groupSize.eta != int(m_nEtaTower) || groupSize.phi != int(m_nPhiTower)) {
+      error() << "Tower grid of " << tool.name() << " (" << groupSize.eta << " x " << groupSize.phi
+              << ") differs from the grid of the tower tool (" << m_nEtaTower << " x " << m_nPhiTower << ")!"
+              << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  m_file.open(m_fileName, std::ios::binary | std::ios::trunc);
+  if (!m_file) {
+    error() << "Unable to open output file " << m_fileName << endmsg;
+    return StatusCode::FAILURE;
+  }
+  // file header with the tower grid
+  calo_towers::FileHeader header;
+  std::copy(std::begin(calo_towers::kMagic), std::end(calo_towers::kMagic), header.magic);
+  header.version = calo_towers::kVersion;
+  header.numLayerGroups = m_layerGroupTools.size();
+  header.numEta = m_nEtaTower;
+  header.numPhi = m_nPhiTower;
+  header.etaFirst = m_towerTool->eta(0);
+  header.deltaEta = m_nEtaTower > 1 ? m_towerTool->eta(1) - m_towerTool->eta(0) : 1.;
+  header.phiFirst = m_towerTool->phi(0);
+  header.deltaPhi = m_nPhiTower > 1 ? m_towerTool->phi(1) - m_towerTool->phi(0) : 1.;
+  header.radius = m_towerTool->radiusForPosition();
+  header.reserved = 0;
+  m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  m_bytesWritten = sizeof(header);
+  info() << "Writing towers (" << m_nEtaTower << " x " << m_nPhiTower << ") with " << m_layerGroupTools.size()
+         << " layer groups to " << m_fileName << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode WriteCaloTowerSummary::execute() {
+  StageTimer timer(m_timeTowers);
+  std::vector<std::vector<float>> towers(m_nEtaTower, std::vector<float>(m_nPhiTower, 0));
+  m_towerTool->buildTowers(towers);
+  // zero suppression
+  std::vector<uint32_t> indices;
+  for (uint iEta = 0; iEta < m_nEtaTower; iEta++) {
+    for (uint iPhi = 0; iPhi < m_nPhiTower; iPhi++) {
+      if (towers[iEta][iPhi] != 0 && std::fabs(towers[iEta][iPhi]) > m_threshold) {
+        indices.push_back(iEta * m_nPhiTower + iPhi);
+      }
+    }
+  }
+  // energies of all layers, then of each layer group, for the stored towers
+  std::vector<float> energies;
+  energies.reserve(indices.size() * (1 + m_layerGroupTools.size()));
+  for (uint32_t index : indices) {
+    energies.push_back(towers[index / m_nPhiTower][index % m_nPhiTower]);
+  }
+  for (auto& tool : m_layerGroupTools) {
+    for (auto& etaTowers : towers) {
+      std::fill(etaTowers.begin(), etaTowers.end(), 0);
+    }
+    tool->buildTowers(towers);
+    for (uint32_t index : indices) {
+      energies.push_back(towers[index / m_nPhiTower][index % m_nPhiTower]);
+    }
+  }
+  std::vector<char> buffer;
+  calo_towers::encodeEvent(indices, energies, buffer);
+  m_file.write(buffer.data(), buffer.size());
+  if (!m_file) {
+    error() << "Unable to write to " << m_fileName << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_bytesWritten += buffer.size();
+  m_numTowers += indices.size();
+  debug() << indices.size() << " of " << m_nEtaTower * m_nPhiTower << " towers written in " << buffer.size()
+          << " bytes" << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode WriteCaloTowerSummary::finalize() {
+  m_file.close();
+  info() << "Written " << m_numTowers.sum() << " towers in " << m_bytesWritten << " bytes to " << m_fileName
+         << endmsg;
+  return GaudiAlgorithm::finalize();
+}
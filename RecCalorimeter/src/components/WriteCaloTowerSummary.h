@@ -0,0 +1,64 @@
+#ifndef RECCALORIMETER_WRITECALOTOWERSUMMARY_H
+#define RECCALORIMETER_WRITECALOTOWERSUMMARY_H
+
+// Gaudi
+#include "GaudiAlg/GaudiAlgorithm.h"
+#include "GaudiKernel/ToolHandle.h"
+
+// FCCSW
+#include "k4Interface/ITowerTool.h"
+
+#include "StageTimer.h"
+
+#include <fstream>
+
+/** @class WriteCaloTowerSummary
+ *
+ *  Algorithm writing the calorimeter towers of each event to a tower summary file (see CaloTowerSummaryFormat.h),
+ *  so that the analyses which only need towers, and the sliding window clustering with CaloTowerSummaryTool, can run
+ *  without the cells and without rebuilding the towers.
+ *
+ *  The towers are built by '\b towerTool' (e.g. CaloTowerTool, configured as for CreateCaloClustersSlidingWindow) and
+ *  only the towers with |transverse energy| > '\b threshold' are stored (zero suppression), with their index in the
+ *  eta-phi grid. The tools of '\b layerGroupTools' (e.g. LayeredCaloTowerTool with a layer range each) build the
+ *  towers of groups of layers: their transverse energies are stored for the same towers. They must have the same
+ *  tower grid as '\b towerTool'.
+ *  The grid (number, centre and size of the towers, radius for the positions) is stored in the file header.
+ */
+
+class WriteCaloTowerSummary : public GaudiAlgorithm {
+
+public:
+  WriteCaloTowerSummary(const std::string& name, ISvcLocator* svcLoc);
+
+  StatusCode initialize();
+
+  StatusCode execute();
+
+  StatusCode finalize();
+
+private:
+  /// Handle for the tower building tool
+  ToolHandle<ITowerTool> m_towerTool;
+  /// Handles for the tower building tools of the layer groups
+  ToolHandleArray<ITowerTool> m_layerGroupTools;
+  /// Name of the output file
+  Gaudi::Property<std::string> m_fileName{this, "filename", "caloTowerSummary.bin", "Name of the output file"};
+  /// Threshold of the stored towers
+  Gaudi::Property<double> m_threshold{this, "threshold", 0.,
+                                      "Towers with |transverse energy| above this threshold (GeV) are stored"};
+  /// Number of towers in eta
+  uint m_nEtaTower = 0;
+  /// Number of towers in phi
+  uint m_nPhiTower = 0;
+  /// Output file
+  std::ofstream m_file;
+  /// Number of bytes written
+  size_t m_bytesWritten = 0;
+  /// Time to build the towers and encode the event
+  StageTimer::Counter m_timeTowers{this, "Time towers [us]"};
+  /// Number of towers stored per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numTowers{this, "Towers"};
+};
+
+#endif /* RECCALORIMETER_WRITECALOTOWERSUMMARY_H */
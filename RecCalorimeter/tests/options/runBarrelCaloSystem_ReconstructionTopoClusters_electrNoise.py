@@ -222,6 +222,13 @@ positionsClusterBarrel =CreateCaloCellPositions("positionsClusterBarrel",
                                                 positionedHits = "caloClusterBarrelCellPositions",
                                                 OutputLevel = INFO)
 
+#Store the cells after noise addition for replays of the clustering (see runBarrelCaloSystem_ReconstructionTopoClusters_replay.py)
+from Configurables import WriteCaloCellReplay
+writeReplay = WriteCaloCellReplay("WriteCellReplay",
+                                  cells = ["ECalBarrelCellsNoise", "HCalBarrelCellsNoise"],
+                                  filename = "cellReplay_BarrelTopo_electrNoise_50GeVe_3ev.bin",
+                                  deltaCoding = True)
+
 out = PodioOutput("out", filename = "output_BarrelTopo_electrNoise_50GeVe_3ev.root", OutputLevel = DEBUG)
 out.outputCommands =["drop *", "keep GenParticles", "keep GenVertices", "keep caloClustersBarrel","keep caloClusterBarrelCells", "keep caloClusterBarrelCellPositions"]
 
@@ -245,6 +252,7 @@ ApplicationMgr(TopAlg =
                 createemptycells, 
                 createTopoClusters, 
                 positionsClusterBarrel,
+                writeReplay,
                 out
                 ],
                EvtSel = 'NONE',
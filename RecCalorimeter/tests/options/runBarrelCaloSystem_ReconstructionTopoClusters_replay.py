@@ -0,0 +1,109 @@
+# Replay of the topo-clustering on stored cells.
+# The cells after noise addition are stored by WriteCaloCellReplay in
+# runBarrelCaloSystem_ReconstructionTopoClusters_electrNoise.py, no simulation hits and no digitisation are needed here.
+replayFileName = "cellReplay_BarrelTopo_electrNoise_50GeVe_3ev.bin"
+ecalBarrelReadoutName = "ECalBarrelPhiEta"
+hcalBarrelReadoutName = "BarHCal_Readout_phieta"
+
+#Number of events
+num_events = 3
+
+from Gaudi.Configuration import *
+from Configurables import ApplicationMgr, FCCDataSvc, PodioOutput
+podioevent = FCCDataSvc("EventDataSvc")
+
+from Configurables import GeoSvc
+detectors_to_use =['file:Detector/DetFCChhBaseline1/compact/FCChh_DectMaster.xml',
+                   ]
+geoservice = GeoSvc("GeoSvc", detectors = detectors_to_use, OutputLevel = INFO)
+
+#Configure tools for calo cell positions
+from Configurables import CellPositionsECalBarrelTool, CellPositionsHCalBarrelTool
+ECalBcells = CellPositionsECalBarrelTool("CellPositionsECalBarrel",
+                                         readoutName = ecalBarrelReadoutName,
+                                         OutputLevel = INFO)
+HCalBcells = CellPositionsHCalBarrelTool("CellPositionsHCalBarrel",
+                                         readoutName = hcalBarrelReadoutName,
+                                         radii = [291.05, 301.05, 313.55, 328.55, 343.55, 358.55, 378.55, 403.55, 428.55, 453.55],
+                                         OutputLevel = INFO)
+
+#Cells map for the topo-clustering, read directly from the replay file
+from Configurables import CaloCellReplayInputTool, CaloTopoCluster, TopoCaloNeighbours, TopoCaloNoisyCells
+replayTopoInput = CaloCellReplayInputTool("ReplayTopoInput",
+                                          filename = replayFileName,
+                                          OutputLevel = DEBUG)
+
+readNeighboursMap =TopoCaloNeighbours("ReadNeighboursMap",
+                                      fileName = "http://fccsw.web.cern.ch/fccsw/testsamples/calo/neighbours_map_barrel.root",
+                                      OutputLevel = DEBUG)
+
+#Noise levels per cell
+readNoisyCellsMap = TopoCaloNoisyCells("ReadNoisyCellsMap",
+                                       fileName = "http://fccsw.web.cern.ch/fccsw/testsamples/calo/cellNoise_map_electronicsNoiseLevel.root",
+                                       OutputLevel = DEBUG)
+
+createTopoClusters = CaloTopoCluster("CreateTopoClusters",
+                                     TopoClusterInput = replayTopoInput,
+                                     neigboursTool = readNeighboursMap,
+                                     noiseTool = readNoisyCellsMap,
+                                     positionsECalBarrelTool = ECalBcells,
+                                     positionsHCalBarrelTool = HCalBcells,
+                                     seedSigma = 4,
+                                     neighbourSigma = 2,
+                                     lastNeighbourSigma = 0,
+                                     OutputLevel = DEBUG)
+createTopoClusters.clusters.Path ="caloClustersBarrel"
+createTopoClusters.clusterCells.Path = "caloClusterBarrelCells"
+
+#Cell collections for the tower tool, read from the same file
+from Configurables import ReadCaloCellReplay, CreateEmptyCaloCellsCollection
+readReplay = ReadCaloCellReplay("ReadCellReplay",
+                                filename = replayFileName,
+                                OutputLevel = DEBUG)
+createemptycells = CreateEmptyCaloCellsCollection("CreateEmptyCaloCells")
+createemptycells.cells.Path = "emptyCaloCells"
+
+from GaudiKernel.PhysicalConstants import pi
+from Configurables import CaloTowerTool, CreateCaloClustersSlidingWindow
+towers = CaloTowerTool("towers",
+                       deltaEtaTower = 0.01,
+                       deltaPhiTower = 2*pi/704.,
+                       ecalBarrelReadoutName = ecalBarrelReadoutName,
+                       ecalEndcapReadoutName = "",
+                       ecalFwdReadoutName = "",
+                       hcalBarrelReadoutName = "",
+                       hcalExtBarrelReadoutName = "",
+                       hcalEndcapReadoutName = "",
+                       hcalFwdReadoutName = "")
+towers.ecalBarrelCells.Path = "ECalBarrelCellsNoise"
+towers.ecalEndcapCells.Path = "emptyCaloCells"
+towers.ecalFwdCells.Path = "emptyCaloCells"
+towers.hcalBarrelCells.Path = "emptyCaloCells"
+towers.hcalExtBarrelCells.Path = "emptyCaloCells"
+towers.hcalEndcapCells.Path = "emptyCaloCells"
+towers.hcalFwdCells.Path = "emptyCaloCells"
+
+createClusters = CreateCaloClustersSlidingWindow("CreateClusters",
+                                                 towerTool = towers,
+                                                 nEtaWindow = 7, nPhiWindow = 19,
+                                                 nEtaPosition = 3, nPhiPosition = 3,
+                                                 nEtaDuplicates = 5, nPhiDuplicates = 11,
+                                                 nEtaFinal = 7, nPhiFinal = 19,
+                                                 energyThreshold = 10)
+createClusters.clusters.Path = "caloClustersSW"
+
+out = PodioOutput("out", filename = "output_BarrelTopo_replay_50GeVe_3ev.root", OutputLevel = DEBUG)
+out.outputCommands =["drop *", "keep caloClustersBarrel", "keep caloClusterBarrelCells", "keep caloClustersSW"]
+
+ApplicationMgr(TopAlg =
+               [createTopoClusters,
+                readReplay,
+                createemptycells,
+                createClusters,
+                out
+                ],
+               EvtSel = 'NONE',
+               EvtMax = num_events,
+               ExtSvc = [ geoservice, podioevent ],
+               OutputLevel = INFO
+               )
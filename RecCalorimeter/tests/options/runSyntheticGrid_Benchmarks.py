@@ -0,0 +1,104 @@
+# Timing of the reconstruction on synthetic events, without detector description and without input files.
+# The hits are created on a regular layer x eta x phi grid by CreateSyntheticCaloHits, the geometry dependent tools are
+# replaced by SyntheticCaloGridTool (neighbours, noise, positions, list of cells) and SyntheticCaloTowerTool.
+# Timed steps: calibration and noise (CreateCaloCells), topo-clustering (CaloTopoCluster), cluster splitting
+# (SplitClusters), tower building and sliding window clustering (CreateCaloClustersSlidingWindow).
+# The times per step are printed at the end by the counters of the algorithms and by the ChronoStatSvc.
+#
+# The occupancy is selected with the environment variable BENCHMARK_PILEUP (default 0), e.g.:
+#   for pu in 0 200 1000; do BENCHMARK_PILEUP=$pu k4run runSyntheticGrid_Benchmarks.py; done
+import os
+
+pileup = int(os.environ.get("BENCHMARK_PILEUP", 0))
+num_events = int(os.environ.get("BENCHMARK_EVENTS", 20))
+
+from Gaudi.Configuration import *
+from Configurables import ApplicationMgr, FCCDataSvc
+podioevent = FCCDataSvc("EventDataSvc")
+
+# Same grid for all synthetic components: 8 layers, 0.02 x 2pi/352 in |eta| < 1.5 (see syntheticGrid.py)
+import sys
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import syntheticGrid
+grid = syntheticGrid.largeGrid
+etaMax = syntheticGrid.largeEtaMax
+createHits = syntheticGrid.createSyntheticHits(grid,
+                                               numShowers = 5,
+                                               showerEnergy = 50.,
+                                               pileup = pileup,
+                                               pileupHitsPerEvent = 100,
+                                               pileupHitEnergy = 0.05)
+gridTool = syntheticGrid.syntheticGridTool(grid, etaMax)
+
+# Calibration and noise
+createCells = syntheticGrid.createCells(gridTool)
+
+# Topo-clustering, all cells in the "ECal barrel" collection
+from Configurables import CaloTopoCluster
+createEmptyCells = syntheticGrid.createEmptyCells()
+topoInput = syntheticGrid.topoClusterInput("TopoInput")
+
+createTopoClusters = CaloTopoCluster("CreateTopoClusters",
+                                     TopoClusterInput = topoInput,
+                                     neigboursTool = gridTool,
+                                     noiseTool = gridTool,
+                                     positionsECalBarrelTool = gridTool,
+                                     positionsHCalBarrelTool = gridTool,
+                                     positionsHCalBarrelNoSegTool = gridTool,
+                                     noSegmentationHCal = False,
+                                     seedSigma = 4,
+                                     neighbourSigma = 2,
+                                     lastNeighbourSigma = 0)
+createTopoClusters.clusters.Path = "SyntheticTopoClusters"
+createTopoClusters.clusterCells.Path = "SyntheticTopoClusterCells"
+
+# Cluster splitting
+from Configurables import SplitClusters
+splitClusters = SplitClusters("SplitClusters",
+                              clusters = "SyntheticTopoClusters",
+                              outClusters = "SyntheticSplitClusters",
+                              outCells = "SyntheticSplitClusterCells",
+                              neigboursTool = gridTool,
+                              positionsECalBarrelTool = gridTool,
+                              positionsHCalBarrelTool = gridTool,
+                              positionsHCalBarrelNoSegTool = gridTool,
+                              noSegmentationHCal = False,
+                              threshold = 0.01)
+
+# Towers and sliding window clustering
+from Configurables import SyntheticCaloTowerTool, CreateCaloClustersSlidingWindow
+towers = SyntheticCaloTowerTool("SyntheticTowers", **syntheticGrid.geometry(grid, etaMax))
+towers.cells.Path = "SyntheticCells"
+createClusters = CreateCaloClustersSlidingWindow("CreateSlidingWindowClusters",
+                                                 towerTool = towers,
+                                                 nEtaWindow = 5, nPhiWindow = 9,
+                                                 nEtaPosition = 3, nPhiPosition = 3,
+                                                 nEtaDuplicates = 3, nPhiDuplicates = 5,
+                                                 nEtaFinal = 5, nPhiFinal = 9,
+                                                 energyThreshold = 10)
+createClusters.clusters.Path = "SyntheticSlidingWindowClusters"
+createClusters.clusterCells.Path = "SyntheticSlidingWindowClusterCells"
+
+#CPU information
+from Configurables import AuditorSvc, ChronoAuditor
+chra = ChronoAuditor()
+audsvc = AuditorSvc()
+audsvc.Auditors = [chra]
+createHits.AuditExecute = True
+createCells.AuditExecute = True
+createTopoClusters.AuditExecute = True
+splitClusters.AuditExecute = True
+createClusters.AuditExecute = True
+
+ApplicationMgr(TopAlg = [createHits,
+                         createCells,
+                         createEmptyCells,
+                         createTopoClusters,
+                         splitClusters,
+                         createClusters
+                         ],
+               EvtSel = 'NONE',
+               EvtMax = num_events,
+               ExtSvc = [podioevent, audsvc],
+               OutputLevel = INFO
+               )
@@ -0,0 +1,64 @@
+# Positioned cells on a synthetic grid (see runSyntheticGrid_Benchmarks.py): the positions of all cells of the grid
+# are filled by CreateCaloCellPositions cloning each cell, and with batchPositions, on 4 threads with the position
+# cache and on one thread without it. The times are in the counter "Time positions [us]" of each algorithm, exported
+# with the JSON sink to cellPositions_syntheticGrid.json; the positioned cells are written to
+# cellPositions_syntheticGrid.root and compared by RecCalorimeter/tests/scripts/checkSyntheticGridCellPositions.py.
+import os
+
+num_events = int(os.environ.get("BENCHMARK_EVENTS", 20))
+
+from Gaudi.Configuration import *
+from Configurables import ApplicationMgr, FCCDataSvc, PodioOutput
+podioevent = FCCDataSvc("EventDataSvc")
+
+# Grid of intermediate size, 4 layers of 60 x 128 cells in |eta| < 1.2
+import sys
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import syntheticGrid
+grid = dict(systemId = 5, numLayers = 4, numEta = 60, numPhi = 128)
+createHits = syntheticGrid.createSyntheticHits(grid,
+                                               numShowers = 2,
+                                               showerEnergy = 50.,
+                                               pileup = 50,
+                                               pileupHitsPerEvent = 100,
+                                               pileupHitEnergy = 0.05)
+gridTool = syntheticGrid.syntheticGridTool(grid, 1.2)
+
+# All cells of the grid, with noise
+createCells = syntheticGrid.createCells(gridTool)
+
+# Cell positions, cloned and in batch
+from Configurables import CreateCaloCellPositions
+positionsClone = CreateCaloCellPositions("PositionsClone",
+                                         positionsECalBarrelTool = gridTool,
+                                         hits = "SyntheticCells",
+                                         positionedHits = "PositionedCellsClone")
+positionsBatch = CreateCaloCellPositions("PositionsBatch",
+                                         positionsECalBarrelTool = gridTool,
+                                         batchPositions = True,
+                                         numThreads = 4,
+                                         hits = "SyntheticCells",
+                                         positionedHits = "PositionedCellsBatch")
+positionsBatchNoCache = CreateCaloCellPositions("PositionsBatchNoCache",
+                                                positionsECalBarrelTool = gridTool,
+                                                batchPositions = True,
+                                                cachePositions = False,
+                                                hits = "SyntheticCells",
+                                                positionedHits = "PositionedCellsBatchNoCache")
+
+out = PodioOutput("out", filename = "cellPositions_syntheticGrid.root")
+out.outputCommands = ["drop *", "keep PositionedCells*"]
+
+from Configurables import Gaudi__Monitoring__JSONSink as JSONSink
+ApplicationMgr(TopAlg = [createHits,
+                         createCells,
+                         positionsClone,
+                         positionsBatch,
+                         positionsBatchNoCache,
+                         out
+                         ],
+               EvtSel = 'NONE',
+               EvtMax = num_events,
+               ExtSvc = [podioevent, JSONSink(FileName = "cellPositions_syntheticGrid.json")],
+               OutputLevel = INFO
+               )
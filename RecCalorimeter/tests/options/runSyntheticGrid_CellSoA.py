@@ -0,0 +1,77 @@
+# Cells exchanged as structure of arrays on a small synthetic grid (see runSyntheticGrid_Benchmarks.py): the cell
+# collection is converted once per event to a CaloCellSoA by CreateCaloCellSoA, and converted back to a collection by
+# CreateCaloCellsFromSoA. The topo-clustering is run on the original collection, on the CaloCellSoA (with
+# CaloCellSoAInputTool) and on the converted collection; the counters are exported with the JSON sink to
+# cellSoA_syntheticGrid.json and compared by RecCalorimeter/tests/scripts/checkSyntheticGridCellSoA.py.
+outputFile = "cellSoA_syntheticGrid.json"
+
+from Gaudi.Configuration import *
+from Configurables import ApplicationMgr, FCCDataSvc
+podioevent = FCCDataSvc("EventDataSvc")
+
+import os, sys
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import syntheticGrid
+createHits = syntheticGrid.createSyntheticHits(syntheticGrid.smallGrid,
+                                               numShowers = 2,
+                                               showerEnergy = 20.,
+                                               pileup = 10,
+                                               pileupHitsPerEvent = 20,
+                                               pileupHitEnergy = 0.05)
+gridTool = syntheticGrid.syntheticGridTool(syntheticGrid.smallGrid, syntheticGrid.smallEtaMax)
+
+# All cells of the grid, with noise
+createCells = syntheticGrid.createCells(gridTool)
+
+# Conversion to the structure of arrays and back
+from Configurables import CreateCaloCellSoA, CreateCaloCellsFromSoA
+createCellSoA = CreateCaloCellSoA("CreateCellSoA",
+                                  cells = ["SyntheticCells"],
+                                  time = True,
+                                  positions = True)
+createCellSoA.cellSoA.Path = "SyntheticCellSoA"
+createCellsFromSoA = CreateCaloCellsFromSoA("CreateCellsFromSoA")
+createCellsFromSoA.cellSoA.Path = "SyntheticCellSoA"
+createCellsFromSoA.cells.Path = "SyntheticCellsFromSoA"
+
+# Topo-clustering of the three inputs
+from Configurables import CaloCellSoAInputTool, CaloTopoCluster
+createEmptyCells = syntheticGrid.createEmptyCells()
+
+soaInput = CaloCellSoAInputTool("TopoInputSoA")
+soaInput.cellSoA.Path = "SyntheticCellSoA"
+
+def topoClustering(name, topoInput):
+    createTopoClusters = CaloTopoCluster(name,
+                                         TopoClusterInput = topoInput,
+                                         neigboursTool = gridTool,
+                                         noiseTool = gridTool,
+                                         positionsECalBarrelTool = gridTool,
+                                         positionsHCalBarrelTool = gridTool,
+                                         positionsHCalBarrelNoSegTool = gridTool,
+                                         noSegmentationHCal = False)
+    createTopoClusters.clusters.Path = name + "Clusters"
+    createTopoClusters.clusterCells.Path = name + "ClusterCells"
+    return createTopoClusters
+
+topoFromCells = topoClustering("TopoFromCells", syntheticGrid.topoClusterInput("TopoInputCells"))
+topoFromSoA = topoClustering("TopoFromSoA", soaInput)
+topoFromSoACells = topoClustering("TopoFromSoACells",
+                                  syntheticGrid.topoClusterInput("TopoInputSoACells", "SyntheticCellsFromSoA"))
+
+# Export of the counters
+from Configurables import Gaudi__Monitoring__JSONSink as JSONSink
+ApplicationMgr(TopAlg = [createHits,
+                         createCells,
+                         createCellSoA,
+                         createCellsFromSoA,
+                         createEmptyCells,
+                         topoFromCells,
+                         topoFromSoA,
+                         topoFromSoACells
+                         ],
+               EvtSel = 'NONE',
+               EvtMax = 5,
+               ExtSvc = [podioevent, JSONSink(FileName = outputFile)],
+               OutputLevel = INFO
+               )
@@ -0,0 +1,120 @@
+# Throughput of the whole reconstruction chain on reproducible synthetic events, without detector description and
+# without input files: cells with noise, cell positions, topo-clustering, cluster splitting and cluster corrections.
+# The events (single electrons, jets and minimum-bias pileup hits) are created by CreateSyntheticCaloHits on the grid of
+# SyntheticCaloGridTool (see runSyntheticGrid_Benchmarks.py).
+# ThroughputReport prints the events per second, the time share of each algorithm and the peak RSS at the end.
+#
+# Configuration through environment variables:
+#   BENCHMARK_PILEUP       number of pileup interactions (default 200)
+#   BENCHMARK_EVENTS       number of events (default 50)
+#   BENCHMARK_FIRST_EVENT  number of the first event, to split a sample between processes (default 0)
+#   BENCHMARK_REPORT       JSON file for the report of ThroughputReport (default: none)
+# Several processes are run and collected by RecCalorimeter/tests/scripts/runSyntheticChainScaling.py.
+import os
+
+pileup = int(os.environ.get("BENCHMARK_PILEUP", 200))
+num_events = int(os.environ.get("BENCHMARK_EVENTS", 50))
+first_event = int(os.environ.get("BENCHMARK_FIRST_EVENT", 0))
+report_file = os.environ.get("BENCHMARK_REPORT", "")
+gridEncoding = "system:4,layer:8,eta:12,phi:12"
+
+from Gaudi.Configuration import *
+from Configurables import ApplicationMgr, FCCDataSvc
+podioevent = FCCDataSvc("EventDataSvc")
+
+from Configurables import ThroughputReport
+report = ThroughputReport("ThroughputReport", outputFile = report_file)
+
+# Same grid for all synthetic components: 8 layers, 0.02 x 2pi/352 in |eta| < 1.5 (see syntheticGrid.py)
+import sys
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import syntheticGrid
+grid = syntheticGrid.largeGrid
+createHits = syntheticGrid.createSyntheticHits(grid,
+                                               numShowers = 2,
+                                               showerEnergy = 50.,
+                                               numJets = 2,
+                                               jetEnergy = 100.,
+                                               pileup = pileup,
+                                               pileupHitsPerEvent = 100,
+                                               pileupHitEnergy = 0.05,
+                                               seed = 1234,
+                                               firstEvent = first_event)
+gridTool = syntheticGrid.syntheticGridTool(grid, syntheticGrid.largeEtaMax)
+
+# Cells with noise
+createCells = syntheticGrid.createCells(gridTool)
+
+# Cell positions
+from Configurables import CreateCaloCellPositions
+positionCells = CreateCaloCellPositions("PositionCells",
+                                        positionsECalBarrelTool = gridTool,
+                                        hits = "SyntheticCells",
+                                        positionedHits = "SyntheticPositionedCells")
+
+# Topo-clustering
+from Configurables import CaloTopoCluster
+createEmptyCells = syntheticGrid.createEmptyCells()
+topoInput = syntheticGrid.topoClusterInput("TopoInput", "SyntheticPositionedCells")
+
+createTopoClusters = CaloTopoCluster("CreateTopoClusters",
+                                     TopoClusterInput = topoInput,
+                                     neigboursTool = gridTool,
+                                     noiseTool = gridTool,
+                                     positionsECalBarrelTool = gridTool,
+                                     positionsHCalBarrelTool = gridTool,
+                                     positionsHCalBarrelNoSegTool = gridTool,
+                                     noSegmentationHCal = False,
+                                     seedSigma = 4,
+                                     neighbourSigma = 2,
+                                     lastNeighbourSigma = 0)
+createTopoClusters.clusters.Path = "SyntheticTopoClusters"
+createTopoClusters.clusterCells.Path = "SyntheticTopoClusterCells"
+
+# Cluster splitting
+from Configurables import SplitClusters
+splitClusters = SplitClusters("SplitClusters",
+                              clusters = "SyntheticTopoClusters",
+                              outClusters = "SyntheticSplitClusters",
+                              outCells = "SyntheticSplitClusterCells",
+                              neigboursTool = gridTool,
+                              positionsECalBarrelTool = gridTool,
+                              positionsHCalBarrelTool = gridTool,
+                              positionsHCalBarrelNoSegTool = gridTool,
+                              noSegmentationHCal = False,
+                              threshold = 0.01)
+
+# Upstream and downstream corrections, the cell IDs are decoded with the grid encoding
+from Configurables import CorrectCaloClusters
+correctClusters = CorrectCaloClusters("CorrectClusters",
+                                      inClusters = "SyntheticSplitClusters",
+                                      outClusters = "SyntheticCorrectedClusters",
+                                      systemIDs = [grid["systemId"]],
+                                      readoutNames = ["SyntheticGrid"],
+                                      readoutEncodings = [gridEncoding],
+                                      numLayers = [grid["numLayers"]],
+                                      firstLayerIDs = [0],
+                                      lastLayerIDs = [grid["numLayers"] - 1],
+                                      upstreamParameters = [[0.09, -11.7, -178.6, 1.68, -22.7, -50.2]],
+                                      upstreamFormulas = [['[0]+[1]/(x-[2])', '[0]+[1]/(x-[2])']],
+                                      downstreamParameters = [[0.0024, 0.0082, 1.64, -1.84, 0.028, 8.73]],
+                                      downstreamFormulas = [['[0]+[1]*x', '[0]+[1]/sqrt(x)', '[0]+[1]/x']])
+
+algorithms = [createHits, createCells, positionCells, createEmptyCells, createTopoClusters, splitClusters,
+              correctClusters]
+
+#CPU information
+from Configurables import AuditorSvc, ChronoAuditor
+chra = ChronoAuditor()
+audsvc = AuditorSvc()
+audsvc.Auditors = [chra]
+for alg in algorithms:
+    alg.AuditExecute = True
+report.algorithms = [alg.name() for alg in algorithms]
+
+ApplicationMgr(TopAlg = [report] + algorithms,
+               EvtSel = 'NONE',
+               EvtMax = num_events,
+               ExtSvc = [podioevent, audsvc],
+               OutputLevel = INFO
+               )
@@ -0,0 +1,54 @@
+# Concurrent lookups in the neighbours and noise maps read from files by TopoCaloNeighbours and TopoCaloNoisyCells,
+# as done by the clustering of concurrent events. The maps of a small synthetic grid are written by
+# RecCalorimeter/tests/scripts/writeSyntheticGridMaps.py, with single trees (read at initialize) and with one tree per
+# system (read at the first lookup, from the threads of TimeCaloTableLookups). Each TimeCaloTableLookups looks up
+# the cells of a geometry tool from several threads:
+#   - LookupsReference: the maps built by SyntheticCaloGridTool for the same grid,
+#   - LookupsFiles: the maps of the single trees,
+#   - LookupsLazy: the maps of the trees per system,
+#   - LookupsMisses: the cells of a grid of another system, not in the maps.
+# The counters are exported with the JSON sink to concurrentLookups_syntheticGrid.json and compared by
+# RecCalorimeter/tests/scripts/checkSyntheticGridConcurrentLookups.py. Built with K4RECCALORIMETER_THREAD_SANITIZER,
+# the test runs under ThreadSanitizer and fails on a data race in the lookups.
+num_threads = 8
+grid = dict(systemId = 5, numLayers = 4, numEta = 40, numPhi = 64)
+mapsFile = "syntheticGrid_maps.root"
+mapsPerSystemFile = "syntheticGrid_mapsPerSystem.root"
+outputFile = "concurrentLookups_syntheticGrid.json"
+
+# The trees of the lazy maps are read from the lookup threads
+import ROOT
+ROOT.EnableThreadSafety()
+
+from Gaudi.Configuration import *
+from Configurables import ApplicationMgr, FCCDataSvc
+podioevent = FCCDataSvc("EventDataSvc")
+
+from Configurables import SyntheticCaloGridTool, TopoCaloNeighbours, TopoCaloNoisyCells, TimeCaloTableLookups
+gridTool = SyntheticCaloGridTool("Grid", cellNoise = 0.003, cellNoiseOffset = 0., **grid)
+otherGrid = dict(grid, systemId = grid["systemId"] + 1)
+otherGridTool = SyntheticCaloGridTool("OtherSystemGrid", **otherGrid)
+neighboursFiles = TopoCaloNeighbours("NeighboursFiles", fileName = mapsFile)
+noiseFiles = TopoCaloNoisyCells("NoiseFiles", fileName = mapsFile)
+neighboursLazy = TopoCaloNeighbours("NeighboursLazy", fileName = mapsPerSystemFile, lazyLoading = True)
+noiseLazy = TopoCaloNoisyCells("NoiseLazy", fileName = mapsPerSystemFile, lazyLoading = True)
+
+def lookups(name, neighboursTool, noiseTool, geometryTool):
+    return TimeCaloTableLookups(name,
+                                neighboursTool = neighboursTool,
+                                noiseTool = noiseTool,
+                                geometryTool = geometryTool,
+                                numThreads = num_threads,
+                                lookupsPerThread = 100000)
+
+# Export of the counters
+from Configurables import Gaudi__Monitoring__JSONSink as JSONSink
+ApplicationMgr(TopAlg = [lookups("LookupsReference", gridTool, gridTool, gridTool),
+                         lookups("LookupsFiles", neighboursFiles, noiseFiles, gridTool),
+                         lookups("LookupsLazy", neighboursLazy, noiseLazy, gridTool),
+                         lookups("LookupsMisses", neighboursFiles, noiseFiles, otherGridTool)],
+               EvtSel = 'NONE',
+               EvtMax = 3,
+               ExtSvc = [podioevent, JSONSink(FileName = outputFile)],
+               OutputLevel = INFO
+               )
@@ -0,0 +1,105 @@
+# Per-event budget of the topo-clustering and of the cluster splitting on a small synthetic grid (see
+# runSyntheticGrid_Benchmarks.py). The cells with noise are clustered without budget, with a budget never reached
+# (the clusters have to be the same), and with a budget of a few neighbour lookups and cluster cells, reached in every
+# event; the topo-clusters are split without budget, with a budget never reached, with a maximal cluster size and with
+# a budget of a few neighbour lookups, reached before any cluster is split: its clusters have to be the topo-clusters,
+# copied without splitting (CompareCaloClusters).
+# The counters are exported with the JSON sink to eventBudget_syntheticGrid.json and compared by
+# RecCalorimeter/tests/scripts/checkSyntheticGridEventBudget.py.
+outputFile = "eventBudget_syntheticGrid.json"
+
+from Gaudi.Configuration import *
+from Configurables import ApplicationMgr, FCCDataSvc
+podioevent = FCCDataSvc("EventDataSvc")
+
+import os, sys
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import syntheticGrid
+createHits = syntheticGrid.createSyntheticHits(syntheticGrid.smallGrid,
+                                               numShowers = 2,
+                                               showerEnergy = 20.,
+                                               pileup = 10,
+                                               pileupHitsPerEvent = 20,
+                                               pileupHitEnergy = 0.05)
+gridTool = syntheticGrid.syntheticGridTool(syntheticGrid.smallGrid, syntheticGrid.smallEtaMax)
+
+# All cells of the grid, with noise
+createCells = syntheticGrid.createCells(gridTool)
+
+# Topo-clustering without budget, with a budget never reached and with a tight budget
+from Configurables import CaloTopoCluster
+createEmptyCells = syntheticGrid.createEmptyCells()
+topoInput = syntheticGrid.topoClusterInput("TopoInput")
+
+def topoClustering(name, **budget):
+    createTopoClusters = CaloTopoCluster(name,
+                                         TopoClusterInput = topoInput,
+                                         neigboursTool = gridTool,
+                                         noiseTool = gridTool,
+                                         positionsECalBarrelTool = gridTool,
+                                         positionsHCalBarrelTool = gridTool,
+                                         positionsHCalBarrelNoSegTool = gridTool,
+                                         noSegmentationHCal = False,
+                                         **budget)
+    createTopoClusters.clusters.Path = name + "Clusters"
+    createTopoClusters.clusterCells.Path = name + "ClusterCells"
+    return createTopoClusters
+
+topoUnlimited = topoClustering("TopoUnlimited")
+topoLargeBudget = topoClustering("TopoLargeBudget",
+                                 maxNeighbourLookups = 10000000,
+                                 maxClusterCells = 1000000,
+                                 maxEventTime = 600000.)
+topoTightBudget = topoClustering("TopoTightBudget",
+                                 maxNeighbourLookups = 20,
+                                 maxClusterCells = 10)
+
+# Cluster splitting without budget, with a budget never reached, with a maximal cluster size and with a few lookups
+from Configurables import SplitClusters
+def splitting(name, **budget):
+    return SplitClusters(name,
+                         clusters = "TopoUnlimitedClusters",
+                         outClusters = name + "Clusters",
+                         outCells = name + "ClusterCells",
+                         neigboursTool = gridTool,
+                         positionsECalBarrelTool = gridTool,
+                         positionsHCalBarrelTool = gridTool,
+                         positionsHCalBarrelNoSegTool = gridTool,
+                         noSegmentationHCal = False,
+                         threshold = 0.01,
+                         **budget)
+
+splitUnlimited = splitting("SplitUnlimited")
+splitLargeBudget = splitting("SplitLargeBudget",
+                             maxNeighbourLookups = 10000000,
+                             maxClusterCells = 1000000,
+                             maxEventTime = 600000.)
+splitTightBudget = splitting("SplitTightBudget",
+                             maxClusterCells = 10)
+splitTightLookups = splitting("SplitTightLookups",
+                              maxNeighbourLookups = 3)
+
+from Configurables import CompareCaloClusters
+compareTightLookups = CompareCaloClusters("CompareSplitTightLookups",
+                                          reference = "TopoUnlimitedClusters",
+                                          candidate = "SplitTightLookupsClusters")
+
+# Export of the counters
+from Configurables import Gaudi__Monitoring__JSONSink as JSONSink
+ApplicationMgr(TopAlg = [createHits,
+                         createCells,
+                         createEmptyCells,
+                         topoUnlimited,
+                         topoLargeBudget,
+                         topoTightBudget,
+                         splitUnlimited,
+                         splitLargeBudget,
+                         splitTightBudget,
+                         splitTightLookups,
+                         compareTightLookups
+                         ],
+               EvtSel = 'NONE',
+               EvtMax = 5,
+               ExtSvc = [podioevent, JSONSink(FileName = outputFile)],
+               OutputLevel = INFO
+               )
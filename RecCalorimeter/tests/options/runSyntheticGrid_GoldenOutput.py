@@ -0,0 +1,251 @@
+# Golden-output comparison of the optimised reconstruction paths with their reference configurations on the same
+# reproducible synthetic events (see runSyntheticGrid_Benchmarks.py). For each step, the output of the candidate
+# configuration is compared to the output of the reference by CompareCaloCells or CompareCaloClusters:
+#   - cells: CreateCaloCells with the asynchronous initialisation against the synchronous one (without noise, which is
+#     not reproducible between two instances), and the cells converted to a CaloCellSoA and back against the original;
+#   - topo-clustering: the input read from the CaloCellSoA (CaloCellSoAInputTool) against the input read from the cell
+#     collection;
+#   - cells and topo-clusters in one step: CreateCaloTopoClustersFromHits against CreateCaloCells,
+#     CreateCaloCellPositions and CaloTopoCluster, without noise (random, so different in the two paths), with the
+#     clusters below 1 GeV written as summaries;
+#   - multi-threshold topo-clustering: the clusters of each configuration of CaloTopoClusterMultiThreshold, built in one
+#     traversal, against a CaloTopoCluster with the same thresholds;
+#   - cluster splitting: with a budget never reached against no budget;
+#   - sliding window: with the cells attached to the clusters against the clusters without cells.
+# The differences are listed per event in goldenOutput_<step>.diff, the counters are exported with the JSON sink to
+# goldenOutput_syntheticGrid.json and the times of the reference and candidate algorithms by ThroughputReport to
+# goldenOutput_timing.json; both are checked by RecCalorimeter/tests/scripts/checkSyntheticGridGoldenOutput.py.
+# A new optimised path is added as a candidate of the step it replaces, with the same tolerances.
+import os
+
+num_events = int(os.environ.get("BENCHMARK_EVENTS", 5))
+outputFile = "goldenOutput_syntheticGrid.json"
+timingFile = "goldenOutput_timing.json"
+# Tolerances of the comparisons: relative and absolute (GeV) energy, position (mm)
+tolerances = dict(energyTolerance = 1e-6, absoluteEnergyTolerance = 1e-9, positionTolerance = 1e-3)
+
+# The asynchronous initialisation needs the thread safety of ROOT, enabled for the whole job before the components
+import ROOT
+ROOT.EnableThreadSafety()
+
+from Gaudi.Configuration import *
+from Configurables import ApplicationMgr, FCCDataSvc
+podioevent = FCCDataSvc("EventDataSvc")
+
+from Configurables import ThroughputReport
+report = ThroughputReport("ThroughputReport", outputFile = timingFile)
+
+import sys
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import syntheticGrid
+grid = syntheticGrid.smallGrid
+etaMax = syntheticGrid.smallEtaMax
+createHits = syntheticGrid.createSyntheticHits(grid,
+                                               numShowers = 2,
+                                               showerEnergy = 20.,
+                                               numJets = 1,
+                                               jetEnergy = 50.,
+                                               pileup = 10,
+                                               pileupHitsPerEvent = 20,
+                                               pileupHitEnergy = 0.05,
+                                               seed = 1234)
+gridTool = syntheticGrid.syntheticGridTool(grid, etaMax)
+
+from Configurables import CompareCaloCells, CompareCaloClusters
+def compareCells(name, reference, candidate):
+    return CompareCaloCells(name,
+                            reference = reference,
+                            candidate = candidate,
+                            diffFile = "goldenOutput_" + name + ".diff",
+                            **tolerances)
+
+def compareClusters(name, reference, candidate, **options):
+    return CompareCaloClusters(name,
+                               reference = reference,
+                               candidate = candidate,
+                               diffFile = "goldenOutput_" + name + ".diff",
+                               **dict(tolerances, **options))
+
+# Cells without noise, synchronous and asynchronous initialisation
+def createCells(name, cells, **options):
+    return syntheticGrid.createCells(gridTool, name, cells = cells, **options)
+
+cellsReference = createCells("CellsReference", "ReferenceCells", addCellNoise = False, asyncInitialize = False)
+cellsCandidate = createCells("CellsCandidate", "CandidateCells", addCellNoise = False, asyncInitialize = True)
+compareCellsInit = compareCells("CompareCellsInitialize", "ReferenceCells", "CandidateCells")
+
+# Cells with noise, the input of the clustering, and their conversion to a CaloCellSoA and back
+from Configurables import CreateCaloCellSoA, CreateCaloCellsFromSoA
+cellsNoise = createCells("CellsNoise", "SyntheticCells", addCellNoise = True, filterCellNoise = False)
+createCellSoA = CreateCaloCellSoA("CreateCellSoA",
+                                  cells = ["SyntheticCells"],
+                                  time = True,
+                                  positions = True)
+createCellSoA.cellSoA.Path = "SyntheticCellSoA"
+createCellsFromSoA = CreateCaloCellsFromSoA("CreateCellsFromSoA")
+createCellsFromSoA.cellSoA.Path = "SyntheticCellSoA"
+createCellsFromSoA.cells.Path = "SyntheticCellsFromSoA"
+compareCellsSoA = compareCells("CompareCellsSoA", "SyntheticCells", "SyntheticCellsFromSoA")
+
+# Topo-clustering from the cell collection (reference) and from the CaloCellSoA
+from Configurables import CaloCellSoAInputTool, CaloTopoCluster
+createEmptyCells = syntheticGrid.createEmptyCells()
+collectionInput = syntheticGrid.topoClusterInput
+
+soaInput = CaloCellSoAInputTool("TopoInputSoA")
+soaInput.cellSoA.Path = "SyntheticCellSoA"
+
+def topoClustering(name, topoInput, **options):
+    createTopoClusters = CaloTopoCluster(name,
+                                         TopoClusterInput = topoInput,
+                                         neigboursTool = gridTool,
+                                         noiseTool = gridTool,
+                                         positionsECalBarrelTool = gridTool,
+                                         positionsHCalBarrelTool = gridTool,
+                                         positionsHCalBarrelNoSegTool = gridTool,
+                                         noSegmentationHCal = False,
+                                         **options)
+    createTopoClusters.clusters.Path = name + "Clusters"
+    createTopoClusters.clusterCells.Path = name + "ClusterCells"
+    return createTopoClusters
+
+topoReference = topoClustering("TopoReference", collectionInput("TopoInputCells", "SyntheticCells"))
+topoSoA = topoClustering("TopoSoA", soaInput)
+compareTopoSoA = compareClusters("CompareTopoSoA", "TopoReferenceClusters", "TopoSoAClusters")
+
+# Cells and topo-clusters in one step, against the separate algorithms on the cells without noise
+from Configurables import CreateCaloCellPositions, CreateCaloTopoClustersFromHits
+summaries = dict(minEnergyFullCluster = 1.)
+positionsReference = CreateCaloCellPositions("FusedReferencePositions",
+                                             positionsECalBarrelTool = gridTool,
+                                             hits = "ReferenceCells",
+                                             positionedHits = "FusedReferenceCells")
+topoFusedReference = topoClustering("FusedReference", collectionInput("FusedReferenceInput", "FusedReferenceCells"),
+                                    **summaries)
+topoFusedReference.clusterSummaries.Path = "FusedReferenceClusterSummaries"
+topoFused = CreateCaloTopoClustersFromHits("Fused",
+                                           doCellCalibration = True,
+                                           calibTool = syntheticGrid.calibTool(),
+                                           addCellNoise = False,
+                                           noiseTool = syntheticGrid.noiseTool(),
+                                           geometryTool = gridTool,
+                                           positionsTool = gridTool,
+                                           noiseMapTool = gridTool,
+                                           neigboursTool = gridTool,
+                                           hits = "SyntheticHits",
+                                           cells = "FusedCells",
+                                           **summaries)
+topoFused.clusters.Path = "FusedClusters"
+topoFused.clusterCells.Path = "FusedClusterCells"
+topoFused.clusterSummaries.Path = "FusedClusterSummaries"
+compareFusedCells = compareCells("CompareFusedCells", "FusedReferenceCells", "FusedCells")
+compareFusedClusters = compareClusters("CompareFusedClusters", "FusedReferenceClusters", "FusedClusters")
+compareFusedSummaries = compareClusters("CompareFusedSummaries", "FusedReferenceClusterSummaries",
+                                        "FusedClusterSummaries", compareCells = False)
+
+# Topo-clustering for several threshold configurations in one algorithm, against one CaloTopoCluster per configuration
+from Configurables import CaloTopoClusterMultiThreshold
+thresholds = [(4, 2, 0), (4, 2, 2), (6, 3, 0)]
+def thresholdsName(seed, neighbour, last):
+    return "Topo%d%d%d" % (seed, neighbour, last)
+
+topoThresholds = [topoClustering(thresholdsName(*t) + "Reference",
+                                 collectionInput(thresholdsName(*t) + "Input", "SyntheticCells"),
+                                 seedSigma = t[0], neighbourSigma = t[1], lastNeighbourSigma = t[2])
+                  for t in thresholds]
+topoMultiThreshold = CaloTopoClusterMultiThreshold("TopoMultiThreshold",
+                                                   TopoClusterInput = collectionInput("TopoInputMultiThreshold",
+                                                                                      "SyntheticCells"),
+                                                   neigboursTool = gridTool,
+                                                   noiseTool = gridTool,
+                                                   positionsECalBarrelTool = gridTool,
+                                                   positionsHCalBarrelTool = gridTool,
+                                                   positionsHCalBarrelNoSegTool = gridTool,
+                                                   noSegmentationHCal = False,
+                                                   seedSigma = [t[0] for t in thresholds],
+                                                   neighbourSigma = [t[1] for t in thresholds],
+                                                   lastNeighbourSigma = [t[2] for t in thresholds],
+                                                   clusters = [thresholdsName(*t) + "MultiThresholdClusters"
+                                                               for t in thresholds],
+                                                   clusterCells = [thresholdsName(*t) + "MultiThresholdClusterCells"
+                                                                   for t in thresholds])
+compareMultiThreshold = [compareClusters("Compare" + thresholdsName(*t) + "MultiThreshold",
+                                         thresholdsName(*t) + "ReferenceClusters",
+                                         thresholdsName(*t) + "MultiThresholdClusters")
+                         for t in thresholds]
+
+# Cluster splitting without budget (reference) and with a budget never reached
+from Configurables import SplitClusters
+def splitting(name, **budget):
+    return SplitClusters(name,
+                         clusters = "TopoReferenceClusters",
+                         outClusters = name + "Clusters",
+                         outCells = name + "ClusterCells",
+                         neigboursTool = gridTool,
+                         positionsECalBarrelTool = gridTool,
+                         positionsHCalBarrelTool = gridTool,
+                         positionsHCalBarrelNoSegTool = gridTool,
+                         noSegmentationHCal = False,
+                         threshold = 0.01,
+                         **budget)
+
+splitReference = splitting("SplitReference")
+splitBudget = splitting("SplitBudget",
+                        maxNeighbourLookups = 10000000,
+                        maxClusterCells = 1000000,
+                        maxEventTime = 600000.)
+compareSplit = compareClusters("CompareSplit", "SplitReferenceClusters", "SplitBudgetClusters")
+
+# Sliding window clustering, the reference clusters have no cells: matched by position, the cells are not compared
+from Configurables import CreateCaloClustersSlidingWindow
+from Configurables import SyntheticCaloTowerTool
+towers = SyntheticCaloTowerTool("SyntheticTowers", **syntheticGrid.geometry(grid, etaMax))
+towers.cells.Path = "SyntheticCells"
+def slidingWindow(name, **options):
+    createClusters = CreateCaloClustersSlidingWindow(name,
+                                                     towerTool = towers,
+                                                     nEtaWindow = 5, nPhiWindow = 9,
+                                                     nEtaPosition = 3, nPhiPosition = 3,
+                                                     nEtaDuplicates = 3, nPhiDuplicates = 5,
+                                                     nEtaFinal = 5, nPhiFinal = 9,
+                                                     energyThreshold = 5,
+                                                     **options)
+    createClusters.clusters.Path = name + "Clusters"
+    createClusters.clusterCells.Path = name + "ClusterCells"
+    return createClusters
+
+slidingWindowReference = slidingWindow("SlidingWindowReference")
+slidingWindowCells = slidingWindow("SlidingWindowCells", attachCells = True)
+compareSlidingWindow = compareClusters("CompareSlidingWindow", "SlidingWindowReferenceClusters",
+                                       "SlidingWindowCellsClusters", compareCells = False)
+
+algorithms = [createHits,
+              cellsReference, cellsCandidate, compareCellsInit,
+              cellsNoise, createCellSoA, createCellsFromSoA, compareCellsSoA,
+              createEmptyCells, topoReference, topoSoA, compareTopoSoA,
+              positionsReference, topoFusedReference, topoFused,
+              compareFusedCells, compareFusedClusters, compareFusedSummaries] + \
+             topoThresholds + [topoMultiThreshold] + compareMultiThreshold + \
+             [splitReference, splitBudget, compareSplit,
+              slidingWindowReference, slidingWindowCells, compareSlidingWindow]
+
+# Times of the reference and candidate algorithms
+from Configurables import AuditorSvc, ChronoAuditor
+chra = ChronoAuditor()
+audsvc = AuditorSvc()
+audsvc.Auditors = [chra]
+timed = [cellsReference, cellsCandidate, createCellSoA, createCellsFromSoA, topoReference, topoSoA,
+         positionsReference, topoFusedReference, topoFused] + topoThresholds + \
+        [topoMultiThreshold, splitReference, splitBudget, slidingWindowReference, slidingWindowCells]
+for alg in timed:
+    alg.AuditExecute = True
+report.algorithms = [alg.name() for alg in timed]
+
+# Export of the counters
+from Configurables import Gaudi__Monitoring__JSONSink as JSONSink
+ApplicationMgr(TopAlg = [report] + algorithms,
+               EvtSel = 'NONE',
+               EvtMax = num_events,
+               ExtSvc = [podioevent, audsvc, JSONSink(FileName = outputFile)],
+               OutputLevel = INFO
+               )
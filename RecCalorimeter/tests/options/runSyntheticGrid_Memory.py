@@ -0,0 +1,66 @@
+# Memory accounting of the reconstruction on a small synthetic grid (see runSyntheticGrid_Benchmarks.py): the estimated
+# memory of the neighbours and noise maps at initialize and the per-event memory of the transient containers of
+# CreateCaloCells, CaloTopoCluster and SplitClusters are exported with the JSON sink to memory_syntheticGrid.json and
+# checked by RecCalorimeter/tests/scripts/checkSyntheticGridMemory.py.
+# The check script assumes the same grid dimensions (smallGrid of syntheticGrid.py).
+outputFile = "memory_syntheticGrid.json"
+
+from Gaudi.Configuration import *
+from Configurables import ApplicationMgr, FCCDataSvc
+podioevent = FCCDataSvc("EventDataSvc")
+
+import os, sys
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import syntheticGrid
+createHits = syntheticGrid.createSyntheticHits(syntheticGrid.smallGrid,
+                                               numShowers = 2,
+                                               showerEnergy = 20.,
+                                               pileup = 10,
+                                               pileupHitsPerEvent = 20,
+                                               pileupHitEnergy = 0.05)
+gridTool = syntheticGrid.syntheticGridTool(syntheticGrid.smallGrid, syntheticGrid.smallEtaMax)
+
+# All cells of the grid, with noise
+createCells = syntheticGrid.createCells(gridTool)
+
+# Topo-clustering and splitting
+from Configurables import CaloTopoCluster
+createEmptyCells = syntheticGrid.createEmptyCells()
+topoInput = syntheticGrid.topoClusterInput("TopoInput")
+
+createTopoClusters = CaloTopoCluster("CreateTopoClusters",
+                                     TopoClusterInput = topoInput,
+                                     neigboursTool = gridTool,
+                                     noiseTool = gridTool,
+                                     positionsECalBarrelTool = gridTool,
+                                     positionsHCalBarrelTool = gridTool,
+                                     positionsHCalBarrelNoSegTool = gridTool,
+                                     noSegmentationHCal = False)
+createTopoClusters.clusters.Path = "SyntheticTopoClusters"
+createTopoClusters.clusterCells.Path = "SyntheticTopoClusterCells"
+
+from Configurables import SplitClusters
+splitClusters = SplitClusters("SplitClusters",
+                              clusters = "SyntheticTopoClusters",
+                              outClusters = "SyntheticSplitClusters",
+                              outCells = "SyntheticSplitClusterCells",
+                              neigboursTool = gridTool,
+                              positionsECalBarrelTool = gridTool,
+                              positionsHCalBarrelTool = gridTool,
+                              positionsHCalBarrelNoSegTool = gridTool,
+                              noSegmentationHCal = False,
+                              threshold = 0.01)
+
+# Export of the counters
+from Configurables import Gaudi__Monitoring__JSONSink as JSONSink
+ApplicationMgr(TopAlg = [createHits,
+                         createCells,
+                         createEmptyCells,
+                         createTopoClusters,
+                         splitClusters
+                         ],
+               EvtSel = 'NONE',
+               EvtMax = 5,
+               ExtSvc = [podioevent, JSONSink(FileName = outputFile)],
+               OutputLevel = INFO
+               )
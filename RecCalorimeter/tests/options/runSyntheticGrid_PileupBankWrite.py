@@ -0,0 +1,33 @@
+# Pileup bank on a small synthetic grid (see runSyntheticGrid_Benchmarks.py): the hits of minimum-bias events (pileup
+# hits only) are merged into the cells of the grid, 10 events per entry of the bank, and written to
+# pileupBank_syntheticGrid.bin, which is overlaid on signal events by runSyntheticGrid_PileupOverlay.py.
+from Gaudi.Configuration import *
+from Configurables import ApplicationMgr, FCCDataSvc
+podioevent = FCCDataSvc("EventDataSvc")
+
+import os, sys
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import syntheticGrid
+createMinBias = syntheticGrid.createSyntheticHits(syntheticGrid.smallGrid, "CreateMinBiasHits", "MinBiasHits",
+                                                  numShowers = 0,
+                                                  pileup = 1,
+                                                  pileupHitsPerEvent = 20,
+                                                  pileupHitEnergy = 0.05,
+                                                  seed = 4321)
+gridTool = syntheticGrid.syntheticGridTool(syntheticGrid.smallGrid, syntheticGrid.smallEtaMax)
+
+from Configurables import WriteCaloPileupBank
+writeBank = WriteCaloPileupBank("WritePileupBank",
+                                hits = "MinBiasHits",
+                                geometryTool = gridTool,
+                                filename = "pileupBank_syntheticGrid.bin",
+                                pileup = 10)
+
+ApplicationMgr(TopAlg = [createMinBias,
+                         writeBank
+                         ],
+               EvtSel = 'NONE',
+               EvtMax = 40,
+               ExtSvc = [podioevent],
+               OutputLevel = INFO
+               )
@@ -0,0 +1,34 @@
+# Overlay of the pileup bank written by runSyntheticGrid_PileupBankWrite.py on signal events of the same synthetic
+# grid: OverlayCaloPileupCells merges the signal hits into cells and adds a random entry of the bank, CreateCaloCells
+# applies the calibration and the noise to the merged cells.
+from Gaudi.Configuration import *
+from Configurables import ApplicationMgr, FCCDataSvc
+podioevent = FCCDataSvc("EventDataSvc")
+
+import os, sys
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import syntheticGrid
+createHits = syntheticGrid.createSyntheticHits(syntheticGrid.smallGrid,
+                                               numShowers = 2,
+                                               showerEnergy = 20.,
+                                               pileup = 0)
+gridTool = syntheticGrid.syntheticGridTool(syntheticGrid.smallGrid, syntheticGrid.smallEtaMax)
+
+from Configurables import OverlayCaloPileupCells
+overlay = OverlayCaloPileupCells("OverlayPileup",
+                                 hits = "SyntheticHits",
+                                 mergedHits = "SyntheticHitsWithPileup",
+                                 geometryTool = gridTool,
+                                 filename = "pileupBank_syntheticGrid.bin")
+
+createCells = syntheticGrid.createCells(gridTool, hits = "SyntheticHitsWithPileup")
+
+ApplicationMgr(TopAlg = [createHits,
+                         overlay,
+                         createCells
+                         ],
+               EvtSel = 'NONE',
+               EvtMax = 5,
+               ExtSvc = [podioevent],
+               OutputLevel = INFO
+               )
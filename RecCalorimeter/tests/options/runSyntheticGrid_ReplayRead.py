@@ -0,0 +1,23 @@
+# Read throughput of the replay files written by runSyntheticGrid_ReplayWrite.py: each file is read into a
+# CalorimeterHitCollection by ReadCaloCellReplay, which prints at the end the cells and bytes read per second
+# (counter "Time read [us]" for the time per event).
+import os
+
+num_events = int(os.environ.get("BENCHMARK_EVENTS", 20))
+
+from Gaudi.Configuration import *
+from Configurables import ApplicationMgr, FCCDataSvc
+podioevent = FCCDataSvc("EventDataSvc")
+
+from Configurables import ReadCaloCellReplay
+readers = [ReadCaloCellReplay("ReadReplay" + name.capitalize(),
+                              filename = "cellReplay_syntheticGrid_" + name + ".bin",
+                              cells = ["Cells" + name.capitalize()])
+           for name in ["raw", "delta", "quantised"]]
+
+ApplicationMgr(TopAlg = readers,
+               EvtSel = 'NONE',
+               EvtMax = num_events,
+               ExtSvc = [podioevent],
+               OutputLevel = INFO
+               )
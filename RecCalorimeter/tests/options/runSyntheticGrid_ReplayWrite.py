@@ -0,0 +1,58 @@
+# Size of the stored cells on a synthetic grid (see runSyntheticGrid_Benchmarks.py): the cells with noise of all cells
+# of the grid are written to replay files with raw cellIDs and float energies, with delta-coded cellIDs, and with
+# delta-coded cellIDs and quantised energies, and to a podio file as CalorimeterHitCollection.
+# The writers print the bytes per cell at the end, runSyntheticGrid_ReplayRead.py reads the replay files back.
+import os
+
+num_events = int(os.environ.get("BENCHMARK_EVENTS", 20))
+# step of the quantised energies, well below the noise
+energyPrecision = 1e-5
+
+from Gaudi.Configuration import *
+from Configurables import ApplicationMgr, FCCDataSvc, PodioOutput
+podioevent = FCCDataSvc("EventDataSvc")
+
+import sys
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import syntheticGrid
+grid = syntheticGrid.largeGrid
+etaMax = syntheticGrid.largeEtaMax
+createHits = syntheticGrid.createSyntheticHits(grid,
+                                               numShowers = 5,
+                                               showerEnergy = 50.,
+                                               pileup = 200,
+                                               pileupHitsPerEvent = 100,
+                                               pileupHitEnergy = 0.05)
+gridTool = syntheticGrid.syntheticGridTool(grid, etaMax)
+createCells = syntheticGrid.createCells(gridTool)
+
+from Configurables import WriteCaloCellReplay
+writeRaw = WriteCaloCellReplay("WriteReplayRaw",
+                               cells = ["SyntheticCells"],
+                               filename = "cellReplay_syntheticGrid_raw.bin",
+                               deltaCoding = False)
+writeDelta = WriteCaloCellReplay("WriteReplayDelta",
+                                 cells = ["SyntheticCells"],
+                                 filename = "cellReplay_syntheticGrid_delta.bin",
+                                 deltaCoding = True)
+writeQuantised = WriteCaloCellReplay("WriteReplayQuantised",
+                                     cells = ["SyntheticCells"],
+                                     filename = "cellReplay_syntheticGrid_quantised.bin",
+                                     deltaCoding = True,
+                                     energyPrecision = energyPrecision)
+
+out = PodioOutput("out", filename = "cells_syntheticGrid.root")
+out.outputCommands = ["drop *", "keep SyntheticCells"]
+
+ApplicationMgr(TopAlg = [createHits,
+                         createCells,
+                         writeRaw,
+                         writeDelta,
+                         writeQuantised,
+                         out
+                         ],
+               EvtSel = 'NONE',
+               EvtMax = num_events,
+               ExtSvc = [podioevent],
+               OutputLevel = INFO
+               )
@@ -0,0 +1,49 @@
+# Placement of the neighbours and noise maps in memory (see LargeTableMemory.h), on the default synthetic grid (see
+# runSyntheticGrid_Benchmarks.py). The maps of one SyntheticCaloGridTool per policy are read by TimeCaloTableLookups
+# from several threads: default placement with 4 kB pages, with transparent huge pages, interleaved over the NUMA
+# nodes, replicated per NUMA node, and with explicit huge pages (transparent huge pages if none are reserved).
+# The counters are exported with the JSON sink to tablePlacement_syntheticGrid.json and compared by
+# RecCalorimeter/tests/scripts/checkSyntheticGridTablePlacement.py. The effect of the placement is only visible on
+# nodes with several NUMA nodes, with as many threads as cores (BENCHMARK_THREADS).
+import os
+
+num_events = int(os.environ.get("BENCHMARK_EVENTS", 5))
+num_threads = int(os.environ.get("BENCHMARK_THREADS", 4))
+outputFile = "tablePlacement_syntheticGrid.json"
+
+from Gaudi.Configuration import *
+from Configurables import ApplicationMgr, FCCDataSvc
+podioevent = FCCDataSvc("EventDataSvc")
+
+import sys
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import syntheticGrid
+grid = syntheticGrid.largeGrid
+
+from Configurables import SyntheticCaloGridTool, TimeCaloTableLookups
+policies = [("Default", "default", "none"),
+            ("TransparentHugePages", "default", "transparent"),
+            ("Interleave", "interleave", "transparent"),
+            ("Replicate", "replicate", "transparent"),
+            ("ExplicitHugePages", "default", "explicit")]
+lookups = []
+for name, placement, hugePages in policies:
+    gridTool = SyntheticCaloGridTool("Grid" + name,
+                                     tablePlacement = placement,
+                                     hugePages = hugePages,
+                                     **grid)
+    lookups.append(TimeCaloTableLookups("Lookups" + name,
+                                        neighboursTool = gridTool,
+                                        noiseTool = gridTool,
+                                        geometryTool = gridTool,
+                                        numThreads = num_threads,
+                                        lookupsPerThread = 1000000))
+
+# Export of the counters
+from Configurables import Gaudi__Monitoring__JSONSink as JSONSink
+ApplicationMgr(TopAlg = lookups,
+               EvtSel = 'NONE',
+               EvtMax = num_events,
+               ExtSvc = [podioevent, JSONSink(FileName = outputFile)],
+               OutputLevel = INFO
+               )
@@ -0,0 +1,45 @@
+# Sliding window clustering on the towers stored by runSyntheticGrid_TowerSummaryWrite.py, without cells: the tower
+# grid is rebuilt by CaloTowerSummaryTool from towerSummary_syntheticGrid.bin. The clusters are compared by
+# CompareCaloClusters with the clusters built on the cells, read from towerSummary_clusters.root; the towers are stored
+# as float and the tower positions are recomputed from the grid in the header, hence the tolerances.
+import os
+
+num_events = int(os.environ.get("BENCHMARK_EVENTS", 5))
+
+from Gaudi.Configuration import *
+from Configurables import ApplicationMgr, FCCDataSvc
+podioevent = FCCDataSvc("EventDataSvc", input = "towerSummary_clusters.root")
+
+from Configurables import PodioInput
+podioinput = PodioInput("PodioReader", collections = ["SyntheticSlidingWindowClusters"])
+
+from Configurables import CaloTowerSummaryTool
+towers = CaloTowerSummaryTool("TowerSummary", filename = "towerSummary_syntheticGrid.bin")
+
+from Configurables import CreateCaloClustersSlidingWindow
+createClusters = CreateCaloClustersSlidingWindow("CreateSlidingWindowClusters",
+                                                 towerTool = towers,
+                                                 nEtaWindow = 5, nPhiWindow = 9,
+                                                 nEtaPosition = 3, nPhiPosition = 3,
+                                                 nEtaDuplicates = 3, nPhiDuplicates = 5,
+                                                 nEtaFinal = 5, nPhiFinal = 9,
+                                                 energyThreshold = 10)
+createClusters.clusters.Path = "SummarySlidingWindowClusters"
+createClusters.clusterCells.Path = "SummarySlidingWindowClusterCells"
+
+from Configurables import CompareCaloClusters
+compareClusters = CompareCaloClusters("CompareTowerSummary",
+                                      reference = "SyntheticSlidingWindowClusters",
+                                      candidate = "SummarySlidingWindowClusters",
+                                      energyTolerance = 1e-5,
+                                      positionTolerance = 0.1,
+                                      compareCells = False,
+                                      diffFile = "towerSummary_clusters.diff")
+
+from Configurables import Gaudi__Monitoring__JSONSink as JSONSink
+ApplicationMgr(TopAlg = [podioinput, createClusters, compareClusters],
+               EvtSel = 'NONE',
+               EvtMax = num_events,
+               ExtSvc = [podioevent, JSONSink(FileName = "towerSummary_read.json")],
+               OutputLevel = INFO
+               )
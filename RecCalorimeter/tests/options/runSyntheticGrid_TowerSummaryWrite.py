@@ -0,0 +1,62 @@
+# Tower summary on a synthetic grid (see runSyntheticGrid_Benchmarks.py): the towers built from the cells with noise by
+# SyntheticCaloTowerTool are written by WriteCaloTowerSummary to towerSummary_syntheticGrid.bin and clustered with the
+# sliding window. runSyntheticGrid_TowerSummaryRead.py runs the same clustering on the stored towers, without cells,
+# and compares its clusters with the clusters of this job, written to towerSummary_clusters.root;
+# checkSyntheticGridTowerSummary.py checks the comparison and the numbers of clusters exported by the JSON sinks.
+import os
+
+num_events = int(os.environ.get("BENCHMARK_EVENTS", 5))
+
+from Gaudi.Configuration import *
+from Configurables import ApplicationMgr, FCCDataSvc, PodioOutput
+podioevent = FCCDataSvc("EventDataSvc")
+
+import sys
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import syntheticGrid
+grid = syntheticGrid.largeGrid
+etaMax = syntheticGrid.largeEtaMax
+createHits = syntheticGrid.createSyntheticHits(grid,
+                                               numShowers = 5,
+                                               showerEnergy = 50.,
+                                               pileup = 200,
+                                               pileupHitsPerEvent = 100,
+                                               pileupHitEnergy = 0.05)
+gridTool = syntheticGrid.syntheticGridTool(grid, etaMax)
+createCells = syntheticGrid.createCells(gridTool)
+
+from Configurables import SyntheticCaloTowerTool
+towers = SyntheticCaloTowerTool("SyntheticTowers", **syntheticGrid.geometry(grid, etaMax))
+towers.cells.Path = "SyntheticCells"
+
+from Configurables import WriteCaloTowerSummary
+writeTowers = WriteCaloTowerSummary("WriteTowerSummary",
+                                    towerTool = towers,
+                                    filename = "towerSummary_syntheticGrid.bin")
+
+from Configurables import CreateCaloClustersSlidingWindow
+createClusters = CreateCaloClustersSlidingWindow("CreateSlidingWindowClusters",
+                                                 towerTool = towers,
+                                                 nEtaWindow = 5, nPhiWindow = 9,
+                                                 nEtaPosition = 3, nPhiPosition = 3,
+                                                 nEtaDuplicates = 3, nPhiDuplicates = 5,
+                                                 nEtaFinal = 5, nPhiFinal = 9,
+                                                 energyThreshold = 10)
+createClusters.clusters.Path = "SyntheticSlidingWindowClusters"
+createClusters.clusterCells.Path = "SyntheticSlidingWindowClusterCells"
+
+out = PodioOutput("out", filename = "towerSummary_clusters.root")
+out.outputCommands = ["drop *", "keep SyntheticSlidingWindowClusters"]
+
+from Configurables import Gaudi__Monitoring__JSONSink as JSONSink
+ApplicationMgr(TopAlg = [createHits,
+                         createCells,
+                         writeTowers,
+                         createClusters,
+                         out
+                         ],
+               EvtSel = 'NONE',
+               EvtMax = num_events,
+               ExtSvc = [podioevent, JSONSink(FileName = "towerSummary_write.json")],
+               OutputLevel = INFO
+               )
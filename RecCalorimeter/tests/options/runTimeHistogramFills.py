@@ -0,0 +1,30 @@
+# Monitoring histograms filled directly and through HistogramFillBuffer (algorithm TimeHistogramFills), without input:
+# the same random fills of TH1D and TH2D histograms, with unit and random weights, are done directly and through the
+# buffer, which is flushed every 1000 fills, every 100000 fills (the default) and only at finalize. Each job fails if
+# a buffered histogram is not identical to its directly filled twin. The counters are exported with the JSON sink to
+# histogramFills.json, checkHistogramFills.py checks them and prints the time of the buffered fills relative to the
+# direct fills.
+import os
+
+num_events = int(os.environ.get("BENCHMARK_EVENTS", 20))
+outputFile = "histogramFills.json"
+
+from Gaudi.Configuration import *
+from Configurables import ApplicationMgr
+
+from Configurables import TimeHistogramFills
+flushSizes = [("FlushSmall", 1000), ("FlushDefault", 100000), ("FlushAtFinalize", 0)]
+fills = [TimeHistogramFills("Fills" + name,
+                            numHistograms = 4,
+                            fillsPerEvent = 100000,
+                            histogramFlushSize = flushSize)
+         for name, flushSize in flushSizes]
+
+# Export of the counters
+from Configurables import Gaudi__Monitoring__JSONSink as JSONSink
+ApplicationMgr(TopAlg = fills,
+               EvtSel = 'NONE',
+               EvtMax = num_events,
+               ExtSvc = [JSONSink(FileName = outputFile)],
+               OutputLevel = INFO
+               )
@@ -0,0 +1,72 @@
+# Common fixture of the jobs on a synthetic calorimeter grid (runSyntheticGrid_*.py), which need neither geometry nor
+# input files: the grids, the synthetic events (CreateSyntheticCaloHits), the grid tool (SyntheticCaloGridTool, also
+# used as neighbours, noise and positions tool), the cells (CreateCaloCells with calibration and flat noise) and the
+# input of the topo-clustering with the cells of the grid as the only calorimeter.
+# The options files import it from their own directory:
+#   import os, sys
+#   sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+#   import syntheticGrid
+from Configurables import CreateSyntheticCaloHits, SyntheticCaloGridTool
+from Configurables import CreateCaloCells, CalibrateCaloHitsTool, NoiseCaloCellsFlatTool
+from Configurables import CreateEmptyCaloCellsCollection, CaloTopoClusterInputTool
+
+# Barrel of full size, 8 layers of 150 x 352 cells in eta x phi
+largeGrid = dict(systemId = 5, numLayers = 8, numEta = 150, numPhi = 352)
+largeEtaMax = 1.5
+# Small barrel of the quick tests
+smallGrid = dict(systemId = 5, numLayers = 4, numEta = 20, numPhi = 32)
+smallEtaMax = 0.4
+rMin = 1920.
+layerDepth = 50.
+samplingFraction = 0.15
+cellNoise = 0.003
+
+def geometry(grid, etaMax):
+    """Properties of the grid geometry, for SyntheticCaloGridTool and SyntheticCaloTowerTool"""
+    return dict(grid, etaMax = etaMax, rMin = rMin, layerDepth = layerDepth)
+
+def createSyntheticHits(grid, name = "CreateSyntheticHits", hits = "SyntheticHits", **events):
+    """Synthetic events on the grid, written to the collection 'hits'"""
+    createHits = CreateSyntheticCaloHits(name, samplingFraction = samplingFraction, **dict(grid, **events))
+    createHits.hits.Path = hits
+    return createHits
+
+def syntheticGridTool(grid, etaMax, name = "SyntheticGrid", **options):
+    """Geometry, neighbours, noise and positions tool of the grid, with the noise of the cells"""
+    return SyntheticCaloGridTool(name, cellNoise = cellNoise, **dict(geometry(grid, etaMax), **options))
+
+def calibTool():
+    return CalibrateCaloHitsTool("Calibrate", invSamplingFraction = 1. / samplingFraction)
+
+def noiseTool():
+    return NoiseCaloCellsFlatTool("Noise", cellNoise = cellNoise)
+
+def createCells(gridTool, name = "CreateCells", hits = "SyntheticHits", cells = "SyntheticCells", **options):
+    """Calibrated cells with noise, all cells kept unless 'options' say otherwise"""
+    settings = dict(doCellCalibration = True, addCellNoise = True, filterCellNoise = False)
+    settings.update(options)
+    return CreateCaloCells(name,
+                           calibTool = calibTool(),
+                           noiseTool = noiseTool(),
+                           geometryTool = gridTool,
+                           hits = hits,
+                           cells = cells,
+                           **settings)
+
+def createEmptyCells():
+    """Empty cell collection 'emptyCaloCells', the input of the other calorimeters of the topo-clustering"""
+    createEmptyCells = CreateEmptyCaloCellsCollection("CreateEmptyCaloCells")
+    createEmptyCells.cells.Path = "emptyCaloCells"
+    return createEmptyCells
+
+def topoClusterInput(name, cells = "SyntheticCells"):
+    """Input of the topo-clustering: the cells of the grid as ECal barrel, no cells in the other calorimeters"""
+    topoInput = CaloTopoClusterInputTool(name)
+    topoInput.ecalBarrelCells.Path = cells
+    topoInput.ecalEndcapCells.Path = "emptyCaloCells"
+    topoInput.ecalFwdCells.Path = "emptyCaloCells"
+    topoInput.hcalBarrelCells.Path = "emptyCaloCells"
+    topoInput.hcalExtBarrelCells.Path = "emptyCaloCells"
+    topoInput.hcalEndcapCells.Path = "emptyCaloCells"
+    topoInput.hcalFwdCells.Path = "emptyCaloCells"
+    return topoInput
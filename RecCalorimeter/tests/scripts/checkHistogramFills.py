@@ -0,0 +1,27 @@
+# Check of the histograms filled through HistogramFillBuffer (runTimeHistogramFills.py): no buffered histogram may
+# differ from its directly filled twin, and the time of the buffered fills (final flush included) is printed relative
+# to the time of the direct fills. The counters are read from the JSON sink of the job.
+import sys
+
+from syntheticGridCounters import Counters
+
+jsonFile = sys.argv[1] if len(sys.argv) > 1 else "histogramFills.json"
+components = ["FillsFlushSmall", "FillsFlushDefault", "FillsFlushAtFinalize"]
+
+counter = Counters(jsonFile)
+for component in components:
+    # the counters without any difference may be left out by the sink
+    differences = counter(component, "Histogram differences", {"nEntries": 0})
+    if differences["nEntries"] != 0:
+        sys.exit("Histogram fills check failed: %d buffered histograms of %s differ from the direct fills" %
+                 (differences["nEntries"], component))
+
+print("%-22s %14s %14s %8s" % ("", "direct [us]", "buffered [us]", "ratio"))
+for component in components:
+    direct = counter(component, "Time direct fills [us]")
+    buffered = counter(component, "Time buffered fills [us]")
+    flush = counter(component, "Time final flush [us]")
+    events = max(direct["nEntries"], 1)
+    bufferedSum = buffered["sum"] + flush["sum"]
+    print("%-22s %14.0f %14.0f %8.2f" % (component, direct["sum"] / events, bufferedSum / events,
+                                        bufferedSum / direct["sum"] if direct["sum"] > 0 else 0.))
@@ -0,0 +1,43 @@
+# Check of the positioned cells of runSyntheticGrid_CellPositions.py: the cells filled in batch, with and without the
+# position cache, have to be identical to the cloned cells, in the same order. The leaves of the podio file are read
+# directly, without the datamodel dictionaries. The times of the three modes are read from the JSON sink of the job.
+import sys
+
+import ROOT
+
+from syntheticGridCounters import Counters
+
+rootFile = sys.argv[1] if len(sys.argv) > 1 else "cellPositions_syntheticGrid.root"
+jsonFile = sys.argv[2] if len(sys.argv) > 2 else "cellPositions_syntheticGrid.json"
+reference = "PositionedCellsClone"
+compared = ["PositionedCellsBatch", "PositionedCellsBatchNoCache"]
+members = ["cellID", "energy", "energyError", "time", "position.x", "position.y", "position.z", "type"]
+
+f = ROOT.TFile.Open(rootFile)
+tree = f.Get("events")
+numCells = 0
+for iEvent in range(tree.GetEntries()):
+    tree.GetEntry(iEvent)
+    for member in members:
+        referenceLeaf = tree.GetLeaf(reference + "." + member)
+        for collection in compared:
+            leaf = tree.GetLeaf(collection + "." + member)
+            if leaf.GetLen() != referenceLeaf.GetLen():
+                sys.exit("Event %d: %d cells in %s, %d in %s" %
+                         (iEvent, referenceLeaf.GetLen(), reference, leaf.GetLen(), collection))
+            for i in range(referenceLeaf.GetLen()):
+                if leaf.GetValue(i) != referenceLeaf.GetValue(i):
+                    sys.exit("Event %d, cell %d: %s %g in %s, %g in %s" %
+                             (iEvent, i, member, referenceLeaf.GetValue(i), reference, leaf.GetValue(i), collection))
+    numCells += tree.GetLeaf(reference + ".cellID").GetLen()
+f.Close()
+
+counter = Counters(jsonFile)
+
+def mean(component, name):
+    entity = counter(component, name)
+    return entity["sum"] / max(entity["nEntries"], 1)
+
+print("Positioned cells identical in %d events (%d cells)" % (tree.GetEntries(), numCells))
+for component in ["PositionsClone", "PositionsBatch", "PositionsBatchNoCache"]:
+    print("%-22s %10.0f us per event" % (component, mean(component, "Time positions [us]")))
@@ -0,0 +1,23 @@
+# Check of the cells exchanged as structure of arrays (runSyntheticGrid_CellSoA.py): the topo-clustering of the
+# CaloCellSoA and of the collection converted back from it has to find the same cells, seeds and clusters as the
+# topo-clustering of the original cell collection. The counters are read from the JSON sink of the job.
+import sys
+
+from syntheticGridCounters import Counters
+
+jsonFile = sys.argv[1] if len(sys.argv) > 1 else "cellSoA_syntheticGrid.json"
+
+counter = Counters(jsonFile)
+
+for name in ["Cells", "Seeds", "Clusters"]:
+    reference = counter("TopoFromCells", name)
+    for component in ["TopoFromSoA", "TopoFromSoACells"]:
+        entity = counter(component, name)
+        if entity["nEntries"] != reference["nEntries"] or entity["sum"] != reference["sum"]:
+            sys.exit("Cell SoA check failed: %s %d in %d events from the cells, %d in %d events in %s" %
+                     (name, reference["sum"], reference["nEntries"], entity["sum"], entity["nEntries"], component))
+
+cells = counter("CreateCellSoA", "Cells")
+memory = counter("CreateCellSoA", "Memory cell SoA [kB]")
+print("Cell SoA: %.0f cells and %.1f kB per event, same topo-clusters as from the cell collection" %
+      (cells["sum"] / max(cells["nEntries"], 1), memory["sum"] / max(memory["nEntries"], 1)))
@@ -0,0 +1,27 @@
+# Check of the concurrent lookups (runSyntheticGrid_ConcurrentLookups.py): the maps read from the files, at initialize
+# or at the first lookup, have to give the same neighbours and noise as the maps of the grid tool, and the cells that
+# are not in the maps no neighbours and no noise. The counters are read from the JSON sink of the job.
+import sys
+
+from syntheticGridCounters import Counters
+
+jsonFile = sys.argv[1] if len(sys.argv) > 1 else "concurrentLookups_syntheticGrid.json"
+
+counter = Counters(jsonFile)
+
+for name in ["Neighbour IDs", "Noise sum"]:
+    expected = counter("LookupsReference", name)
+    if expected["nEntries"] == 0 or expected["sum"] <= 0:
+        sys.exit("Concurrent lookups check failed: no %s in the reference" % name)
+    for lookups in ["LookupsFiles", "LookupsLazy"]:
+        entity = counter(lookups, name)
+        if (entity["nEntries"] != expected["nEntries"] or
+                abs(entity["sum"] - expected["sum"]) > 1e-9 * abs(expected["sum"])):
+            sys.exit("Concurrent lookups check failed: %s %g in %d events in the reference, %g in %d events with %s" %
+                     (name, expected["sum"], expected["nEntries"], entity["sum"], entity["nEntries"], lookups))
+    misses = counter("LookupsMisses", name)
+    if misses["nEntries"] != expected["nEntries"] or misses["sum"] != 0:
+        sys.exit("Concurrent lookups check failed: %s %g for the cells that are not in the maps" %
+                 (name, misses["sum"]))
+
+print("Concurrent lookups: same neighbours and noise from the files as from the grid tool, none for missing cells")
@@ -0,0 +1,39 @@
+# Check of the per-event budget (runSyntheticGrid_EventBudget.py): with a budget never reached, the topo-clustering
+# has to find the same cells, seeds, neighbour lookups and clusters as without budget, and no event may be flagged;
+# with the tight budgets every event has to be flagged, and the clusters split with a few lookups have to be copied
+# without splitting. The counters are read from the JSON sink of the job.
+import sys
+
+from syntheticGridCounters import Counters
+
+jsonFile = sys.argv[1] if len(sys.argv) > 1 else "eventBudget_syntheticGrid.json"
+
+counter = Counters(jsonFile)
+
+for name in ["Cells", "Seeds", "Neighbour lookups", "Clusters"]:
+    reference = counter("TopoUnlimited", name)
+    entity = counter("TopoLargeBudget", name)
+    if entity["nEntries"] != reference["nEntries"] or entity["sum"] != reference["sum"]:
+        sys.exit("Event budget check failed: %s %d in %d events without budget, %d in %d events with budget" %
+                 (name, reference["sum"], reference["nEntries"], entity["sum"], entity["nEntries"]))
+
+for component in ["TopoLargeBudget", "SplitLargeBudget"]:
+    overBudget = counter(component, "Events over budget")
+    if overBudget["nTrueEntries"] != 0:
+        sys.exit("Event budget check failed: %d events over budget in %s" % (overBudget["nTrueEntries"], component))
+
+for component in ["TopoTightBudget", "SplitTightBudget", "SplitTightLookups"]:
+    overBudget = counter(component, "Events over budget")
+    if overBudget["nEntries"] == 0 or overBudget["nTrueEntries"] != overBudget["nEntries"]:
+        sys.exit("Event budget check failed: %d of %d events over budget in %s" %
+                 (overBudget["nTrueEntries"], overBudget["nEntries"], component))
+
+unsplit = counter("CompareSplitTightLookups", "Events with differences")
+if unsplit["nEntries"] == 0 or unsplit["nTrueEntries"] != 0:
+    sys.exit("Event budget check failed: %d of %d events with clusters split over the lookup budget" %
+             (unsplit["nTrueEntries"], unsplit["nEntries"]))
+
+lookups = counter("TopoUnlimited", "Neighbour lookups")
+tightLookups = counter("TopoTightBudget", "Neighbour lookups")
+print("Event budget: same clusters with a large budget; with the tight budget %.0f instead of %.0f lookups per event" %
+      (tightLookups["sum"] / max(tightLookups["nEntries"], 1), lookups["sum"] / max(lookups["nEntries"], 1)))
@@ -0,0 +1,79 @@
+# Check of the golden-output comparison (runSyntheticGrid_GoldenOutput.py): no comparison may find missing, extra or
+# differing cells or clusters. The differences listed by the comparisons are printed if the check fails, and the
+# times of the candidate algorithms are printed relative to their reference. The counters are read from the JSON sink
+# of the job, the times from the report of ThroughputReport.
+import json
+import os
+import sys
+
+from syntheticGridCounters import Counters
+
+jsonFile = sys.argv[1] if len(sys.argv) > 1 else "goldenOutput_syntheticGrid.json"
+timingFile = sys.argv[2] if len(sys.argv) > 2 else "goldenOutput_timing.json"
+differences = {
+    "CompareCellsInitialize": ["Missing cells", "Extra cells", "Energy differences", "Position differences"],
+    "CompareCellsSoA": ["Missing cells", "Extra cells", "Energy differences", "Position differences"],
+    "CompareTopoSoA": ["Missing clusters", "Extra clusters", "Energy differences", "Position differences",
+                       "Membership differences"],
+    "CompareSplit": ["Missing clusters", "Extra clusters", "Energy differences", "Position differences",
+                     "Membership differences"],
+    "CompareSlidingWindow": ["Missing clusters", "Extra clusters", "Energy differences", "Position differences"],
+    "CompareFusedCells": ["Missing cells", "Extra cells", "Energy differences", "Position differences"],
+    "CompareFusedClusters": ["Missing clusters", "Extra clusters", "Energy differences", "Position differences",
+                             "Membership differences"],
+    "CompareFusedSummaries": ["Missing clusters", "Extra clusters", "Energy differences", "Position differences"],
+}
+# one comparison per configuration of the multi-threshold topo-clustering
+multiThresholdReferences = []
+for thresholds in ["420", "422", "630"]:
+    differences["CompareTopo%sMultiThreshold" % thresholds] = differences["CompareTopoSoA"]
+    multiThresholdReferences.append("Topo%sReference" % thresholds)
+# (reference, candidate) algorithms of each comparison, the times of several references are summed
+timings = {
+    "CompareFused": (["CellsReference", "FusedReferencePositions", "FusedReference"], "Fused"),
+    "CompareMultiThreshold": (multiThresholdReferences, "TopoMultiThreshold"),
+    "CompareCellsInitialize": ("CellsReference", "CellsCandidate"),
+    "CompareTopoSoA": ("TopoReference", "TopoSoA"),
+    "CompareSplit": ("SplitReference", "SplitBudget"),
+    "CompareSlidingWindow": ("SlidingWindowReference", "SlidingWindowCells"),
+}
+maxDiffLines = 20
+
+counter = Counters(jsonFile)
+
+failed = []
+for comparison in sorted(differences):
+    # the counters without any difference may be left out by the sink
+    numbers = [(counter(comparison, name, {"nEntries": 0})["nEntries"], name) for name in differences[comparison]]
+    found = ["%d %s" % (number, name.lower()) for number, name in numbers if number > 0]
+    events = counter(comparison, "Events with differences")
+    if found:
+        failed.append(comparison)
+        print("%s: %s, in %d of %d events" % (comparison, ", ".join(found), events["nTrueEntries"],
+                                              events["nEntries"]))
+        diffFile = "goldenOutput_" + comparison + ".diff"
+        if os.path.exists(diffFile):
+            with open(diffFile) as f:
+                lines = f.readlines()
+            for line in lines[:maxDiffLines]:
+                print("    " + line.rstrip())
+            if len(lines) > maxDiffLines:
+                print("    ... %d more lines in %s" % (len(lines) - maxDiffLines, diffFile))
+    else:
+        print("%s: same output in %d events" % (comparison, events["nEntries"]))
+
+if os.path.exists(timingFile):
+    with open(timingFile) as f:
+        times = json.load(f)["algorithms"]
+    print("Times per job [s]:")
+    for comparison in sorted(timings):
+        reference, candidate = timings[comparison]
+        references = reference if isinstance(reference, list) else [reference]
+        if all(r in times for r in references) and candidate in times:
+            referenceTime = sum(times[r] for r in references)
+            print("  %-24s %-24s %8.3f  %-24s %8.3f (%.2f x)" %
+                  (comparison, " + ".join(references), referenceTime, candidate, times[candidate],
+                   times[candidate] / referenceTime if referenceTime > 0 else 0))
+
+if failed:
+    sys.exit("Golden-output check failed: differences in %s" % ", ".join(failed))
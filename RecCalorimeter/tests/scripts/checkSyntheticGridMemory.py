@@ -0,0 +1,60 @@
+# Check of the memory accounting exported by runSyntheticGrid_Memory.py (JSON sink of the Gaudi counters).
+# The memory of the maps of the synthetic grid is known from its dimensions, the estimates are checked against it.
+import sys
+
+from syntheticGridCounters import Counters
+
+# same grid as in runSyntheticGrid_Memory.py (smallGrid of tests/options/syntheticGrid.py)
+numLayers, numEta, numPhi = 4, 20, 32
+numCells = numLayers * numEta * numPhi
+# size of a pointer, of a cell ID and of an energy
+pointer, cellId, energy = 8, 8, 8
+
+fileName = sys.argv[1] if len(sys.argv) > 1 else "memory_syntheticGrid.json"
+# the tools are named after their owner, e.g. CreateCells.SyntheticGrid
+counter = Counters(fileName, ownedTools = True)
+
+def check(condition, message):
+    if not condition:
+        sys.exit("Memory accounting check failed: " + message)
+
+# neighbours: 3x3x3 cells minus the cell itself, fewer at the first and last layers and eta bins (phi is periodic)
+def numAdjacent(i, n):
+    return (i > 0) + 1 + (i < n - 1)
+numNeighbours = sum(numAdjacent(l, numLayers) * numAdjacent(e, numEta) * 3 - 1
+                    for l in range(numLayers) for e in range(numEta))  * numPhi
+
+neighbours = counter("SyntheticGrid", "Memory neighbours map [kB]")
+check(neighbours["nEntries"] >= 1, "no entry for the neighbours map")
+# at least the neighbour IDs, the map nodes and the buckets
+minNeighbours = (numNeighbours * cellId + numCells * (cellId + 3 * pointer + pointer) + numCells * pointer) / 1024.
+check(minNeighbours <= neighbours["max"] < 2 * minNeighbours,
+      "neighbours map %.1f kB, expected at least %.1f kB" % (neighbours["max"], minNeighbours))
+
+noise = counter("SyntheticGrid", "Memory noise map [kB]")
+minNoise = numCells * (cellId + 2 * energy + 2 * pointer) / 1024.
+check(minNoise <= noise["max"] < 2 * minNoise, "noise map %.1f kB, expected at least %.1f kB" % (noise["max"], minNoise))
+
+# all cells are kept (noise added, not filtered): the cells map of the topo-clustering is an ordered map of all cells
+cellsMap = counter("CreateTopoClusters", "Memory cells map [kB]")
+check(cellsMap["nEntries"] == 5, "%d entries for the cells map of the topo-clustering" % cellsMap["nEntries"])
+expectedCellsMap = numCells * (cellId + energy + 4 * pointer) / 1024.
+check(abs(cellsMap["max"] - expectedCellsMap) < 1e-6 and abs(cellsMap["min"] - expectedCellsMap) < 1e-6,
+      "cells map of the topo-clustering %.1f kB, expected %.1f kB" % (cellsMap["max"], expectedCellsMap))
+
+emptyCells = counter("CreateCells", "Memory empty cells map [kB]")
+cells = counter("CreateCells", "Memory cells map [kB]")
+minCells = numCells * (cellId + energy + pointer) / 1024.
+check(emptyCells["max"] >= minCells, "empty cells map %.1f kB, expected at least %.1f kB" % (emptyCells["max"], minCells))
+check(cells["nEntries"] == 5 and cells["max"] >= minCells,
+      "cells map %.1f kB, expected at least %.1f kB" % (cells["max"], minCells))
+
+# transient containers of the clustering, only recorded
+for component, name in [("CreateTopoClusters", "Memory proto-clusters [kB]"),
+                        ("SplitClusters", "Memory cluster maps [kB]"),
+                        ("SplitClusters", "Memory output cells [kB]")]:
+    entity = counter(component, name)
+    check(entity["nEntries"] == 5 and entity["min"] >= 0, "%s of %s" % (name, component))
+
+print("Memory accounting on the synthetic grid: neighbours map %.1f kB, noise map %.1f kB, cells map %.1f kB" %
+      (neighbours["max"], noise["max"], cellsMap["max"]))
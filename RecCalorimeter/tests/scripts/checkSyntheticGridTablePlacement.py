@@ -0,0 +1,33 @@
+# Check of the placement of the maps (runSyntheticGrid_TablePlacement.py): all policies have to read the same
+# neighbours and noise, the time per lookup of each policy is printed relative to the default placement.
+# The counters are read from the JSON sink of the job.
+import sys
+
+from syntheticGridCounters import Counters
+
+jsonFile = sys.argv[1] if len(sys.argv) > 1 else "tablePlacement_syntheticGrid.json"
+reference = "Default"
+policies = ["TransparentHugePages", "Interleave", "Replicate", "ExplicitHugePages"]
+
+counter = Counters(jsonFile)
+
+for policy in policies:
+    for name in ["Neighbour IDs", "Noise sum"]:
+        expected = counter("Lookups" + reference, name)
+        entity = counter("Lookups" + policy, name)
+        if (entity["nEntries"] != expected["nEntries"] or
+                abs(entity["sum"] - expected["sum"]) > 1e-9 * abs(expected["sum"])):
+            sys.exit("Table placement check failed: %s %g in %d events with %s, %g in %d events with %s" %
+                     (name, expected["sum"], expected["nEntries"], reference, entity["sum"], entity["nEntries"],
+                      policy))
+
+def meanTime(policy):
+    entity = counter("Lookups" + policy, "Time per lookup [ns]")
+    return entity["sum"] / max(entity["nEntries"], 1)
+
+referenceTime = meanTime(reference)
+print("Table placement: same lookups for all policies; time per lookup %.1f ns with the default placement" %
+      referenceTime)
+for policy in policies:
+    time = meanTime(policy)
+    print("  %-22s %6.1f ns (%.2f x)" % (policy, time, time / referenceTime if referenceTime > 0 else 0))
@@ -0,0 +1,34 @@
+# Check of the tower summary: the sliding window clustering on the stored towers (runSyntheticGrid_TowerSummaryRead.py)
+# has to find the same clusters as on the cells (runSyntheticGrid_TowerSummaryWrite.py), all non-zero towers being
+# stored. The numbers of pre-clusters and clusters are compared from the JSON sinks of both jobs, and the energies and
+# positions of the clusters by CompareCaloClusters in the read job (differences in towerSummary_clusters.diff).
+import sys
+
+from syntheticGridCounters import Counters
+
+writeFile = sys.argv[1] if len(sys.argv) > 1 else "towerSummary_write.json"
+readFile = sys.argv[2] if len(sys.argv) > 2 else "towerSummary_read.json"
+
+writeCounter = Counters(writeFile)
+readCounter = Counters(readFile)
+
+for name in ["Pre-clusters", "Clusters"]:
+    fromCells = writeCounter("CreateSlidingWindowClusters", name)
+    fromSummary = readCounter("CreateSlidingWindowClusters", name)
+    if fromCells["nEntries"] != fromSummary["nEntries"] or fromCells["sum"] != fromSummary["sum"]:
+        sys.exit("Tower summary check failed: %s %d in %d events from the cells, %d in %d events from the towers" %
+                 (name, fromCells["sum"], fromCells["nEntries"], fromSummary["sum"], fromSummary["nEntries"]))
+
+for name in ["Missing clusters", "Extra clusters", "Energy differences", "Position differences"]:
+    # counters without entries may be left out by the sink
+    differences = readCounter("CompareTowerSummary", name, {"nEntries": 0})
+    if differences["nEntries"] != 0:
+        sys.exit("Tower summary check failed: %d %s in the clusters from the towers (see towerSummary_clusters.diff)" %
+                 (differences["nEntries"], name.lower()))
+compared = readCounter("CompareTowerSummary", "Events with differences")
+if compared["nEntries"] == 0:
+    sys.exit("Tower summary check failed: no event compared")
+
+towers = writeCounter("WriteTowerSummary", "Towers")
+print("Tower summary: %.0f towers per event stored, same sliding window clusters as on the cells (energy, position)" %
+      (towers["sum"] / max(towers["nEntries"], 1)))
@@ -0,0 +1,88 @@
+#!/usr/bin/env python
+# Throughput scaling of the reconstruction chain of runSyntheticGrid_Chain.py with the number of processes.
+# For each number of processes n in 1..N, n jobs are started at the same time, each on its own range of synthetic events
+# (BENCHMARK_FIRST_EVENT), and the reports of ThroughputReport are collected: events per second (all events divided by
+# the wall time of the slowest job), time shares of the algorithms and peak RSS of a job.
+# The algorithms are not thread-safe (GaudiAlgorithm with the FCCDataSvc), so the scaling is done with processes.
+#
+# Example:
+#   python runSyntheticChainScaling.py --processes 4 --events 50 --pileup 200 --output scaling.json
+#   python runSyntheticChainScaling.py --processes 1 --reference scaling.json --tolerance 0.1
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+parser = argparse.ArgumentParser(description="Throughput of the synthetic reconstruction chain for 1..N processes")
+parser.add_argument("--processes", type=int, default=1, help="Maximal number of parallel processes")
+parser.add_argument("--events", type=int, default=50, help="Number of events per process")
+parser.add_argument("--pileup", type=int, default=200, help="Number of pileup interactions")
+parser.add_argument("--options", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "options",
+                                                      "runSyntheticGrid_Chain.py"), help="Job options")
+parser.add_argument("--output", default="", help="JSON file with the results")
+parser.add_argument("--reference", default="", help="JSON file with reference results (from --output)")
+parser.add_argument("--tolerance", type=float, default=0.1,
+                    help="Allowed relative loss of events per second with respect to the reference")
+args = parser.parse_args()
+
+results = {}
+workdir = tempfile.mkdtemp(prefix="syntheticChainScaling")
+for numProcesses in range(1, args.processes + 1):
+    jobs = []
+    start = time.time()
+    for iProcess in range(numProcesses):
+        report = os.path.join(workdir, "report_%d_%d.json" % (numProcesses, iProcess))
+        env = dict(os.environ,
+                   BENCHMARK_EVENTS=str(args.events),
+                   BENCHMARK_PILEUP=str(args.pileup),
+                   BENCHMARK_FIRST_EVENT=str(iProcess * args.events),
+                   BENCHMARK_REPORT=report)
+        log = open(os.path.join(workdir, "log_%d_%d.txt" % (numProcesses, iProcess)), "w")
+        jobs.append((subprocess.Popen(["k4run", args.options], env=env, stdout=log, stderr=subprocess.STDOUT), report))
+    reports = []
+    for job, report in jobs:
+        if job.wait() != 0:
+            sys.exit("Job failed, see the logs in " + workdir)
+        with open(report) as f:
+            reports.append(json.load(f))
+    wallTime = time.time() - start
+    numEvents = sum(r["events"] for r in reports)
+    # time shares of the algorithms, summed over the processes
+    loopTime = sum(r["wallTime"] for r in reports)
+    shares = {}
+    for r in reports:
+        for name, algTime in r["algorithms"].items():
+            shares[name] = shares.get(name, 0) + algTime / loopTime
+    result = {"events": numEvents,
+              # the events per second of the event loops, without the initialisation of the jobs
+              "eventsPerSecond": sum(r["eventsPerSecond"] for r in reports),
+              "eventsPerSecondWithInit": numEvents / wallTime,
+              "peakRSSkB": max(r["peakRSSkB"] for r in reports),
+              "shares": shares}
+    results[str(numProcesses)] = result
+    print("%d process(es): %.2f events/s (%.2f events/s including initialisation), peak RSS %.1f MB" %
+          (numProcesses, result["eventsPerSecond"], result["eventsPerSecondWithInit"], result["peakRSSkB"] / 1024.))
+    for name, share in sorted(shares.items(), key=lambda item: -item[1]):
+        print("    %-40s %5.1f %%" % (name, 100 * share))
+
+if args.output:
+    with open(args.output, "w") as f:
+        json.dump(results, f, indent=2)
+
+if args.reference:
+    with open(args.reference) as f:
+        reference = json.load(f)
+    failed = False
+    for numProcesses, result in results.items():
+        if numProcesses not in reference:
+            continue
+        expected = reference[numProcesses]["eventsPerSecond"]
+        if result["eventsPerSecond"] < (1 - args.tolerance) * expected:
+            print("Throughput regression for %s process(es): %.2f events/s, reference %.2f events/s" %
+                  (numProcesses, result["eventsPerSecond"], expected))
+            failed = True
+    if failed:
+        sys.exit(1)
@@ -0,0 +1,26 @@
+# Counters exported by the JSON sink of the jobs on a synthetic grid, read by the check scripts checkSyntheticGrid*.py:
+#   counter = Counters("eventBudget_syntheticGrid.json")
+#   seeds = counter("TopoUnlimited", "Seeds")
+import json
+import sys
+
+class Counters:
+    """Counters of one JSON sink file, looked up by component and name"""
+
+    def __init__(self, fileName, ownedTools = False):
+        # with ownedTools, a tool is also found under the name of its owner, e.g. CreateCells.SyntheticGrid
+        self.fileName = fileName
+        self.ownedTools = ownedTools
+        with open(fileName) as f:
+            self.counters = json.load(f)
+
+    def __call__(self, component, name, default = None):
+        """Entity of the counter, default if given and the counter is missing, exit otherwise"""
+        for c in self.counters:
+            if c["name"] != name:
+                continue
+            if c["component"] == component or (self.ownedTools and c["component"].endswith("." + component)):
+                return c["entity"]
+        if default is not None:
+            return default
+        sys.exit("Counter '%s' of %s not found in %s" % (name, component, self.fileName))
@@ -0,0 +1,60 @@
+# Neighbours and noise maps of a synthetic grid (see SyntheticCaloGrid.h), in the formats read by TopoCaloNeighbours
+# and TopoCaloNoisyCells: one file with the single trees "neighbours" and "noisyCells", one with a tree per system
+# ("neighbours_system<ID>", "noisyCells_system<ID>"). The noise is flat, as in SyntheticCaloGridTool, so that the
+# maps read by the tools match the grid tool with the same dimensions.
+# Usage: writeSyntheticGridMaps.py <file with single trees> <file with trees per system>
+import sys
+from array import array
+import ROOT
+
+singleFile = sys.argv[1] if len(sys.argv) > 1 else "syntheticGrid_maps.root"
+perSystemFile = sys.argv[2] if len(sys.argv) > 2 else "syntheticGrid_mapsPerSystem.root"
+systemId, numLayers, numEta, numPhi = 5, 4, 40, 64
+cellNoise, cellNoiseOffset = 0.003, 0.
+
+def cellId(layer, idEta, idPhi):
+    return systemId | (layer << 4) | (idEta << 12) | (idPhi << 24)
+
+def neighbours(layer, idEta, idPhi):
+    cells = []
+    for iLayer in range(layer - 1, layer + 2):
+        if iLayer < 0 or iLayer >= numLayers:
+            continue
+        for iEta in range(idEta - 1, idEta + 2):
+            if iEta < 0 or iEta >= numEta:
+                continue
+            for iPhi in range(idPhi - 1, idPhi + 2):
+                if (iLayer, iEta, iPhi) != (layer, idEta, idPhi):
+                    cells.append(cellId(iLayer, iEta, (iPhi + numPhi) % numPhi))
+    return cells
+
+def writeMaps(fileName, neighboursTree, noiseTree):
+    outFile = ROOT.TFile(fileName, "RECREATE")
+    readCellId = array("Q", [0])
+    readNeighbours = ROOT.std.vector("unsigned long")()
+    readNoise = array("d", [0.])
+    readNoiseOffset = array("d", [0.])
+    treeNeighbours = ROOT.TTree(neighboursTree, "Neighbours of the cells")
+    treeNeighbours.Branch("cellId", readCellId, "cellId/l")
+    treeNeighbours.Branch("neighbours", readNeighbours)
+    treeNoise = ROOT.TTree(noiseTree, "Noise of the cells")
+    treeNoise.Branch("cellId", readCellId, "cellId/l")
+    treeNoise.Branch("noiseLevel", readNoise, "noiseLevel/D")
+    treeNoise.Branch("noiseOffset", readNoiseOffset, "noiseOffset/D")
+    for layer in range(numLayers):
+        for idEta in range(numEta):
+            for idPhi in range(numPhi):
+                readCellId[0] = cellId(layer, idEta, idPhi)
+                readNeighbours.clear()
+                for neighbour in neighbours(layer, idEta, idPhi):
+                    readNeighbours.push_back(neighbour)
+                readNoise[0] = cellNoise
+                readNoiseOffset[0] = cellNoiseOffset
+                treeNeighbours.Fill()
+                treeNoise.Fill()
+    outFile.Write()
+    outFile.Close()
+
+writeMaps(singleFile, "neighbours", "noisyCells")
+writeMaps(perSystemFile, "neighbours_system%d" % systemId, "noisyCells_system%d" % systemId)
+print("Maps of %d cells written to %s and %s" % (numLayers * numEta * numPhi, singleFile, perSystemFile))
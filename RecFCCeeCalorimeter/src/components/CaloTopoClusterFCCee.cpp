@@ -1,4 +1,5 @@
 #include "CaloTopoClusterFCCee.h"
+#include "../../../RecCalorimeter/src/components/ClusterMomentsAccumulator.h"
 #include "../../../RecCalorimeter/src/components/NoiseCaloCellsFromFileTool.h"
 
 // FCCSW
@@ -112,30 +113,21 @@ StatusCode CaloTopoClusterFCCee::execute() {
   debug() << "Building " << preClusterCollection.size() << " cluster." << endmsg;
   double checkTotEnergy = 0.;
   int clusterWithMixedCells = 0;
-  for (auto i : preClusterCollection) {
+  // accumulator of the cluster moments, its buffers are reused for all clusters
+  ClusterMomentsAccumulator clusterMoments;
+  for (const auto& i : preClusterCollection) {
     edm4hep::MutableCluster cluster;
-    //auto& clusterCore = cluster.core();
-    double posX = 0.;
-    double posY = 0.;
-    double posZ = 0.;
-    double energy = 0.;
-    double deltaR = 0.;
-    std::vector<double> posPhi (i.second.size());
-    std::vector<double> posEta (i.second.size());
-    std::vector<double> vecEnergy (i.second.size());
-    double sumPhi = 0.;
-    double sumEta = 0.;
+    clusterMoments.clear();
+    clusterMoments.reserve(i.second.size());
     std::map<int,int> system;
 
-    for (auto pair : i.second) {
+    for (const auto& pair : i.second) {
       dd4hep::DDSegmentation::CellID cID = pair.first;
-	  // auto cellID = pair.first;
       // get CalorimeterHit by cellID
       auto newCell = edmClusterCells->create();
       newCell.setEnergy(allCells[cID]);
       newCell.setCellID(cID);
       newCell.setType(pair.second);
-      energy += newCell.getEnergy();
 
       // get cell position by cellID
       // identify calo system
@@ -163,43 +155,23 @@ StatusCode CaloTopoClusterFCCee::execute() {
       else
         warning() << "No cell positions tool found for system id " << systemId << ". " << endmsg;
 
-      posX += posCell.X() * newCell.getEnergy();
-      posY += posCell.Y() * newCell.getEnergy();
-      posZ += posCell.Z() * newCell.getEnergy();
-      posPhi.push_back(posCell.Phi());
-      posEta.push_back(posCell.Eta());
-      vecEnergy.push_back(newCell.getEnergy());
-      sumPhi += posCell.Phi() * newCell.getEnergy();
-      sumEta += posCell.Eta() * newCell.getEnergy();
-      
+      clusterMoments.add(newCell.getEnergy(), posCell.X(), posCell.Y(), posCell.Z());
+
       cluster.addToHits(newCell);
       auto er = allCells.erase(cID);
       
       if (er!=1)
 	info() << "Problem in erasing cell ID from map." << endmsg;
     }
-    cluster.setEnergy(energy);
-    cluster.setPosition(edm4hep::Vector3f(posX / energy, posY / energy, posZ / energy));
-    // store deltaR of cluster in time for the moment..
-    sumPhi = sumPhi / energy;
-    sumEta = sumEta / energy;
-    int counter = 0;
-    for (auto entryEta : posEta){
-      deltaR += sqrt(pow(entryEta-sumEta,2) + pow(posEta[counter]-sumPhi,2)) * vecEnergy[counter];
-      counter++;
-    }
-    cluster.addToShapeParameters(deltaR / energy);
+    auto moments = clusterMoments.compute();
+    ClusterMomentsAccumulator::setEnergyAndPosition(moments, cluster);
+    ClusterMomentsAccumulator::addShapeParameters(moments, cluster);
     verbose() << "Cluster energy:     " << cluster.getEnergy() << endmsg;
     checkTotEnergy += cluster.getEnergy();
 
     edmClusters->push_back(cluster);
     if (system.size() > 1)
       clusterWithMixedCells++;
-
-    posPhi.clear();
-    posEta.clear();
-    vecEnergy.clear();
-
   }
 
   m_clusterCellsCollection.put(edmClusterCells);
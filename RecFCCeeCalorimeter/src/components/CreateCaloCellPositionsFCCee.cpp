@@ -31,6 +31,26 @@ CreateCaloCellPositionsFCCee::CreateCaloCellPositionsFCCee(const std::string& na
 StatusCode CreateCaloCellPositionsFCCee::initialize() {
   StatusCode sc = GaudiAlgorithm::initialize();
   if (sc.isFailure()) return sc;
+  if (m_batchPositions) {
+    // the tools are called from several threads, they are retrieved here instead of at their first use
+    for (auto tool : {&m_cellPositionsECalBarrelTool, &m_cellPositionsHCalBarrelTool, &m_cellPositionsHCalExtBarrelTool,
+                      &m_cellPositionsEMECTool, &m_cellPositionsHECTool, &m_cellPositionsEMFwdTool,
+                      &m_cellPositionsHFwdTool}) {
+      if (!tool->empty() && !tool->retrieve()) {
+        error() << "Unable to retrieve the cell positions tool " << tool->typeAndName() << endmsg;
+        return StatusCode::FAILURE;
+      }
+    }
+    large_table::Policy policy;
+    std::string policyError = policy.parse(m_tablePlacement, m_hugePages);
+    if (!policyError.empty()) {
+      error() << policyError << endmsg;
+      return StatusCode::FAILURE;
+    }
+    m_positionCache.configure(policy, m_numThreads);
+    info() << "Positions filled in batch on " << m_numThreads << " threads, "
+           << (m_cachePositions ? "with" : "without") << " cache" << endmsg;
+  }
   return StatusCode::SUCCESS;
 }
 
@@ -41,44 +61,61 @@ StatusCode CreateCaloCellPositionsFCCee::execute() {
   // Initialize output collection
   auto edmPositionedHitCollection = m_positionedHits.createAndPut();
 
-  for (const auto& hit : *hits) {
-    auto positionedHit = hit.clone();
-    dd4hep::DDSegmentation::CellID cellId = positionedHit.getCellID();
-    // identify calo system
-    auto systemId = m_decoder->get(cellId, "system");
-    dd4hep::Position posCell;
-
-    if (systemId == 4)  // ECAL BARREL system id
-      posCell = m_cellPositionsECalBarrelTool->xyzPosition(cellId);
-    else if (systemId == 10)  // HCAL BARREL system id
-      posCell = m_cellPositionsHCalBarrelTool->xyzPosition(cellId);
-    else if (systemId == 9)  // HCAL EXT BARREL system id
-      posCell = m_cellPositionsHCalExtBarrelTool->xyzPosition(cellId);
-    else if (systemId == 6)  // EMEC system id
-      posCell = m_cellPositionsEMECTool->xyzPosition(cellId);
-    else if (systemId == 7)  // HEC system id
-      posCell = m_cellPositionsHECTool->xyzPosition(cellId);
-    else if (systemId == 10)  // EMFWD system id
-      posCell = m_cellPositionsEMFwdTool->xyzPosition(cellId);
-    else if (systemId == 11)  // HFWD system id
-      posCell = m_cellPositionsHFwdTool->xyzPosition(cellId);
-
-    auto edmPos = edm4hep::Vector3f();
-    edmPos.x = posCell.x() / dd4hep::mm;
-    edmPos.y = posCell.y() / dd4hep::mm;
-    edmPos.z = posCell.z() / dd4hep::mm;
-
-    positionedHit.setPosition(edmPos);
-    edmPositionedHitCollection->push_back(positionedHit);
-
-    // Debug information about cell position
-    debug() << "Cell energy (GeV) : " << positionedHit.getEnergy() << "\tcellID " << positionedHit.getCellID() << endmsg;
-    debug() << "Position of cell (mm) : \t" << posCell.x() / dd4hep::mm << "\t" << posCell.y() / dd4hep::mm << "\t"
-            << posCell.z() / dd4hep::mm << endmsg;
+  StageTimer timer(m_timePositions);
+  if (m_batchPositions) {
+    size_t numComputed = m_positionCache.fill(
+        *hits, *edmPositionedHitCollection, [this](uint64_t aCellId) { return positionOf(aCellId); });
+    if (!m_cachePositions) m_positionCache.clear();
+    m_numComputed += numComputed;
+  } else {
+    for (const auto& hit : *hits) {
+      auto positionedHit = hit.clone();
+      dd4hep::DDSegmentation::CellID cellId = positionedHit.getCellID();
+      dd4hep::Position posCell = positionOf(cellId);
+
+      auto edmPos = edm4hep::Vector3f();
+      edmPos.x = posCell.x() / dd4hep::mm;
+      edmPos.y = posCell.y() / dd4hep::mm;
+      edmPos.z = posCell.z() / dd4hep::mm;
+
+      positionedHit.setPosition(edmPos);
+      edmPositionedHitCollection->push_back(positionedHit);
+
+      // Debug information about cell position
+      debug() << "Cell energy (GeV) : " << positionedHit.getEnergy() << "\tcellID " << positionedHit.getCellID()
+              << endmsg;
+      debug() << "Position of cell (mm) : \t" << posCell.x() / dd4hep::mm << "\t" << posCell.y() / dd4hep::mm << "\t"
+              << posCell.z() / dd4hep::mm << endmsg;
+    }
   }
+  timer.stop();
+  m_numCells += hits->size();
 
   debug() << "Output positions collection size: " << edmPositionedHitCollection->size() << endmsg;
   return StatusCode::SUCCESS;
 }
 
+dd4hep::Position CreateCaloCellPositionsFCCee::positionOf(uint64_t aCellId) const {
+  // identify calo system
+  auto systemId = m_decoder->get(aCellId, "system");
+  dd4hep::Position posCell;
+
+  if (systemId == 4)  // ECAL BARREL system id
+    posCell = m_cellPositionsECalBarrelTool->xyzPosition(aCellId);
+  else if (systemId == 10)  // HCAL BARREL system id
+    posCell = m_cellPositionsHCalBarrelTool->xyzPosition(aCellId);
+  else if (systemId == 9)  // HCAL EXT BARREL system id
+    posCell = m_cellPositionsHCalExtBarrelTool->xyzPosition(aCellId);
+  else if (systemId == 6)  // EMEC system id
+    posCell = m_cellPositionsEMECTool->xyzPosition(aCellId);
+  else if (systemId == 7)  // HEC system id
+    posCell = m_cellPositionsHECTool->xyzPosition(aCellId);
+  else if (systemId == 10)  // EMFWD system id
+    posCell = m_cellPositionsEMFwdTool->xyzPosition(aCellId);
+  else if (systemId == 11)  // HFWD system id
+    posCell = m_cellPositionsHFwdTool->xyzPosition(aCellId);
+
+  return posCell;
+}
+
 StatusCode CreateCaloCellPositionsFCCee::finalize() { return GaudiAlgorithm::finalize(); }
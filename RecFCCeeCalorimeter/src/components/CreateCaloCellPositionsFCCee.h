@@ -12,6 +12,9 @@
 #include "edm4hep/CalorimeterHit.h"
 #include "edm4hep/CalorimeterHitCollection.h"
 
+#include "CaloCellPositionCache.h"
+#include "StageTimer.h"
+
 class IGeoSvc;
 
 /** @class CreateCaloCellPositions Reconstruction/RecCalorimeter/src/components/CreateCaloCellPositions.h
@@ -20,6 +23,13 @@ class IGeoSvc;
  *  Retrieve positions of the cells from cell ID.
  *  This algorithm saves the centre position of the volume. Defined for all Calo-Subsystems within tools.
  *
+ *  With "batchPositions" the cells are not cloned: the positions are taken from a cache of the positions of the cells
+ *  seen in the previous events, the missing ones are computed in one pass over the cellIDs (on "numThreads" threads,
+ *  which requires position tools safe to call concurrently), and the positioned cells are created in one pass, in the
+ *  order of the input (see CaloCellPositionCache.h). The time of both modes is recorded in the counter
+ *  "Time positions [us]". The memory of the cache is placed with "tablePlacement" and "hugePages" (see
+ *  LargeTableMemory.h).
+ *
  *  @author Coralie Neubueser
  *
  */
@@ -42,6 +52,9 @@ public:
   StatusCode finalize();
 
 private:
+  /// Position of a cell, from the tool of its system
+  dd4hep::Position positionOf(uint64_t aCellId) const;
+
   /// Handle for tool to get positions in ECal Barrel
   ToolHandle<ICellPositionsTool> m_cellPositionsECalBarrelTool;
   /// Handle for tool to get positions in HCal Barrel and Ext Barrel, no Segmentation
@@ -62,6 +75,27 @@ private:
   DataHandle<edm4hep::CalorimeterHitCollection> m_hits{"hits/hits", Gaudi::DataHandle::Reader, this};
   /// Output collection
   DataHandle<edm4hep::CalorimeterHitCollection> m_positionedHits{"hits/positionedHits", Gaudi::DataHandle::Writer, this};
+  /// Fill the positions in one batch with cached positions instead of cloning each cell
+  Gaudi::Property<bool> m_batchPositions{this, "batchPositions", false,
+                                         "Fill the positions in one batch with cached positions"};
+  /// Number of threads computing the positions missing in the cache (batch mode)
+  Gaudi::Property<unsigned> m_numThreads{this, "numThreads", 1, "Number of threads computing the positions"};
+  /// Keep the positions of the cells for the next events (batch mode)
+  Gaudi::Property<bool> m_cachePositions{this, "cachePositions", true, "Keep the positions for the next events"};
+  /// Placement of the cache over the NUMA nodes (batch mode)
+  Gaudi::Property<std::string> m_tablePlacement{this, "tablePlacement", "default",
+                                                "Placement of the position cache: default, interleave"};
+  /// Page size of the cache (batch mode)
+  Gaudi::Property<std::string> m_hugePages{this, "hugePages", "none",
+                                           "Huge pages for the position cache: none, transparent, explicit"};
+  /// Cache of the cell positions (batch mode)
+  CaloCellPositionCache m_positionCache;
+  /// Number of cells per event
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numCells{this, "Cells"};
+  /// Number of positions computed per event, i.e. not found in the cache (batch mode)
+  Gaudi::Accumulators::StatCounter<unsigned long> m_numComputed{this, "Computed positions"};
+  /// Time to create the positioned cells
+  StageTimer::Counter m_timePositions{this, "Time positions [us]"};
 };
 
 #endif /* DETCOMPONENTS_CREATECELLPOSITIONSFCCEE_H */
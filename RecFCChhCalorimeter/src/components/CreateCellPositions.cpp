@@ -25,6 +25,17 @@ StatusCode CreateCellPositions::initialize() {
     error() << "Unable to retrieve the cell positions tool!!!" << endmsg;
     return StatusCode::FAILURE;
   }
+  if (m_batchPositions) {
+    large_table::Policy policy;
+    std::string policyError = policy.parse(m_tablePlacement, m_hugePages);
+    if (!policyError.empty()) {
+      error() << policyError << endmsg;
+      return StatusCode::FAILURE;
+    }
+    m_positionCache.configure(policy, m_numThreads);
+    info() << "Positions filled in batch on " << m_numThreads << " threads, "
+           << (m_cachePositions ? "with" : "without") << " cache" << endmsg;
+  }
   return StatusCode::SUCCESS;
 }
 
@@ -35,7 +46,19 @@ StatusCode CreateCellPositions::execute() {
   // Initialize output collection
   auto edmPositionedHitCollection = m_positionedHits.createAndPut();
 
-  m_cellPositionsTool->getPositions(*hits, *edmPositionedHitCollection);
+  StageTimer timer(m_timePositions);
+  if (m_batchPositions) {
+    const ICellPositionsTool* positionsTool = m_cellPositionsTool.get();
+    size_t numComputed = m_positionCache.fill(
+        *hits, *edmPositionedHitCollection,
+        [positionsTool](uint64_t aCellId) { return positionsTool->xyzPosition(aCellId); });
+    if (!m_cachePositions) m_positionCache.clear();
+    m_numComputed += numComputed;
+  } else {
+    m_cellPositionsTool->getPositions(*hits, *edmPositionedHitCollection);
+  }
+  timer.stop();
+  m_numCells += hits->size();
 
   debug() << "Output positions collection size: " << edmPositionedHitCollection->size() << endmsg;
   return StatusCode::SUCCESS;
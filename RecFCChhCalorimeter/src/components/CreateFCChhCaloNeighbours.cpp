@@ -4,9 +4,14 @@
 #include "DetCommon/DetUtils.h"
 #include "k4Interface/IGeoSvc.h"
 
+#include "DDSegmentation/BitFieldCoder.h"
+
 #include "TFile.h"
 #include "TTree.h"
 
+#include <algorithm>
+#include <map>
+
 DECLARE_COMPONENT(CreateFCChhCaloNeighbours)
 
 CreateFCChhCaloNeighbours::CreateFCChhCaloNeighbours(const std::string& aName, ISvcLocator* aSL)
@@ -442,19 +447,31 @@ StatusCode CreateFCChhCaloNeighbours::initialize() {
   }
   debug() << "cells with neighbours across Calo boundaries: " << count << endmsg;
 
+  // cells stored in each tree: one tree per system, or a single tree
+  std::map<std::string, std::vector<uint64_t>> cellsOfTree;
+  dd4hep::DDSegmentation::BitFieldCoder decoder(m_systemEncoding);
+  for (const auto& item : map) {
+    std::string treeName = "neighbours";
+    if (m_splitBySystem) treeName += "_system" + std::to_string(decoder.get(item.first, "system"));
+    cellsOfTree[treeName].push_back(item.first);
+  }
   std::unique_ptr<TFile> file(TFile::Open(m_outputFileName.c_str(), "RECREATE"));
   file->cd();
-  TTree tree("neighbours", "Tree with map of neighbours");
-  uint64_t saveCellId;
-  std::vector<uint64_t> saveNeighbours;
-  tree.Branch("cellId", &saveCellId, "cellId/l");
-  tree.Branch("neighbours", &saveNeighbours);
-  for (const auto& item : map) {
-    saveCellId = item.first;
-    saveNeighbours = item.second;
-    tree.Fill();
+  for (auto& cells : cellsOfTree) {
+    std::sort(cells.second.begin(), cells.second.end());
+    TTree tree(cells.first.c_str(), "Tree with map of neighbours");
+    uint64_t saveCellId;
+    std::vector<uint64_t> saveNeighbours;
+    tree.Branch("cellId", &saveCellId, "cellId/l");
+    tree.Branch("neighbours", &saveNeighbours);
+    for (uint64_t cellId : cells.second) {
+      saveCellId = cellId;
+      saveNeighbours = map[cellId];
+      tree.Fill();
+    }
+    tree.Write();
+    info() << "Tree " << cells.first << ": " << cells.second.size() << " cells" << endmsg;
   }
-  file->Write();
   file->Close();
 
   return StatusCode::SUCCESS;
@@ -11,6 +11,7 @@ class IGeoSvc;
  *  Service building a map of neighbours for all existing cells in the geometry.
  *  The volumes for which the neighbour map is created can be either segmented in eta-phi (e.g. ECal inclined),
  *  or can contain nested volumes (e.g. HCal barrel).
+ *  The map is written with one tree per system, so that the systems can be read separately (see TopoCaloNeighbours).
  *
  *  @author Anna Zaborowska
  */
@@ -63,6 +64,11 @@ private:
       {"layerVolume", "moduleVolume", "wedgeVolume"}};  // to find out number of volumes
   /// Name of output file
   std::string m_outputFileName;
+  /// Write one tree per system, "neighbours_system<ID>", instead of a single tree "neighbours"
+  Gaudi::Property<bool> m_splitBySystem{this, "splitBySystem", true, "Write one tree per system"};
+  /// Encoding of the system in the cell IDs
+  Gaudi::Property<std::string> m_systemEncoding{this, "systemEncoding", "system:4",
+                                                "Encoding of the field system in the cell IDs"};
 
   // For combination of barrels: flag if ECal and HCal barrels should be merged
   Gaudi::Property<bool> m_connectBarrels{this, "connectBarrels", true};
@@ -4,8 +4,21 @@
 #include "DetCommon/DetUtils.h"
 #include "k4Interface/IGeoSvc.h"
 
+#include "DDSegmentation/BitFieldCoder.h"
+
+#include "CaloNoiseTableFormat.h"
+
 #include "TFile.h"
 #include "TTree.h"
+#include "TVirtualMutex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <future>
+#include <map>
+#include <memory>
+#include <unordered_map>
 
 DECLARE_COMPONENT(CreateFCChhCaloNoiseLevelMap)
 
@@ -14,6 +27,7 @@ CreateFCChhCaloNoiseLevelMap::CreateFCChhCaloNoiseLevelMap(const std::string& aN
   declareProperty("ECalBarrelNoiseTool", m_ecalBarrelNoiseTool, "Handle for the cells noise tool of Barrel ECal");
   declareProperty("HCalBarrelNoiseTool", m_hcalBarrelNoiseTool, "Handle for the cells noise tool of Barrel HCal");
   declareProperty( "outputFileName", m_outputFileName, "Name of the output file");
+  declareProperty("cellsTool", m_cellsTool, "Handle for the tool listing the cells instead of the geometry");
 }
 
 CreateFCChhCaloNoiseLevelMap::~CreateFCChhCaloNoiseLevelMap() {}
@@ -24,13 +38,20 @@ StatusCode CreateFCChhCaloNoiseLevelMap::initialize() {
     error() << "Unable to initialize Service()" << endmsg;
     return StatusCode::FAILURE;
   }
+  if (!m_cellsTool.empty()) {
+    std::vector<LayerTask> tasks;
+    if (cellsToolTasks(tasks).isFailure()) return StatusCode::FAILURE;
+    return writeMap(tasks);
+  }
   m_geoSvc = service("GeoSvc");
   if (!m_geoSvc) {
     error() << "Unable to locate Geometry Service. "
             << "Make sure you have GeoSvc and SimSvc in the right order in the configuration." << endmsg;
     return StatusCode::FAILURE;
   }
-  std::unordered_map<uint64_t, std::pair<double,double>> map;
+  // the cells are enumerated by tasks of one layer each, grouped by system
+  dd4hep::DDSegmentation::BitFieldCoder systemDecoder(m_systemEncoding);
+  std::vector<LayerTask> tasks;
 
   //////////////////////////////////
   /// SEGMENTED ETA-PHI VOLUMES  ///
@@ -82,25 +103,35 @@ StatusCode CreateFCChhCaloNoiseLevelMap::initialize() {
 	numCells[2]=minEtaID;
       }
       debug() << "Number of segmentation cells in (phi,eta): " << numCells << endmsg;
+      // noise tool of the system, retrieved here as the tasks may run in parallel
+      INoiseConstTool* noiseTool = nullptr;
+      if (m_fieldValuesSegmented[iSys] == m_hcalBarrelSysId) {
+        noiseTool = retrieveNoiseTool(m_hcalBarrelNoiseTool);
+        if (noiseTool == nullptr) return StatusCode::FAILURE;
+      } else if (m_fieldValuesSegmented[iSys] == m_ecalBarrelSysId) {
+        noiseTool = retrieveNoiseTool(m_ecalBarrelNoiseTool);
+        if (noiseTool == nullptr) return StatusCode::FAILURE;
+      }
       // Loop over segmenation cells
-      for (unsigned int iphi = 0; iphi < numCells[0]; iphi++) {
-        for (unsigned int ieta = 0; ieta < numCells[1]; ieta++) {
-	  dd4hep::DDSegmentation::CellID cellId = volumeId;
-	  decoder->set(cellId, "phi", iphi);
-	  decoder->set(cellId, "eta", ieta + numCells[2]);  // start from the minimum existing eta cell in this layer
-	  uint64_t id = cellId;
-	  double noise = 0.;
-	  double noiseOffset = 0.;
-	  if (m_fieldValuesSegmented[iSys] == m_hcalBarrelSysId){
-	    noise = m_hcalBarrelNoiseTool->getNoiseConstantPerCell(id);
-	    noiseOffset = m_hcalBarrelNoiseTool->getNoiseOffsetPerCell(id);
-	  } else if (m_fieldValuesSegmented[iSys] == m_ecalBarrelSysId){
-	    noise = m_ecalBarrelNoiseTool->getNoiseConstantPerCell(id);
-            noiseOffset = m_ecalBarrelNoiseTool->getNoiseOffsetPerCell(id);
-	  }
-          map.insert( std::pair<uint64_t, std::pair<double, double> >(id, std::make_pair(noise, noiseOffset) ) );
+      tasks.push_back({systemDecoder.get(volumeId, "system"), [decoder, volumeId, numCells,
+                                                              noiseTool](std::vector<NoiseCell>& aCells) {
+        aCells.reserve(numCells[0] * numCells[1]);
+        for (unsigned int iphi = 0; iphi < numCells[0]; iphi++) {
+          for (unsigned int ieta = 0; ieta < numCells[1]; ieta++) {
+	    dd4hep::DDSegmentation::CellID cellId = volumeId;
+	    decoder->set(cellId, "phi", iphi);
+	    decoder->set(cellId, "eta", ieta + numCells[2]);  // start from the minimum existing eta cell in this layer
+	    uint64_t id = cellId;
+	    double noise = 0.;
+	    double noiseOffset = 0.;
+	    if (noiseTool != nullptr) {
+	      noise = noiseTool->getNoiseConstantPerCell(id);
+	      noiseOffset = noiseTool->getNoiseOffsetPerCell(id);
+	    }
+            aCells.push_back({id, noise, noiseOffset});
+          }
         }
-      }
+      }});
     }
   }
 
@@ -179,43 +210,248 @@ StatusCode CreateFCChhCaloNoiseLevelMap::initialize() {
     extrema.push_back(std::make_pair(0, activeVolumesNumbersNested.find(m_activeFieldNamesNested[0])->second - 1));
     extrema.push_back(std::make_pair(0, activeVolumesNumbersNested.find(m_activeFieldNamesNested[1])->second - 1));
     extrema.push_back(std::make_pair(0, activeVolumesNumbersNested.find(m_activeFieldNamesNested[2])->second - 1));
+    uint numPhi = activeVolumesNumbersNested.find(m_activeFieldNamesNested[1])->second;
+    uint numZ = activeVolumesNumbersNested.find(m_activeFieldNamesNested[2])->second;
+    INoiseConstTool* noiseTool = retrieveNoiseTool(m_hcalBarrelNoiseTool);
+    if (noiseTool == nullptr) return StatusCode::FAILURE;
+    std::vector<std::string> fieldNames = m_activeFieldNamesNested;
     for (unsigned int ilayer = 0; ilayer < activeVolumesNumbersNested.find(m_activeFieldNamesNested[0])->second;
          ilayer++) {
-      for (unsigned int iphi = 0; iphi < activeVolumesNumbersNested.find(m_activeFieldNamesNested[1])->second; iphi++) {
-        for (unsigned int iz = 0; iz < activeVolumesNumbersNested.find(m_activeFieldNamesNested[2])->second; iz++) {
+      tasks.push_back({systemDecoder.get(volumeId, "system"), [decoder, volumeId, ilayer, numPhi, numZ, noiseTool,
+                                                              fieldNames](std::vector<NoiseCell>& aCells) {
+        aCells.reserve(numPhi * numZ);
+        for (unsigned int iphi = 0; iphi < numPhi; iphi++) {
+          for (unsigned int iz = 0; iz < numZ; iz++) {
 
-	  dd4hep::DDSegmentation::CellID cID = volumeId;
-          decoder->set(cID, m_activeFieldNamesNested[0], ilayer);
-	  decoder->set(cID, m_activeFieldNamesNested[1], iphi);
-	  decoder->set(cID, m_activeFieldNamesNested[2], iz);
+	    dd4hep::DDSegmentation::CellID cID = volumeId;
+            decoder->set(cID, fieldNames[0], ilayer);
+	    decoder->set(cID, fieldNames[1], iphi);
+	    decoder->set(cID, fieldNames[2], iz);
 	  
-	  double noise = m_hcalBarrelNoiseTool->getNoiseConstantPerCell(cID);
-	  double noiseOffset = m_hcalBarrelNoiseTool->getNoiseOffsetPerCell(cID);
+	    double noise = noiseTool->getNoiseConstantPerCell(cID);
+	    double noiseOffset = noiseTool->getNoiseOffsetPerCell(cID);
 	  
-	  map.insert( std::pair<uint64_t, std::pair<double, double> >(cID, std::make_pair(noise, noiseOffset) ) );
+	    aCells.push_back({cID, noise, noiseOffset});
+          }
         }
+      }});
+    }
+  }
+
+  return writeMap(tasks);
+}
+
+INoiseConstTool* CreateFCChhCaloNoiseLevelMap::retrieveNoiseTool(ToolHandle<INoiseConstTool>& aTool) {
+  if (!aTool.retrieve()) {
+    error() << "Unable to retrieve the noise tool " << aTool.typeAndName() << endmsg;
+    return nullptr;
+  }
+  return aTool.get();
+}
+
+StatusCode CreateFCChhCaloNoiseLevelMap::cellsToolTasks(std::vector<LayerTask>& aTasks) {
+  // number of cells enumerated by a task, the cells of a system are split in several tasks as the layers
+  constexpr size_t kCellsPerTask = 10000;
+  if (!m_cellsTool.retrieve()) {
+    error() << "Unable to retrieve the cells tool " << m_cellsTool.typeAndName() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  std::unordered_map<uint64_t, double> cells;
+  if (m_cellsTool->prepareEmptyCells(cells).isFailure()) {
+    error() << "Unable to get the cells from the tool " << m_cellsTool.typeAndName() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  dd4hep::DDSegmentation::BitFieldCoder systemDecoder(m_systemEncoding);
+  std::map<uint, std::vector<uint64_t>> cellsOfSystem;
+  for (const auto& cell : cells) {
+    cellsOfSystem[systemDecoder.get(cell.first, "system")].push_back(cell.first);
+  }
+  for (auto& system : cellsOfSystem) {
+    INoiseConstTool* noiseTool = nullptr;
+    if (system.first == m_hcalBarrelSysId) {
+      noiseTool = retrieveNoiseTool(m_hcalBarrelNoiseTool);
+      if (noiseTool == nullptr) return StatusCode::FAILURE;
+    } else if (system.first == m_ecalBarrelSysId) {
+      noiseTool = retrieveNoiseTool(m_ecalBarrelNoiseTool);
+      if (noiseTool == nullptr) return StatusCode::FAILURE;
+    }
+    std::sort(system.second.begin(), system.second.end());
+    info() << "System " << system.first << " of the cells tool: " << system.second.size() << " cells" << endmsg;
+    // shared by the tasks of the system, which run after this function
+    auto cellIds = std::make_shared<const std::vector<uint64_t>>(std::move(system.second));
+    for (size_t first = 0; first < cellIds->size(); first += kCellsPerTask) {
+      size_t last = std::min(first + kCellsPerTask, cellIds->size());
+      aTasks.push_back({system.first, [cellIds, first, last, noiseTool](std::vector<NoiseCell>& aCells) {
+                          aCells.reserve(last - first);
+                          for (size_t iCell = first; iCell < last; iCell++) {
+                            double noise = 0.;
+                            double noiseOffset = 0.;
+                            if (noiseTool != nullptr) {
+                              noise = noiseTool->getNoiseConstantPerCell((*cellIds)[iCell]);
+                              noiseOffset = noiseTool->getNoiseOffsetPerCell((*cellIds)[iCell]);
+                            }
+                            aCells.push_back({(*cellIds)[iCell], noise, noiseOffset});
+                          }
+                        }});
+    }
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CreateFCChhCaloNoiseLevelMap::writeMap(std::vector<LayerTask>& aTasks) {
+  // tasks of each system, in the order of the configuration
+  std::map<uint, std::vector<size_t>> tasksOfSystem;
+  for (size_t iTask = 0; iTask < aTasks.size(); iTask++) {
+    tasksOfSystem[aTasks[iTask].system].push_back(iTask);
+  }
+
+  // run the tasks on a pool of threads, each task fills and sorts its cells
+  std::vector<std::vector<NoiseCell>> cellsOfTask(aTasks.size());
+  std::vector<std::promise<void>> done(aTasks.size());
+  std::atomic<size_t> nextTask{0};
+  auto worker = [&]() {
+    for (size_t iTask = nextTask++; iTask < aTasks.size(); iTask = nextTask++) {
+      try {
+        aTasks[iTask].fill(cellsOfTask[iTask]);
+        std::sort(cellsOfTask[iTask].begin(), cellsOfTask[iTask].end(),
+                  [](const NoiseCell& lhs, const NoiseCell& rhs) { return lhs.cellId < rhs.cellId; });
+        done[iTask].set_value();
+      } catch (...) {
+        done[iTask].set_exception(std::current_exception());
       }
     }
+  };
+  uint numThreads = std::max(1u, std::min<uint>(m_numThreads, aTasks.size()));
+  // the thread safety of ROOT is enabled by the job (the global mutex is created by ROOT::EnableThreadSafety)
+  if (numThreads > 1 && gGlobalMutex == nullptr) {
+    warning() << "ROOT thread safety is not enabled in the job options (ROOT.EnableThreadSafety()), "
+              << "the noise is computed by one thread" << endmsg;
+    numThreads = 1;
   }
+  std::vector<std::future<void>> workers;
+  for (uint iThread = 0; iThread < numThreads; iThread++) {
+    workers.push_back(std::async(numThreads > 1 ? std::launch::async : std::launch::deferred, worker));
+  }
+  if (numThreads == 1) workers.front().get();
+  info() << "Noise of " << aTasks.size() << " layers computed with " << numThreads << " threads" << endmsg;
 
-  std::unique_ptr<TFile> file(TFile::Open(m_outputFileName.c_str(), "RECREATE"));
-  file->cd();
-  TTree tree("noisyCells", "Tree with map of noise per cell");
+  // outputs: ROOT file with one tree per system or a single tree, and/or binary table
+  std::unique_ptr<TFile> file;
+  std::unique_ptr<TTree> singleTree;
   uint64_t saveCellId;
   double saveNoiseLevel;
   double saveNoiseOffset;
-  tree.Branch("cellId", &saveCellId, "cellId/l");
-  tree.Branch("noiseLevel", &saveNoiseLevel);
-  tree.Branch("noiseOffset", &saveNoiseOffset);
-  for (const auto& item : map) {
-    saveCellId = item.first;
-    saveNoiseLevel = item.second.first;
-    saveNoiseOffset = item.second.second;
-    tree.Fill();
-  }
-  file->Write();
-  file->Close();
+  auto branches = [&](TTree& aTree) {
+    aTree.Branch("cellId", &saveCellId, "cellId/l");
+    aTree.Branch("noiseLevel", &saveNoiseLevel);
+    aTree.Branch("noiseOffset", &saveNoiseOffset);
+  };
+  if (!m_outputFileName.empty()) {
+    file.reset(TFile::Open(m_outputFileName.c_str(), "RECREATE"));
+    if (file == nullptr || file->IsZombie()) {
+      error() << "Unable to open the output file " << m_outputFileName << endmsg;
+      return StatusCode::FAILURE;
+    }
+    file->cd();
+    if (!m_splitBySystem) {
+      singleTree = std::make_unique<TTree>("noisyCells", "Tree with map of noise per cell");
+      branches(*singleTree);
+    }
+  }
+  std::ofstream table;
+  std::vector<calo_noise::SystemEntry> systemTable;
+  if (!m_binaryFileName.empty()) {
+    table.open(m_binaryFileName, std::ios::binary | std::ios::trunc);
+    if (!table) {
+      error() << "Unable to open the output file " << m_binaryFileName.value() << endmsg;
+      return StatusCode::FAILURE;
+    }
+    // the table is written again with the number of cells of each system at the end
+    systemTable.resize(tasksOfSystem.size(), calo_noise::SystemEntry{0, 0, 0});
+    calo_noise::writeHeader(table, systemTable);
+  }
+
+  // the systems are written as soon as their tasks are done, the cells of the other systems are still computed
+  size_t offset = calo_noise::headerSize(tasksOfSystem.size());
+  size_t iSystem = 0;
+  for (const auto& system : tasksOfSystem) {
+    std::vector<NoiseCell> cells;
+    for (size_t iTask : system.second) {
+      try {
+        done[iTask].get_future().get();
+      } catch (const std::exception& e) {
+        error() << "Computation of the noise failed: " << e.what() << endmsg;
+        return StatusCode::FAILURE;
+      }
+      size_t previous = cells.size();
+      cells.insert(cells.end(), cellsOfTask[iTask].begin(), cellsOfTask[iTask].end());
+      std::vector<NoiseCell>().swap(cellsOfTask[iTask]);
+      std::inplace_merge(cells.begin(), cells.begin() + previous, cells.end(),
+                         [](const NoiseCell& lhs, const NoiseCell& rhs) { return lhs.cellId < rhs.cellId; });
+    }
+    // a cell enumerated twice keeps its first noise values
+    cells.erase(std::unique(cells.begin(), cells.end(),
+                            [](const NoiseCell& lhs, const NoiseCell& rhs) { return lhs.cellId == rhs.cellId; }),
+                cells.end());
+
+    if (file != nullptr) {
+      std::unique_ptr<TTree> systemTree;
+      if (m_splitBySystem) {
+        systemTree = std::make_unique<TTree>(("noisyCells_system" + std::to_string(system.first)).c_str(),
+                                             "Tree with map of noise per cell");
+        branches(*systemTree);
+      }
+      TTree& tree = m_splitBySystem ? *systemTree : *singleTree;
+      for (const auto& cell : cells) {
+        saveCellId = cell.cellId;
+        saveNoiseLevel = cell.noise;
+        saveNoiseOffset = cell.noiseOffset;
+        tree.Fill();
+      }
+      if (m_splitBySystem) {
+        systemTree->Write();
+        systemTree.reset();
+      }
+    }
+    if (table.is_open()) {
+      std::vector<uint64_t> cellIds;
+      std::vector<float> noiseLevels, noiseOffsets;
+      cellIds.reserve(cells.size());
+      noiseLevels.reserve(cells.size());
+      noiseOffsets.reserve(cells.size());
+      for (const auto& cell : cells) {
+        cellIds.push_back(cell.cellId);
+        noiseLevels.push_back(cell.noise);
+        noiseOffsets.push_back(cell.noiseOffset);
+      }
+      calo_noise::writeSystem(table, cellIds, noiseLevels, noiseOffsets);
+      systemTable[iSystem] = calo_noise::SystemEntry{system.first, uint32_t(cells.size()), offset};
+      offset += calo_noise::blockSize(cells.size());
+    }
+    info() << "System " << system.first << ": " << cells.size() << " cells" << endmsg;
+    iSystem++;
+  }
+  for (auto& thread : workers) {
+    if (thread.valid()) thread.get();
+  }
 
+  if (file != nullptr) {
+    if (singleTree != nullptr) {
+      singleTree->Write();
+      singleTree.reset();
+    }
+    file->Close();
+  }
+  if (table.is_open()) {
+    table.seekp(0);
+    calo_noise::writeHeader(table, systemTable);
+    table.close();
+    if (!table) {
+      error() << "Unable to write the output file " << m_binaryFileName.value() << endmsg;
+      return StatusCode::FAILURE;
+    }
+    info() << "Noise table written to " << m_binaryFileName.value() << " (" << offset << " bytes)" << endmsg;
+  }
   return StatusCode::SUCCESS;
 }
 
@@ -4,9 +4,14 @@
 // Gaudi
 #include "GaudiKernel/Service.h"
 #include "k4Interface/ICaloCreateMap.h"
+#include "k4Interface/ICalorimeterTool.h"
 #include "k4Interface/INoiseConstTool.h"
 #include "k4Interface/ICellPositionsTool.h"
 
+#include <functional>
+#include <string>
+#include <vector>
+
 class IGeoSvc;
 
 /** @class CreateFCChhCaloNoiseLevelMap
@@ -14,6 +19,19 @@ class IGeoSvc;
  *  Service building a map from cellIds to noise level per cell.
  *  The volumes for which the neighbour map is created can be either segmented in eta-phi (e.g. ECal inclined),
  *  or can contain nested volumes (e.g. HCal barrel).
+ *  The map is written with one tree per system, so that the systems can be read separately (see TopoCaloNoisyCells).
+ *
+ *  The cells are enumerated and their noise computed by one task per layer of each readout, run on '\b numThreads'
+ *  threads. The cells of a system are sorted by cellID and written as soon as the tasks of the system are done, so
+ *  that only the cells of the systems not written yet are held in memory.
+ *  With more than one thread the noise tools are called concurrently, they have to be thread-safe: e.g.
+ *  ReadNoiseFromFileTool only with thread-safe cell positions tools and without debug output. The threads also
+ *  need the thread safety of ROOT enabled for the whole job (ROOT.EnableThreadSafety() in the job options), otherwise
+ *  the noise is computed by one thread.
+ *  With '\b cellsTool' (e.g. SyntheticCaloGridTool), the cells are taken from prepareEmptyCells of the tool instead
+ *  of the readouts of the geometry, in tasks of consecutive cellIDs, with the noise tool of their system.
+ *  The map is written to the ROOT file '\b outputFileName' and/or to the binary table '\b binaryFileName' (see
+ *  CaloNoiseTableFormat.h), which stores the cells of each system sorted, with the noise as float.
  *
  *  @author Coralie Neubueser
  */
@@ -34,8 +52,30 @@ public:
   virtual StatusCode finalize() final;
 
 private:
+  /// Cell with its noise level and offset
+  struct NoiseCell {
+    uint64_t cellId;
+    double noise;
+    double noiseOffset;
+  };
+  /// Enumeration of the cells of a layer
+  struct LayerTask {
+    /// System of the cells
+    uint system;
+    /// Fills the cells of the layer
+    std::function<void(std::vector<NoiseCell>&)> fill;
+  };
+  /// Run the tasks and write the cells of each system
+  StatusCode writeMap(std::vector<LayerTask>& aTasks);
+  /// Retrieve a noise tool, nullptr if not found
+  INoiseConstTool* retrieveNoiseTool(ToolHandle<INoiseConstTool>& aTool);
+  /// Tasks enumerating the cells of the cells tool
+  StatusCode cellsToolTasks(std::vector<LayerTask>& aTasks);
+
   /// Pointer to the geometry service
   SmartIF<IGeoSvc> m_geoSvc;
+  /// Handle for the tool listing the cells instead of the geometry, not used if empty
+  ToolHandle<ICalorimeterTool> m_cellsTool{"", this};
 
   /// Handle for the cells noise tool in ECal
   ToolHandle<INoiseConstTool> m_ecalBarrelNoiseTool{"ReadNoiseFromFileTool", this};
@@ -75,6 +115,18 @@ private:
 
   /// Name of output file
   std::string m_outputFileName;
+  /// Write one tree per system, "noisyCells_system<ID>", instead of a single tree "noisyCells"
+  Gaudi::Property<bool> m_splitBySystem{this, "splitBySystem", true, "Write one tree per system"};
+  /// Name of the binary output file, not written if empty
+  Gaudi::Property<std::string> m_binaryFileName{this, "binaryFileName", "",
+                                                "Name of the output file with the binary table, none if empty"};
+  /// Number of threads computing the noise of the layers
+  Gaudi::Property<uint> m_numThreads{
+      this, "numThreads", 1,
+      "Number of threads computing the noise of the layers, > 1 needs thread-safe noise tools and ROOT thread safety"};
+  /// Encoding of the system in the cell IDs
+  Gaudi::Property<std::string> m_systemEncoding{this, "systemEncoding", "system:4",
+                                                "Encoding of the field system in the cell IDs"};
 };
 
 #endif /* RECALORIMETER_CREATEFCCHHCALONOISELEVELMAP_H */
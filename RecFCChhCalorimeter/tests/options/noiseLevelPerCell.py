@@ -1,5 +1,10 @@
 from Gaudi.Configuration import *
 
+# More than one thread (numThreads of CreateFCChhCaloNoiseLevelMap) needs the thread safety of ROOT, enabled for the
+# whole job before the components
+import ROOT
+ROOT.EnableThreadSafety()
+
 # DD4hep geometry service
 from Configurables import GeoSvc
 geoservice = GeoSvc("GeoSvc", detectors=[ 'file:Detector/DetFCChhBaseline1/compact/FCChh_DectEmptyMaster.xml',
@@ -62,6 +67,8 @@ noisePerCell = CreateFCChhCaloNoiseLevelMap("noisePerCell",
                                             activeVolumesEta = [1.2524, 1.2234, 1.1956, 1.1561, 1.1189, 1.0839, 1.0509, 0.9999, 0.9534, 0.91072],
                                             readoutNamesVolumes=[],
                                             outputFileName="cellNoise_map_electronicsNoiseLevel.root",
+                                            binaryFileName="cellNoise_map_electronicsNoiseLevel.bin",
+                                            numThreads=4,
                                             OutputLevel=DEBUG)
 
 # ApplicationMgr
@@ -0,0 +1,38 @@
+# Regression test of the noise map written by CreateFCChhCaloNoiseLevelMap on the synthetic grid, without the detector
+# geometry: the cells and their noise are given by SyntheticCaloGridTool. The map is created with one and with four
+# threads, each time in the ROOT file and in the binary table; the four files are compared by
+# tests/scripts/compareNoiseMapFormats.py.
+grid = dict(systemId = 5, numLayers = 4, numEta = 20, numPhi = 32)
+
+# More than one thread needs the thread safety of ROOT, enabled for the whole job before the components
+import ROOT
+ROOT.EnableThreadSafety()
+
+from Gaudi.Configuration import *
+
+from Configurables import SyntheticCaloGridTool
+gridTool = SyntheticCaloGridTool("SyntheticGrid",
+                                 etaMax = 0.4,
+                                 cellNoise = 0.003,
+                                 cellNoiseOffset = 0.001,
+                                 **grid)
+
+from Configurables import CreateFCChhCaloNoiseLevelMap
+def noiseMap(name, numThreads):
+    return CreateFCChhCaloNoiseLevelMap(name,
+                                        cellsTool = gridTool,
+                                        ECalBarrelNoiseTool = gridTool,
+                                        ecalBarrelSysId = grid["systemId"],
+                                        readoutNamesPhiEta = [],
+                                        readoutNamesVolumes = [],
+                                        outputFileName = "cellNoise_syntheticGrid_%dthreads.root" % numThreads,
+                                        binaryFileName = "cellNoise_syntheticGrid_%dthreads.bin" % numThreads,
+                                        numThreads = numThreads,
+                                        OutputLevel = INFO)
+
+from Configurables import ApplicationMgr
+ApplicationMgr(TopAlg = [],
+               EvtSel = 'NONE',
+               EvtMax = 1,
+               ExtSvc = [noiseMap("noisePerCell1Thread", 1), noiseMap("noisePerCell4Threads", 4)],
+               OutputLevel = INFO)
@@ -0,0 +1,48 @@
+# Regression test of the noise map written by CreateFCChhCaloNoiseLevelMap (tests/options/noiseLevelPerCell*.py):
+# the binary noise table has to contain the same cells as the ROOT file, sorted by cellID, with the same noise level
+# and offset up to the float precision of the table.
+import struct
+import sys
+
+import ROOT
+
+rootFile = sys.argv[1] if len(sys.argv) > 1 else "cellNoise_map_electronicsNoiseLevel.root"
+tableFile = sys.argv[2] if len(sys.argv) > 2 else "cellNoise_map_electronicsNoiseLevel.bin"
+tolerance = 1e-6
+
+# cells of the ROOT file, one tree per system or a single tree
+fromRoot = {}
+f = ROOT.TFile.Open(rootFile)
+for key in f.GetListOfKeys():
+    if not key.GetName().startswith("noisyCells"):
+        continue
+    for cell in f.Get(key.GetName()):
+        fromRoot[cell.cellId] = (cell.noiseLevel, cell.noiseOffset)
+f.Close()
+
+# cells of the binary table (see RecCalorimeter/src/components/CaloNoiseTableFormat.h)
+fromTable = {}
+with open(tableFile, "rb") as table:
+    data = table.read()
+magic, version, numSystems = struct.unpack_from("=8sII", data, 0)
+if magic != b"CNOISE\0\0" or version != 1:
+    sys.exit("%s is not a noise table of version 1" % tableFile)
+for iSystem in range(numSystems):
+    system, numCells, offset = struct.unpack_from("=IIQ", data, 16 + 16 * iSystem)
+    cellIds = struct.unpack_from("=%dQ" % numCells, data, offset)
+    if list(cellIds) != sorted(cellIds):
+        sys.exit("Cells of system %d are not sorted in %s" % (system, tableFile))
+    floatBytes = 4 * numCells
+    noiseLevels = struct.unpack_from("=%df" % numCells, data, offset + 8 * numCells)
+    noiseOffsets = struct.unpack_from("=%df" % numCells, data, offset + 8 * numCells + (floatBytes + 7) // 8 * 8)
+    for cellId, noiseLevel, noiseOffset in zip(cellIds, noiseLevels, noiseOffsets):
+        fromTable[cellId] = (noiseLevel, noiseOffset)
+
+if set(fromRoot) != set(fromTable):
+    sys.exit("Different cells: %d in %s, %d in %s, %d in common" %
+             (len(fromRoot), rootFile, len(fromTable), tableFile, len(set(fromRoot) & set(fromTable))))
+for cellId, values in fromRoot.items():
+    for reference, value in zip(values, fromTable[cellId]):
+        if abs(reference - value) > tolerance * max(abs(reference), 1e-12):
+            sys.exit("Cell %d: noise %g in %s, %g in %s" % (cellId, reference, rootFile, value, tableFile))
+print("Noise maps agree: %d cells in %d systems" % (len(fromRoot), numSystems))